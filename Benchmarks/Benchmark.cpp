@@ -0,0 +1,22 @@
+/* Copyright (c) 2022 [Rick de Bondt] - Benchmark.cpp
+ * This file contains the benchmark main cpp
+ **/
+
+#include <benchmark/benchmark.h>
+
+#include "Logger.h"
+
+int main(int argc, char** argv)
+{
+    // Keep logging out of the measurements, only the cost of the level check remains
+    Logger::GetInstance().SetLogLevel(Logger::Level::ERROR);
+
+    ::benchmark::Initialize(&argc, argv);
+    if (::benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+
+    ::benchmark::RunSpecifiedBenchmarks();
+    ::benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,76 @@
+/* Copyright (c) 2022 [Rick de Bondt] - BenchmarkHelpers.cpp */
+
+#include "BenchmarkHelpers.h"
+
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include "PCapWrapper.h"
+
+namespace
+{
+    std::atomic<uint64_t> gAllocationCount{0};
+}  // namespace
+
+// Replace the global allocation functions so allocations in the hot paths can be counted, the array and nothrow
+// variants end up here as well
+void* operator new(std::size_t aSize)
+{
+    gAllocationCount.fetch_add(1, std::memory_order_relaxed);
+
+    void* lReturn{std::malloc(aSize > 0 ? aSize : 1)};
+    if (lReturn == nullptr) {
+        throw std::bad_alloc();
+    }
+
+    return lReturn;
+}
+
+void operator delete(void* aPointer) noexcept
+{
+    std::free(aPointer);
+}
+
+void operator delete(void* aPointer, std::size_t /*aSize*/) noexcept
+{
+    std::free(aPointer);
+}
+
+std::vector<std::string> LoadPackets(std::string_view aFileName, benchmark::State& aState)
+{
+    std::vector<std::string>           lReturn{};
+    std::array<char, PCAP_ERRBUF_SIZE> lErrorBuffer{};
+    PCapWrapper                        lWrapper{};
+
+    lWrapper.OpenOffline(std::string(aFileName).c_str(), lErrorBuffer.data());
+    if (lWrapper.IsActivated()) {
+        pcap_pkthdr*         lHeader{nullptr};
+        const unsigned char* lData{nullptr};
+
+        while (lWrapper.NextEx(&lHeader, &lData) >= 0) {
+            lReturn.emplace_back(reinterpret_cast<const char*>(lData), lHeader->caplen);
+        }
+
+        lWrapper.Close();
+    }
+
+    if (lReturn.empty()) {
+        aState.SkipWithError(("Could not load any packets from " + std::string(aFileName)).c_str());
+    }
+
+    return lReturn;
+}
+
+uint64_t GetAllocationCount()
+{
+    return gAllocationCount.load(std::memory_order_relaxed);
+}
+
+void ReportPerPacket(benchmark::State& aState, uint64_t aAllocationsAtStart)
+{
+    aState.SetItemsProcessed(aState.iterations());
+    aState.counters["allocs/packet"] = benchmark::Counter(
+        static_cast<double>(GetAllocationCount() - aAllocationsAtStart), benchmark::Counter::kAvgIterations);
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+/* Copyright (c) 2022 [Rick de Bondt] - BenchmarkHelpers.h
+ *
+ * This file contains helpers shared by all benchmarks.
+ *
+ **/
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+namespace BenchmarkHelpers_Constants
+{
+    // Captures are read relative to the build directory, just like the unittests do
+    static constexpr std::string_view cMonitorCapture{"../Tests/Input/MonitorHelloWorld.pcapng"};
+    static constexpr std::string_view cPluginCapture{"../Tests/Input/PluginFromPSPTest.pcapng"};
+    static constexpr std::string_view cPromiscuousCapture{"../Tests/Input/PromiscuousTestDevice.pcap"};
+    static constexpr std::string_view cXLinkCapture{"../Tests/Input/PromiscuousTestXLink.pcap"};
+    static constexpr std::string_view cMonitorSSIDFilter{"T#STNET"};
+}  // namespace BenchmarkHelpers_Constants
+
+/**
+ * Loads all packets of a capture in memory, skips the benchmark if there is nothing to load.
+ * @param aFileName - Capture to load.
+ * @param aState - State of the benchmark that needs the packets.
+ * @return List of packets, empty if the capture could not be read.
+ */
+std::vector<std::string> LoadPackets(std::string_view aFileName, benchmark::State& aState);
+
+/**
+ * Gets the amount of heap allocations done by this process so far.
+ * @return The amount of allocations.
+ */
+uint64_t GetAllocationCount();
+
+/**
+ * Adds the allocations per packet counter to a benchmark. Every benchmark iteration handles exactly one packet, so the
+ * reported time is the time per packet.
+ * @param aState - State of the benchmark to report to.
+ * @param aAllocationsAtStart - Result of GetAllocationCount() right before the benchmark loop.
+ */
+void ReportPerPacket(benchmark::State& aState, uint64_t aAllocationsAtStart);
@@ -0,0 +1,159 @@
+/* Copyright (c) 2022 [Rick de Bondt] - FakeXLinkKai.cpp */
+
+#include "FakeXLinkKai.h"
+
+#include "Logger.h"
+#include "XLinkKaiConnection.h"
+
+using namespace FakeXLinkKai_Constants;
+using namespace TrafficRecorder_Constants;
+using namespace std::chrono;
+using namespace XLinkKai_Constants;
+
+FakeXLinkKai::FakeXLinkKai(TrafficRecorder& aFromBridge, TrafficRecorder& aToBridge) :
+    mFromBridge(aFromBridge), mToBridge(aToBridge)
+{}
+
+FakeXLinkKai::~FakeXLinkKai()
+{
+    Close();
+}
+
+bool FakeXLinkKai::Open()
+{
+    bool lReturn{true};
+
+    try {
+        mSocket.open(boost::asio::ip::udp::v4());
+        mSocket.bind(boost::asio::ip::udp::endpoint(boost::asio::ip::address_v4::loopback(), 0));
+    } catch (const boost::system::system_error& lException) {
+        Logger::GetInstance().Log("Failed to open fake XLink Kai socket: " + std::string(lException.what()),
+                                  Logger::Level::ERROR);
+        lReturn = false;
+    }
+
+    if (lReturn) {
+        ScheduleReceive();
+        ScheduleKeepAlive();
+        mThread = std::make_shared<std::thread>([&] { mService.run(); });
+    }
+
+    return lReturn;
+}
+
+void FakeXLinkKai::Close()
+{
+    mService.stop();
+
+    if (mThread != nullptr) {
+        mThread->join();
+        mThread = nullptr;
+    }
+
+    if (mSocket.is_open()) {
+        mSocket.close();
+    }
+
+    mConnected = false;
+}
+
+unsigned int FakeXLinkKai::GetPort() const
+{
+    return mSocket.local_endpoint().port();
+}
+
+bool FakeXLinkKai::IsConnected() const
+{
+    return mConnected;
+}
+
+bool FakeXLinkKai::IsTrafficDone() const
+{
+    return mTrafficDone;
+}
+
+void FakeXLinkKai::StartTraffic(const Traffic& aTraffic)
+{
+    mTrafficDone = false;
+
+    // Only touch the traffic settings on the engine thread
+    boost::asio::post(mService, [this, aTraffic] {
+        mTraffic      = aTraffic;
+        mTrafficStart = steady_clock::now();
+        mTrafficSent  = 0;
+        mTrafficTotal = aTraffic.PacketsPerSecond * static_cast<uint64_t>(aTraffic.Duration.count()) / 1000;
+        ScheduleTraffic();
+    });
+}
+
+void FakeXLinkKai::HandleMessage(std::string_view aMessage)
+{
+    if (aMessage.substr(0, cEthernetDataString.size()) == cEthernetDataString) {
+        mFromBridge.Record(aMessage.substr(cEthernetDataString.size()));
+    } else if (aMessage.substr(0, cConnectFormat.size() + cSeparator.size()) ==
+               std::string(cConnectFormat) + cSeparator.data()) {
+        mBridgeEndpoint = mSenderEndpoint;
+        SendToBridge(cConnectedString + cSeparator.data() + cEmulatorName.data() + cSeparator.data());
+        mConnected = true;
+    } else if (aMessage.substr(0, cDisconnectString.size()) == cDisconnectString) {
+        mConnected = false;
+    }
+}
+
+void FakeXLinkKai::ScheduleKeepAlive()
+{
+    mKeepAliveTimer.expires_after(cKeepAliveInterval);
+    mKeepAliveTimer.async_wait([this](const boost::system::error_code& aError) {
+        if (!aError) {
+            if (mConnected) {
+                SendToBridge(cKeepAliveString);
+            }
+            ScheduleKeepAlive();
+        }
+    });
+}
+
+void FakeXLinkKai::ScheduleReceive()
+{
+    mSocket.async_receive_from(boost::asio::buffer(mData),
+                               mSenderEndpoint,
+                               [this](const boost::system::error_code& aError, std::size_t aBytesReceived) {
+                                   if (!aError) {
+                                       HandleMessage(std::string_view(mData.data(), aBytesReceived));
+                                   }
+
+                                   if (aError != boost::asio::error::operation_aborted) {
+                                       ScheduleReceive();
+                                   }
+                               });
+}
+
+void FakeXLinkKai::ScheduleTraffic()
+{
+    if (mTrafficSent >= mTrafficTotal) {
+        mTrafficDone = true;
+    } else {
+        // Pace against the start time, so a late timer catches up instead of lowering the rate
+        mTrafficTimer.expires_at(mTrafficStart + duration_cast<steady_clock::duration>(
+                                                     duration<double>(static_cast<double>(mTrafficSent) /
+                                                                      mTraffic.PacketsPerSecond)));
+        mTrafficTimer.async_wait([this](const boost::system::error_code& aError) {
+            if (!aError) {
+                bool lBroadcast{(mTrafficSent % 100) < mTraffic.BroadcastPercentage};
+                SendToBridge(cEthernetDataString +
+                             mToBridge.CreateFrame(lBroadcast ? Net_Constants::cBroadcastMac :
+                                                                mTraffic.DestinationMac,
+                                                   mTraffic.SourceMac,
+                                                   mTraffic.FrameSize));
+                mTrafficSent++;
+                ScheduleTraffic();
+            }
+        });
+    }
+}
+
+void FakeXLinkKai::SendToBridge(std::string_view aMessage)
+{
+    boost::system::error_code lError{};
+    mSocket.send_to(boost::asio::buffer(aMessage.data(), aMessage.size()), mBridgeEndpoint, 0, lError);
+}
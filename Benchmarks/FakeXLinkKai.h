@@ -0,0 +1,100 @@
+#pragma once
+
+/* Copyright (c) 2022 [Rick de Bondt] - FakeXLinkKai.h
+ *
+ * This file contains a stand-in for the XLink Kai engine, used to measure the bridge without a real engine.
+ *
+ **/
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+
+#include <boost/asio.hpp>
+
+#include "TrafficRecorder.h"
+
+namespace FakeXLinkKai_Constants
+{
+    static constexpr std::size_t          cMaxLength{4096};
+    static constexpr std::chrono::seconds cKeepAliveInterval{1};
+}  // namespace FakeXLinkKai_Constants
+
+/**
+ * Speaks just enough of the XLink Kai UDP protocol (connect;, connected;, keepalive; and e;e;) to get a bridge to
+ * connect, then generates and records ethernet frames. Everything runs on a single io_service thread.
+ */
+class FakeXLinkKai
+{
+public:
+    /**
+     * Creates the fake engine.
+     * @param aFromBridge - Recorder for frames the bridge sends to XLink Kai.
+     * @param aToBridge - Recorder that creates the frames sent to the bridge.
+     */
+    FakeXLinkKai(TrafficRecorder& aFromBridge, TrafficRecorder& aToBridge);
+    ~FakeXLinkKai();
+    FakeXLinkKai(const FakeXLinkKai& aFakeXLinkKai) = delete;
+    FakeXLinkKai& operator=(const FakeXLinkKai& aFakeXLinkKai) = delete;
+
+    /**
+     * Binds to a free port on localhost and starts the engine thread.
+     * @return true if successful.
+     */
+    bool Open();
+
+    /**
+     * Stops the engine thread and closes the socket.
+     */
+    void Close();
+
+    /**
+     * Gets the port the engine listens on.
+     * @return The port.
+     */
+    [[nodiscard]] unsigned int GetPort() const;
+
+    /**
+     * Checks whether a bridge has connected.
+     * @return true if connected.
+     */
+    [[nodiscard]] bool IsConnected() const;
+
+    /**
+     * Checks whether all traffic has been sent.
+     * @return true if done.
+     */
+    [[nodiscard]] bool IsTrafficDone() const;
+
+    /**
+     * Starts sending traffic to the connected bridge.
+     * @param aTraffic - Traffic to generate.
+     */
+    void StartTraffic(const TrafficRecorder_Constants::Traffic& aTraffic);
+
+private:
+    void HandleMessage(std::string_view aMessage);
+    void ScheduleKeepAlive();
+    void ScheduleReceive();
+    void ScheduleTraffic();
+    void SendToBridge(std::string_view aMessage);
+
+    TrafficRecorder&                                     mFromBridge;
+    TrafficRecorder&                                     mToBridge;
+    std::array<char, FakeXLinkKai_Constants::cMaxLength> mData{};
+    boost::asio::io_service                              mService{};
+    boost::asio::ip::udp::socket                         mSocket{mService};
+    boost::asio::ip::udp::endpoint                       mBridgeEndpoint{};
+    boost::asio::ip::udp::endpoint                       mSenderEndpoint{};
+    boost::asio::steady_timer                            mKeepAliveTimer{mService};
+    boost::asio::steady_timer                            mTrafficTimer{mService};
+    std::atomic<bool>                                    mConnected{false};
+    std::shared_ptr<std::thread>                         mThread{nullptr};
+    TrafficRecorder_Constants::Traffic                   mTraffic{};
+    std::chrono::time_point<std::chrono::steady_clock>   mTrafficStart{};
+    uint64_t                                             mTrafficSent{0};
+    uint64_t                                             mTrafficTotal{0};
+    std::atomic<bool>                                    mTrafficDone{true};
+};
@@ -0,0 +1,194 @@
+/* Copyright (c) 2022 [Rick de Bondt] - GeneratorPCapWrapper.cpp */
+
+#include "GeneratorPCapWrapper.h"
+
+#include "NetworkingHeaders.h"
+
+using namespace std::chrono;
+using namespace TrafficRecorder_Constants;
+
+GeneratorPCapWrapper::GeneratorPCapWrapper(TrafficRecorder& aFromDevice, TrafficRecorder& aToDevice) :
+    mFromDevice(aFromDevice), mToDevice(aToDevice)
+{}
+
+GeneratorPCapWrapper::~GeneratorPCapWrapper()
+{
+    StopTraffic();
+}
+
+void GeneratorPCapWrapper::StartTraffic(const Traffic& aTraffic)
+{
+    StopTraffic();
+
+    mGeneratorThread = std::make_shared<std::thread>([this, aTraffic] {
+        uint64_t lTotal{aTraffic.PacketsPerSecond * static_cast<uint64_t>(aTraffic.Duration.count()) / 1000};
+        time_point<steady_clock> lStart{steady_clock::now()};
+
+        for (uint64_t lCount = 0; lCount < lTotal && !mStopCommand; lCount++) {
+            // Pace against the start time, so a late wakeup catches up instead of lowering the rate
+            std::this_thread::sleep_until(
+                lStart + duration_cast<steady_clock::duration>(
+                             duration<double>(static_cast<double>(lCount) / aTraffic.PacketsPerSecond)));
+
+            bool        lBroadcast{(lCount % 100) < aTraffic.BroadcastPercentage};
+            std::string lFrame{mFromDevice.CreateFrame(
+                lBroadcast ? Net_Constants::cBroadcastMac : aTraffic.DestinationMac,
+                aTraffic.SourceMac,
+                aTraffic.FrameSize)};
+
+            std::scoped_lock lLock{mQueueMutex};
+            mQueue.emplace_back(std::move(lFrame));
+        }
+    });
+}
+
+void GeneratorPCapWrapper::StopTraffic()
+{
+    if (mGeneratorThread != nullptr) {
+        mGeneratorThread->join();
+        mGeneratorThread = nullptr;
+    }
+}
+
+int GeneratorPCapWrapper::Activate()
+{
+    mActivated = true;
+    return 0;
+}
+
+void GeneratorPCapWrapper::BreakLoop() {}
+
+void GeneratorPCapWrapper::Close()
+{
+    mStopCommand = true;
+    StopTraffic();
+    mStopCommand = false;
+    mActivated   = false;
+}
+
+pcap_t* GeneratorPCapWrapper::Create(const char* /*source*/, char* /*errbuf*/)
+{
+    return nullptr;
+}
+
+int GeneratorPCapWrapper::Dispatch(int /*cnt*/, pcap_handler callback, unsigned char* user)
+{
+    std::vector<std::string> lFrames{};
+    {
+        std::scoped_lock lLock{mQueueMutex};
+        lFrames.swap(mQueue);
+    }
+
+    for (const auto& lFrame : lFrames) {
+        pcap_pkthdr lHeader{};
+        lHeader.caplen = static_cast<bpf_u_int32>(lFrame.size());
+        lHeader.len    = static_cast<bpf_u_int32>(lFrame.size());
+        callback(user, &lHeader, reinterpret_cast<const unsigned char*>(lFrame.data()));
+    }
+
+    return static_cast<int>(lFrames.size());
+}
+
+void GeneratorPCapWrapper::Dump(unsigned char* /*user*/, pcap_pkthdr* /*header*/, unsigned char* /*message*/) {}
+
+void GeneratorPCapWrapper::DumpClose(pcap_dumper_t* /*dumper*/) {}
+
+pcap_dumper_t* GeneratorPCapWrapper::DumpOpen(const char* /*outputfile*/)
+{
+    return nullptr;
+}
+
+int GeneratorPCapWrapper::FindAllDevices(pcap_if_t** /*alldevicesp*/, char* /*errbuf*/)
+{
+    return -1;
+}
+
+void GeneratorPCapWrapper::FreeAllDevices(pcap_if_t* /*devices*/) {}
+
+int GeneratorPCapWrapper::GetDatalink()
+{
+    return DLT_EN10MB;
+}
+
+char* GeneratorPCapWrapper::GetError()
+{
+    return mError.data();
+}
+
+bool GeneratorPCapWrapper::IsActivated()
+{
+    return mActivated;
+}
+
+pcap_t* GeneratorPCapWrapper::OpenDead(int /*linktype*/, int /*snaplen*/)
+{
+    return nullptr;
+}
+
+pcap_t* GeneratorPCapWrapper::OpenOffline(const char* /*fname*/, char* /*errbuf*/)
+{
+    return nullptr;
+}
+
+int GeneratorPCapWrapper::NextEx(pcap_pkthdr** /*header*/, const unsigned char** /*pkt_data*/)
+{
+    return 0;
+}
+
+int GeneratorPCapWrapper::SendPacket(std::string_view buffer)
+{
+    mToDevice.Record(buffer);
+    return 0;
+}
+
+int GeneratorPCapWrapper::SetDirection(PcapDirection::Direction /*direction*/)
+{
+    return 0;
+}
+
+int GeneratorPCapWrapper::SetImmediateMode(int /*mode*/)
+{
+    return 0;
+}
+
+int GeneratorPCapWrapper::SetPromiscuousMode(int /*promiscuous*/)
+{
+    return 0;
+}
+
+int GeneratorPCapWrapper::SetSnapLen(int /*snaplen*/)
+{
+    return 0;
+}
+
+int GeneratorPCapWrapper::SetTimeOut(int /*timeout*/)
+{
+    return 0;
+}
+
+bool GeneratorPCapWrapper::WaitsForPackets()
+{
+    return false;
+}
+
+LoopbackWifiInterface::LoopbackWifiInterface(uint64_t aAdapterMacAddress) : mAdapterMacAddress(aAdapterMacAddress) {}
+
+bool LoopbackWifiInterface::Connect(const WifiInformation& /*aConnection*/)
+{
+    return true;
+}
+
+bool LoopbackWifiInterface::LeaveIBSS()
+{
+    return true;
+}
+
+uint64_t LoopbackWifiInterface::GetAdapterMacAddress()
+{
+    return mAdapterMacAddress;
+}
+
+std::vector<IWifiInterface::WifiInformation>& LoopbackWifiInterface::GetAdhocNetworks()
+{
+    return mNetworks;
+}
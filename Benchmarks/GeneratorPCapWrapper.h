@@ -0,0 +1,105 @@
+#pragma once
+
+/* Copyright (c) 2022 [Rick de Bondt] - GeneratorPCapWrapper.h
+ *
+ * This file contains a pcap wrapper that generates traffic instead of capturing it from an adapter.
+ *
+ **/
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <pcap/pcap.h>
+
+#include "IPCapWrapper.h"
+#include "IWifiInterface.h"
+#include "TrafficRecorder.h"
+
+/**
+ * Pcap wrapper that hands out frames from a generator thread as if they were captured, and records the frames the
+ * device sends instead of putting them on the air.
+ */
+class GeneratorPCapWrapper : public IPCapWrapper
+{
+public:
+    /**
+     * Creates the wrapper.
+     * @param aFromDevice - Recorder that creates the frames the device captures.
+     * @param aToDevice - Recorder for frames the device sends.
+     */
+    GeneratorPCapWrapper(TrafficRecorder& aFromDevice, TrafficRecorder& aToDevice);
+    ~GeneratorPCapWrapper();
+    GeneratorPCapWrapper(const GeneratorPCapWrapper& aGeneratorPCapWrapper) = delete;
+    GeneratorPCapWrapper& operator=(const GeneratorPCapWrapper& aGeneratorPCapWrapper) = delete;
+
+    /**
+     * Starts the generator thread.
+     * @param aTraffic - Traffic to generate.
+     */
+    void StartTraffic(const TrafficRecorder_Constants::Traffic& aTraffic);
+
+    /**
+     * Waits for the generator thread to finish.
+     */
+    void StopTraffic();
+
+    int            Activate() override;
+    void           BreakLoop() override;
+    void           Close() override;
+    pcap_t*        Create(const char* source, char* errbuf) override;
+    int            Dispatch(int cnt, pcap_handler callback, unsigned char* user) override;
+    void           Dump(unsigned char* user, pcap_pkthdr* header, unsigned char* message) override;
+    void           DumpClose(pcap_dumper_t* dumper) override;
+    pcap_dumper_t* DumpOpen(const char* outputfile) override;
+    int            FindAllDevices(pcap_if_t** alldevicesp, char* errbuf) override;
+    void           FreeAllDevices(pcap_if_t* devices) override;
+    int            GetDatalink() override;
+    char*          GetError() override;
+    bool           IsActivated() override;
+    pcap_t*        OpenDead(int linktype, int snaplen) override;
+    pcap_t*        OpenOffline(const char* fname, char* errbuf) override;
+    int            NextEx(pcap_pkthdr** header, const unsigned char** pkt_data) override;
+    int            SendPacket(std::string_view buffer) override;
+    int            SetDirection(PcapDirection::Direction direction) override;
+    int            SetImmediateMode(int mode) override;
+    int            SetPromiscuousMode(int promiscuous) override;
+    int            SetSnapLen(int snaplen) override;
+    int            SetTimeOut(int timeout) override;
+    bool           WaitsForPackets() override;
+
+private:
+    std::atomic<bool>            mActivated{false};
+    std::string                  mError{};
+    TrafficRecorder&             mFromDevice;
+    std::vector<std::string>     mQueue{};
+    std::mutex                   mQueueMutex{};
+    std::shared_ptr<std::thread> mGeneratorThread{nullptr};
+    std::atomic<bool>            mStopCommand{false};
+    TrafficRecorder&             mToDevice;
+};
+
+/**
+ * Wifi interface that is always connected and never finds any networks.
+ */
+class LoopbackWifiInterface : public IWifiInterface
+{
+public:
+    /**
+     * Creates the interface.
+     * @param aAdapterMacAddress - Mac address the adapter reports.
+     */
+    explicit LoopbackWifiInterface(uint64_t aAdapterMacAddress);
+
+    bool                          Connect(const WifiInformation& aConnection) override;
+    bool                          LeaveIBSS() override;
+    uint64_t                      GetAdapterMacAddress() override;
+    std::vector<WifiInformation>& GetAdhocNetworks() override;
+
+private:
+    uint64_t                     mAdapterMacAddress{0};
+    std::vector<WifiInformation> mNetworks{};
+};
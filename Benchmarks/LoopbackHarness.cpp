@@ -0,0 +1,95 @@
+/* Copyright (c) 2022 [Rick de Bondt] - LoopbackHarness.cpp */
+
+#include "LoopbackHarness.h"
+
+#include <thread>
+
+#include "FakeXLinkKai.h"
+#include "GeneratorPCapWrapper.h"
+#include "Logger.h"
+#include "WirelessPromiscuousDevice.h"
+#include "XLinkKaiConnection.h"
+
+using namespace LoopbackHarness_Constants;
+using namespace std::chrono;
+
+bool LoopbackHarness::Run(const TrafficMix& aMix, Results& aResults)
+{
+    bool lReturn{false};
+
+    if (aMix.PacketsPerSecond == 0) {
+        Logger::GetInstance().Log("Can't run a traffic mix without traffic", Logger::Level::ERROR);
+        return lReturn;
+    }
+
+    TrafficRecorder lToXLinkKai{};
+    TrafficRecorder lToDevice{};
+    FakeXLinkKai    lXLinkKai{lToXLinkKai, lToDevice};
+
+    if (lXLinkKai.Open()) {
+        auto lWrapper{std::make_shared<GeneratorPCapWrapper>(lToXLinkKai, lToDevice)};
+        auto lDevice{std::make_shared<WirelessPromiscuousDevice>(
+            false, seconds(0), nullptr, std::make_shared<Handler8023>(), lWrapper)};
+        auto lConnection{std::make_shared<XLinkKaiConnection>()};
+
+        lConnection->SetIncomingConnection(lDevice);
+        lDevice->SetConnector(lConnection);
+
+        std::vector<std::string> lSSIDFilter{};
+        if (lConnection->Open("127.0.0.1", lXLinkKai.GetPort()) &&
+            lDevice->Open("loopback", lSSIDFilter, std::make_shared<LoopbackWifiInterface>(cAdapterMac)) &&
+            lDevice->StartReceiverThread() && lConnection->StartReceiverThread()) {
+            time_point<steady_clock> lDeadline{steady_clock::now() + cConnectTimeout};
+            while (!lXLinkKai.IsConnected() && steady_clock::now() < lDeadline) {
+                std::this_thread::sleep_for(1ms);
+            }
+
+            if (lXLinkKai.IsConnected()) {
+                // Let the connection send its settings before the measurement starts
+                std::this_thread::sleep_for(cSettleTime);
+
+                TrafficRecorder_Constants::Traffic lTraffic{};
+                lTraffic.FrameSize           = aMix.FrameSize;
+                lTraffic.PacketsPerSecond    = aMix.PacketsPerSecond;
+                lTraffic.BroadcastPercentage = aMix.BroadcastPercentage;
+                lTraffic.Duration            = aMix.Duration;
+
+                lTraffic.DestinationMac = cRemoteMac;
+                lTraffic.SourceMac      = cHandheldMac;
+                lWrapper->StartTraffic(lTraffic);
+
+                lTraffic.DestinationMac = cHandheldMac;
+                lTraffic.SourceMac      = cRemoteMac;
+                lXLinkKai.StartTraffic(lTraffic);
+
+                time_point<steady_clock> lStart{steady_clock::now()};
+                lWrapper->StopTraffic();
+                while (!lXLinkKai.IsTrafficDone()) {
+                    std::this_thread::sleep_for(1ms);
+                }
+
+                // Give the last frames some time to come out on the other side
+                std::this_thread::sleep_for(cDrainTime);
+
+                nanoseconds lDuration{duration_cast<nanoseconds>(aMix.Duration)};
+                aResults.ToXLinkKai = lToXLinkKai.GetResults(lDuration);
+                aResults.ToDevice   = lToDevice.GetResults(lDuration);
+                lReturn             = true;
+
+                milliseconds lRunTime{duration_cast<milliseconds>(steady_clock::now() - lStart)};
+                Logger::GetInstance().Log("Loopback run took " + std::to_string(lRunTime.count()) + "ms",
+                                          Logger::Level::DEBUG);
+            } else {
+                Logger::GetInstance().Log("XLinkKaiConnection did not connect to the fake engine",
+                                          Logger::Level::ERROR);
+            }
+        }
+
+        lConnection->Close();
+        lDevice->Close();
+    }
+
+    lXLinkKai.Close();
+
+    return lReturn;
+}
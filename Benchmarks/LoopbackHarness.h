@@ -0,0 +1,60 @@
+#pragma once
+
+/* Copyright (c) 2022 [Rick de Bondt] - LoopbackHarness.h
+ *
+ * This file contains a harness that pumps traffic through the complete bridge on a single machine.
+ *
+ **/
+
+#include <chrono>
+
+#include "TrafficRecorder.h"
+
+namespace LoopbackHarness_Constants
+{
+    static constexpr std::chrono::seconds      cConnectTimeout{5};
+    static constexpr std::chrono::milliseconds cSettleTime{100};
+    static constexpr std::chrono::milliseconds cDrainTime{250};
+
+    // Mac address of the handheld behind the device, the remote handheld behind XLink Kai and the wifi adapter
+    static constexpr uint64_t cHandheldMac{0x050403020100};
+    static constexpr uint64_t cRemoteMac{0x0F0E0D0C0B0A};
+    static constexpr uint64_t cAdapterMac{0x010000000002};
+
+    /**
+     * Traffic mix to send in both directions at the same time.
+     */
+    struct TrafficMix
+    {
+        std::size_t               FrameSize{TrafficRecorder_Constants::cMinimumFrameSize};
+        unsigned int              PacketsPerSecond{1000}; /**< Per direction */
+        unsigned int              BroadcastPercentage{0};
+        std::chrono::milliseconds Duration{1000};
+    };
+
+    /**
+     * Results for both directions.
+     */
+    struct Results
+    {
+        TrafficRecorder_Constants::DirectionResults ToXLinkKai{}; /**< Captured by the device, sent to XLink Kai */
+        TrafficRecorder_Constants::DirectionResults ToDevice{};   /**< Received from XLink Kai, sent by the device */
+    };
+}  // namespace LoopbackHarness_Constants
+
+/**
+ * Connects an unmodified XLinkKaiConnection and WirelessPromiscuousDevice to each other, with a fake XLink Kai engine
+ * on a localhost UDP socket on one side and a generating pcap wrapper on the other side. Then sends numbered,
+ * timestamped frames through the bridge in both directions to measure throughput, loss and latency.
+ */
+class LoopbackHarness
+{
+public:
+    /**
+     * Runs a traffic mix through a freshly set up bridge.
+     * @param aMix - Traffic to send.
+     * @param aResults - Filled with the results of the run.
+     * @return true if the bridge could be set up and connected.
+     */
+    bool Run(const LoopbackHarness_Constants::TrafficMix& aMix, LoopbackHarness_Constants::Results& aResults);
+};
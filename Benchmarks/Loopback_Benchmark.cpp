@@ -0,0 +1,66 @@
+/* Copyright (c) 2022 [Rick de Bondt] - Loopback_Benchmark.cpp
+ * This file contains end-to-end benchmarks of the complete bridge, using the loopback harness.
+ **/
+
+#include <string>
+
+#include <benchmark/benchmark.h>
+
+#include "LoopbackHarness.h"
+
+using namespace LoopbackHarness_Constants;
+
+namespace
+{
+    /**
+     * Adds the results of one direction as counters to a benchmark.
+     * @param aState - State of the benchmark to report to.
+     * @param aPrefix - Prefix for the counter names.
+     * @param aResults - Results to report.
+     */
+    void ReportDirection(benchmark::State&                                  aState,
+                         const std::string&                                 aPrefix,
+                         const TrafficRecorder_Constants::DirectionResults& aResults)
+    {
+        auto lMicroseconds = [](std::chrono::nanoseconds aDuration) {
+            return std::chrono::duration<double, std::micro>(aDuration).count();
+        };
+
+        aState.counters[aPrefix + "pps"]    = aResults.PacketsPerSecond;
+        aState.counters[aPrefix + "loss%"]  = aResults.LossPercentage;
+        aState.counters[aPrefix + "p50_us"] = lMicroseconds(aResults.P50);
+        aState.counters[aPrefix + "p90_us"] = lMicroseconds(aResults.P90);
+        aState.counters[aPrefix + "p99_us"] = lMicroseconds(aResults.P99);
+        aState.counters[aPrefix + "max_us"] = lMicroseconds(aResults.Max);
+    }
+}  // namespace
+
+// Arguments are the frame size, packets per second per direction and the percentage of broadcast frames
+static void LoopbackBridge(benchmark::State& aState)
+{
+    TrafficMix lMix{};
+    lMix.FrameSize           = static_cast<std::size_t>(aState.range(0));
+    lMix.PacketsPerSecond    = static_cast<unsigned int>(aState.range(1));
+    lMix.BroadcastPercentage = static_cast<unsigned int>(aState.range(2));
+
+    LoopbackHarness lHarness{};
+    Results         lResults{};
+
+    for (auto lState : aState) {
+        if (!lHarness.Run(lMix, lResults)) {
+            aState.SkipWithError("Could not set up the loopback bridge");
+            break;
+        }
+    }
+
+    ReportDirection(aState, "kai_", lResults.ToXLinkKai);
+    ReportDirection(aState, "dev_", lResults.ToDevice);
+}
+BENCHMARK(LoopbackBridge)
+    ->ArgNames({"size", "pps", "bcast%"})
+    ->Args({64, 1000, 0})
+    ->Args({512, 5000, 20})
+    ->Args({1400, 20000, 5})
+    ->Iterations(1)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
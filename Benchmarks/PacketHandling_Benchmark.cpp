@@ -0,0 +1,225 @@
+/* Copyright (c) 2022 [Rick de Bondt] - PacketHandling_Benchmark.cpp
+ * This file contains benchmarks for the packet handlers and the readers they use.
+ **/
+
+#include <benchmark/benchmark.h>
+
+#include "BenchmarkHelpers.h"
+#include "Handler80211.h"
+#include "Handler8023.h"
+#include "HandlerPSPPlugin.h"
+#include "MacBlackList.h"
+#include "NetConversionFunctions.h"
+
+using namespace BenchmarkHelpers_Constants;
+
+namespace
+{
+    /**
+     * Locks a monitor mode handler on to the network in the monitor capture.
+     * @param aHandler - The handler, which cannot be copied as its blacklist is shared between threads.
+     * @param aPackets - Packets of the monitor capture.
+     */
+    void LockHandler80211(Handler80211& aHandler, const std::vector<std::string>& aPackets)
+    {
+        std::vector<std::string> lSSIDFilter{std::string(cMonitorSSIDFilter)};
+        aHandler.SetSSIDFilterList(lSSIDFilter);
+
+        for (const auto& lPacket : aPackets) {
+            aHandler.Update(lPacket);
+        }
+    }
+
+    /**
+     * Gets the beacon frames out of a monitor capture.
+     * @param aPackets - Packets of the monitor capture.
+     * @return List with only the beacon frames.
+     */
+    std::vector<std::string> GetBeacons(const std::vector<std::string>& aPackets)
+    {
+        std::vector<std::string> lReturn{};
+        RadioTapReader           lReader{};
+
+        for (const auto& lPacket : aPackets) {
+            lReader.FillRadioTapParameters(lPacket);
+            if (lPacket.size() > lReader.GetLength() &&
+                GetRawData<uint8_t>(lPacket, lReader.GetLength()) == Net_80211_Constants::cBeaconType) {
+                lReturn.emplace_back(lPacket);
+            }
+        }
+
+        return lReturn;
+    }
+}  // namespace
+
+static void Handler80211Update(benchmark::State& aState)
+{
+    std::vector<std::string> lPackets{LoadPackets(cMonitorCapture, aState)};
+    Handler80211             lHandler{PhysicalDeviceHeaderType::RadioTap};
+    std::size_t              lIndex{0};
+    LockHandler80211(lHandler, lPackets);
+
+    uint64_t lAllocations{GetAllocationCount()};
+    for (auto lState : aState) {
+        lHandler.Update(lPackets[lIndex]);
+        benchmark::DoNotOptimize(lHandler.ShouldSend());
+        lIndex = (lIndex + 1) % lPackets.size();
+    }
+    ReportPerPacket(aState, lAllocations);
+}
+BENCHMARK(Handler80211Update);
+
+// ConvertPacketOut works on the last packet given to Update, so these benchmarks measure both
+static void Handler80211ConvertPacketOut(benchmark::State& aState)
+{
+    std::vector<std::string> lPackets{LoadPackets(cMonitorCapture, aState)};
+    Handler80211             lHandler{PhysicalDeviceHeaderType::RadioTap};
+    std::vector<std::string> lDataPackets{};
+    LockHandler80211(lHandler, lPackets);
+
+    for (const auto& lPacket : lPackets) {
+        lHandler.Update(lPacket);
+        if (lHandler.ShouldSend()) {
+            lDataPackets.emplace_back(lPacket);
+        }
+    }
+
+    if (lDataPackets.empty()) {
+        aState.SkipWithError("No data packets in capture");
+        return;
+    }
+
+    std::size_t lIndex{0};
+    uint64_t    lAllocations{GetAllocationCount()};
+    for (auto lState : aState) {
+        lHandler.Update(lDataPackets[lIndex]);
+        benchmark::DoNotOptimize(lHandler.ConvertPacketOut());
+        lIndex = (lIndex + 1) % lDataPackets.size();
+    }
+    ReportPerPacket(aState, lAllocations);
+}
+BENCHMARK(Handler80211ConvertPacketOut);
+
+static void Handler8023ConvertPacketOut(benchmark::State& aState)
+{
+    std::vector<std::string>                 lPackets{LoadPackets(cXLinkCapture, aState)};
+    Handler8023                              lHandler{};
+    RadioTapReader::PhysicalDeviceParameters lParameters{};
+    std::size_t                              lIndex{0};
+
+    uint64_t lAllocations{GetAllocationCount()};
+    for (auto lState : aState) {
+        lHandler.Update(lPackets[lIndex]);
+        benchmark::DoNotOptimize(lHandler.ConvertPacketOut(Net_Constants::cBroadcastMac, lParameters));
+        lIndex = (lIndex + 1) % lPackets.size();
+    }
+    ReportPerPacket(aState, lAllocations);
+}
+BENCHMARK(Handler8023ConvertPacketOut);
+
+static void HandlerPSPPluginConvertPacketOut(benchmark::State& aState)
+{
+    std::vector<std::string> lPackets{LoadPackets(cPluginCapture, aState)};
+    HandlerPSPPlugin         lHandler{};
+    std::size_t              lIndex{0};
+
+    // Plugin packets carry the destination Mac at the end, anything shorter than that can't be converted
+    std::erase_if(lPackets, [](const std::string& aPacket) {
+        return aPacket.size() < Net_8023_Constants::cHeaderLength + Net_8023_Constants::cDestinationAddressLength;
+    });
+
+    if (lPackets.empty()) {
+        aState.SkipWithError("No convertible packets in capture");
+        return;
+    }
+
+    uint64_t lAllocations{GetAllocationCount()};
+    for (auto lState : aState) {
+        lHandler.Update(lPackets[lIndex]);
+        benchmark::DoNotOptimize(lHandler.ConvertPacketOut());
+        lIndex = (lIndex + 1) % lPackets.size();
+    }
+    ReportPerPacket(aState, lAllocations);
+}
+BENCHMARK(HandlerPSPPluginConvertPacketOut);
+
+static void RadioTapReaderFillRadioTapParameters(benchmark::State& aState)
+{
+    std::vector<std::string> lPackets{LoadPackets(cMonitorCapture, aState)};
+    RadioTapReader           lReader{};
+    std::size_t              lIndex{0};
+
+    uint64_t lAllocations{GetAllocationCount()};
+    for (auto lState : aState) {
+        lReader.FillRadioTapParameters(lPackets[lIndex]);
+        benchmark::DoNotOptimize(lReader.GetLength());
+        lIndex = (lIndex + 1) % lPackets.size();
+    }
+    ReportPerPacket(aState, lAllocations);
+}
+BENCHMARK(RadioTapReaderFillRadioTapParameters);
+
+static void Parameter80211ReaderUpdate(benchmark::State& aState)
+{
+    std::vector<std::string> lBeacons{GetBeacons(LoadPackets(cMonitorCapture, aState))};
+
+    if (lBeacons.empty()) {
+        aState.SkipWithError("No beacons in capture");
+        return;
+    }
+
+    // All beacons come from the same adapter, so the RadioTap header length is the same for all of them
+    auto lRadioTapReader{std::make_shared<RadioTapReader>()};
+    lRadioTapReader->FillRadioTapParameters(lBeacons.front());
+
+    Parameter80211Reader lReader{lRadioTapReader};
+    std::size_t          lIndex{0};
+
+    uint64_t lAllocations{GetAllocationCount()};
+    for (auto lState : aState) {
+        lReader.Update(lBeacons[lIndex]);
+        benchmark::DoNotOptimize(lReader.GetSSID());
+        lIndex = (lIndex + 1) % lBeacons.size();
+    }
+    ReportPerPacket(aState, lAllocations);
+}
+BENCHMARK(Parameter80211ReaderUpdate);
+
+static void ConstructAcknowledgementFrameBenchmark(benchmark::State& aState)
+{
+    RadioTapReader::PhysicalDeviceParameters lParameters{};
+    uint64_t                                 lReceiverMac{MacToInt("01:23:45:67:AB:CD")};
+
+    uint64_t lAllocations{GetAllocationCount()};
+    for (auto lState : aState) {
+        benchmark::DoNotOptimize(ConstructAcknowledgementFrame(lReceiverMac, lParameters));
+    }
+    ReportPerPacket(aState, lAllocations);
+}
+BENCHMARK(ConstructAcknowledgementFrameBenchmark);
+
+// Looks up every source Mac of the promiscuous capture in a blacklist of the given size
+static void MacBlackListIsMacAllowed(benchmark::State& aState)
+{
+    std::vector<std::string> lPackets{LoadPackets(cPromiscuousCapture, aState)};
+    MacBlackList             lBlackList{};
+    std::vector<uint64_t>    lSourceMacs{};
+    std::size_t              lIndex{0};
+
+    for (int64_t lCount = 0; lCount < aState.range(0); lCount++) {
+        lBlackList.AddToMacBlackList(static_cast<uint64_t>(0x0000FFEEDDCCBBAA + lCount));
+    }
+
+    for (const auto& lPacket : lPackets) {
+        lSourceMacs.emplace_back(GetRawData<uint64_t>(lPacket, Net_8023_Constants::cSourceAddressIndex) &
+                                 Net_Constants::cBroadcastMac);
+    }
+
+    uint64_t lAllocations{GetAllocationCount()};
+    for (auto lState : aState) {
+        benchmark::DoNotOptimize(lBlackList.IsMacAllowed(lSourceMacs[lIndex]));
+        lIndex = (lIndex + 1) % lSourceMacs.size();
+    }
+    ReportPerPacket(aState, lAllocations);
+}
+BENCHMARK(MacBlackListIsMacAllowed)->Arg(1)->Arg(16)->Arg(256);
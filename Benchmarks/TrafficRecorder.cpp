@@ -0,0 +1,85 @@
+/* Copyright (c) 2022 [Rick de Bondt] - TrafficRecorder.cpp */
+
+#include "TrafficRecorder.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "NetConversionFunctions.h"
+
+using namespace std::chrono;
+using namespace TrafficRecorder_Constants;
+
+std::string TrafficRecorder::CreateFrame(uint64_t aDestinationMac, uint64_t aSourceMac, std::size_t aFrameSize)
+{
+    std::string lReturn(std::max(aFrameSize, cMinimumFrameSize), '\0');
+
+    uint64_t lSequence{mSent++};
+    int64_t  lTimeStamp{duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count()};
+
+    memcpy(lReturn.data() + Net_8023_Constants::cDestinationAddressIndex,
+           &aDestinationMac,
+           Net_8023_Constants::cDestinationAddressLength);
+    memcpy(lReturn.data() + Net_8023_Constants::cSourceAddressIndex,
+           &aSourceMac,
+           Net_8023_Constants::cSourceAddressLength);
+    memcpy(lReturn.data() + Net_8023_Constants::cEtherTypeIndex, &cEtherType, sizeof(cEtherType));
+    memcpy(lReturn.data() + cMagicIndex, &cMagic, sizeof(cMagic));
+    memcpy(lReturn.data() + cSequenceIndex, &lSequence, sizeof(lSequence));
+    memcpy(lReturn.data() + cTimeStampIndex, &lTimeStamp, sizeof(lTimeStamp));
+
+    return lReturn;
+}
+
+bool TrafficRecorder::Record(std::string_view aFrame)
+{
+    bool lReturn{false};
+
+    if (aFrame.size() >= cMinimumFrameSize && GetRawData<uint32_t>(aFrame, cMagicIndex) == cMagic) {
+        nanoseconds lLatency{duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()) -
+                             nanoseconds(GetRawData<int64_t>(aFrame, cTimeStampIndex))};
+
+        std::scoped_lock lLock{mMutex};
+        // Duplicates count as received once, their latency is not interesting either
+        if (mReceived.insert(GetRawData<uint64_t>(aFrame, cSequenceIndex)).second) {
+            mLatencies.emplace_back(lLatency);
+        }
+        lReturn = true;
+    }
+
+    return lReturn;
+}
+
+DirectionResults TrafficRecorder::GetResults(nanoseconds aDuration)
+{
+    DirectionResults lReturn{};
+    std::scoped_lock lLock{mMutex};
+
+    lReturn.Sent     = mSent;
+    lReturn.Received = mReceived.size();
+
+    if (aDuration.count() > 0) {
+        lReturn.PacketsPerSecond = static_cast<double>(lReturn.Received) / duration<double>(aDuration).count();
+    }
+
+    if (lReturn.Sent > 0) {
+        lReturn.LossPercentage =
+            100.0 * static_cast<double>(lReturn.Sent - std::min(lReturn.Sent, lReturn.Received)) /
+            static_cast<double>(lReturn.Sent);
+    }
+
+    if (!mLatencies.empty()) {
+        std::sort(mLatencies.begin(), mLatencies.end());
+
+        auto lPercentile = [&](std::size_t aPercentile) {
+            return mLatencies.at(std::min(mLatencies.size() - 1, mLatencies.size() * aPercentile / 100));
+        };
+
+        lReturn.P50 = lPercentile(50);
+        lReturn.P90 = lPercentile(90);
+        lReturn.P99 = lPercentile(99);
+        lReturn.Max = mLatencies.back();
+    }
+
+    return lReturn;
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+/* Copyright (c) 2022 [Rick de Bondt] - TrafficRecorder.h
+ *
+ * This file contains a recorder for generated traffic, used to measure loss and latency through the bridge.
+ *
+ **/
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+#include "NetworkingHeaders.h"
+
+namespace TrafficRecorder_Constants
+{
+    // Marks frames generated by the recorder, "XLHB" in memory
+    static constexpr uint32_t    cMagic{0x42484C58};
+    static constexpr std::size_t cMagicIndex{Net_8023_Constants::cDataIndex};
+    static constexpr std::size_t cSequenceIndex{cMagicIndex + sizeof(uint32_t)};
+    static constexpr std::size_t cTimeStampIndex{cSequenceIndex + sizeof(uint64_t)};
+    static constexpr std::size_t cMinimumFrameSize{cTimeStampIndex + sizeof(int64_t)};
+    static constexpr uint16_t    cEtherType{0xC888};  // 0x88C8 in network order, the EtherType the PSP uses
+
+    /**
+     * Traffic to generate towards the bridge, from either side.
+     */
+    struct Traffic
+    {
+        uint64_t                  DestinationMac{0};
+        uint64_t                  SourceMac{0};
+        std::size_t               FrameSize{cMinimumFrameSize};
+        unsigned int              PacketsPerSecond{1000};
+        unsigned int              BroadcastPercentage{0}; /**< Percentage of frames sent to the broadcast address */
+        std::chrono::milliseconds Duration{1000};
+    };
+
+    /**
+     * Results for one direction of traffic.
+     */
+    struct DirectionResults
+    {
+        uint64_t                 Sent{0};
+        uint64_t                 Received{0};
+        double                   PacketsPerSecond{0}; /**< Received packets per second */
+        double                   LossPercentage{0};
+        std::chrono::nanoseconds P50{0};
+        std::chrono::nanoseconds P90{0};
+        std::chrono::nanoseconds P99{0};
+        std::chrono::nanoseconds Max{0};
+    };
+}  // namespace TrafficRecorder_Constants
+
+/**
+ * Creates numbered, timestamped ethernet frames for one direction of traffic and records them when they come out on
+ * the other side of the bridge.
+ */
+class TrafficRecorder
+{
+public:
+    /**
+     * Creates a new frame, stamped with the next sequence number and the current time.
+     * @param aDestinationMac - Destination Mac address of the frame.
+     * @param aSourceMac - Source Mac address of the frame.
+     * @param aFrameSize - Size of the complete frame, at least cMinimumFrameSize.
+     * @return The frame.
+     */
+    std::string CreateFrame(uint64_t aDestinationMac, uint64_t aSourceMac, std::size_t aFrameSize);
+
+    /**
+     * Records a frame that came out of the bridge.
+     * @param aFrame - The frame.
+     * @return true if the frame was created by this recorder.
+     */
+    bool Record(std::string_view aFrame);
+
+    /**
+     * Gets the results of the recorded traffic.
+     * @param aDuration - Time the traffic was generated for, used to calculate the packets per second.
+     * @return The results.
+     */
+    TrafficRecorder_Constants::DirectionResults GetResults(std::chrono::nanoseconds aDuration);
+
+private:
+    std::vector<std::chrono::nanoseconds> mLatencies{};
+    std::mutex                            mMutex{};
+    std::unordered_set<uint64_t>          mReceived{};
+    std::atomic<uint64_t>                 mSent{0};
+};
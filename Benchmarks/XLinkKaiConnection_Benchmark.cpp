@@ -0,0 +1,181 @@
+/* Copyright (c) 2022 [Rick de Bondt] - XLinkKaiConnection_Benchmark.cpp
+ * This file contains benchmarks for the XLinkKaiConnection class.
+ **/
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+#include <benchmark/benchmark.h>
+
+#include "BenchmarkHelpers.h"
+#include "IPCapDevice.h"
+#include "IUDPSocketWrapper.h"
+#include "PCapReplayer.h"
+#include "XLinkKaiConnection.h"
+
+using namespace BenchmarkHelpers_Constants;
+using namespace XLinkKai_Constants;
+
+namespace
+{
+    /**
+     * Socket that hands out prepared messages in a loop instead of touching the network. Mocks are not used here,
+     * because their bookkeeping would end up in the measurements.
+     */
+    class ReplaySocketWrapper : public IUDPSocketWrapper
+    {
+    public:
+        void SetMessages(std::vector<std::string> aMessages)
+        {
+            mMessages = std::move(aMessages);
+            mIndex    = 0;
+        }
+
+        void        Close() override {}
+        bool        Open(std::string_view /*aIp*/, unsigned int /*aPort*/) override { return true; }
+        bool        SetOptions(const UDPSocketWrapper_Constants::SocketOptions& /*aOptions*/) override { return true; }
+        bool        IsOpen() override { return true; }
+        std::size_t SendTo(std::string_view aData) override { return aData.size(); }
+
+        std::size_t ReceiveFrom(char* aDataBuffer, size_t aDataBufferSize) override
+        {
+            const std::string& lMessage{mMessages[mIndex]};
+            mIndex = (mIndex + 1) % mMessages.size();
+
+            std::size_t lSize{std::min(lMessage.size(), aDataBufferSize)};
+            memcpy(aDataBuffer, lMessage.data(), lSize);
+            return lSize;
+        }
+
+        void AsyncReceiveFrom(IUDPReceiveHandler& /*aHandler*/) override {}
+        void StartThread() override {}
+        void StopThread() override {}
+        bool IsThreadStopped() override { return true; }
+        void PollThread() override {}
+
+    private:
+        std::vector<std::string> mMessages{};
+        std::size_t              mIndex{0};
+    };
+
+    /**
+     * Device that drops everything it is asked to send.
+     */
+    class NullDevice : public IPCapDevice
+    {
+    public:
+        void        BlackList(uint64_t /*aMac*/) override {}
+        void        RemoveFromBlackList(uint64_t /*aMac*/) override {}
+        void        Close() override {}
+        bool        Connect(std::string_view /*aESSID*/) override { return true; }
+        bool        Open(std::string_view /*aName*/, std::vector<std::string>& /*aSSIDFilter*/) override
+        {
+            return true;
+        }
+        std::string DataToString(const unsigned char* /*aData*/, const pcap_pkthdr* /*aHeader*/) override
+        {
+            return {};
+        }
+        const unsigned char* GetData() override { return nullptr; }
+        const pcap_pkthdr*   GetHeader() override { return nullptr; }
+        std::string          GetESSID() override { return {}; }
+        IPCapDevice_Constants::DeviceStatistics GetStatistics() const override { return {}; }
+        std::string                             GetTitleId() override { return {}; }
+        bool                                    Send(std::string_view aData) override
+        {
+            benchmark::DoNotOptimize(aData.data());
+            return true;
+        }
+        void SetConnector(std::shared_ptr<IConnector> /*aDevice*/) override {}
+        void SetReceiverThreadAffinity(int /*aCPU*/) override {}
+        void ShowPacketStatistics(const pcap_pkthdr* /*aHeader*/) const override {}
+        bool StartReceiverThread() override { return true; }
+        bool ReadCallback(const unsigned char* /*aData*/, const pcap_pkthdr* /*aHeader*/) override { return true; }
+    };
+}  // namespace
+
+// Feeds the ethernet frames XLink Kai sent in the promiscuous capture through HandleDatagram, to the given amount of
+// devices sharing the connection
+static void XLinkKaiConnectionReceiveCallback(benchmark::State& aState)
+{
+    std::vector<std::string> lMessages{};
+    for (const auto& lPacket : LoadPackets(cXLinkCapture, aState)) {
+        lMessages.emplace_back(cEthernetDataString + lPacket);
+    }
+
+    if (lMessages.empty()) {
+        return;
+    }
+
+    // Connect first, after that only ethernet frames are handed out
+    auto               lSocketWrapper{std::make_shared<ReplaySocketWrapper>()};
+    XLinkKaiConnection lConnection{lSocketWrapper};
+    lConnection.Open("127.0.0.1", cPort);
+
+    for (int64_t lCount = 0; lCount < aState.range(0); lCount++) {
+        lConnection.AddIncomingConnection(std::make_shared<NullDevice>());
+    }
+
+    lSocketWrapper->SetMessages({cConnectedString + ";XLHA;"});
+    lConnection.ReadNextData();
+    lSocketWrapper->SetMessages(lMessages);
+
+    uint64_t lAllocations{GetAllocationCount()};
+    for (auto lState : aState) {
+        lConnection.ReadNextData();
+    }
+    ReportPerPacket(aState, lAllocations);
+
+    lConnection.Close();
+}
+BENCHMARK(XLinkKaiConnectionReceiveCallback)->Arg(1)->Arg(4);
+
+// Replays the promiscuous capture into a connection from the given amount of streams at once, as if that many devices
+// share the connection. Every iteration replays the whole capture once per stream.
+static void XLinkKaiConnectionReplayStreams(benchmark::State& aState)
+{
+    auto lSocketWrapper{std::make_shared<ReplaySocketWrapper>()};
+    auto lConnection{std::make_shared<XLinkKaiConnection>(lSocketWrapper)};
+    lConnection->Open("127.0.0.1", cPort);
+
+    // Ethernet data is only sent once XLink Kai confirmed the connection
+    lSocketWrapper->SetMessages({cConnectedString + ";XLHA;"});
+    lConnection->ReadNextData();
+
+    PCapReplayer lReplayer{};
+    if (!lReplayer.Open(cPromiscuousCapture)) {
+        aState.SkipWithError(("Could not load any packets from " + std::string(cPromiscuousCapture)).c_str());
+        return;
+    }
+    lReplayer.SetConnector(lConnection);
+
+    PCapReplayer_Constants::ReplaySettings lSettings{};
+    lSettings.SpeedMultiplier = PCapReplayer_Constants::cMaxSpeed;
+    lSettings.Streams         = static_cast<unsigned int>(aState.range(0));
+
+    uint64_t                 lPackets{0};
+    std::chrono::nanoseconds lMaxLatency{0};
+    for (auto lState : aState) {
+        if (!lReplayer.Start(lSettings)) {
+            aState.SkipWithError("Could not start the replay");
+            break;
+        }
+
+        while (!lReplayer.IsDone()) {
+            std::this_thread::yield();
+        }
+        lReplayer.Stop();
+
+        PCapReplayer_Constants::ReplayStatistics lStatistics{lReplayer.GetStatistics()};
+        lPackets += lStatistics.Packets;
+        lMaxLatency = std::max(lMaxLatency, lStatistics.MaxLatency);
+    }
+
+    aState.SetItemsProcessed(static_cast<int64_t>(lPackets));
+    aState.counters["max_latency_us"] = std::chrono::duration<double, std::micro>(lMaxLatency).count();
+
+    lConnection->Close();
+}
+BENCHMARK(XLinkKaiConnectionReplayStreams)->ArgName("streams")->Arg(1)->Arg(8)->Arg(64)->UseRealTime();
@@ -0,0 +1,107 @@
+#pragma once
+
+/* Copyright (c) 2022 [Rick de Bondt] - ArpProxy.h
+ *
+ * This file contains an ARP proxy, answering ARP requests for hosts on the other side of XLink Kai.
+ *
+ **/
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace ArpProxy_Constants
+{
+    // Bindings that have not been confirmed for this long are forgotten
+    static constexpr std::chrono::seconds cAgingTime{60};
+
+    // Upper bound on the amount of bindings, when full the one not confirmed for the longest is forgotten first
+    static constexpr std::size_t cMaxEntries{256};
+
+    // Parts of an ARP packet for IPv4 over ethernet, as indices in the ethernet frame
+    static constexpr uint16_t cHardwareTypeIndex{14};
+    static constexpr uint16_t cProtocolTypeIndex{16};
+    static constexpr uint16_t cHardwareSizeIndex{18};
+    static constexpr uint16_t cProtocolSizeIndex{19};
+    static constexpr uint16_t cSenderIpIndex{28};
+    static constexpr uint16_t cTargetIpIndex{38};
+    static constexpr uint16_t cPacketLength{42};
+
+    // As read from the packet, so in network byte order
+    static constexpr uint16_t cHardwareTypeEthernet{0x0100};
+    static constexpr uint16_t cProtocolTypeIPv4{0x0008};
+    static constexpr uint8_t  cIPv4Length{4};
+}  // namespace ArpProxy_Constants
+
+/**
+ * Learns which IPv4 address belongs to which Mac address from the ARP packets going either way, and answers ARP
+ * requests for hosts on the other side of XLink Kai itself. This saves a trip through XLink Kai, and the internet,
+ * when a game sets up a connection over IP. Thread-safe.
+ */
+class ArpProxy
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    enum class Side
+    {
+        Local,  /**< Reached over the air */
+        Remote, /**< Reached through XLink Kai */
+    };
+
+    /**
+     * Sets which requests to answer, by default none are.
+     * @param aAnswerLocal - Whether to answer requests from the air for hosts behind XLink Kai.
+     * @param aAnswerRemote - Whether to answer requests from XLink Kai for hosts on the air.
+     */
+    void SetEnabled(bool aAnswerLocal, bool aAnswerRemote);
+
+    /**
+     * Learns from an ethernet frame and answers it if it is an ARP request the proxy knows the answer to.
+     * @param aData - The ethernet frame.
+     * @param aSide - Side the frame came from.
+     * @param aNow - Time the frame arrived.
+     * @return The ARP reply to send back to aSide instead of passing the request on, std::nullopt if the frame should
+     * be passed on as usual.
+     */
+    std::optional<std::string> Handle(std::string_view aData, Side aSide, Clock::time_point aNow = Clock::now());
+
+    /**
+     * Gets the amount of requests answered by the proxy.
+     * @return The amount of requests.
+     */
+    [[nodiscard]] uint64_t GetAnswered() const;
+
+private:
+    struct Binding
+    {
+        uint64_t          mMac{0};
+        Side              mSide{Side::Local};
+        Clock::time_point mLastSeen{};
+    };
+
+    /**
+     * Learns the sender of an ARP packet, has to be called with mMutex held.
+     * @param aIp - IPv4 address of the sender.
+     * @param aMac - Mac address of the sender.
+     * @param aSide - Side the packet came from.
+     * @param aNow - Time the packet arrived.
+     * @return false if the address is known on the other side, so the packet looped around.
+     */
+    bool Learn(uint32_t aIp, uint64_t aMac, Side aSide, Clock::time_point aNow);
+
+    /**
+     * Forgets the binding that has not been confirmed for the longest, has to be called with mMutex held.
+     */
+    void EvictOldest();
+
+    mutable std::mutex                    mMutex{};
+    bool                                  mAnswerLocal{false};
+    bool                                  mAnswerRemote{false};
+    uint64_t                              mAnswered{0};
+    std::unordered_map<uint32_t, Binding> mBindings{};
+};
@@ -0,0 +1,115 @@
+#pragma once
+
+/* Copyright (c) 2022 [Rick de Bondt] - BroadcastGovernor.h
+ *
+ * This file contains a filter that keeps broadcasts from the devices from flooding XLink Kai.
+ *
+ **/
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
+
+namespace BroadcastGovernor_Constants
+{
+    // The same broadcast sent again within this window is not forwarded
+    static constexpr std::chrono::milliseconds cRepeatWindow{100};
+
+    // Repeats and rates are only remembered for this long after the last broadcast of a source
+    static constexpr std::chrono::seconds cForgetTime{10};
+
+    /**
+     * Counters of a broadcast governor.
+     */
+    struct Statistics
+    {
+        uint64_t Forwarded{0};
+        uint64_t Repeats{0};     /**< Broadcasts suppressed because they were sent just before */
+        uint64_t RateLimited{0}; /**< Broadcasts suppressed because their source sent too many */
+    };
+}  // namespace BroadcastGovernor_Constants
+
+/**
+ * Decides which broadcasts from the devices are forwarded to XLink Kai. Lobby discovery of games sends the same
+ * broadcast over and over, and XLink Kai sends every one of them to every remote player. Identical broadcasts from the
+ * same source within a short window are suppressed, and every source can be limited to a number of broadcasts per
+ * second. Data to a single Mac address is always forwarded. Thread-safe.
+ */
+class BroadcastGovernor
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * Constructs a governor.
+     * @param aRepeatWindow - How long identical broadcasts are suppressed, 0 to forward all of them.
+     * @param aRateLimit - Broadcasts per second a single source may send, 0 for no limit.
+     */
+    explicit BroadcastGovernor(Clock::duration aRepeatWindow = BroadcastGovernor_Constants::cRepeatWindow,
+                               unsigned int    aRateLimit    = 0);
+
+    /**
+     * Changes the limits, broadcasts seen so far are still remembered.
+     * @param aRepeatWindow - How long identical broadcasts are suppressed, 0 to forward all of them.
+     * @param aRateLimit - Broadcasts per second a single source may send, 0 for no limit.
+     */
+    void SetLimits(Clock::duration aRepeatWindow, unsigned int aRateLimit);
+
+    /**
+     * Checks if ethernet data should be forwarded.
+     * @param aData - The ethernet data.
+     * @param aNow - Time the data arrived.
+     * @return true if it should be forwarded.
+     */
+    bool Allow(std::string_view aData, Clock::time_point aNow = Clock::now());
+
+    /**
+     * Gets the counters of the governor.
+     * @return The counters.
+     */
+    [[nodiscard]] BroadcastGovernor_Constants::Statistics GetStatistics() const;
+
+private:
+    /**
+     * What makes broadcasts the same.
+     */
+    struct Key
+    {
+        uint64_t    mSourceMac{0};
+        uint16_t    mEtherType{0};
+        std::size_t mPayloadHash{0};
+
+        bool operator==(const Key& aKey) const = default;
+    };
+
+    struct KeyHash
+    {
+        std::size_t operator()(const Key& aKey) const;
+    };
+
+    /**
+     * Token bucket of a single source, one token per broadcast.
+     */
+    struct Bucket
+    {
+        double            mTokens{0};
+        Clock::time_point mLastRefill{};
+    };
+
+    /**
+     * Forgets about broadcasts and sources that have been quiet for a while, has to be called with mMutex held.
+     * @param aNow - Current time.
+     */
+    void Sweep(Clock::time_point aNow);
+
+    mutable std::mutex                                  mMutex{};
+    Clock::duration                                     mRepeatWindow{};
+    unsigned int                                        mRateLimit{0};
+    Clock::time_point                                   mNextSweep{};
+    std::unordered_map<Key, Clock::time_point, KeyHash> mLastForwarded{};
+    std::unordered_map<uint64_t, Bucket>                mBuckets{};
+    BroadcastGovernor_Constants::Statistics             mStatistics{};
+};
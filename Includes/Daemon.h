@@ -0,0 +1,178 @@
+#pragma once
+
+/* Copyright (c) 2022 [Rick de Bondt] - Daemon.h
+ *
+ * This file contains the headless mode of the program, controlled through a local control socket.
+ *
+ **/
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/asio.hpp>
+
+#include "Engine.h"
+#include "WindowModel.h"
+
+namespace Daemon_Constants
+{
+    static constexpr std::string_view cDefaultSocketName{"xlinkhandheldassistant.sock"};
+
+    // Lines longer than this are not a command, the connection gets closed
+    static constexpr std::size_t cMaxCommandLength{256};
+
+    // Time between attempts when XLink Kai could not be reached
+    static constexpr std::chrono::seconds cRetryTime{10};
+
+    // Time before accepting control connections again after accepting one failed
+    static constexpr std::chrono::milliseconds cAcceptRetryTime{100};
+
+    // Commands on the control socket, one per line
+    static constexpr std::string_view cCommandStart{"start"};
+    static constexpr std::string_view cCommandStop{"stop"};
+    static constexpr std::string_view cCommandReConnect{"reconnect"};
+    static constexpr std::string_view cCommandHosting{"hosting"};
+    static constexpr std::string_view cCommandStats{"stats"};
+    static constexpr std::string_view cCommandStatus{"status"};
+    static constexpr std::string_view cArgumentOn{"on"};
+    static constexpr std::string_view cArgumentOff{"off"};
+
+    // Every reply ends with one of these
+    static constexpr std::string_view cReplyOk{"ok"};
+    static constexpr std::string_view cReplyError{"error: "};
+
+    enum class Command
+    {
+        Start = 0,
+        Stop,
+        ReConnect,
+        Hosting,
+        Stats,
+        Status
+    };
+
+    /**
+     * A parsed line from the control socket.
+     */
+    struct Request
+    {
+        Command Type{Command::Status};
+        bool    Hosting{false}; /**< Only used by the Hosting command */
+    };
+}  // namespace Daemon_Constants
+
+/**
+ * Runs the engine without user interface. Commands come in through a local control socket and are handled on the
+ * thread calling Run, which sleeps on a condition variable until there is something to do.
+ */
+class Daemon
+{
+public:
+    /**
+     * Creates the daemon.
+     * @param aModel - The model with the settings to start the engine with.
+     */
+    explicit Daemon(WindowModel& aModel);
+    ~Daemon();
+    Daemon(const Daemon& aDaemon) = delete;
+    Daemon& operator=(const Daemon& aDaemon) = delete;
+
+    /**
+     * Opens the control socket and starts the thread that serves it.
+     * @param aPath - Path of the socket file, an existing file is replaced.
+     * @return true if successful.
+     */
+    bool Open(std::string_view aPath);
+
+    /**
+     * Starts the engine and handles commands until Stop is called, then stops the engine again.
+     */
+    void Run();
+
+    /**
+     * Makes Run return, can be called from any thread.
+     */
+    void Stop();
+
+    /**
+     * Parses a line from the control socket.
+     * @param aLine - The line without the newline.
+     * @return The request, empty if the line is not a valid command.
+     */
+    static std::optional<Daemon_Constants::Request> ParseRequest(std::string_view aLine);
+
+private:
+    class Session;
+
+    /**
+     * A request waiting to be handled by Run, together with how to reply to it.
+     */
+    struct PendingRequest
+    {
+        Daemon_Constants::Request         mRequest{};
+        std::function<void(std::string)> mReply{nullptr};
+    };
+
+    /**
+     * Accepts the next connection on the control socket.
+     */
+    void Accept();
+
+    /**
+     * Queues a request for Run, can be called from any thread.
+     * @param aRequest - The request to queue.
+     */
+    void Post(PendingRequest aRequest);
+
+    /**
+     * Handles a request, only called from Run.
+     * @param aRequest - The request to handle.
+     */
+    void Handle(PendingRequest& aRequest);
+
+    /**
+     * Handles the result of a start of the engine, only called from Run.
+     * @param aResult - The result of the start.
+     */
+    void HandleStartResult(Engine_Constants::StartResult aResult);
+
+    /**
+     * Replies to every start command waiting for the engine to start.
+     * @param aReply - The reply to send.
+     */
+    void ReplyToStart(const std::string& aReply);
+
+    /**
+     * Creates the reply to a stats command.
+     * @return The statistics and readiness of the engine, one line per adapter or component.
+     */
+    std::string CreateStatistics() const;
+
+    WindowModel& mModel;
+    Engine       mEngine;
+
+    std::condition_variable    mCondition{};
+    std::mutex                 mMutex{};
+    std::deque<PendingRequest> mRequests{};
+    bool                       mStopCommand{false};
+
+    // Replies to start commands are sent once the engine is done starting
+    std::vector<std::function<void(std::string)>>        mStartReplies{};
+    std::optional<std::chrono::steady_clock::time_point> mRetryTime{};
+
+    boost::asio::io_service mIoService{};
+    std::thread             mIoThread{};
+    std::string             mSocketPath{};
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+    std::unique_ptr<boost::asio::local::stream_protocol::acceptor> mAcceptor{nullptr};
+    boost::asio::steady_timer                                      mAcceptRetryTimer{mIoService};
+#endif
+};
@@ -0,0 +1,229 @@
+#pragma once
+
+/* Copyright (c) 2022 [Rick de Bondt] - Engine.h
+ *
+ * This file contains the engine that bridges one or more wifi adapters to XLink Kai.
+ *
+ **/
+
+#include <atomic>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "IPCapDevice.h"
+#include "IPCapWrapper.h"
+#include "WindowModel.h"
+#include "XLinkKaiConnection.h"
+
+namespace Engine_Constants
+{
+    enum class StartResult
+    {
+        Success = 0,      /**< All adapters are running */
+        ConnectorFailed,  /**< Could not open a connection to XLink Kai */
+        DeviceFailed,     /**< Could not open an adapter or start its threads */
+        UnknownMethod,    /**< The connection method is not supported */
+        Cancelled         /**< Stop was called before everything was started */
+    };
+
+    enum class Readiness
+    {
+        Pending = 0, /**< Still being brought up */
+        Ready,       /**< Up and running */
+        Failed       /**< Could not be brought up */
+    };
+
+    /**
+     * Readiness of a single component of the engine, either an adapter or a connection to XLink Kai.
+     */
+    struct ComponentReadiness
+    {
+        std::string Name{};
+        Readiness   State{Readiness::Pending};
+    };
+
+    /**
+     * Statistics of a single adapter, used for a per-adapter breakdown.
+     */
+    struct AdapterStatistics
+    {
+        std::string                             Name{};
+        std::string                             ConnectedNetwork{};
+        IPCapDevice_Constants::DeviceStatistics Device{};
+        XLinkKai_Constants::LinkStatistics      Link{}; /**< Of the connection the adapter uses, can be shared */
+    };
+}  // namespace Engine_Constants
+
+/**
+ * Class that bridges one or more wifi adapters to XLink Kai, every adapter has its own device and packet handler.
+ * Adapters either have their own connection to XLink Kai or share the connection of the first adapter.
+ */
+class Engine
+{
+public:
+    /**
+     * Creates the engine.
+     * @param aModel - The model to read the settings from and to report the connected network to.
+     */
+    explicit Engine(WindowModel& aModel);
+    ~Engine();
+    Engine(const Engine& aEngine) = delete;
+    Engine& operator=(const Engine& aEngine) = delete;
+
+    /**
+     * Creates the devices for all configured adapters if needed, opens them and starts their threads. The handshake
+     * with XLink Kai and the activation of every adapter run in parallel, this returns when all of them are done.
+     * @return Success if every adapter is running, otherwise what step failed.
+     */
+    Engine_Constants::StartResult Start();
+
+    /**
+     * Runs Start in the background, so the caller stays responsive. Does nothing if the engine is already starting.
+     */
+    void StartAsync();
+
+    /**
+     * Checks whether a start from StartAsync is still running or its result has not been picked up yet.
+     * @return true if starting.
+     */
+    [[nodiscard]] bool IsStarting() const;
+
+    /**
+     * Picks up the result of StartAsync when it is done.
+     * @return The result, empty while still starting or if the engine is not starting at all.
+     */
+    std::optional<Engine_Constants::StartResult> GetStartResult();
+
+    /**
+     * Gets the readiness of every adapter and connection to XLink Kai, can be called while the engine is starting.
+     * @return A list with the readiness per component.
+     */
+    std::vector<Engine_Constants::ComponentReadiness> GetReadiness() const;
+
+    /**
+     * Closes all adapters and their connections to XLink Kai and removes the devices. A start running in the
+     * background skips the steps it has not begun yet and is waited for.
+     */
+    void Stop();
+
+    /**
+     * Tells all adapters to connect to a (new) network.
+     */
+    void ReConnect();
+
+    /**
+     * Whether we are hosting a game or not.
+     * @param aHosting - Set to true if hosting.
+     */
+    void SetHosting(bool aHosting);
+
+    /**
+     * Gets the statistics of every adapter.
+     * @return A list with statistics per adapter, in the same order as the configured adapters.
+     */
+    std::vector<Engine_Constants::AdapterStatistics> GetStatistics() const;
+
+    /**
+     * Logs the statistics of every adapter.
+     */
+    void LogStatistics() const;
+
+private:
+    /**
+     * One wifi adapter with everything it needs to be bridged to XLink Kai.
+     */
+    struct Adapter
+    {
+        std::string                         mName{};
+        std::shared_ptr<IPCapDevice>        mDevice{nullptr};
+        std::shared_ptr<XLinkKaiConnection> mConnection{nullptr};
+        std::vector<std::string>            mSSIDFilter{}; /**< Own copy, the adapters are opened in parallel */
+
+        // Only used by additional adapters, the first adapter reports to the model
+        Property<std::string> mCurrentlyConnectedNetwork{};
+    };
+
+    /**
+     * Creates the pcap wrapper for a device, which uses AF_XDP or injects through io_uring if that is enabled in the
+     * model.
+     * @return The created wrapper.
+     */
+    std::shared_ptr<IPCapWrapper> CreatePCapWrapper() const;
+
+    /**
+     * Creates the socket wrapper for a connection to XLink Kai, which uses io_uring if that is enabled in the model.
+     * @return The created wrapper.
+     */
+    std::shared_ptr<IUDPSocketWrapper> CreateSocketWrapper() const;
+
+    /**
+     * Creates a device for the connection method set in the model.
+     * @param aCurrentlyConnectedNetwork - Property the device writes the connected network to.
+     * @return The created device, nullptr if the connection method is not supported.
+     */
+    std::shared_ptr<IPCapDevice> CreateDevice(Property<std::string>* aCurrentlyConnectedNetwork);
+
+    /**
+     * Creates an adapter for every configured wifi adapter if the adapters have not been created yet.
+     * @return true if successful.
+     */
+    bool CreateAdapters();
+
+    /**
+     * A component of the engine as tracked for GetReadiness.
+     */
+    struct Component
+    {
+        Engine_Constants::ComponentReadiness mReadiness{};
+        std::shared_ptr<XLinkKaiConnection>  mConnection{nullptr}; /**< Only set for connections to XLink Kai */
+    };
+
+    /**
+     * Gets every distinct XLink Kai connection, shared connections are only returned once.
+     * @return List of connections.
+     */
+    std::vector<std::shared_ptr<XLinkKaiConnection>> GetConnections() const;
+
+    /**
+     * Opens the XLink Kai connections and starts their receiver threads, which do the handshake with XLink Kai.
+     * Data from XLink Kai is not delivered to the adapters until all adapters are running.
+     * @return Success if every connection is opened.
+     */
+    Engine_Constants::StartResult StartConnections();
+
+    /**
+     * Opens all adapters and starts their receiver threads, every adapter in its own thread.
+     * @return Success if every adapter is running.
+     */
+    Engine_Constants::StartResult StartAdapters();
+
+    /**
+     * Opens a single adapter and starts its receiver thread.
+     * @param aAdapter - Adapter to start.
+     * @return true if successful.
+     */
+    bool StartAdapter(Adapter& aAdapter);
+
+    /**
+     * Sets the readiness of a component, adding it if it is not known yet.
+     * @param aName - Name of the component.
+     * @param aState - The new readiness.
+     * @param aConnection - The connection if the component is a connection to XLink Kai.
+     */
+    void SetReadiness(std::string_view                    aName,
+                      Engine_Constants::Readiness         aState,
+                      std::shared_ptr<XLinkKaiConnection> aConnection = nullptr);
+
+    WindowModel&                               mModel;
+    std::vector<std::shared_ptr<Adapter>>      mAdapters{};
+    std::vector<Component>                     mComponents{};
+    mutable std::mutex                         mComponentsMutex{};
+    WindowModel_Constants::ConnectionMethod    mConnectionMethod{WindowModel_Constants::cDefaultConnectionMethod};
+    std::vector<std::string>                   mSSIDFilters{};
+    std::future<Engine_Constants::StartResult> mStartResult{};
+    std::atomic<bool>                          mStopRequested{false};
+};
@@ -0,0 +1,165 @@
+#pragma once
+
+/* Copyright (c) 2022 [Rick de Bondt] - FlightRecorder.h
+ *
+ * This file contains a flight recorder, remembering the latest frames so they can be saved when something goes wrong.
+ *
+ **/
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+namespace FlightRecorder_Constants
+{
+    // Amount of frames remembered, has to be a power of two
+    static constexpr std::size_t cSlots{4096};
+
+    // Only the start of every frame is remembered, which holds all the headers
+    static constexpr std::size_t cSnapLength{128};
+
+    // Frames older than this are left out of a dump
+    static constexpr std::chrono::seconds cWindow{30};
+
+    // Anomalies tend to come in bursts, only the first one of a burst is dumped
+    static constexpr std::chrono::seconds cMinimumDumpInterval{10};
+
+    // Only the newest dumps are kept, older ones are removed when a new one is saved
+    static constexpr std::size_t cMaxDumps{10};
+
+    static constexpr std::string_view cFilePrefix{"flightrecorder-"};
+    static constexpr std::string_view cFileExtension{".pcapng"};
+
+    // pcapng, see https://www.ietf.org/archive/id/draft-ietf-opsawg-pcapng-00.html
+    static constexpr uint32_t cSectionHeaderBlock{0x0A0D0D0A};
+    static constexpr uint32_t cInterfaceDescriptionBlock{0x00000001};
+    static constexpr uint32_t cEnhancedPacketBlock{0x00000006};
+    static constexpr uint32_t cByteOrderMagic{0x1A2B3C4D};
+    static constexpr uint16_t cOptionEnd{0};
+    static constexpr uint16_t cOptionComment{1};
+    static constexpr uint16_t cOptionInterfaceName{2};
+    static constexpr uint16_t cOptionTimestampResolution{9};
+    static constexpr uint16_t cOptionFlags{2};
+    static constexpr uint8_t  cNanosecondResolution{9};
+    static constexpr uint16_t cLinkTypeEthernet{1};
+    static constexpr uint16_t cLinkTypeRadioTap{127};
+}  // namespace FlightRecorder_Constants
+
+/**
+ * Remembers the start of the latest frames going either way, so a capture of what led up to a problem can be saved
+ * without running at TRACE level. Recording does not take a lock and copies at most a cache line or two, so it can
+ * stay on all the time. When the ring is full the oldest frames are overwritten.
+ */
+class FlightRecorder
+{
+public:
+    using Clock = std::chrono::system_clock;
+
+    /**
+     * Where a frame was seen, every interface gets its own interface in the dump.
+     */
+    enum class Interface : uint8_t
+    {
+        Air,         /**< Ethernet frames on the wireless adapter */
+        AirRadioTap, /**< 802.11 frames with a RadioTap header on an adapter in monitor mode */
+        XLinkKai,    /**< Ethernet frames to and from XLink Kai */
+        Count
+    };
+
+    enum class Direction : uint8_t
+    {
+        Inbound,
+        Outbound
+    };
+
+    FlightRecorder()                                                 = default;
+    FlightRecorder(const FlightRecorder& aFlightRecorder)            = delete;
+    FlightRecorder& operator=(const FlightRecorder& aFlightRecorder) = delete;
+
+    /**
+     * Gets the FlightRecorder shared by the whole program.
+     * @return The FlightRecorder object.
+     */
+    static FlightRecorder& GetInstance()
+    {
+        static FlightRecorder lInstance;
+        return lInstance;
+    }
+
+    /**
+     * Remembers a frame, can be called from any thread.
+     * @param aInterface - Where the frame was seen.
+     * @param aDirection - Whether the frame was received or sent.
+     * @param aData - The frame, only the first cSnapLength bytes are kept.
+     */
+    void Record(Interface aInterface, Direction aDirection, std::string_view aData);
+
+    /**
+     * Saves the remembered frames to a pcapng file in the dump directory, unless a dump was saved shortly before or
+     * no dump directory has been set. Removes the oldest dumps so at most cMaxDumps are left.
+     * @param aReason - What went wrong, saved as a comment in the file.
+     * @return true if a file was saved.
+     */
+    bool Dump(std::string_view aReason);
+
+    /**
+     * Writes the frames of the last cWindow as pcapng, oldest first.
+     * @param aStream - Stream to write to.
+     * @param aReason - Comment to add to the section.
+     * @param aNow - Time to count the window back from.
+     * @return true if the stream was written successfully.
+     */
+    bool Write(std::ostream& aStream, std::string_view aReason, Clock::time_point aNow = Clock::now()) const;
+
+    /**
+     * Sets the directory dumps are saved in, nothing is saved until this is called.
+     * @param aDirectory - The directory.
+     */
+    void SetDumpDirectory(std::string_view aDirectory);
+
+private:
+    /**
+     * Removes the oldest dumps in the dump directory until at most cMaxDumps are left, has to be called with
+     * mDumpMutex held.
+     */
+    void RemoveOldDumps() const;
+
+    static constexpr std::size_t cWords{FlightRecorder_Constants::cSnapLength / sizeof(uint64_t)};
+
+    /**
+     * A single remembered frame. Protected by a sequence number that is odd while the slot is being written, so a
+     * reader can tell it got a torn copy. Everything is atomic so reading while a slot is written is well defined.
+     */
+    struct Slot
+    {
+        std::atomic<uint64_t>                     mSequence{0};
+        std::atomic<int64_t>                      mTimestamp{0};
+        std::atomic<uint64_t>                     mInfo{0}; /**< Length, interface and direction */
+        std::array<std::atomic<uint64_t>, cWords> mData{};
+    };
+
+    /**
+     * A copy of a slot taken by a reader.
+     */
+    struct Frame
+    {
+        uint64_t                     mSequence{0};
+        int64_t                      mTimestamp{0};
+        uint32_t                     mLength{0};
+        Interface                    mInterface{Interface::Air};
+        Direction                    mDirection{Direction::Inbound};
+        std::array<uint64_t, cWords> mData{};
+    };
+
+    std::array<Slot, FlightRecorder_Constants::cSlots> mSlots{};
+    std::atomic<uint64_t>                              mHead{0};
+    std::atomic<int64_t>                               mLastDump{0};
+    mutable std::mutex                                 mDumpMutex{};
+    std::optional<std::string>                         mDumpDirectory{};
+};
@@ -0,0 +1,133 @@
+#pragma once
+
+/* Copyright (c) 2022 [Rick de Bondt] - ForwardingDatabase.h
+ *
+ * This file contains the table of Mac addresses a bridge uses to decide where to forward data.
+ *
+ **/
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+
+class IPCapDevice;
+
+namespace ForwardingDatabase_Constants
+{
+    // Mac addresses that have not sent anything for this long are forgotten, the default of IEEE 802.1D
+    static constexpr std::chrono::seconds cAgingTime{300};
+
+    // Upper bound on the amount of Mac addresses, when full the one silent for the longest is forgotten first
+    static constexpr std::size_t cMaxEntries{1024};
+}  // namespace ForwardingDatabase_Constants
+
+/**
+ * Forwarding database of a bridge between the local radio and XLink Kai. Learns on which side every Mac address lives
+ * from the source of the data passing through, and forgets Mac addresses once they have been silent for a while.
+ * Group addresses are never learned. Thread-safe.
+ */
+class ForwardingDatabase
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    enum class Side
+    {
+        Local,  /**< Reached over the air, through one of the devices */
+        Remote, /**< Reached through XLink Kai */
+    };
+
+    /**
+     * What is known about a single Mac address.
+     */
+    struct Entry
+    {
+        Side              mSide{Side::Local};
+        IPCapDevice*      mDevice{nullptr}; /**< Device a local Mac address was seen on, nullptr for remote ones */
+        Clock::time_point mLastSeen{};
+        uint64_t          mPackets{0};
+        uint64_t          mBytes{0};
+    };
+
+    /**
+     * Called when a Mac address is learned or forgotten, with the database locked, so it may not call back into it.
+     * @param aMac - The Mac address.
+     * @param aSide - Side the Mac address lives on.
+     * @param aKnown - true when the Mac address was learned, false when it was forgotten.
+     */
+    using ChangeHandler = std::function<void(uint64_t aMac, Side aSide, bool aKnown)>;
+
+    /**
+     * Constructs an empty forwarding database.
+     * @param aAgingTime - How long a Mac address can stay silent before it is forgotten.
+     */
+    explicit ForwardingDatabase(Clock::duration aAgingTime = ForwardingDatabase_Constants::cAgingTime);
+
+    /**
+     * Learns a Mac address from data it sent.
+     * @param aMac - Source Mac address of the data.
+     * @param aSide - Side the data came from.
+     * @param aDevice - Device the data came from, nullptr for data from XLink Kai.
+     * @param aBytes - Size of the data.
+     * @param aNow - Time the data arrived.
+     * @return false if the Mac address is known on the other side, which means the data looped around and should be
+     * dropped. The entry is left as it is in that case.
+     */
+    bool Learn(
+        uint64_t aMac, Side aSide, IPCapDevice* aDevice, std::size_t aBytes, Clock::time_point aNow = Clock::now());
+
+    /**
+     * Looks up a Mac address.
+     * @param aMac - Mac address to look up.
+     * @param aNow - Current time, Mac addresses that have aged are not returned.
+     * @return A copy of the entry, std::nullopt if the Mac address is not known.
+     */
+    [[nodiscard]] std::optional<Entry> Find(uint64_t aMac, Clock::time_point aNow = Clock::now()) const;
+
+    /**
+     * Forgets all Mac addresses.
+     */
+    void Clear();
+
+    /**
+     * Sets the function that gets told about Mac addresses being learned and forgotten, so filters elsewhere can be
+     * kept in line with the database.
+     * @param aHandler - The function, nullptr to stop being told.
+     */
+    void SetChangeHandler(ChangeHandler aHandler);
+
+    /**
+     * Gets the amount of Mac addresses in the database, including ones that have aged but were not swept out yet.
+     * @return The amount of Mac addresses.
+     */
+    [[nodiscard]] std::size_t GetSize() const;
+
+private:
+    /**
+     * Forgets all Mac addresses that have aged, has to be called with mMutex held.
+     * @param aNow - Current time.
+     */
+    void Sweep(Clock::time_point aNow);
+
+    /**
+     * Forgets the Mac address that has been silent for the longest, has to be called with mMutex held.
+     */
+    void EvictOldest();
+
+    /**
+     * Tells the change handler about a change, has to be called with mMutex held.
+     * @param aMac - The Mac address that changed.
+     * @param aSide - Side the Mac address lives on.
+     * @param aKnown - true when the Mac address was learned, false when it was forgotten.
+     */
+    void NotifyChange(uint64_t aMac, Side aSide, bool aKnown) const;
+
+    Clock::duration                     mAgingTime{};
+    Clock::time_point                   mNextSweep{};
+    mutable std::mutex                  mMutex{};
+    std::unordered_map<uint64_t, Entry> mEntries{};
+    ChangeHandler                       mChangeHandler{nullptr};
+};
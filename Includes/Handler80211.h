@@ -6,14 +6,164 @@
  *
  **/
 
+#include <array>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "IHandler.h"
 #include "NetworkingHeaders.h"
 #include "Parameter80211Reader.h"
 #include "RadioTapReader.h"
+#include "SSIDMatcher.h"
+
+namespace Handler80211_Constants
+{
+    // Beacons of this many networks are remembered, after that the cache starts over
+    static constexpr std::size_t cMaxBeaconCacheSize{256};
+
+    /**
+     * Everything the first frame control byte tells about a frame.
+     */
+    struct FrameClassification
+    {
+        Main80211PacketType       MainType{Main80211PacketType::None};
+        Control80211PacketType    ControlType{Control80211PacketType::None};
+        Data80211PacketType       DataType{Data80211PacketType::None};
+        Management80211PacketType ManagementType{Management80211PacketType::None};
+        bool                      QoS{false};
+        uint8_t                   HeaderLength{0}; /**< 802.11 header length, without a fourth address */
+    };
+
+    /**
+     * Classifies a frame by its first frame control byte.
+     * Makes more sense if you read this: https://en.wikipedia.org/wiki/802.11_Frame_Types#Frame_Control
+     * @param aFrameControl - First frame control byte.
+     * @return The classification, the main type is None for extension frames.
+     */
+    constexpr FrameClassification ClassifyFrameControl(uint8_t aFrameControl)
+    {
+        FrameClassification lReturn{};
+        auto                lType{static_cast<uint8_t>((aFrameControl >> 2U) & 0b11U)};
+        auto                lSubType{static_cast<uint8_t>((aFrameControl >> 4U) & 0b1111U)};
+
+        switch (lType) {
+            case 0b00U:
+                lReturn.MainType     = Main80211PacketType::Management;
+                lReturn.HeaderLength = Net_80211_Constants::c80211DataHeaderLength;
+
+                switch (lSubType) {
+                    case 0b0000U:
+                        lReturn.ManagementType = Management80211PacketType::AssociationRequest;
+                        break;
+                    case 0b0001U:
+                        lReturn.ManagementType = Management80211PacketType::AssociationResponse;
+                        break;
+                    case 0b0010U:
+                        lReturn.ManagementType = Management80211PacketType::ReassociationRequest;
+                        break;
+                    case 0b0011U:
+                        lReturn.ManagementType = Management80211PacketType::ReassociationResponse;
+                        break;
+                    case 0b0100U:
+                        lReturn.ManagementType = Management80211PacketType::ProbeRequest;
+                        break;
+                    case 0b0101U:
+                        lReturn.ManagementType = Management80211PacketType::ProbeResponse;
+                        break;
+                    case 0b1000U:
+                        lReturn.ManagementType = Management80211PacketType::Beacon;
+                        break;
+                    case 0b1010U:
+                        lReturn.ManagementType = Management80211PacketType::Disassociation;
+                        break;
+                    case 0b1011U:
+                        lReturn.ManagementType = Management80211PacketType::Authentication;
+                        break;
+                    case 0b1100U:
+                        lReturn.ManagementType = Management80211PacketType::Deauthentication;
+                        break;
+                    case 0b1101U:
+                        lReturn.ManagementType = Management80211PacketType::Action;
+                        break;
+                    case 0b1110U:
+                        lReturn.ManagementType = Management80211PacketType::ActionNoAck;
+                        break;
+                    default:
+                        break;
+                }
+                break;
+            case 0b01U:
+                lReturn.MainType = Main80211PacketType::Control;
+
+                // CTS and ACK frames only have a receiver address
+                lReturn.HeaderLength = (lSubType == 0b1100U || lSubType == 0b1101U) ?
+                                           Net_80211_Constants::cControlShortHeaderLength :
+                                           Net_80211_Constants::cControlHeaderLength;
+
+                switch (lSubType) {
+                    case 0b1000U:
+                        lReturn.ControlType = Control80211PacketType::BlockAckRequest;
+                        break;
+                    case 0b1001U:
+                        lReturn.ControlType = Control80211PacketType::BlockAck;
+                        break;
+                    case 0b1101U:
+                        lReturn.ControlType = Control80211PacketType::ACK;
+                        break;
+                    default:
+                        break;
+                }
+                break;
+            case 0b10U:
+                lReturn.MainType     = Main80211PacketType::Data;
+                lReturn.QoS          = (lSubType & 0b1000U) != 0;
+                lReturn.HeaderLength = Net_80211_Constants::c80211DataHeaderLength +
+                                       (lReturn.QoS ? Net_80211_Constants::cDataQOSLength : 0);
+
+                switch (lSubType) {
+                    case 0b0000U:
+                        lReturn.DataType = Data80211PacketType::Data;
+                        break;
+                    case 0b0100U:
+                        lReturn.DataType = Data80211PacketType::Null;
+                        break;
+                    case 0b1000U:
+                        lReturn.DataType = Data80211PacketType::QoSData;
+                        break;
+                    case 0b1100U:
+                        lReturn.DataType = Data80211PacketType::QoSNull;
+                        break;
+                    default:
+                        break;
+                }
+                break;
+            default:
+                // Ignore extensions
+                break;
+        }
+
+        return lReturn;
+    }
+
+    /**
+     * Creates a table with the classification of every possible first frame control byte.
+     * @return The table, indexed by the first frame control byte.
+     */
+    constexpr std::array<FrameClassification, 256> CreateFrameClassificationTable()
+    {
+        std::array<FrameClassification, 256> lReturn{};
+        for (unsigned int lFrameControl = 0; lFrameControl < lReturn.size(); lFrameControl++) {
+            lReturn.at(lFrameControl) = ClassifyFrameControl(static_cast<uint8_t>(lFrameControl));
+        }
+
+        return lReturn;
+    }
+
+    // Built at compile time, so classifying a frame is a single lookup
+    static constexpr std::array<FrameClassification, 256> cFrameClassificationTable{CreateFrameClassificationTable()};
+}  // namespace Handler80211_Constants
 
 /**
  * This class reads packets from a monitor format and converts to a promiscuous format.
@@ -116,32 +266,65 @@ public:
     void SavePhysicalDeviceParameters(RadioTapReader::PhysicalDeviceParameters& aParameters);
 
     /**
-     * Sets the SSID to filter on.
+     * Sets the SSID to filter on, the filters are compiled once and swapped in atomically so this can be called while
+     * packets are being handled.
+     * @param aSSIDList - SSIDs to filter on, an empty list allows all SSIDs.
      */
-    void SetSSIDFilterList(std::vector<std::string>& aSSIDList);
+    void SetSSIDFilterList(const std::vector<std::string>& aSSIDList);
 
     void Update(std::string_view aPacket) override;
 
 private:
+    /**
+     * What is remembered about the last beacon of a network.
+     */
+    struct BeaconInformation
+    {
+        std::size_t                        mFingerprint{0};
+        std::string                        mSSID{};
+        bool                               mSSIDAllowed{false};
+        std::shared_ptr<const SSIDMatcher> mMatcher{nullptr}; /**< Matcher that made the verdict */
+    };
+
+    /**
+     * Classifies the beacon in the last received packet. Beacons are only parsed when their information elements
+     * differ from the last beacon of the same BSSID, otherwise the remembered SSID is used. The remembered filter
+     * verdict is used as long as the SSID filter did not change.
+     * @return Information about the beacon.
+     */
+    const BeaconInformation& ClassifyBeacon();
+
+    /**
+     * Gets a fingerprint of the information elements of the beacon in the last received packet, the fixed parameters
+     * and the frame check sequence are left out because they change with every beacon.
+     * @return The fingerprint.
+     */
+    [[nodiscard]] std::size_t GetBeaconFingerprint() const;
+
     void UpdateBSSID();
-    void UpdateControlPacketType();
-    void UpdateDataPacketType();
-    void UpdateMainPacketType();
-    void UpdateManagementPacketType();
+
+    /**
+     * Classifies the last received packet using both frame control bytes, the first one through
+     * cFrameClassificationTable and the flags of the second one.
+     */
+    void UpdateFrameControl();
+
     void UpdateAckable();
-    void UpdateRetry();
     void UpdateDestinationMac();
     void UpdateSourceMac();
 
     // Save last data in this class
     std::string mLastReceivedData{};
 
-    std::vector<std::string> mSSIDList{};
+    // Only accessed through std::atomic_load and std::atomic_store
+    std::shared_ptr<const SSIDMatcher> mSSIDMatcher{std::make_shared<const SSIDMatcher>()};
+
+    std::unordered_map<uint64_t, BeaconInformation> mBeaconCache{};
 
-    Main80211PacketType       mMainPacketType{Main80211PacketType::None};
-    Control80211PacketType    mControlPacketType{Control80211PacketType::None};
-    Data80211PacketType       mDataPacketType{Data80211PacketType::None};
-    Management80211PacketType mManagementPacketType{Management80211PacketType::None};
+    Handler80211_Constants::FrameClassification mFrameClassification{};
+    uint8_t                                     mHeaderLength{0}; /**< 802.11 header length, fourth address included */
+    bool                                        mFromDS{false};
+    bool                                        mToDS{false};
 
     bool         mAckable{false};
     MacBlackList mBlackList{};
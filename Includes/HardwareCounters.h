@@ -0,0 +1,111 @@
+#pragma once
+
+/* Copyright (c) 2022 [Rick de Bondt] - HardwareCounters.h
+ *
+ * This file contains per packet CPU counters, read from the performance monitoring unit of the processor.
+ *
+ **/
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace HardwareCounters_Constants
+{
+    /**
+     * The counters that are read, in the order they are stored in.
+     */
+    enum class Counter
+    {
+        Cycles = 0,
+        Instructions,
+        CacheMisses,
+        BranchMisses,
+        Count
+    };
+
+    static constexpr std::size_t cCounters{static_cast<std::size_t>(Counter::Count)};
+
+    /**
+     * Totals of the counters over all measured packets.
+     */
+    struct Statistics
+    {
+        uint64_t                        Packets{0};
+        std::array<uint64_t, cCounters> Totals{};
+
+        /**
+         * Gets the average of a counter for a single packet.
+         * @param aCounter - The counter.
+         * @return The average, 0 if nothing was measured.
+         */
+        [[nodiscard]] double GetPerPacket(Counter aCounter) const
+        {
+            return (Packets > 0) ? static_cast<double>(Totals.at(static_cast<std::size_t>(aCounter))) / Packets : 0;
+        }
+    };
+}  // namespace HardwareCounters_Constants
+
+/**
+ * Counts how many cycles, instructions, cache misses and branch misses handling a packet costs, using
+ * perf_event_open on Linux. Every thread opens its own counters the first time it measures something. This is an
+ * instrumentation mode, off by default, as reading the counters takes two system calls per packet. On other systems
+ * and when the counters cannot be opened nothing is measured.
+ */
+class HardwareCounters
+{
+public:
+    /**
+     * Turns measuring on or off for the whole program.
+     * @param aEnabled - true to measure.
+     */
+    static void SetEnabled(bool aEnabled);
+
+    /**
+     * Checks if measuring is turned on.
+     * @return true if measuring.
+     */
+    static bool IsEnabled();
+
+    /**
+     * Checks if the calling thread can read the counters, opening them if they were not opened yet.
+     * @return true if the counters are available.
+     */
+    static bool IsAvailable();
+
+    /**
+     * Measures the packet being handled on the calling thread, for as long as it exists.
+     */
+    class Measurement
+    {
+    public:
+        /**
+         * Starts measuring, if measuring is turned on.
+         * @param aCounters - Counters to add the measurement to.
+         */
+        explicit Measurement(HardwareCounters& aCounters);
+        ~Measurement();
+        Measurement(const Measurement& aMeasurement)            = delete;
+        Measurement& operator=(const Measurement& aMeasurement) = delete;
+
+    private:
+        HardwareCounters*                                           mCounters{nullptr};
+        std::array<uint64_t, HardwareCounters_Constants::cCounters> mStart{};
+    };
+
+    /**
+     * Gets the totals of all measured packets.
+     * @return The totals.
+     */
+    [[nodiscard]] HardwareCounters_Constants::Statistics GetStatistics() const;
+
+private:
+    /**
+     * Adds a measured packet.
+     * @param aValues - What the packet cost.
+     */
+    void Add(const std::array<uint64_t, HardwareCounters_Constants::cCounters>& aValues);
+
+    std::atomic<uint64_t>                                                    mPackets{0};
+    std::array<std::atomic<uint64_t>, HardwareCounters_Constants::cCounters> mTotals{};
+};
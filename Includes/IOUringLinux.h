@@ -0,0 +1,234 @@
+#pragma once
+
+/* Copyright (c) 2022 [Rick de Bondt] - IOUringLinux.h
+ *
+ * This file contains a minimal io_uring implementation, used to cut down on the amount of system calls per packet.
+ *
+ **/
+
+#if defined(ENABLE_IO_URING)
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+#include <linux/io_uring.h>
+#include <sys/uio.h>
+
+namespace IOUring_Constants
+{
+    // Amount of datagrams or frames that can be in flight on a sender
+    static constexpr unsigned int cSendSlots{64};
+
+    // Largest datagram or frame a sender can take, anything bigger is sent synchronously by the caller
+    static constexpr std::size_t cSendSlotLength{4096};
+
+    /**
+     * What happened to data handed to IOUringSender::Send.
+     */
+    enum class SendResult
+    {
+        Queued,    /**< On its way, the kernel sends it without the caller waiting */
+        NotQueued, /**< The sender cannot take it, the caller should send it itself */
+        Failed     /**< The kernel refused the data, or data sent before it failed to go out */
+    };
+}  // namespace IOUring_Constants
+
+/**
+ * A single io_uring instance, talks to the kernel directly so no library is needed. Not thread-safe, users have to
+ * lock around it themselves.
+ */
+class IOUring
+{
+public:
+    IOUring() = default;
+    ~IOUring();
+    IOUring(const IOUring& aIOUring) = delete;
+    IOUring& operator=(const IOUring& aIOUring) = delete;
+
+    /**
+     * Checks if the kernel supports io_uring together with the given operations.
+     * @param aOperations - The IORING_OP_ operations that have to be supported.
+     * @return true if supported.
+     */
+    static bool IsSupported(const std::vector<uint8_t>& aOperations);
+
+    /**
+     * Sets up the ring.
+     * @param aEntries - Amount of submission entries, the completion queue gets twice as many.
+     * @return true if successful.
+     */
+    bool Open(unsigned int aEntries);
+
+    /**
+     * Tears down the ring, this cancels everything that is still in flight.
+     */
+    void Close();
+
+    /**
+     * Checks if the ring is set up.
+     * @return true if open.
+     */
+    [[nodiscard]] bool IsOpen() const;
+
+    /**
+     * Gets the next free submission entry, cleared. It is not seen by the kernel until Publish is called.
+     * @return The entry, nullptr if the submission queue is full.
+     */
+    io_uring_sqe* GetSubmissionEntry();
+
+    /**
+     * Makes all submission entries gotten since the last call visible to the kernel.
+     * @return The amount of newly visible entries.
+     */
+    unsigned int Publish();
+
+    /**
+     * Tells the kernel to start working on published entries, safe to call without holding the lock of the user.
+     * @param aCount - The amount of entries to submit.
+     * @param aMinimumCompletions - Amount of completions to wait for, 0 to return right away.
+     * @return The amount of entries submitted, negative errno on failure.
+     */
+    int Enter(unsigned int aCount, unsigned int aMinimumCompletions = 0);
+
+    /**
+     * Calls aFunction for every completion that is ready and then hands the completions back to the kernel.
+     * @param aFunction - Function taking a const io_uring_cqe&.
+     * @return The amount of completions handled.
+     */
+    template<typename Function> unsigned int ForEachCompletion(Function&& aFunction)
+    {
+        unsigned int lHead{std::atomic_ref<uint32_t>(*mCompletionHead).load(std::memory_order_relaxed)};
+        unsigned int lTail{std::atomic_ref<uint32_t>(*mCompletionTail).load(std::memory_order_acquire)};
+        unsigned int lCount{0};
+
+        for (; lHead != lTail; lHead++, lCount++) {
+            aFunction(mCompletions[lHead & *mCompletionMask]);
+        }
+
+        std::atomic_ref<uint32_t>(*mCompletionHead).store(lHead, std::memory_order_release);
+        return lCount;
+    }
+
+    /**
+     * Registers buffers with the kernel, so they don't have to be mapped for every operation. Used with the _FIXED
+     * operations, the index in aBuffers is the buf_index.
+     * @param aBuffers - The buffers to register.
+     * @return true if successful.
+     */
+    bool RegisterBuffers(const std::vector<iovec>& aBuffers);
+
+    /**
+     * Registers a ring the kernel picks receive buffers from, for operations with IOSQE_BUFFER_SELECT.
+     * @param aGroup - Buffer group id to use in the submission entries.
+     * @param aEntries - Amount of buffers in the ring, a power of two.
+     * @return true if successful.
+     */
+    bool RegisterBufferRing(uint16_t aGroup, uint16_t aEntries);
+
+    /**
+     * Hands a buffer to the registered buffer ring, it is not seen by the kernel until CommitBuffers is called.
+     * @param aBuffer - The buffer.
+     * @param aLength - Length of the buffer.
+     * @param aId - Id to identify the buffer by in the completion.
+     */
+    void ProvideBuffer(char* aBuffer, unsigned int aLength, uint16_t aId);
+
+    /**
+     * Makes all buffers provided since the last call visible to the kernel.
+     */
+    void CommitBuffers();
+
+private:
+    int mFd{-1};
+
+    void*       mSubmissionRing{nullptr};
+    std::size_t mSubmissionRingSize{0};
+    void*       mCompletionRing{nullptr};
+    std::size_t mCompletionRingSize{0};
+
+    io_uring_sqe* mSubmissions{nullptr};
+    std::size_t   mSubmissionsSize{0};
+    uint32_t*     mSubmissionHead{nullptr};
+    uint32_t*     mSubmissionTail{nullptr};
+    uint32_t*     mSubmissionMask{nullptr};
+    uint32_t      mSubmissionEntries{0};
+    uint32_t      mLocalTail{0};    /**< Tail including entries that are not published yet */
+    uint32_t      mPublishedTail{0};
+
+    io_uring_cqe* mCompletions{nullptr};
+    uint32_t*     mCompletionHead{nullptr};
+    uint32_t*     mCompletionTail{nullptr};
+    uint32_t*     mCompletionMask{nullptr};
+
+    io_uring_buf_ring* mBufferRing{nullptr};
+    std::size_t        mBufferRingSize{0};
+    uint16_t           mBufferRingMask{0};
+    uint16_t           mBufferRingTail{0};
+};
+
+/**
+ * Sends data on a file descriptor through io_uring. Data is copied into preallocated slots that are registered with
+ * the kernel, sends from multiple threads that arrive while one of them is in the kernel are submitted together.
+ */
+class IOUringSender
+{
+public:
+    /**
+     * Sets up the ring and the slots for the given file descriptor, which has to be able to send with write, like a
+     * connected UDP socket or a bound packet socket.
+     * @param aFd - The file descriptor to send on.
+     * @return true if successful, false if the kernel does not support what is needed.
+     */
+    bool Open(int aFd);
+
+    /**
+     * Tears down the ring, does not close the file descriptor.
+     */
+    void Close();
+
+    /**
+     * Checks if the sender is set up.
+     * @return true if open.
+     */
+    [[nodiscard]] bool IsOpen() const;
+
+    /**
+     * Queues data to be sent, returns without waiting for the kernel to send it. When all slots are in flight this
+     * waits for one to come back, so data is never sent ahead of what was queued before it.
+     * @param aData - The data to send, copied before returning.
+     * @return Whether the data was queued, see IOUring_Constants::SendResult. Sends complete in the background, so
+     * Failed can also be about data queued by an earlier call.
+     */
+    IOUring_Constants::SendResult Send(std::string_view aData);
+
+private:
+    /**
+     * Frees the slots of sends that are done, has to be called with mMutex held.
+     */
+    void HandleCompletions();
+
+    /**
+     * Waits for at least one send in flight to complete, has to be called with mMutex held through aLock.
+     * @param aLock - Lock on mMutex, released while waiting.
+     * @return false if the kernel could not be waited on.
+     */
+    bool WaitForCompletion(std::unique_lock<std::mutex>& aLock);
+
+    using Slot = std::array<char, IOUring_Constants::cSendSlotLength>;
+
+    std::mutex            mMutex{};
+    IOUring               mRing{};
+    int                   mFd{-1};
+    bool                  mFixedBuffers{false};
+    bool                  mSubmitting{false};
+    unsigned int          mUnsubmitted{0};
+    std::vector<Slot>     mSlots{};
+    std::vector<uint16_t> mFreeSlots{};
+    uint64_t              mFailedSends{0};
+    bool                  mUnreportedFailure{false};
+};
+#endif
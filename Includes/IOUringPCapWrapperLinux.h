@@ -0,0 +1,45 @@
+#pragma once
+
+/* Copyright (c) 2022 [Rick de Bondt] - IOUringPCapWrapperLinux.h
+ *
+ * This file contains a pcap wrapper that injects packets through io_uring.
+ *
+ **/
+
+#if defined(ENABLE_IO_URING)
+#include <string>
+
+#include "IOUringLinux.h"
+#include "PCapWrapper.h"
+
+/**
+ * Pcap wrapper that sends packets through an IOUringSender instead of a send system call per packet, receiving is
+ * left to libpcap. Packets go out on a packet socket bound to the same adapter, the same way libpcap injects them.
+ * Falls back to pcap_sendpacket when the kernel does not support this.
+ */
+class IOUringPCapWrapper : public PCapWrapper
+{
+public:
+    int     Activate() override;
+    void    Close() override;
+    pcap_t* Create(const char* source, char* errbuf) override;
+    int     SendPacket(std::string_view buffer) override;
+
+    /**
+     * Checks if packets are sent through io_uring.
+     * @return true if io_uring is used, false if fallen back to libpcap.
+     */
+    [[nodiscard]] bool IsSendingThroughRing() const;
+
+private:
+    /**
+     * Opens a packet socket that only sends, bound to the adapter.
+     * @return true if successful.
+     */
+    bool OpenSendSocket();
+
+    std::string   mSource{};
+    int           mSendSocket{-1};
+    IOUringSender mSender{};
+};
+#endif
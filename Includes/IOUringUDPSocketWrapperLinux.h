@@ -0,0 +1,80 @@
+#pragma once
+
+/* Copyright (c) 2022 [Rick de Bondt] - IOUringUDPSocketWrapperLinux.h
+ *
+ * This file contains an UDP socket wrapper that does its I/O through io_uring.
+ *
+ **/
+
+#if defined(ENABLE_IO_URING)
+#include <vector>
+
+#include <sys/socket.h>
+
+#include "IOUringLinux.h"
+#include "UDPSocketWrapper.h"
+
+namespace IOUringUDPSocketWrapper_Constants
+{
+    // Amount of receive buffers the kernel can fill before they are handed back, a power of two
+    static constexpr uint16_t cReceiveBuffers{64};
+
+    // Every receive buffer starts with a header describing the datagram
+    static constexpr std::size_t cReceiveBufferLength{UDPSocketWrapper_Constants::cMaxDatagramLength +
+                                                      sizeof(io_uring_recvmsg_out)};
+
+    static constexpr uint16_t cBufferGroup{0};
+}  // namespace IOUringUDPSocketWrapper_Constants
+
+/**
+ * UDP socket wrapper that receives with a single multishot recvmsg, which keeps delivering datagrams into buffers
+ * registered with the kernel without rearming, and sends through an IOUringSender. Falls back to the plain
+ * UDPSocketWrapper when the kernel does not support this.
+ */
+class IOUringUDPSocketWrapper : public UDPSocketWrapper
+{
+public:
+    void        Close() override;
+    bool        Open(std::string_view aIp, unsigned int aPort) override;
+    std::size_t SendTo(std::string_view aData) override;
+    void        AsyncReceiveFrom(IUDPReceiveHandler& aHandler) override;
+    void        PollThread() override;
+
+    /**
+     * Checks if the receiving side uses io_uring.
+     * @return true if io_uring is used to receive, false if fallen back to the plain socket.
+     */
+    [[nodiscard]] bool IsReceivingThroughRing() const;
+
+    /**
+     * Checks if the sending side uses io_uring.
+     * @return true if io_uring is used to send, false if fallen back to the plain socket.
+     */
+    [[nodiscard]] bool IsSendingThroughRing() const;
+
+private:
+    /**
+     * Sets up the receive ring and its buffers.
+     * @return true if successful.
+     */
+    bool OpenReceiveRing();
+
+    /**
+     * Submits the multishot receive.
+     */
+    void ArmReceive();
+
+    /**
+     * Hands received datagrams to the handler and the buffers they were in back to the kernel.
+     */
+    void HandleCompletions();
+
+    IOUring             mReceiveRing{};
+    IOUringSender       mSender{};
+    std::vector<char>   mReceiveBuffers{};
+    msghdr              mMessage{};
+    IUDPReceiveHandler* mHandler{nullptr};
+    bool                mReceiveArmed{false};
+    bool                mReceivedAnything{false};
+};
+#endif
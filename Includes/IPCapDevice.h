@@ -10,6 +10,7 @@
 #include <string>
 #include <vector>
 
+#include "HardwareCounters.h"
 #include "NetworkingHeaders.h"
 
 namespace IPCapDevice_Constants
@@ -21,6 +22,21 @@ namespace IPCapDevice_Constants
         uint8_t     MaxRate{RadioTap_Constants::cRateFlags};
         uint16_t    Frequency{RadioTap_Constants::cChannel};
     };
+
+    /**
+     * Snapshot of the traffic counters of a device, used for per-adapter statistics.
+     */
+    struct DeviceStatistics
+    {
+        uint64_t PacketsReceived{0};
+        uint64_t BytesReceived{0};
+        uint64_t PacketsSent{0};
+        uint64_t BytesSent{0};
+        uint64_t SendErrors{0};
+
+        // Handling received packets, only counted while hardware counters are enabled
+        HardwareCounters_Constants::Statistics Cpu{};
+    };
 }  // namespace IPCapDevice_Constants
 
 class IConnector;
@@ -38,6 +54,12 @@ public:
      */
     virtual void BlackList(uint64_t aMac) = 0;
 
+    /**
+     * Removes a Mac address from the blacklist.
+     * @param aMac - Mac address to remove.
+     */
+    virtual void RemoveFromBlackList(uint64_t aMac) = 0;
+
     /**
      * Closes the PCAP device.
      */
@@ -83,6 +105,12 @@ public:
      */
     virtual std::string GetESSID() = 0;
 
+    /**
+     * Gets the traffic counters of this device.
+     * @return A snapshot of the statistics of this device.
+     */
+    virtual IPCapDevice_Constants::DeviceStatistics GetStatistics() const = 0;
+
     /**
      * Gets the title id of the game currently played if known.
      * @return The titleId of the game currently played.
@@ -102,6 +130,12 @@ public:
      */
     virtual void SetConnector(std::shared_ptr<IConnector> aDevice) = 0;
 
+    /**
+     * Pins the receiver thread of this device to a CPU, has to be set before StartReceiverThread is called.
+     * @param aCPU - Index of the CPU to run the receiver thread on, a negative number disables pinning.
+     */
+    virtual void SetReceiverThreadAffinity(int aCPU) = 0;
+
     /**
      * Prints some fancy statistics about a packet.
      * @param aHeader - Header of the packet to show statistics of.
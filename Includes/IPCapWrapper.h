@@ -57,4 +57,5 @@ public:
     virtual int            SetPromiscuousMode(int promiscuous)                                    = 0;
     virtual int            SetSnapLen(int snaplen)                                                = 0;
     virtual int            SetTimeOut(int timeout)                                                = 0;
+    virtual bool           WaitsForPackets()                                                      = 0;
 };
@@ -6,15 +6,39 @@
  *
  **/
 
-/**
- * Interface for UDP socket wrapper.
- */
-
-#include <array>
 #include <cstddef>
-#include <functional>
 #include <string_view>
 
+namespace UDPSocketWrapper_Constants
+{
+    /**
+     * Options for the UDP socket, a value of 0 keeps the default of the operating system.
+     */
+    struct SocketOptions
+    {
+        int ReceiveBufferSize{0}; /**< SO_RCVBUF in bytes */
+        int SendBufferSize{0};    /**< SO_SNDBUF in bytes */
+        int BusyPoll{0};          /**< SO_BUSY_POLL in microseconds, only supported on Linux */
+    };
+}  // namespace UDPSocketWrapper_Constants
+
+/**
+ * Interface for classes handling the datagrams received by an UDP socket wrapper.
+ */
+class IUDPReceiveHandler
+{
+public:
+    /**
+     * Handles a single datagram.
+     *
+     * @param aData - The datagram, only valid during the call.
+     */
+    virtual void HandleDatagram(std::string_view aData) = 0;
+};
+
+/**
+ * Interface for UDP socket wrapper.
+ */
 class IUDPSocketWrapper
 {
 public:
@@ -33,6 +57,14 @@ public:
      */
     virtual bool Open(std::string_view aIp, unsigned int aPort) = 0;
 
+    /**
+     * Sets the options of the UDP socket, applied immediately if the socket is open and otherwise when it is opened.
+     *
+     * @param aOptions - The options to use.
+     * @return true if all options could be applied.
+     */
+    virtual bool SetOptions(const UDPSocketWrapper_Constants::SocketOptions& aOptions) = 0;
+
     /**
      * Checks if the UDP socket is open.
      *
@@ -58,13 +90,13 @@ public:
     virtual std::size_t ReceiveFrom(char* aDataBuffer, size_t aDataBufferSize) = 0;
 
     /**
-     * Asynchronously receive data, function returns immediately, callback will be called when the data arrives.
+     * Asynchronously receive data, function returns immediately. When data arrives every datagram that is waiting on
+     * the socket is received in one go and handed to the handler, in the order they arrived. Does nothing while a
+     * receive is still pending, so this can be called every loop.
      *
-     * @param aDataBuffer - The databuffer to send the data to.
-     * @param aDataBufferSize  - The size of the buffer to send the data to.
-     * @param aCallBack - Callback to the function which will handle the callback.
+     * @param aHandler - Handler for the received datagrams, has to outlive the receive.
      */
-    virtual void AsyncReceiveFrom(char* aDataBuffer, size_t aDataBufferSize, std::function<void(size_t)> aCallBack) = 0;
+    virtual void AsyncReceiveFrom(IUDPReceiveHandler& aHandler) = 0;
 
     /**
      * Starts the thread for asynchronous data.
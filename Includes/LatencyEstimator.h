@@ -0,0 +1,68 @@
+#pragma once
+
+/* Copyright (c) 2022 [Rick de Bondt] - LatencyEstimator.h
+ *
+ * This file contains a smoothed estimate of a recurring duration, like a round trip time.
+ *
+ **/
+
+#include <chrono>
+
+namespace LatencyEstimator_Constants
+{
+    // Gains from RFC 6298, expressed as the divisor of the difference with the new sample
+    static constexpr int cSmoothingDivisor{8};
+    static constexpr int cVariationDivisor{4};
+
+    // Amount of variations on top of the smoothed value, before a duration is unexpectedly long
+    static constexpr int cVariationMultiplier{4};
+}  // namespace LatencyEstimator_Constants
+
+/**
+ * Keeps a smoothed value and mean deviation of measured durations, the same way TCP estimates its round trip time.
+ * Outliers move the estimate slowly, while the variation reacts quickly to jitter.
+ */
+class LatencyEstimator
+{
+public:
+    /**
+     * Adds a measurement to the estimate.
+     * @param aSample - The measured duration.
+     */
+    void AddSample(std::chrono::microseconds aSample);
+
+    /**
+     * Forgets all measurements.
+     */
+    void Reset();
+
+    /**
+     * Checks if any measurement has been added since the last reset.
+     * @return true if there are measurements.
+     */
+    [[nodiscard]] bool HasSamples() const;
+
+    /**
+     * Gets the smoothed duration.
+     * @return The smoothed duration, 0 without measurements.
+     */
+    [[nodiscard]] std::chrono::microseconds GetSmoothed() const;
+
+    /**
+     * Gets the mean deviation of the measurements, the jitter.
+     * @return The variation, 0 without measurements.
+     */
+    [[nodiscard]] std::chrono::microseconds GetVariation() const;
+
+    /**
+     * Gets how long a duration can take before it is unexpectedly long, the smoothed duration plus a margin for
+     * jitter.
+     * @return The upper bound, 0 without measurements.
+     */
+    [[nodiscard]] std::chrono::microseconds GetUpperBound() const;
+
+private:
+    std::chrono::microseconds mSmoothed{0};
+    std::chrono::microseconds mVariation{0};
+    bool                      mHasSamples{false};
+};
@@ -7,8 +7,12 @@
  **/
 
 #include <cstdint>
+#include <shared_mutex>
 #include <vector>
 
+/**
+ * Lists of Mac addresses to filter on. Thread-safe, as XLink Kai updates the list while the devices read it.
+ */
 class MacBlackList
 {
 public:
@@ -18,6 +22,12 @@ public:
      */
     void AddToMacBlackList(uint64_t aMac);
 
+    /**
+     * Removes a Mac address from the blacklist.
+     * @param aMac - Mac address to remove.
+     */
+    void RemoveFromMacBlackList(uint64_t aMac);
+
     /**
      * Add the source Mac address to whitelist. Whitelist takes prevalence over the blacklist.
      * @param aMac - Mac address to whitelist.
@@ -46,7 +56,7 @@ public:
      * @param aMac - Mac to check
      * @return true if Mac address is allowed.
      */
-    bool IsMacAllowed(uint64_t aMac);
+    [[nodiscard]] bool IsMacAllowed(uint64_t aMac) const;
 
     /**
      * Sets the source Mac addresses blacklist.
@@ -59,6 +69,14 @@ public:
     void SetMacWhiteList(std::vector<uint64_t>& aWhiteList);
 
 private:
-    std::vector<uint64_t> mBlackList{};
-    std::vector<uint64_t> mWhiteList{};
+    /**
+     * Checks if this Mac is not blacklisted / whitelisted, has to be called with mMutex held.
+     * @param aMac - Mac to check
+     * @return true if Mac address is allowed.
+     */
+    [[nodiscard]] bool IsMacAllowedLocked(uint64_t aMac) const;
+
+    mutable std::shared_mutex mMutex{};
+    std::vector<uint64_t>     mBlackList{};
+    std::vector<uint64_t>     mWhiteList{};
 };
@@ -13,6 +13,7 @@
 #include "IConnector.h"
 #include "PCapDeviceBase.h"
 #include "PCapWrapper.h"
+#include "Property.h"
 
 /**
  * Class which allows a wireless device in monitor mode to capture data and send wireless frames.
@@ -29,10 +30,11 @@ public:
      */
     explicit MonitorDevice(uint64_t                      aSourceMacToFilter         = std::uint64_t(0),
                            bool                          aAcknowledgeDataFrames     = false,
-                           std::string*                  aCurrentlyConnectedNetwork = nullptr,
+                           Property<std::string>*        aCurrentlyConnectedNetwork = nullptr,
                            std::shared_ptr<IPCapWrapper> aPcapWrapper               = std::make_shared<PCapWrapper>());
 
     void BlackList(uint64_t aMac) override;
+    void RemoveFromBlackList(uint64_t aMac) override;
     void Close() override;
     bool Connect(std::string_view aESSID) override;
 
@@ -63,7 +65,7 @@ private:
 
     bool                          mAcknowledgePackets{false};
     bool                          mConnected{false};
-    std::string*                  mCurrentlyConnectedNetwork{nullptr};
+    Property<std::string>*        mCurrentlyConnectedNetwork{nullptr};
     std::shared_ptr<IPCapWrapper> mPcapWrapper;
     Handler80211                  mPacketHandler{PhysicalDeviceHeaderType::RadioTap};
     std::shared_ptr<std::thread>  mReceiverThread{nullptr};
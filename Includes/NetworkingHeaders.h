@@ -163,6 +163,7 @@ namespace Net_Constants
     static constexpr uint16_t         cPSPEtherType{0xC888};
     static constexpr uint8_t          cMacAddressLength{6};
     static constexpr uint64_t         cBroadcastMac{0xFFFFFFFFFFFF};
+    static constexpr uint64_t         cGroupAddressBit{0x000000000001};
     static constexpr uint64_t         cDDSReplaceMac{0xFE01005E0000};
     static constexpr std::string_view cPSPSSIDFilterName{"PSP_"};
     static constexpr std::string_view cVitaSSIDFilterName{"SCE_"};
@@ -192,6 +193,10 @@ namespace Net_80211_Constants
     static constexpr uint8_t  cDataNullFuncType{0x48};
     static constexpr uint8_t  cAcknowledgementType{0xd4};
 
+    // Second frame control byte
+    static constexpr uint8_t cToDSFlag{0x01};
+    static constexpr uint8_t cFromDSFlag{0x02};
+
     // IEEE 802.11 Data Flags
     static constexpr uint8_t cTypeIndex{0};
     static constexpr uint8_t cTypeLength{2};
@@ -207,6 +212,12 @@ namespace Net_80211_Constants
     static constexpr uint8_t cFragmentNumberLength{2};
     static constexpr uint8_t c80211DataHeaderLength{cTypeLength + cDurationLength + cDestinationAddressLength +
                                                     cSourceAddressLength + cBSSIDLength + cFragmentNumberLength};
+    static constexpr uint8_t cAddress4Length{6};
+
+    // IEEE 802.11 Control, ACK and CTS frames only carry a receiver address
+    static constexpr uint8_t cControlHeaderLength{cTypeLength + cDurationLength + cDestinationAddressLength +
+                                                  cSourceAddressLength};
+    static constexpr uint8_t cControlShortHeaderLength{cTypeLength + cDurationLength + cDestinationAddressLength};
 
     // IEEE 802.11 Wireless Management
     static constexpr uint8_t cFixedParameterTypeSSIDIndex{36};
@@ -5,6 +5,8 @@
  * This file contains the base class for pcap devices.
  **/
 
+#include <atomic>
+
 #include "IPCapDevice.h"
 
 /**
@@ -13,22 +15,50 @@
 class PCapDeviceBase : public IPCapDevice
 {
 public:
-    std::string          DataToString(const unsigned char* aData, const pcap_pkthdr* aHeader) override;
-    const unsigned char* GetData() override;
-    const pcap_pkthdr*   GetHeader() override;
-    void                 SetConnector(std::shared_ptr<IConnector> aDevice) override;
-    void                 ShowPacketStatistics(const pcap_pkthdr* aHeader) const override;
+    std::string                             DataToString(const unsigned char* aData,
+                                                         const pcap_pkthdr*   aHeader) override;
+    const unsigned char*                    GetData() override;
+    const pcap_pkthdr*                      GetHeader() override;
+    IPCapDevice_Constants::DeviceStatistics GetStatistics() const override;
+    void                                    SetConnector(std::shared_ptr<IConnector> aDevice) override;
+    void                                    SetReceiverThreadAffinity(int aCPU) override;
+    void                                    ShowPacketStatistics(const pcap_pkthdr* aHeader) const override;
 
 protected:
-    std::shared_ptr<IConnector> GetConnector();
-    void                        IncreasePacketCount();
-    void                        SetData(const unsigned char* aData);
-    void                        SetHeader(const pcap_pkthdr* aHeader);
+    /**
+     * Pins the calling thread to the CPU set by SetReceiverThreadAffinity, call this from the receiver thread.
+     */
+    void ApplyReceiverThreadAffinity();
+
+    /**
+     * Gets the connector packets are handed to, without copying the shared pointer as this is done for every packet.
+     * @return The connector, owned by this device.
+     */
+    IConnector* GetConnector();
+
+    /**
+     * Gets the counters to measure handling a received packet with, see HardwareCounters::Measurement.
+     * @return The counters.
+     */
+    HardwareCounters& GetHardwareCounters();
+    void              IncreasePacketCount();
+    void              IncreaseSendErrorCount();
+    void              IncreaseSentPacketCount(size_t aBytes);
+    void              SetData(const unsigned char* aData);
+    void              SetHeader(const pcap_pkthdr* aHeader);
 
 private:
     std::shared_ptr<IConnector> mConnector{nullptr};
     const unsigned char*        mData{nullptr};
     const pcap_pkthdr*          mHeader{nullptr};
     bool                        mHosting{false};
-    unsigned int                mPacketCount{0};
+    int                         mReceiverThreadAffinity{-1};
+
+    // Counters are read from the engine thread while the receiver thread updates them
+    std::atomic<uint64_t> mPacketCount{0};
+    std::atomic<uint64_t> mBytesReceived{0};
+    std::atomic<uint64_t> mPacketsSent{0};
+    std::atomic<uint64_t> mBytesSent{0};
+    std::atomic<uint64_t> mSendErrors{0};
+    HardwareCounters      mHardwareCounters{};
 };
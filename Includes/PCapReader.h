@@ -39,6 +39,12 @@ public:
      */
     void BlackList(uint64_t aMac) override;
 
+    /**
+     * Removes a Mac address from the blacklist.
+     * @param aMac - Mac address to remove.
+     */
+    void RemoveFromBlackList(uint64_t aMac) override;
+
     void Close() override;
     bool Connect(std::string_view aESSID) override;
 
@@ -112,4 +118,8 @@ private:
     std::shared_ptr<IHandler>                                 mPacketHandler{nullptr};
     std::shared_ptr<std::thread>                              mReplayThread{nullptr};
     std::vector<std::string>                                  mSSIDFilter{};
+
+    // Typed views on mPacketHandler, set when opening so reading packets needs no casts
+    std::shared_ptr<Handler80211> mMonitorHandler{nullptr};
+    std::shared_ptr<Handler8023>  mPromiscuousHandler{nullptr};
 };
\ No newline at end of file
@@ -0,0 +1,156 @@
+#pragma once
+
+/* Copyright (c) 2022 [Rick de Bondt] - PCapReplayer.h
+ *
+ * This file contains a replay engine for captures, used to load test the bridge without real devices.
+ *
+ **/
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "IConnector.h"
+#include "IPCapDevice.h"
+#include "PCapWrapper.h"
+
+namespace PCapReplayer_Constants
+{
+    // Speed multiplier that replays without any pacing
+    static constexpr double cMaxSpeed{0};
+
+    // Byte of the Mac address that gets the stream number mixed in, the first byte after the OUI
+    static constexpr unsigned int cStreamMacByte{3};
+
+    // A single byte tells this many streams apart, more would reuse the Mac addresses of another stream
+    static constexpr unsigned int cMaxStreams{256};
+
+    /**
+     * Settings for a replay.
+     */
+    struct ReplaySettings
+    {
+        double       SpeedMultiplier{1}; /**< 1 is real time, 10 is ten times as fast, cMaxSpeed is unpaced */
+        unsigned int Loops{1};           /**< Amount of times the capture is replayed per stream, 0 loops forever */
+        unsigned int Streams{1};           /**< Concurrent streams with their own Mac addresses, up to cMaxStreams */
+    };
+
+    /**
+     * Results of a replay.
+     */
+    struct ReplayStatistics
+    {
+        uint64_t                 Packets{0};
+        uint64_t                 Bytes{0};
+        std::chrono::nanoseconds Duration{0};
+        double                   PacketsPerSecond{0};
+        std::chrono::nanoseconds AverageLatency{0}; /**< Average time spent handing a packet to the bridge */
+        std::chrono::nanoseconds MaxLatency{0};     /**< Longest time spent handing a packet to the bridge */
+        std::chrono::nanoseconds MaxLateness{0};    /**< Longest delay compared to the paced send time */
+    };
+}  // namespace PCapReplayer_Constants
+
+/**
+ * Replays a promiscuous (802.3) capture into the bridge, either towards a connector (pretending to be a device) or
+ * towards a device (pretending to be XLink Kai). The capture is loaded in memory once, so streams and loops do not
+ * touch the file again.
+ */
+class PCapReplayer
+{
+public:
+    /**
+     * Constructs the replayer.
+     * @param aWrapper - Wrapper for the PCap functions.
+     */
+    explicit PCapReplayer(std::shared_ptr<IPCapWrapper> aWrapper = std::make_shared<PCapWrapper>());
+    ~PCapReplayer();
+    PCapReplayer(const PCapReplayer& aPCapReplayer) = delete;
+    PCapReplayer& operator=(const PCapReplayer& aPCapReplayer) = delete;
+
+    /**
+     * Loads all packets of a capture in memory.
+     * @param aFileName - Capture to load.
+     * @return true if successful and the capture contains packets.
+     */
+    bool Open(std::string_view aFileName);
+
+    /**
+     * Sets the connector to replay to, as if the packets were received by a device.
+     * @param aConnector - Connector to send the packets to.
+     */
+    void SetConnector(std::shared_ptr<IConnector> aConnector);
+
+    /**
+     * Sets the device to replay to, as if the packets were received from XLink Kai.
+     * @param aDevice - Device to send the packets to.
+     */
+    void SetIncomingConnection(std::shared_ptr<IPCapDevice> aDevice);
+
+    /**
+     * Starts a thread per stream that replays the loaded capture.
+     * @param aSettings - Speed, loops and streams to use.
+     * @return true if successful.
+     */
+    bool Start(const PCapReplayer_Constants::ReplaySettings& aSettings);
+
+    /**
+     * Stops all streams and waits for them to finish.
+     */
+    void Stop();
+
+    /**
+     * Checks whether all streams are done replaying.
+     * @return true if done.
+     */
+    [[nodiscard]] bool IsDone() const;
+
+    /**
+     * Gets the combined statistics of all streams, only complete once IsDone returns true.
+     * @return The statistics.
+     */
+    [[nodiscard]] PCapReplayer_Constants::ReplayStatistics GetStatistics() const;
+
+    /**
+     * Rewrites the Mac addresses in an ethernet frame so every stream looks like a different set of devices.
+     * Group addresses are left alone, stream 0 keeps the original addresses.
+     * @param aPacket - Packet to rewrite.
+     * @param aStream - Number of the stream.
+     */
+    static void RewriteMacAddresses(std::string& aPacket, unsigned int aStream);
+
+private:
+    struct Packet
+    {
+        std::string               mData{};
+        std::chrono::microseconds mTimeStamp{0};
+    };
+
+    struct StreamStatistics
+    {
+        uint64_t                 mPackets{0};
+        uint64_t                 mBytes{0};
+        std::chrono::nanoseconds mTotalLatency{0};
+        std::chrono::nanoseconds mMaxLatency{0};
+        std::chrono::nanoseconds mMaxLateness{0};
+        std::chrono::nanoseconds mDuration{0};
+    };
+
+    /**
+     * Replays the capture for one stream, run in its own thread.
+     * @param aStream - Number of the stream.
+     */
+    void ReplayStream(unsigned int aStream);
+
+    std::shared_ptr<IConnector>            mConnector{nullptr};
+    std::shared_ptr<IPCapDevice>           mIncomingConnection{nullptr};
+    std::vector<Packet>                    mPackets{};
+    PCapReplayer_Constants::ReplaySettings mSettings{};
+    std::vector<StreamStatistics>          mStreamStatistics{};
+    std::vector<std::thread>               mStreamThreads{};
+    std::atomic<unsigned int>              mStreamsRunning{0};
+    std::atomic<bool>                      mStopCommand{false};
+    std::shared_ptr<IPCapWrapper>          mWrapper{nullptr};
+};
@@ -37,6 +37,7 @@ public:
     int            SetPromiscuousMode(int promiscuous) override;
     int            SetSnapLen(int snaplen) override;
     int            SetTimeOut(int timeout) override;
+    bool           WaitsForPackets() override;
 
 private:
     pcap_t* mHandler{};
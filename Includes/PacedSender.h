@@ -0,0 +1,73 @@
+#pragma once
+
+/* Copyright (c) 2022 [Rick de Bondt] - PacedSender.h
+ *
+ * This file contains a sender that hands frames to a device from a thread of its own, paced to the air.
+ *
+ **/
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string_view>
+#include <thread>
+
+#include "TransmitQueue.h"
+
+/**
+ * Sends frames through a TransmitQueue on a thread of its own, so whoever hands over the frames never waits for the
+ * adapter, and bursts are spread out to what the air can carry instead of piling up in the driver.
+ */
+class PacedSender
+{
+public:
+    using SendFunction = std::function<bool(std::string_view)>;
+
+    /**
+     * Constructs the sender and starts its thread.
+     * @param aSend - Function that actually sends a frame, called from the thread of the sender, returns false when
+     * the frame could not be sent.
+     */
+    explicit PacedSender(SendFunction aSend);
+    ~PacedSender();
+    PacedSender(const PacedSender& aPacedSender) = delete;
+    PacedSender& operator=(const PacedSender& aPacedSender) = delete;
+
+    /**
+     * Queues a frame to be sent.
+     * @param aData - The frame, copied before returning.
+     * @param aDataRate - Data rate the frame goes over the air with in units of 500 kbps, 0 if not known.
+     */
+    void Send(std::string_view aData, uint8_t aDataRate = 0);
+
+    /**
+     * Starts the thread again after Stop, frames queued in the meantime are sent or aged as usual.
+     */
+    void Start();
+
+    /**
+     * Stops the thread, waiting for a frame that is being sent to finish. Nothing is sent until Start is called,
+     * so whatever the send function sends to can be closed afterwards.
+     */
+    void Stop();
+
+    /**
+     * Gets the counters of the queue, can be called from any thread.
+     * @return The counters.
+     */
+    [[nodiscard]] TransmitQueue_Constants::Statistics GetStatistics() const;
+
+private:
+    /**
+     * Sends frames as soon as the air is free for them, until the sender is stopped.
+     */
+    void Run();
+
+    SendFunction            mSend{};
+    mutable std::mutex      mMutex{};
+    std::condition_variable mWakeUp{};
+    TransmitQueue           mQueue{};
+    bool                    mStopping{false};
+    uint64_t                mSendErrors{0};
+    std::thread             mThread{};
+};
@@ -0,0 +1,157 @@
+#pragma once
+
+/* Copyright (c) 2022 [Rick de Bondt] - Property.h
+ *
+ * This file contains a thread-safe value that tells subscribers when it changes.
+ *
+ **/
+
+#include <functional>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+/**
+ * Unsubscribes from a Property when it goes out of scope, so an object can not be called after it is destroyed.
+ * Must not outlive the Property it belongs to.
+ */
+class Subscription
+{
+public:
+    Subscription() = default;
+
+    /**
+     * Creates a subscription.
+     * @param aUnsubscribe - Function that removes the subscription.
+     */
+    explicit Subscription(std::function<void()> aUnsubscribe) : mUnsubscribe(std::move(aUnsubscribe)) {}
+
+    ~Subscription()
+    {
+        Reset();
+    }
+
+    Subscription(const Subscription& aSubscription)            = delete;
+    Subscription& operator=(const Subscription& aSubscription) = delete;
+
+    Subscription(Subscription&& aSubscription) noexcept : mUnsubscribe(std::move(aSubscription.mUnsubscribe))
+    {
+        aSubscription.mUnsubscribe = nullptr;
+    }
+
+    Subscription& operator=(Subscription&& aSubscription) noexcept
+    {
+        if (this != &aSubscription) {
+            Reset();
+            mUnsubscribe               = std::move(aSubscription.mUnsubscribe);
+            aSubscription.mUnsubscribe = nullptr;
+        }
+        return *this;
+    }
+
+    /**
+     * Unsubscribes, does nothing if already unsubscribed.
+     */
+    void Reset()
+    {
+        if (mUnsubscribe != nullptr) {
+            mUnsubscribe();
+            mUnsubscribe = nullptr;
+        }
+    }
+
+private:
+    std::function<void()> mUnsubscribe{nullptr};
+};
+
+/**
+ * A value that can be read and written from any thread. Subscribers are called on the thread that changed the value,
+ * so they should only do a small amount of work, like waking up the thread that actually handles the change.
+ */
+template<typename Type> class Property
+{
+public:
+    using Callback = std::function<void(const Type&)>;
+
+    Property() = default;
+
+    /**
+     * Creates the property with an initial value.
+     * @param aValue - The initial value.
+     */
+    explicit Property(Type aValue) : mValue(std::move(aValue)) {}
+
+    Property(const Property& aProperty)            = delete;
+    Property& operator=(const Property& aProperty) = delete;
+
+    /**
+     * Gets a copy of the value.
+     * @return The value.
+     */
+    Type Get() const
+    {
+        std::lock_guard<std::mutex> lLock{mMutex};
+        return mValue;
+    }
+
+    /**
+     * Sets the value and calls the subscribers if it changed.
+     * @param aValue - The new value.
+     * @return true if the value changed.
+     */
+    bool Set(Type aValue)
+    {
+        bool lChanged{false};
+        {
+            std::lock_guard<std::mutex> lLock{mMutex};
+            if (!(mValue == aValue)) {
+                mValue   = aValue;
+                lChanged = true;
+            }
+        }
+
+        if (lChanged) {
+            // Held while calling, so unsubscribing waits for running callbacks to finish. Iterates over a copy, a
+            // callback is allowed to unsubscribe itself.
+            std::lock_guard<std::recursive_mutex> lLock{mSubscribersMutex};
+            auto                                  lSubscribers{mSubscribers};
+            for (auto& lSubscriber : lSubscribers) {
+                lSubscriber.second(aValue);
+            }
+        }
+
+        return lChanged;
+    }
+
+    /**
+     * Calls the callback every time the value changes, until the returned subscription is destroyed.
+     * @param aCallback - Function to call with the new value.
+     * @return The subscription.
+     */
+    [[nodiscard]] Subscription Subscribe(Callback aCallback)
+    {
+        std::lock_guard<std::recursive_mutex> lLock{mSubscribersMutex};
+        unsigned int                          lId{mNextId++};
+        mSubscribers.emplace_back(lId, std::move(aCallback));
+
+        return Subscription{[this, lId] { Unsubscribe(lId); }};
+    }
+
+private:
+    void Unsubscribe(unsigned int aId)
+    {
+        std::lock_guard<std::recursive_mutex> lLock{mSubscribersMutex};
+        for (auto lIterator = mSubscribers.begin(); lIterator != mSubscribers.end(); lIterator++) {
+            if (lIterator->first == aId) {
+                mSubscribers.erase(lIterator);
+                break;
+            }
+        }
+    }
+
+    mutable std::mutex                             mMutex{};
+    Type                                           mValue{};
+    std::recursive_mutex                           mSubscribersMutex{};
+    std::vector<std::pair<unsigned int, Callback>> mSubscribers{};
+    unsigned int                                   mNextId{0};
+};
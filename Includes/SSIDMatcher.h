@@ -0,0 +1,54 @@
+#pragma once
+
+/* Copyright (c) 2022 [Rick de Bondt] - SSIDMatcher.h
+ *
+ * This file contains a matcher that checks SSIDs against a list of filters in a single pass.
+ *
+ **/
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace SSIDMatcher_Constants
+{
+    static constexpr std::size_t cAlphabetSize{256};
+    static constexpr uint32_t    cRootState{0};
+}  // namespace SSIDMatcher_Constants
+
+/**
+ * Compiles a list of SSID filters into an Aho-Corasick automaton, so an SSID can be checked against all filters at
+ * once. An SSID matches when any of the filters occurs somewhere in it, just like std::string::find would. Matching
+ * walks every character of the SSID once and does not allocate.
+ */
+class SSIDMatcher
+{
+public:
+    SSIDMatcher() = default;
+
+    /**
+     * Compiles the filters.
+     * @param aFilters - Filters to match on.
+     */
+    explicit SSIDMatcher(const std::vector<std::string>& aFilters);
+
+    /**
+     * Checks if there are no filters at all.
+     * @return true if there are no filters.
+     */
+    [[nodiscard]] bool IsEmpty() const;
+
+    /**
+     * Checks if any of the filters occurs in an SSID.
+     * @param aSSID - SSID to check.
+     * @return true if a filter occurs in the SSID, false if not or if there are no filters.
+     */
+    [[nodiscard]] bool Matches(std::string_view aSSID) const;
+
+private:
+    // Every state has an entry for every possible character, so matching never has to follow failure links
+    std::vector<uint32_t> mTransitions{};
+    std::vector<bool>     mAccepting{};
+    bool                  mEmpty{true};
+};
@@ -2,12 +2,12 @@
 
 /* Copyright (c) 2022 [Rick de Bondt] - Timer.h
  *
- * This file contains a timer based on the system clock.
+ * This file contains a timer based on the steady clock.
  *
  **/
 
 /**
- * Timer based on system clock.
+ * Timer based on the steady clock, so it does not jump when the system time is adjusted.
  */
 
 #include <chrono>
@@ -25,7 +25,7 @@ public:
     std::chrono::milliseconds GetTimeLeft() override;
 
 private:
-    std::chrono::time_point<std::chrono::system_clock> mStartTime{};
+    std::chrono::time_point<std::chrono::steady_clock> mStartTime{};
     std::chrono::milliseconds                          mTimeOut{};
     bool                                               mStarted{};
 };
\ No newline at end of file
@@ -0,0 +1,76 @@
+#pragma once
+
+/* Copyright (c) 2022 [Rick de Bondt] - TimerService.h
+ *
+ * This file contains a service that runs timer callbacks on a thread of its own.
+ *
+ **/
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "TimerWheel.h"
+
+/**
+ * Runs a TimerWheel on a thread that sleeps until the next timer is due, so nobody has to poll for timeouts.
+ * Callbacks run on that thread one at a time and should be short, anything heavy should be handed off.
+ */
+class TimerService
+{
+public:
+    TimerService();
+    ~TimerService();
+    TimerService(const TimerService& aTimerService) = delete;
+    TimerService& operator=(const TimerService& aTimerService) = delete;
+
+    /**
+     * Gets the TimerService shared by the whole program.
+     * @return The TimerService object.
+     */
+    static TimerService& GetInstance()
+    {
+        static TimerService lInstance;
+        return lInstance;
+    }
+
+    /**
+     * Runs a callback after a delay.
+     * @param aDelay - Time to wait.
+     * @param aCallback - Function to run.
+     * @return Id of the timer, to cancel it with.
+     */
+    TimerWheel::Id Schedule(std::chrono::milliseconds aDelay, TimerWheel::Callback aCallback);
+
+    /**
+     * Runs a callback at a given moment.
+     * @param aDeadline - When to run the callback.
+     * @param aCallback - Function to run.
+     * @return Id of the timer, to cancel it with.
+     */
+    TimerWheel::Id ScheduleAt(TimerWheel::Clock::time_point aDeadline, TimerWheel::Callback aCallback);
+
+    /**
+     * Cancels a timer. If its callback is running on another thread, waits for it to finish, so the callback is
+     * guaranteed not to be running once this returns.
+     * @param aId - Id of the timer, 0 is ignored.
+     * @return true if the timer had not fired yet.
+     */
+    bool Cancel(TimerWheel::Id aId);
+
+private:
+    /**
+     * Sleeps until the next timer is due and runs it, until the service is destroyed.
+     */
+    void Run();
+
+    std::mutex              mMutex{};
+    std::condition_variable mWakeUp{};
+    std::condition_variable mCallbackDone{};
+    TimerWheel              mWheel{};
+    TimerWheel::Id          mRunning{0};
+    bool                    mChanged{false};
+    bool                    mStopping{false};
+    std::thread             mThread{};
+};
@@ -0,0 +1,128 @@
+#pragma once
+
+/* Copyright (c) 2022 [Rick de Bondt] - TimerWheel.h
+ *
+ * This file contains a hierarchical timer wheel based on the steady clock.
+ *
+ **/
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace TimerWheel_Constants
+{
+    // Resolution of the wheel, timers never fire before their deadline but can fire up to this much later
+    static constexpr std::chrono::milliseconds cTick{1};
+
+    // Every level has 64 slots, each covering 64 times as many ticks as a slot of the level below it
+    static constexpr unsigned int cSlotBits{6};
+    static constexpr unsigned int cSlots{1U << cSlotBits};
+    static constexpr unsigned int cLevels{4};
+
+    // About 4.6 hours, timers further away are parked in the highest level until they get close enough
+    static constexpr uint64_t cRange{uint64_t{1} << (cSlotBits * cLevels)};
+}  // namespace TimerWheel_Constants
+
+/**
+ * Hierarchical timer wheel, scheduling and cancelling a timer is O(1) no matter how many timers there are. Timers are
+ * kept in the slot of the lowest level that can still tell them apart from the current tick, and move down a level
+ * when the wheel gets close to them. Not thread-safe, see TimerService for a wheel that runs by itself.
+ */
+class TimerWheel
+{
+public:
+    using Clock    = std::chrono::steady_clock;
+    using Id       = uint64_t;
+    using Callback = std::function<void()>;
+    using Expired  = std::vector<std::pair<Id, Callback>>;
+
+    /**
+     * Constructs an empty wheel.
+     * @param aNow - The time the wheel starts at.
+     */
+    explicit TimerWheel(Clock::time_point aNow = Clock::now());
+
+    /**
+     * Adds a timer to the wheel.
+     * @param aDeadline - When the timer should fire, deadlines in the past fire on the next tick.
+     * @param aCallback - Function to return from Advance once the deadline has passed.
+     * @return Id of the timer, never 0.
+     */
+    Id Schedule(Clock::time_point aDeadline, Callback aCallback);
+
+    /**
+     * Removes a timer from the wheel.
+     * @param aId - Id of the timer.
+     * @return true if the timer was still waiting to fire.
+     */
+    bool Cancel(Id aId);
+
+    /**
+     * Moves the wheel forward in time and removes all timers that are due.
+     * @param aNow - The time to move to.
+     * @return The ids and callbacks of the timers that are due, in order of their deadline. Left to the caller to run
+     * so callbacks can schedule new timers.
+     */
+    Expired Advance(Clock::time_point aNow);
+
+    /**
+     * Gets the first moment the wheel has something to do, either firing a timer or moving timers down a level.
+     * @return That moment, std::nullopt if the wheel is empty.
+     */
+    [[nodiscard]] std::optional<Clock::time_point> GetNextWakeUp() const;
+
+    /**
+     * Gets the amount of timers that are waiting to fire.
+     * @return The amount of timers.
+     */
+    [[nodiscard]] std::size_t GetSize() const;
+
+private:
+    struct Entry
+    {
+        uint64_t mTick{0};
+        Callback mCallback{};
+    };
+
+    using Slot  = std::vector<Id>;
+    using Level = std::array<Slot, TimerWheel_Constants::cSlots>;
+
+    /**
+     * Puts a timer in the slot that fits its tick.
+     * @param aId - Id of the timer.
+     * @param aTick - Tick the timer fires at.
+     */
+    void Place(Id aId, uint64_t aTick);
+
+    /**
+     * Moves all timers in the current slot of a level down.
+     * @param aLevel - The level to cascade.
+     */
+    void Cascade(unsigned int aLevel);
+
+    /**
+     * Converts a tick to the time it starts at.
+     * @param aTick - The tick to convert.
+     * @return The time.
+     */
+    [[nodiscard]] Clock::time_point GetTime(uint64_t aTick) const;
+
+    /**
+     * Checks if a slot holds any timer that has not been cancelled.
+     * @param aSlot - The slot to check.
+     * @return true if it does.
+     */
+    [[nodiscard]] bool HasEntries(const Slot& aSlot) const;
+
+    Clock::time_point                                mStart{};
+    uint64_t                                         mCurrentTick{0};
+    Id                                               mNextId{1};
+    std::unordered_map<Id, Entry>                    mEntries{};
+    std::array<Level, TimerWheel_Constants::cLevels> mLevels{};
+};
@@ -0,0 +1,158 @@
+#pragma once
+
+/* Copyright (c) 2022 [Rick de Bondt] - Tracer.h
+ *
+ * This file contains a recorder for trace events, which can be saved in the Chrome trace format.
+ *
+ **/
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Tracer_Constants
+{
+    // Amount of events remembered per thread, when full the oldest ones of that thread are overwritten
+    static constexpr std::size_t cMaxEvents{65536};
+
+    static constexpr std::string_view cFileName{"trace.json"};
+    static constexpr std::string_view cCategory{"xlha"};
+}  // namespace Tracer_Constants
+
+/**
+ * Remembers how long parts of the program took and on which thread, so it can be seen how the threads interleave.
+ * The events are saved as Chrome trace JSON, which can be opened in Perfetto (ui.perfetto.dev) or chrome://tracing.
+ * Use the TRACE_ macros below instead of this class directly, they are compiled out unless ENABLE_TRACING is set.
+ * Every thread records into a buffer of its own, so threads adding events do not wait on each other. Thread-safe.
+ */
+class Tracer
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    Tracer()                                 = default;
+    Tracer(const Tracer& aTracer)            = delete;
+    Tracer& operator=(const Tracer& aTracer) = delete;
+
+    /**
+     * Gets the Tracer shared by the whole program.
+     * @return The Tracer object.
+     */
+    static Tracer& GetInstance()
+    {
+        static Tracer lInstance;
+        return lInstance;
+    }
+
+    /**
+     * Remembers that something happened on the calling thread.
+     * @param aName - What happened, has to stay valid for as long as the tracer exists, so a string literal.
+     * @param aStart - When it started.
+     * @param aEnd - When it ended.
+     */
+    void AddEvent(const char* aName, Clock::time_point aStart, Clock::time_point aEnd);
+
+    /**
+     * Names the calling thread in the trace.
+     * @param aName - Name of the thread.
+     */
+    void SetThreadName(std::string_view aName);
+
+    /**
+     * Writes all remembered events as Chrome trace JSON.
+     * @param aStream - Stream to write to.
+     * @return true if the stream was written successfully.
+     */
+    bool Write(std::ostream& aStream) const;
+
+    /**
+     * Saves all remembered events as Chrome trace JSON.
+     * @param aFileName - File to save to.
+     * @return true if successful.
+     */
+    bool Save(const std::string& aFileName) const;
+
+private:
+    struct Event
+    {
+        const char*       mName{nullptr};
+        Clock::time_point mStart{};
+        Clock::duration   mDuration{};
+    };
+
+    // Events of a single thread, only locked by another thread while writing the trace
+    struct ThreadBuffer
+    {
+        std::mutex         mMutex{};
+        std::vector<Event> mEvents{};
+        std::size_t        mNextEvent{0};
+    };
+
+    /**
+     * Gets a small number identifying the calling thread, the same for every tracer.
+     * @return The number.
+     */
+    static uint32_t GetThreadNumber();
+
+    /**
+     * Gets a number identifying a new tracer, unlike its address this is never reused.
+     * @return The number.
+     */
+    static uint64_t GetNextId();
+
+    /**
+     * Gets the buffer of the calling thread, creating it on first use.
+     * @return The buffer.
+     */
+    ThreadBuffer& GetThreadBuffer();
+
+    const uint64_t                                    mId{GetNextId()};
+    mutable std::mutex                                mMutex{};
+    Clock::time_point                                 mCreated{Clock::now()};
+    std::map<uint32_t, std::shared_ptr<ThreadBuffer>> mBuffers{};
+    std::map<uint32_t, std::string>                   mThreadNames{};
+};
+
+/**
+ * Adds an event to the Tracer singleton for the scope it lives in.
+ */
+class ScopedTrace
+{
+public:
+    /**
+     * Starts the event.
+     * @param aName - What is happening, has to be a string literal.
+     */
+    explicit ScopedTrace(const char* aName) : mName(aName) {}
+    ~ScopedTrace() { Tracer::GetInstance().AddEvent(mName, mStart, Tracer::Clock::now()); }
+    ScopedTrace(const ScopedTrace& aScopedTrace)            = delete;
+    ScopedTrace& operator=(const ScopedTrace& aScopedTrace) = delete;
+
+private:
+    const char*               mName{nullptr};
+    Tracer::Clock::time_point mStart{Tracer::Clock::now()};
+};
+
+#if defined(ENABLE_TRACING)
+#define TRACE_CONCATENATE_DETAIL(aFirst, aSecond) aFirst##aSecond
+#define TRACE_CONCATENATE(aFirst, aSecond)        TRACE_CONCATENATE_DETAIL(aFirst, aSecond)
+#define TRACE_SCOPE(aName)                        const ScopedTrace TRACE_CONCATENATE(lScopedTrace, __LINE__){aName}
+// For events that are only worth recording some of the time, TRACE_START remembers when it started in a variable and
+// TRACE_EVENT adds the event if reached
+#define TRACE_START(aStart)                       const Tracer::Clock::time_point aStart{Tracer::Clock::now()}
+#define TRACE_EVENT(aName, aStart)                Tracer::GetInstance().AddEvent(aName, aStart, Tracer::Clock::now())
+#define TRACE_THREAD_NAME(aName)                  Tracer::GetInstance().SetThreadName(aName)
+#define TRACE_SAVE(aFileName)                     Tracer::GetInstance().Save(aFileName)
+#else
+#define TRACE_SCOPE(aName)
+#define TRACE_START(aStart)
+#define TRACE_EVENT(aName, aStart)
+#define TRACE_THREAD_NAME(aName)
+#define TRACE_SAVE(aFileName)
+#endif
@@ -0,0 +1,130 @@
+#pragma once
+
+/* Copyright (c) 2022 [Rick de Bondt] - TransmitQueue.h
+ *
+ * This file contains a queue for frames that are about to go over the air, paced to the airtime they take.
+ *
+ **/
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace TransmitQueue_Constants
+{
+    // Frames that waited this long are dropped no matter what, game state this old is worthless
+    static constexpr std::chrono::milliseconds cMaximumAge{200};
+
+    // CoDel from RFC 8289, starts dropping once frames waited longer than the target for a whole interval
+    static constexpr std::chrono::milliseconds cTarget{5};
+    static constexpr std::chrono::milliseconds cInterval{100};
+
+    // Frames that can wait at most, when full the oldest frame makes room for the new one
+    static constexpr std::size_t cMaximumFrames{128};
+
+    // Time the medium is busy for a frame on top of the data itself: preamble, DIFS and the average backoff. For
+    // 802.11b with a long preamble and for 802.11g.
+    static constexpr std::chrono::microseconds cDSSSOverhead{192 + 50 + 310};
+    static constexpr std::chrono::microseconds cOFDMOverhead{20 + 28 + 68};
+
+    /**
+     * Counters of a transmit queue.
+     */
+    struct Statistics
+    {
+        uint64_t Sent{0};       /**< Frames handed to the adapter */
+        uint64_t Overflows{0};  /**< Frames dropped because the queue was full */
+        uint64_t AgeDrops{0};   /**< Frames dropped because they waited too long */
+        uint64_t SendErrors{0}; /**< Frames the adapter failed to send, only counted by PacedSender */
+    };
+}  // namespace TransmitQueue_Constants
+
+/**
+ * Bounded queue of frames waiting to be sent over the air. Frames are paced so that no more is handed to the adapter
+ * than the air can carry at the data rate of the frame, and frames that wait too long are dropped the way CoDel does,
+ * so the frames that do get sent are fresh. Not thread-safe, see PacedSender for a queue with a thread sending from it.
+ */
+class TransmitQueue
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * Adds a frame to the back of the queue.
+     * @param aData - The frame, copied.
+     * @param aDataRate - Data rate the frame goes over the air with in units of 500 kbps, as in the radiotap header. 0
+     * if not known, the frame is not paced then.
+     * @param aNow - Current time.
+     */
+    void Push(std::string_view aData, uint8_t aDataRate, Clock::time_point aNow);
+
+    /**
+     * Takes the next frame to send from the queue, dropping frames that waited too long.
+     * @param aNow - Current time, should not be before GetNextSendTime.
+     * @return The frame, std::nullopt if there is nothing left to send.
+     */
+    std::optional<std::string> Pop(Clock::time_point aNow);
+
+    /**
+     * Gets when the air is expected to be free again after the frames that have been taken from the queue.
+     * @return The moment the next frame can be taken.
+     */
+    [[nodiscard]] Clock::time_point GetNextSendTime() const;
+
+    /**
+     * Checks if there are frames waiting.
+     * @return true if the queue is empty.
+     */
+    [[nodiscard]] bool IsEmpty() const;
+
+    /**
+     * Gets the counters of the queue.
+     * @return The counters.
+     */
+    [[nodiscard]] TransmitQueue_Constants::Statistics GetStatistics() const;
+
+    /**
+     * Calculates how long a frame keeps the air busy.
+     * @param aSize - Size of the frame in bytes.
+     * @param aDataRate - Data rate in units of 500 kbps, 0 if not known.
+     * @return The airtime, 0 if the data rate is not known.
+     */
+    static Clock::duration GetAirtime(std::size_t aSize, uint8_t aDataRate);
+
+private:
+    struct Frame
+    {
+        std::string       mData{};
+        uint8_t           mDataRate{0};
+        Clock::time_point mQueued{};
+    };
+
+    /**
+     * Takes the frame at the front of the queue and checks whether CoDel would allow dropping it.
+     * @param aNow - Current time.
+     * @param aOkToDrop - Set to true if the frame may be dropped.
+     * @return The frame, std::nullopt if the queue is empty.
+     */
+    std::optional<Frame> TakeFront(Clock::time_point aNow, bool& aOkToDrop);
+
+    /**
+     * Gets the moment of the next CoDel drop, the drops get closer together the longer the queue stays too long.
+     * @param aTime - Moment to count from.
+     * @return The moment of the next drop.
+     */
+    [[nodiscard]] Clock::time_point GetNextDropTime(Clock::time_point aTime) const;
+
+    std::deque<Frame>                   mFrames{};
+    Clock::time_point                   mNextSendTime{};
+    TransmitQueue_Constants::Statistics mStatistics{};
+
+    // CoDel state
+    std::optional<Clock::time_point> mFirstAboveTime{};
+    Clock::time_point                mDropNext{};
+    bool                             mDropping{false};
+    unsigned int                     mCount{0};
+    unsigned int                     mLastCount{0};
+};
@@ -6,31 +6,79 @@
  *
  **/
 
+#include <array>
+#include <vector>
+
 #include <boost/asio.hpp>
 #include <boost/asio/io_service.hpp>
 
+#if defined(__linux__)
+#include <sys/socket.h>
+#endif
+
 #include "IUDPSocketWrapper.h"
 
+namespace UDPSocketWrapper_Constants
+{
+    // Largest datagram that can be received
+    static constexpr std::size_t cMaxDatagramLength{4096};
+
+    // Maximum amount of datagrams received in one go, every one of them has its own preallocated buffer
+    static constexpr std::size_t cBatchSize{32};
+}  // namespace UDPSocketWrapper_Constants
+
 class UDPSocketWrapper : public IUDPSocketWrapper
 {
 public:
+    UDPSocketWrapper();
+
     void        Close() override;
     bool        Open(std::string_view aIp, unsigned int aPort) override;
+    bool        SetOptions(const UDPSocketWrapper_Constants::SocketOptions& aOptions) override;
     bool        IsOpen() override;
     std::size_t SendTo(std::string_view aData) override;
     std::size_t ReceiveFrom(char* aDataBuffer, size_t aDataBufferSize) override;
-    void AsyncReceiveFrom(char* aDataBuffer, size_t aDataBufferSize, std::function<void(size_t)> aCallBack) override;
-    void StartThread() override;
-    void StopThread() override;
-    bool IsThreadStopped() override;
-    void PollThread() override;
+    void        AsyncReceiveFrom(IUDPReceiveHandler& aHandler) override;
+    void        StartThread() override;
+    void        StopThread() override;
+    bool        IsThreadStopped() override;
+    void        PollThread() override;
 
 private:
-    void ReceiveCallBack(const boost::system::error_code& aError, size_t aBufferSize);
+    /**
+     * Applies mOptions to the open socket.
+     * @return true if all options could be applied.
+     */
+    bool ApplyOptions();
+
+    /**
+     * Receives every datagram waiting on the socket, up to the batch size, and hands them to the handler.
+     * @param aError - Result of waiting for the socket to become readable.
+     */
+    void ReceiveBatch(const boost::system::error_code& aError);
+
+    /**
+     * Receives the waiting datagrams into the buffers.
+     * @return The amount of datagrams received.
+     */
+    std::size_t ReceiveIntoBuffers();
+
+    using Buffer = std::array<char, UDPSocketWrapper_Constants::cMaxDatagramLength>;
+
+    std::vector<Buffer>                       mBuffers{std::vector<Buffer>(UDPSocketWrapper_Constants::cBatchSize)};
+    std::vector<std::size_t>                  mSizes{std::vector<std::size_t>(UDPSocketWrapper_Constants::cBatchSize)};
+    IUDPReceiveHandler*                       mHandler{nullptr};
+    bool                                      mReceivePending{false};
+    UDPSocketWrapper_Constants::SocketOptions mOptions{};
 
-    std::function<void(size_t)> mCallBack;
+#if defined(__linux__)
+    // Point at mBuffers, so a batch can be received with a single recvmmsg call
+    std::vector<iovec>   mVectors{std::vector<iovec>(UDPSocketWrapper_Constants::cBatchSize)};
+    std::vector<mmsghdr> mMessages{std::vector<mmsghdr>(UDPSocketWrapper_Constants::cBatchSize)};
+#endif
 
+protected:
     boost::asio::io_service        mThread{};
     boost::asio::ip::udp::endpoint mEndpoint{};
     boost::asio::ip::udp::socket   mSocket{mThread};
-};
\ No newline at end of file
+};
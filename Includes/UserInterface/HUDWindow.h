@@ -6,6 +6,9 @@
  *
  **/
 
+#include <atomic>
+#include <optional>
+
 #include "Window.h"
 
 /**
@@ -20,13 +23,29 @@ public:
     void Draw() override;
 
 private:
+    /**
+     * Updates the picture, start/stop button and status text to the engine status in the model.
+     */
+    void UpdateEngineStatus();
+
+    /**
+     * Updates the connected network text to the connected network in the model.
+     */
+    void UpdateConnected();
+
     // If you want nice ascii art, add on/off txt files
-    std::string        mOffPicture{"    O    "};
-    std::string        mOnPicture{"( ( O ) )"};
-    const std::string* mActivePicture{&mOffPicture};
-    std::string        mOldConnected;
-    bool               mOldHosting{false};
+    std::string                                        mOffPicture{"    O    "};
+    std::string                                        mOnPicture{"( ( O ) )"};
+    const std::string*                                 mActivePicture{&mOffPicture};
+    std::optional<WindowModel_Constants::EngineStatus> mOldEngineStatus{};
+    std::string                                        mOldConnected;
+    bool                                               mOldHosting{false};
+    std::atomic<bool>                                  mModelChanged{true};
 
     Window::Dimensions ScaleHostingButton();
     Window::Dimensions ScaleReConnectionButton();
+
+    // Declared last, so they are unsubscribed before anything else is destroyed
+    Subscription mEngineStatusSubscription{};
+    Subscription mConnectedSubscription{};
 };
@@ -25,7 +25,7 @@ public:
     virtual void SetUp() = 0;
 
     /**
-     * Draws window on screen.
+     * Draws window on screen, only does something if the window is dirty.
      */
     virtual void Draw() = 0;
 
@@ -45,10 +45,21 @@ public:
     virtual void DrawString(int aYCoord, int aXCoord, unsigned int aColorPair, std::string_view aString) = 0;
 
     /**
-     * Refreshes window.
+     * Queues the window for the next screen update, call doupdate to actually put it on screen.
      */
     virtual void Refresh() = 0;
 
+    /**
+     * Marks the window as changed, so it gets drawn again on the next frame.
+     */
+    virtual void SetDirty() = 0;
+
+    /**
+     * Gets if the window changed since it was last drawn.
+     * @return true if the window needs to be drawn.
+     */
+    virtual bool IsDirty() = 0;
+
     /**
      * Moves window. Note: You cannot move a Window beyond the screen boundaries.
      * @param aYCoord - Y coordinate to move window to.
@@ -6,6 +6,7 @@
  *
  **/
 
+#include <atomic>
 #include <cstddef>
 #include <functional>
 #include <memory>
@@ -61,6 +62,10 @@ public:
 
     void Refresh() override;
 
+    void SetDirty() override;
+
+    bool IsDirty() override;
+
     bool Move(int aYCoord, int aXCoord) override;
 
     WindowModel& GetModel() override;
@@ -111,4 +116,7 @@ private:
     bool                                mVisible;
     int                                 mSelectedObject;
     ObjectList                          mObjects;
+
+    // Set from the keyboard thread as well, drawing happens on the main thread
+    std::atomic<bool> mDirty{true};
 };
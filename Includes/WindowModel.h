@@ -12,6 +12,7 @@
 #include <vector>
 
 #include "Logger.h"
+#include "Property.h"
 
 namespace WindowModel_Constants
 {
@@ -42,7 +43,8 @@ namespace WindowModel_Constants
     {
         Idle = 0,
         Running,
-        Error
+        Error,
+        Starting
     };
 
 #if not defined(_WIN32) && not defined(_WIN64)
@@ -53,42 +55,73 @@ namespace WindowModel_Constants
         "Plugin", "Promiscuous", "USB", "Simulation"};
 #endif
 
-    static constexpr std::array<std::string_view, 3> cEngineStatusTexts{"Idle", "Running", "Error"};
+    static constexpr std::array<std::string_view, 4> cEngineStatusTexts{"Idle", "Running", "Error", "Starting"};
     static constexpr std::string_view                cSaveFilePath{"config.txt"};
 
     // Keys in the config file
     static constexpr std::string_view cSaveAcknowledgeDataFrames{"AckDataFrames"};
+    static constexpr std::string_view cSaveAdditionalWifiAdapters{"AdditionalWifiAdapters"};
+    static constexpr std::string_view cSaveArpProxy{"ArpProxy"};
+    static constexpr std::string_view cSaveArpProxyRemote{"ArpProxyRemote"};
     static constexpr std::string_view cSaveAutoDiscoverPSPVita{"AutoDiscoverPSPVita"};
     static constexpr std::string_view cSaveAutoDiscoverXLinkKai{"AutoDiscoverXLinkKai"};
+    static constexpr std::string_view cSaveBroadcastRateLimit{"BroadcastRateLimit"};
+    static constexpr std::string_view cSaveBroadcastRepeatWindowMs{"BroadcastRepeatWindowMs"};
     static constexpr std::string_view cSaveChannel{"Channel"};
     static constexpr std::string_view cSaveConnectionMethod{"Method"};
+    static constexpr std::string_view cSaveHardwareCounters{"HardwareCounters"};
     static constexpr std::string_view cSaveLogLevel{"LogLevel"};
     static constexpr std::string_view cSaveOnlyAcceptFromMac{"OnlyAcceptFromMac"};
+    static constexpr std::string_view cSavePaceTransmissions{"PaceTransmissions"};
+    static constexpr std::string_view cSavePinCaptureThreads{"PinCaptureThreads"};
     static constexpr std::string_view cSaveReConnectionTimeOutS{"ReConnectionTimeOutS"};
+    static constexpr std::string_view cSaveSharedXLinkKaiConnection{"SharedXLinkKaiConnection"};
     static constexpr std::string_view cSaveTheme{"Theme"};
+    static constexpr std::string_view cSaveUseIOUring{"UseIOUring"};
     static constexpr std::string_view cSaveUseSSIDFromHost{"UseSSIDFromHost"};
     static constexpr std::string_view cSaveUseSSIDFromXLinkKai{"UseSSIDFromXLinkKai"};
+    static constexpr std::string_view cSaveUseXDP{"UseXDP"};
     static constexpr std::string_view cSaveUseXLinkKaiHints{"UseXLinkKaiHints"};
     static constexpr std::string_view cSaveWifiAdapter{"WifiAdapter"};
+    static constexpr std::string_view cSaveXLinkBusyPollUs{"XLinkBusyPollUs"};
     static constexpr std::string_view cSaveXLinkIp{"XLinkIp"};
     static constexpr std::string_view cSaveXLinkPort{"XLinkPort"};
+    static constexpr std::string_view cSaveXLinkReceiveBufferSize{"XLinkReceiveBufferSize"};
+    static constexpr std::string_view cSaveXLinkSendBufferSize{"XLinkSendBufferSize"};
 
     // Default values
     static constexpr bool             cDefaultAcknowledgeDataFrames{false};
+    static constexpr std::string_view cDefaultAdditionalWifiAdapters;
+    static constexpr bool             cDefaultArpProxy{true};
+    static constexpr bool             cDefaultArpProxyRemote{false};
     static constexpr bool             cDefaultAutoDiscoverPSPVita{false};
     static constexpr bool             cDefaultAutoDiscoverXLinkKai{false};
+    static constexpr std::string_view cDefaultBroadcastRateLimit{"0"};  // Broadcasts per second per source, 0 is off
+    static constexpr std::string_view cDefaultBroadcastRepeatWindowMs{"100"};
     static constexpr std::string_view cDefaultChannel{"1"};
     static constexpr ConnectionMethod cDefaultConnectionMethod{ConnectionMethod::Plugin};
+    static constexpr bool             cDefaultHardwareCounters{false};
     static constexpr Logger::Level    cDefaultLogLevel{Logger::Level::ERROR};
     static constexpr std::string_view cDefaultOnlyAcceptFromMac;
+    static constexpr bool             cDefaultPaceTransmissions{true};
+    static constexpr bool             cDefaultPinCaptureThreads{false};
     static constexpr std::string_view cDefaultReConnectionTimeOutS{"15"};
+    static constexpr bool             cDefaultSharedXLinkKaiConnection{false};
     static constexpr std::string_view cDefaultTheme{"Default"};
+    static constexpr bool             cDefaultUseIOUring{false};
     static constexpr bool             cDefaultUseSSIDFromHost{false};
     static constexpr bool             cDefaultUseSSIDFromXLinkKai{false};
+    static constexpr bool             cDefaultUseXDP{false};
     static constexpr bool             cDefaultUseXLinkKaiHints{false};
     static constexpr std::string_view cDefaultWifiAdapter;
+    static constexpr std::string_view cDefaultXLinkBusyPollUs{"0"};
     static constexpr std::string_view cDefaultXLinkIp{"127.0.0.1"};
     static constexpr std::string_view cDefaultXLinkPort{"34523"};
+    static constexpr std::string_view cDefaultXLinkReceiveBufferSize{"0"};  // 0 keeps the default of the system
+    static constexpr std::string_view cDefaultXLinkSendBufferSize{"0"};
+
+    // Separator used when multiple wifi adapters are given
+    static constexpr char cWifiAdapterSeparator{','};
 }  // namespace WindowModel_Constants
 
 class WindowModel
@@ -96,41 +129,57 @@ class WindowModel
 public:
     // Settings
     bool        mAcknowledgeDataFrames{WindowModel_Constants::cDefaultAcknowledgeDataFrames};
+    std::string mAdditionalWifiAdapters{WindowModel_Constants::cDefaultAdditionalWifiAdapters};
+    bool        mArpProxy{WindowModel_Constants::cDefaultArpProxy};
+    bool        mArpProxyRemote{WindowModel_Constants::cDefaultArpProxyRemote};
     bool        mAutoDiscoverPSPVitaNetworks{WindowModel_Constants::cDefaultAutoDiscoverPSPVita};
     bool        mAutoDiscoverXLinkKaiInstance{WindowModel_Constants::cDefaultAutoDiscoverXLinkKai};
+    std::string mBroadcastRateLimit{WindowModel_Constants::cDefaultBroadcastRateLimit};
+    std::string mBroadcastRepeatWindowMs{WindowModel_Constants::cDefaultBroadcastRepeatWindowMs};
     std::string mChannel{WindowModel_Constants::cDefaultChannel};
     WindowModel_Constants::ConnectionMethod mConnectionMethod{WindowModel_Constants::cDefaultConnectionMethod};
+    bool                                    mHardwareCounters{WindowModel_Constants::cDefaultHardwareCounters};
     Logger::Level                           mLogLevel{WindowModel_Constants::cDefaultLogLevel};
     std::string                             mOnlyAcceptFromMac{WindowModel_Constants::cDefaultOnlyAcceptFromMac};
+    bool                                    mPaceTransmissions{WindowModel_Constants::cDefaultPaceTransmissions};
+    bool                                    mPinCaptureThreads{WindowModel_Constants::cDefaultPinCaptureThreads};
     std::string                             mReConnectionTimeOutS{WindowModel_Constants::cDefaultReConnectionTimeOutS};
+    bool                                    mSharedXLinkKaiConnection{
+        WindowModel_Constants::cDefaultSharedXLinkKaiConnection};
     std::string                             mTheme{WindowModel_Constants::cDefaultTheme};
+    bool                                    mUseIOUring{WindowModel_Constants::cDefaultUseIOUring};
     bool                                    mUseSSIDFromHost{WindowModel_Constants::cDefaultUseSSIDFromHost};
     bool                                    mUseSSIDFromXLinkKai{WindowModel_Constants::cDefaultUseSSIDFromXLinkKai};
+    bool                                    mUseXDP{WindowModel_Constants::cDefaultUseXDP};
     bool                                    mUseXLinkKaiHints{WindowModel_Constants::cDefaultUseXLinkKaiHints};
     std::string                             mWifiAdapter{WindowModel_Constants::cDefaultWifiAdapter};
+    std::string                             mXLinkBusyPollUs{WindowModel_Constants::cDefaultXLinkBusyPollUs};
     std::string                             mXLinkIp{WindowModel_Constants::cDefaultXLinkIp};
     std::string                             mXLinkPort{WindowModel_Constants::cDefaultXLinkPort};
+    std::string                             mXLinkReceiveBufferSize{
+        WindowModel_Constants::cDefaultXLinkReceiveBufferSize};
+    std::string                             mXLinkSendBufferSize{WindowModel_Constants::cDefaultXLinkSendBufferSize};
 
-    // Statuses
-    WindowModel_Constants::EngineStatus mEngineStatus{WindowModel_Constants::EngineStatus::Idle};
+    // Statuses, written by the engine and read by the user interface
+    Property<WindowModel_Constants::EngineStatus> mEngineStatus{WindowModel_Constants::EngineStatus::Idle};
 
     // Runtime components
-    std::string mCurrentlyConnectedNetwork{};
-    bool        mHosting{false};
-    std::string mProgramPath{};
-    int         mWifiAdapterSelection{0};  // This is going to be converted to a string
+    Property<std::string> mCurrentlyConnectedNetwork{};  //!< Written by the device threads
+    bool                  mHosting{false};
+    std::string           mProgramPath{};
+    int                   mWifiAdapterSelection{0};  // This is going to be converted to a string
 
     // non-descriptive, descriptive
     std::vector<std::pair<std::string, std::string>> mWifiAdapterList{};
 
     // Commands
-    bool                           mAboutSelected{false};
-    WindowModel_Constants::Command mCommand{WindowModel_Constants::Command::NoCommand};
-    bool                           mOptionsSelected{false};
-    bool                           mThemeSelected{false};
-    bool                           mStopProgram{false};
-    bool                           mWindowDone{false};  //!< Tells the program to move to the next step
-    bool                           mWizardSelected{false};
+    bool                                     mAboutSelected{false};
+    Property<WindowModel_Constants::Command> mCommand{WindowModel_Constants::Command::NoCommand};
+    bool                                     mOptionsSelected{false};
+    bool                                     mThemeSelected{false};
+    bool                                     mStopProgram{false};
+    bool                                     mWindowDone{false};  //!< Tells the program to move to the next step
+    bool                                     mWizardSelected{false};
 
     // Command parameters
 
@@ -140,6 +189,12 @@ public:
 
     // Config
 
+    /**
+     * Gets all wifi adapters the engine should use, the first one being mWifiAdapter.
+     * @return List of adapter names, additional adapters are split on cWifiAdapterSeparator.
+     */
+    std::vector<std::string> GetWifiAdapters() const;
+
     /**
      * Saves the config in WindowModel to a file.
      * @param aPath - Path to save it in.
@@ -20,13 +20,14 @@ class WirelessPSPPluginDevice : public WirelessPromiscuousBase
 {
 public:
     explicit WirelessPSPPluginDevice(
-        bool                 aAutoConnect              = false,
-        std::chrono::seconds aReConnectionTimeOut      = WirelessPromiscuousBase_Constants::cReconnectionTimeOut,
-        std::string*         aCurrentlyConnected       = nullptr,
+        bool                   aAutoConnect            = false,
+        std::chrono::seconds   aReConnectionTimeOut    = WirelessPromiscuousBase_Constants::cReconnectionTimeOut,
+        Property<std::string>* aCurrentlyConnected     = nullptr,
         std::shared_ptr<HandlerPSPPlugin> aHandler     = std::make_shared<HandlerPSPPlugin>(),
         std::shared_ptr<IPCapWrapper>     aPcapWrapper = std::make_shared<PCapWrapper>());
 
     void BlackList(uint64_t aMac) override;
+    void RemoveFromBlackList(uint64_t aMac) override;
 
     // Public for easier testing
     bool ReadCallback(const unsigned char* aData, const pcap_pkthdr* aHeader) override;
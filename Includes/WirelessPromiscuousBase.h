@@ -6,7 +6,9 @@
  *
  **/
 
+#include <atomic>
 #include <chrono>
+#include <future>
 #include <memory>
 #include <thread>
 
@@ -15,6 +17,8 @@
 #include "IWifiInterface.h"
 #include "PCapDeviceBase.h"
 #include "PCapWrapper.h"
+#include "Property.h"
+#include "TimerWheel.h"
 
 #if defined(_WIN32) || defined(_WIN64)
 #include "WifiInterfaceWindows.h"
@@ -44,7 +48,7 @@ class WirelessPromiscuousBase : public PCapDeviceBase
 public:
     explicit WirelessPromiscuousBase(bool                          aAutoConnect,
                                      std::chrono::seconds          aReConnectionTimeOut,
-                                     std::string*                  aCurrentlyConnected,
+                                     Property<std::string>*        aCurrentlyConnected,
                                      std::shared_ptr<IPCapWrapper> aPcapWrapper);
 
     void Close() override;
@@ -78,17 +82,29 @@ public:
 
 protected:
     uint64_t&                                           GetAdapterMacAddress();
-    std::chrono::time_point<std::chrono::system_clock>& GetReadWatchdog();
+    std::chrono::time_point<std::chrono::steady_clock>& GetReadWatchdog();
     std::shared_ptr<IPCapWrapper>&                      GetWrapper();
     void                                                SetTitleId(std::string_view aTitleId);
 
 private:
+    /**
+     * Hands a reconnect off to a worker when nothing has been received for too long, otherwise schedules itself again
+     * for when the read watchdog would run out next. Runs on the TimerService.
+     */
+    void CheckReadWatchdog();
+
+    /**
+     * Connects to another network, then schedules the next read watchdog check. Runs on a worker, as scanning and
+     * joining a network can take seconds, which would hold up every other timer.
+     */
+    void Reconnect();
+
     bool                            mConnected{false};
     bool                            mSSIDFromHost{false};
     std::shared_ptr<IPCapWrapper>   mWrapper{nullptr};
     uint64_t                        mAdapterMacAddress{};
     bool                            mAutoConnect{};
-    std::string*                    mCurrentlyConnected{nullptr};
+    Property<std::string>*          mCurrentlyConnected{nullptr};
     IWifiInterface::WifiInformation mCurrentlyConnectedInfo{};
     std::string                     mTitleId{};
     bool                            mPausedAutoConnect{false};
@@ -100,9 +116,10 @@ private:
     std::vector<std::string>        mOldSSIDFilter{};
     std::chrono::seconds            mReConnectionTimeOut{WirelessPromiscuousBase_Constants::cReconnectionTimeOut};
     std::shared_ptr<IWifiInterface> mWifiInterface{nullptr};
-    std::shared_ptr<std::thread>    mWifiTimeoutThread{nullptr};
+    std::atomic<TimerWheel::Id>     mReadWatchdogTimer{0};
+    std::future<void>               mReconnect{};
     /**
      * This timer checks if any data has been received from the connected to network, if not it will try to reconnect.
      */
-    std::chrono::time_point<std::chrono::system_clock> mReadWatchdog{std::chrono::seconds(0)};
+    std::chrono::time_point<std::chrono::steady_clock> mReadWatchdog{std::chrono::seconds(0)};
 };
@@ -10,6 +10,7 @@
 #include <memory>
 #include <thread>
 
+#include "ArpProxy.h"
 #include "Handler8023.h"
 #include "WirelessPromiscuousBase.h"
 
@@ -22,11 +23,19 @@ public:
     explicit WirelessPromiscuousDevice(
         bool                          aAutoConnect         = false,
         std::chrono::seconds          aReConnectionTimeOut = WirelessPromiscuousBase_Constants::cReconnectionTimeOut,
-        std::string*                  aCurrentlyConnected  = nullptr,
+        Property<std::string>*        aCurrentlyConnected  = nullptr,
         std::shared_ptr<Handler8023>  aHandler             = std::make_shared<Handler8023>(),
         std::shared_ptr<IPCapWrapper> aPcapWrapper         = std::make_shared<PCapWrapper>());
 
     void BlackList(uint64_t aMac) override;
+    void RemoveFromBlackList(uint64_t aMac) override;
+
+    /**
+     * Sets which ARP requests the device answers itself, by default none are.
+     * @param aAnswerLocal - Whether to answer requests from the air for hosts behind XLink Kai.
+     * @param aAnswerRemote - Whether to answer requests from XLink Kai for hosts on the air.
+     */
+    void SetArpProxy(bool aAnswerLocal, bool aAnswerRemote);
 
     // Public for easier testing
     bool ReadCallback(const unsigned char* aData, const pcap_pkthdr* aHeader) override;
@@ -34,5 +43,13 @@ public:
     bool Send(std::string_view aData) override;
 
 private:
+    /**
+     * Sends a frame over the air as it is.
+     * @param aData - The frame to send.
+     * @return true if successful.
+     */
+    bool SendPacket(std::string_view aData);
+
     std::shared_ptr<Handler8023> mPacketHandler{nullptr};
+    ArpProxy                     mArpProxy{};
 };
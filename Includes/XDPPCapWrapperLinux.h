@@ -0,0 +1,44 @@
+#pragma once
+
+/* Copyright (c) 2022 [Rick de Bondt] - XDPPCapWrapperLinux.h
+ *
+ * This file contains a pcap wrapper that receives and sends the frames relevant to XLink Kai through AF_XDP.
+ *
+ **/
+
+#if defined(__linux__)
+#include <string>
+
+#include "PCapWrapper.h"
+#include "XDPSocketLinux.h"
+
+/**
+ * Pcap wrapper for adapters that behave like an ethernet device. Frames from the PSP plugin and from consoles are
+ * received through an XDPSocket and handed to the same callback as the frames from libpcap, which still gets
+ * everything else. Dispatch waits on both at once, so neither has to wait for the timeout of the other. Frames are sent
+ * through the XDPSocket as well. Falls back to libpcap when the kernel or the adapter does not support this.
+ */
+class XDPPCapWrapper : public PCapWrapper
+{
+public:
+    int     Activate() override;
+    void    Close() override;
+    pcap_t* Create(const char* source, char* errbuf) override;
+    int     Dispatch(int cnt, pcap_handler callback, unsigned char* user) override;
+    int     SendPacket(std::string_view buffer) override;
+    int     SetTimeOut(int timeout) override;
+    bool    WaitsForPackets() override;
+
+    /**
+     * Checks if AF_XDP is used.
+     * @return true if AF_XDP is used, false if fallen back to libpcap.
+     */
+    [[nodiscard]] bool IsUsingXDP() const;
+
+private:
+    std::string mSource{};
+    XDPSocket   mSocket{};
+    pcap_t*     mHandler{nullptr};
+    int         mTimeOut{1};
+};
+#endif
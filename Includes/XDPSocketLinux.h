@@ -0,0 +1,221 @@
+#pragma once
+
+/* Copyright (c) 2022 [Rick de Bondt] - XDPSocketLinux.h
+ *
+ * This file contains an AF_XDP socket that only gets the frames relevant to XLink Kai, steered to it by a small XDP
+ * program.
+ *
+ **/
+
+#if defined(__linux__)
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <linux/if_xdp.h>
+#include <sys/types.h>
+
+namespace XDPSocket_Constants
+{
+    // Size of a single frame in the shared memory, big enough for any ethernet frame
+    static constexpr uint32_t cFrameSize{2048};
+
+    // Amount of frames for receiving and for sending, the rings are as big as these, powers of two
+    static constexpr uint32_t cReceiveFrames{1024};
+    static constexpr uint32_t cSendFrames{512};
+    static constexpr uint32_t cFrames{cReceiveFrames + cSendFrames};
+
+    // Queue the socket binds to, frames arriving on other queues are left to the stack
+    static constexpr uint32_t cQueue{0};
+
+    // Highest queue index the steering program can redirect
+    static constexpr uint32_t cMaxQueues{64};
+
+    // How long a send waits for the adapter to free up room in a full send ring before giving up
+    static constexpr int cSendWaitMs{10};
+
+    /**
+     * What happened to a frame handed to XDPSocket::Send.
+     */
+    enum class SendResult
+    {
+        Queued,    /**< On its way, the kernel sends it without the caller waiting */
+        NotQueued, /**< The socket cannot take it, the caller should send it itself */
+        Failed     /**< The send ring stayed full, the frame is dropped */
+    };
+
+    // Vendor parts of the mac addresses of Sony consoles, frames from these are what DDS in XLink Kai looks for
+    static constexpr std::array<std::array<uint8_t, 3>, 13> cConsoleVendors{{{0x00, 0x04, 0x1F},
+                                                                            {0x00, 0x13, 0x15},
+                                                                            {0x00, 0x15, 0xC1},
+                                                                            {0x00, 0x19, 0xC5},
+                                                                            {0x00, 0x1D, 0x0D},
+                                                                            {0x00, 0x1F, 0xA7},
+                                                                            {0x00, 0x24, 0x8D},
+                                                                            {0x00, 0xD9, 0xD1},
+                                                                            {0x28, 0x0D, 0xFC},
+                                                                            {0x70, 0x9E, 0x29},
+                                                                            {0xA8, 0xE3, 0xEE},
+                                                                            {0xF8, 0xD0, 0xAC},
+                                                                            {0xFC, 0x0F, 0xE6}}};
+}  // namespace XDPSocket_Constants
+
+/**
+ * AF_XDP socket on a single adapter. A small XDP program attached in generic mode, so it works on any driver, steers
+ * PSP plugin frames (EtherType 0x88C8) and frames sent by consoles to this socket. Everything else stays on the normal
+ * network stack, where libpcap can still see it. Frames are copied between the driver and memory shared with the
+ * kernel, so no system call is needed per received frame.
+ */
+class XDPSocket
+{
+public:
+    XDPSocket() = default;
+    ~XDPSocket();
+    XDPSocket(const XDPSocket& aXDPSocket) = delete;
+    XDPSocket& operator=(const XDPSocket& aXDPSocket) = delete;
+
+    /**
+     * Sets up the socket and attaches the steering program to the adapter.
+     * @param aInterface - Name of the adapter.
+     * @return true if successful, false if the kernel or the adapter does not support this.
+     */
+    bool Open(std::string_view aInterface);
+
+    /**
+     * Detaches the steering program and tears down the socket.
+     */
+    void Close();
+
+    /**
+     * Checks if the socket is set up.
+     * @return true if open.
+     */
+    [[nodiscard]] bool IsOpen() const;
+
+    /**
+     * Gets the file descriptor of the socket, it polls readable when frames have been received.
+     * @return The file descriptor, -1 if not open.
+     */
+    [[nodiscard]] int GetFd() const;
+
+    /**
+     * Calls aFunction for every frame that has been received and then hands the frames back to the kernel. Only one
+     * thread at a time may call this.
+     * @param aFunction - Function taking a std::string_view with the frame, the view is only valid during the call.
+     * @return The amount of frames handled.
+     */
+    template<typename Function> unsigned int ForEachFrame(Function&& aFunction)
+    {
+        unsigned int lProducer{std::atomic_ref<uint32_t>(*mReceiveRing.mProducer).load(std::memory_order_acquire)};
+        unsigned int lConsumer{*mReceiveRing.mConsumer};
+        unsigned int lCount{lProducer - lConsumer};
+        auto*        lDescriptors{static_cast<const xdp_desc*>(mReceiveRing.mDescriptors)};
+
+        for (unsigned int lIndex = lConsumer; lIndex != lProducer; lIndex++) {
+            const xdp_desc& lDescriptor{lDescriptors[lIndex & mReceiveRing.mMask]};
+            aFunction(std::string_view(mMemory + lDescriptor.addr, lDescriptor.len));
+            Refill(lDescriptor.addr);
+        }
+
+        if (lCount > 0) {
+            std::atomic_ref<uint32_t>(*mReceiveRing.mConsumer).store(lProducer, std::memory_order_release);
+            std::atomic_ref<uint32_t>(*mFillRing.mProducer).store(mFillProducer, std::memory_order_release);
+        }
+
+        return lCount;
+    }
+
+    /**
+     * Sends a frame, returns without waiting for the adapter to send it. When the send ring is full this waits for
+     * the adapter to catch up, so frames are never sent ahead of frames queued before them. Safe to call from multiple
+     * threads.
+     * @param aData - The frame to send, copied before returning.
+     * @return Whether the frame was queued, see XDPSocket_Constants::SendResult.
+     */
+    XDPSocket_Constants::SendResult Send(std::string_view aData);
+
+private:
+    /**
+     * A ring shared with the kernel, either holding frame addresses or descriptors.
+     */
+    struct Ring
+    {
+        void*       mMap{nullptr};
+        std::size_t mMapSize{0};
+        uint32_t*   mProducer{nullptr};
+        uint32_t*   mConsumer{nullptr};
+        void*       mDescriptors{nullptr};
+        uint32_t    mMask{0};
+    };
+
+    /**
+     * Maps one of the rings of the socket.
+     * @param aRing - Ring to fill in.
+     * @param aOffsets - Offsets of the ring as gotten from the kernel.
+     * @param aPageOffset - Which ring to map, one of the XDP_PGOFF_ constants.
+     * @param aEntries - Amount of entries in the ring.
+     * @param aEntrySize - Size of a single entry.
+     * @return true if successful.
+     */
+    bool MapRing(
+        Ring& aRing, const xdp_ring_offset& aOffsets, off_t aPageOffset, uint32_t aEntries, std::size_t aEntrySize);
+
+    /**
+     * Creates the maps and loads the steering program into the kernel.
+     * @return true if successful.
+     */
+    bool LoadProgram();
+
+    /**
+     * Attaches the steering program to the adapter in generic mode.
+     * @return true if successful.
+     */
+    bool AttachProgram();
+
+    /**
+     * Puts a frame back on the fill ring, it is not seen by the kernel until the producer is stored.
+     * @param aAddress - Address of the frame, or of anything within it.
+     */
+    void Refill(uint64_t aAddress);
+
+    /**
+     * Takes the frames of sends that are done back, has to be called with mSendMutex held.
+     */
+    void HandleCompletions();
+
+    /**
+     * Asks the kernel to send what is on the send ring, has to be called with mSendMutex held.
+     */
+    void Kick();
+
+    /**
+     * Checks if the send ring can take another frame, has to be called with mSendMutex held.
+     * @return true if there is a free frame and room on the ring.
+     */
+    [[nodiscard]] bool HasSendRoom() const;
+
+    int          mFd{-1};
+    unsigned int mInterfaceIndex{0};
+    char*        mMemory{nullptr};
+
+    Ring     mFillRing{};
+    Ring     mCompletionRing{};
+    Ring     mReceiveRing{};
+    Ring     mSendRing{};
+    uint32_t mFillProducer{0};
+
+    int mSocketMap{-1};
+    int mConsoleMap{-1};
+    int mProgram{-1};
+    int mLink{-1};
+
+    std::mutex            mSendMutex{};
+    std::vector<uint64_t> mFreeFrames{};
+    uint64_t              mFailedSends{0};
+};
+#endif
@@ -6,14 +6,27 @@
  *
  **/
 
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <string>
 #include <thread>
+#include <vector>
 
+#include "BroadcastGovernor.h"
+#include "ForwardingDatabase.h"
 #include "Handler8023.h"
+#include "HardwareCounters.h"
 #include "IConnector.h"
 #include "ITimer.h"
 #include "IUDPSocketWrapper.h"
+#include "LatencyEstimator.h"
+#include "PacedSender.h"
+
+class MonitorDevice;
 
 namespace XLinkKai_Constants
 {
@@ -39,6 +52,42 @@ namespace XLinkKai_Constants
     static constexpr std::chrono::seconds cConnectionTimeout{10};
     static constexpr std::chrono::seconds cKeepAliveTimeout{60};
 
+    // Once there are measurements the timeouts above adapt to XLink Kai, but never go below these
+    static constexpr std::chrono::seconds cMinimumConnectionTimeout{1};
+    static constexpr std::chrono::seconds cMinimumKeepAliveTimeout{5};
+
+    // Amount of keepalive intervals without any message before XLink Kai is considered stalled
+    static constexpr unsigned int cStalledKeepAliveIntervals{3};
+
+    // Amount of round trip times to wait for XLink Kai to confirm a connection
+    static constexpr unsigned int cConnectionRoundTrips{4};
+
+    // Failed connection attempts are retried after a delay that doubles every attempt, between these
+    static constexpr std::chrono::seconds cMinimumReconnectDelay{1};
+    static constexpr std::chrono::seconds cMaximumReconnectDelay{30};
+
+    /**
+     * Measurements of the link with XLink Kai.
+     */
+    struct LinkStatistics
+    {
+        std::chrono::microseconds RoundTripTime{0};          /**< Smoothed time XLink Kai takes to confirm a connect */
+        std::chrono::microseconds RoundTripTimeVariation{0}; /**< Mean deviation of the round trip time */
+        std::chrono::microseconds KeepAliveInterval{0};      /**< Smoothed time between keepalives of XLink Kai */
+        std::chrono::microseconds KeepAliveJitter{0};        /**< Mean deviation of the keepalive interval */
+        uint64_t                  KeepAlivesReceived{0};
+        uint64_t                  ReconnectAttempts{0};
+        std::size_t               MacAddresses{0};         /**< Mac addresses in the forwarding database */
+        uint64_t                  LoopedFrames{0};         /**< Frames dropped because they came back around */
+        uint64_t                  UnknownUnicastFrames{0}; /**< Frames from XLink Kai for no known local device */
+        uint64_t                  QueueDrops{0};           /**< Frames dropped while waiting to be sent over the air */
+        uint64_t                  SuppressedRepeats{0};    /**< Broadcasts not sent as they were just sent before */
+        uint64_t                  RateLimitedBroadcasts{0};
+
+        // Handling data from XLink Kai, only counted while hardware counters are enabled
+        HardwareCounters_Constants::Statistics Cpu{};
+    };
+
     static const std::string cConnectString{std::string(cConnectFormat) + cSeparator.data() +
                                             cLocallyUniqueName.data() + cSeparator.data() + cEmulatorName.data() +
                                             cSeparator.data()};
@@ -78,7 +127,7 @@ using namespace XLinkKai_Constants;
 /**
  * Class that connects to XLink Kai and sends and receives data from and to XLink Kai.
  */
-class XLinkKaiConnection : public IConnector
+class XLinkKaiConnection : public IConnector, public IUDPReceiveHandler
 {
 public:
     /**
@@ -135,6 +184,15 @@ public:
 
     bool Send(std::string_view aData) override;
 
+    /**
+     * Sends data coming from one of the incoming connections, the source Mac address of the data is remembered so
+     * data from XLink Kai for that Mac address only gets sent to that connection.
+     * @param aData - Data to send.
+     * @param aDevice - The device that received the data.
+     * @return true if successful, false on failure.
+     */
+    bool SendFromDevice(std::string_view aData, IPCapDevice& aDevice);
+
     void Close() final;
 
     /**
@@ -149,12 +207,59 @@ public:
      */
     void SetHosting(bool aHosting);
 
+    /**
+     * Whether data from XLink Kai should be delivered to the devices, used to let the handshake with XLink Kai run
+     * while the devices are still being opened. Enabled by default.
+     * @param aEnabled - Set to true to deliver data to the devices, false to drop it.
+     */
+    void SetDeliveryEnabled(bool aEnabled);
+
+    /**
+     * Whether data from XLink Kai should be queued and sent to the devices from a thread per device, paced to the
+     * data rate the device uses and with frames that waited too long dropped. Applies to devices added afterwards,
+     * disabled by default.
+     * @param aPaceTransmissions - Set to true to queue data for the devices, false to send it right away.
+     */
+    void SetPaceTransmissions(bool aPaceTransmissions);
+
+    /**
+     * Limits the broadcasts the devices send to XLink Kai.
+     * @param aRepeatWindow - How long identical broadcasts from a source are suppressed, 0 to send all of them.
+     * @param aRateLimit - Broadcasts per second a single source may send, 0 for no limit.
+     */
+    void SetBroadcastLimits(std::chrono::milliseconds aRepeatWindow, unsigned int aRateLimit);
+
+    /**
+     * Checks whether XLink Kai confirmed the connection.
+     * @return true if connected.
+     */
+    [[nodiscard]] bool IsConnected() const;
+
+    /**
+     * Gets the round trip time and keepalive measurements of the link with XLink Kai, can be called from any thread.
+     * @return The measurements.
+     */
+    [[nodiscard]] XLinkKai_Constants::LinkStatistics GetLinkStatistics() const;
+
     /**
      * Whether or not the SSID from the host should be used in the rest of the program.
      * @param aUseHostSSID - Set to true if host SSID should be used.
      */
     void SetUseHostSSID(bool aUseHostSSID);
 
+    /**
+     * Sets the options of the socket used to talk to XLink Kai, like the size of its buffers.
+     * @param aOptions - The options to use.
+     * @return true if all options could be applied.
+     */
+    bool SetSocketOptions(const UDPSocketWrapper_Constants::SocketOptions& aOptions);
+
+    /**
+     * Handles traffic from XLink Kai.
+     * @param aData - A single message from XLink Kai.
+     */
+    void HandleDatagram(std::string_view aData) override;
+
     /**
      * Sets port to XLink Kai interface.
      * @param aPort - Port to connect to.
@@ -163,11 +268,63 @@ public:
 
     void SetIncomingConnection(std::shared_ptr<IPCapDevice> aDevice) override;
 
+    /**
+     * Adds a device to the devices this connection serves, so multiple devices can share one connection.
+     * Has to be called before the receiver thread is started.
+     * @param aDevice - Device to add.
+     * @return The connector the device should use to send its data, so its Mac addresses can be learned.
+     */
+    std::shared_ptr<IConnector> AddIncomingConnection(std::shared_ptr<IPCapDevice> aDevice);
+
 private:
     /**
-     * Handles traffic from XLink Kai.
+     * A device this connection delivers to, together with the delivery function for its type. The type is resolved
+     * once when the device is added, so delivering data from XLink Kai does not need RTTI.
+     */
+    struct DeliveryTarget
+    {
+        IPCapDevice*   mDevice{nullptr};
+        MonitorDevice* mMonitorDevice{nullptr};
+        void (XLinkKaiConnection::*mDeliver)(const DeliveryTarget& aTarget, std::string_view aData){nullptr};
+        std::shared_ptr<PacedSender> mSender{nullptr}; /**< nullptr if data is sent right away */
+    };
+
+    /**
+     * Creates the delivery target for a device.
+     * @param aDevice - Device to create the target for.
+     * @param aPaceTransmissions - Whether data for the device should be queued.
+     * @return The delivery target.
+     */
+    static DeliveryTarget CreateDeliveryTarget(IPCapDevice& aDevice, bool aPaceTransmissions);
+
+    /**
+     * Sends ethernet data from XLink Kai to a device, specialized for devices that need the data converted.
+     * @param aTarget - Target to send the data to, created for a device of type Device.
+     * @param aData - Ethernet data, mPacketHandler has to be updated with it already.
      */
-    void ReceiveCallback(size_t aBytesReceived);
+    template<typename Device> void DeliverToDevice(const DeliveryTarget& aTarget, std::string_view aData);
+
+    /**
+     * Sends ethernet data from XLink Kai to a delivery target.
+     * @param aTarget - Target to send the data to.
+     * @param aData - Ethernet data, mPacketHandler has to be updated with it already.
+     */
+    void Deliver(const DeliveryTarget& aTarget, std::string_view aData);
+
+    /**
+     * Looks up the delivery target of a device.
+     * @param aDevice - Device to look up.
+     * @return The delivery target, nullptr if the device is not served by this connection.
+     */
+    const DeliveryTarget* FindDeliveryTarget(const IPCapDevice* aDevice) const;
+
+    /**
+     * Learns the source Mac address of ethernet data a device wants to send to XLink Kai.
+     * @param aData - Ethernet data from the device.
+     * @param aDevice - Device the data came from.
+     * @return false if the data came from XLink Kai in the first place and should not be sent back.
+     */
+    bool LearnFromDevice(std::string_view aData, IPCapDevice* aDevice);
 
     /**
      * Sends a keepalive back to the XLink Kai engine, call this function when a keepalive is received.
@@ -175,19 +332,61 @@ private:
      */
     bool HandleKeepAlive();
 
+    /**
+     * Gets how long to wait for XLink Kai to confirm a connection, based on the measured round trip time.
+     * @return The timeout.
+     */
+    std::chrono::milliseconds GetConnectionTimeout() const;
+
+    /**
+     * Gets how long XLink Kai may stay silent before it is considered stalled, based on the measured keepalive
+     * interval.
+     * @return The timeout.
+     */
+    std::chrono::milliseconds GetKeepAliveTimeout() const;
+
+    /**
+     * Schedules the next connection attempt after a failed one, backing off further with every failure.
+     */
+    void ScheduleReconnect();
+
     bool                    mStopCommand{false};
-    bool                    mConnected{false};
+    std::atomic<bool>       mConnected{false};
     bool                    mConnectInitiated{false};
+    std::atomic<bool>       mDeliveryEnabled{true};
+    bool                    mPaceTransmissions{false};
     bool                    mSettingsSent{false};
     std::shared_ptr<ITimer> mConnectionTimer{nullptr};
     std::shared_ptr<ITimer> mKeepAliveTimer{nullptr};
 
-    std::array<char, cMaxLength> mData{};
-    // Raw ethernet data received from XLink Kai
-    std::string                        mEthernetData{};
-    std::string                        mLastESSID{};
-    std::string                        mLastTitleId{};
-    std::shared_ptr<IPCapDevice>       mIncomingConnection{nullptr};
+    // While a reconnect is scheduled the connection timer runs until the next attempt
+    bool                      mReconnectScheduled{false};
+    std::chrono::milliseconds mReconnectDelay{cMinimumReconnectDelay};
+
+    // Link measurements, written by the receiver thread
+    mutable std::mutex                                   mLinkMutex{};
+    LatencyEstimator                                     mRoundTripTime{};
+    LatencyEstimator                                     mKeepAliveInterval{};
+    std::chrono::steady_clock::time_point                mConnectSentTime{};
+    std::optional<std::chrono::steady_clock::time_point> mLastKeepAlive{};
+    uint64_t                                             mKeepAlivesReceived{0};
+    uint64_t                                             mReconnectAttempts{0};
+
+    std::array<char, cMaxLength>              mData{}; /**< Only used by ReadNextData */
+    std::string                               mLastESSID{};
+    std::string                               mLastTitleId{};
+    std::vector<std::shared_ptr<IPCapDevice>> mIncomingConnections{};
+    std::vector<DeliveryTarget>               mDeliveryTargets{};
+
+    // Which side of the bridge every Mac address lives on, learned from the data passing through
+    ForwardingDatabase    mForwardingDatabase{};
+    std::atomic<uint64_t> mLoopedFrames{0};
+    std::atomic<uint64_t> mUnknownUnicastFrames{0};
+
+    // Keeps broadcasts from the devices from flooding XLink Kai
+    BroadcastGovernor mBroadcastGovernor{};
+    HardwareCounters  mHardwareCounters{};
+
     std::string                        mIp{cIp};
     Handler8023                        mPacketHandler{};
     unsigned int                       mPort{cPort};
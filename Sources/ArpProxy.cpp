@@ -0,0 +1,117 @@
+/* Copyright (c) 2022 [Rick de Bondt] - ArpProxy.cpp */
+
+#include "ArpProxy.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "Logger.h"
+#include "NetConversionFunctions.h"
+#include "NetworkingHeaders.h"
+
+using namespace ArpProxy_Constants;
+
+void ArpProxy::SetEnabled(bool aAnswerLocal, bool aAnswerRemote)
+{
+    std::scoped_lock lLock{mMutex};
+    mAnswerLocal  = aAnswerLocal;
+    mAnswerRemote = aAnswerRemote;
+}
+
+std::optional<std::string> ArpProxy::Handle(std::string_view aData, Side aSide, Clock::time_point aNow)
+{
+    std::optional<std::string> lReturn{std::nullopt};
+
+    if (aData.size() >= cPacketLength &&
+        GetRawData<uint16_t>(aData, Net_8023_Constants::cEtherTypeIndex) == Net_Constants::Arp::cEtherType &&
+        GetRawData<uint16_t>(aData, cHardwareTypeIndex) == cHardwareTypeEthernet &&
+        GetRawData<uint16_t>(aData, cProtocolTypeIndex) == cProtocolTypeIPv4 &&
+        GetRawData<uint8_t>(aData, cHardwareSizeIndex) == Net_Constants::cMacAddressLength &&
+        GetRawData<uint8_t>(aData, cProtocolSizeIndex) == cIPv4Length) {
+        uint16_t lOpCode{GetRawData<uint16_t>(aData, Net_Constants::Arp::cOpCodeIndex)};
+        uint64_t lSenderMac{GetRawData<uint64_t>(aData, Net_Constants::Arp::cSenderMacIndex) &
+                            Net_Constants::cBroadcastMac};
+        uint32_t lSenderIp{GetRawData<uint32_t>(aData, cSenderIpIndex)};
+        uint32_t lTargetIp{GetRawData<uint32_t>(aData, cTargetIpIndex)};
+
+        std::scoped_lock lLock{mMutex};
+
+        // A probe has no address of its own yet
+        bool lLearned{lSenderIp == 0 || Learn(lSenderIp, lSenderMac, aSide, aNow)};
+        bool lAnswer{(aSide == Side::Local) ? mAnswerLocal : mAnswerRemote};
+
+        // A gratuitous ARP only announces an address, nobody waits for an answer to it
+        if (lLearned && lAnswer && lOpCode == Net_Constants::Arp::cOpCodeRequest && lTargetIp != lSenderIp) {
+            auto lBinding{mBindings.find(lTargetIp)};
+
+            // Hosts on the same side answer for themselves
+            if (lBinding != mBindings.end() && lBinding->second.mSide != aSide &&
+                (aNow - lBinding->second.mLastSeen) < cAgingTime) {
+                std::string lReply{aData.substr(0, cPacketLength)};
+                uint64_t    lTargetMac{lBinding->second.mMac};
+                uint16_t    lReplyOpCode{Net_Constants::Arp::cOpCodeReply};
+
+                memcpy(lReply.data() + Net_8023_Constants::cDestinationAddressIndex,
+                       &lSenderMac,
+                       Net_Constants::cMacAddressLength);
+                memcpy(lReply.data() + Net_8023_Constants::cSourceAddressIndex,
+                       &lTargetMac,
+                       Net_Constants::cMacAddressLength);
+                memcpy(lReply.data() + Net_Constants::Arp::cOpCodeIndex, &lReplyOpCode, sizeof(lReplyOpCode));
+                memcpy(lReply.data() + Net_Constants::Arp::cSenderMacIndex,
+                       &lTargetMac,
+                       Net_Constants::cMacAddressLength);
+                memcpy(lReply.data() + cSenderIpIndex, &lTargetIp, sizeof(lTargetIp));
+                memcpy(lReply.data() + Net_Constants::Arp::cTargetMacIndex,
+                       &lSenderMac,
+                       Net_Constants::cMacAddressLength);
+                memcpy(lReply.data() + cTargetIpIndex, &lSenderIp, sizeof(lSenderIp));
+
+                Logger::GetInstance().Log("Answered ARP request from " + IntToMac(lSenderMac) + " with " +
+                                              IntToMac(lTargetMac),
+                                          Logger::Level::DEBUG);
+
+                mAnswered++;
+                lReturn = std::move(lReply);
+            }
+        }
+    }
+
+    return lReturn;
+}
+
+uint64_t ArpProxy::GetAnswered() const
+{
+    std::scoped_lock lLock{mMutex};
+    return mAnswered;
+}
+
+bool ArpProxy::Learn(uint32_t aIp, uint64_t aMac, Side aSide, Clock::time_point aNow)
+{
+    bool lReturn{true};
+
+    auto lBinding{mBindings.find(aIp)};
+    if (lBinding != mBindings.end() && lBinding->second.mSide != aSide &&
+        (aNow - lBinding->second.mLastSeen) < cAgingTime) {
+        lReturn = false;
+    } else {
+        if (lBinding == mBindings.end() && mBindings.size() >= cMaxEntries) {
+            EvictOldest();
+        }
+
+        mBindings.insert_or_assign(aIp, Binding{aMac, aSide, aNow});
+    }
+
+    return lReturn;
+}
+
+void ArpProxy::EvictOldest()
+{
+    auto lOldest{std::min_element(mBindings.begin(), mBindings.end(), [](const auto& aFirst, const auto& aSecond) {
+        return aFirst.second.mLastSeen < aSecond.second.mLastSeen;
+    })};
+
+    if (lOldest != mBindings.end()) {
+        mBindings.erase(lOldest);
+    }
+}
@@ -0,0 +1,91 @@
+/* Copyright (c) 2022 [Rick de Bondt] - BroadcastGovernor.cpp */
+
+#include "BroadcastGovernor.h"
+
+#include <algorithm>
+#include <functional>
+
+#include "NetConversionFunctions.h"
+#include "NetworkingHeaders.h"
+
+using namespace BroadcastGovernor_Constants;
+
+BroadcastGovernor::BroadcastGovernor(Clock::duration aRepeatWindow, unsigned int aRateLimit) :
+    mRepeatWindow(aRepeatWindow), mRateLimit(aRateLimit)
+{}
+
+void BroadcastGovernor::SetLimits(Clock::duration aRepeatWindow, unsigned int aRateLimit)
+{
+    std::scoped_lock lLock{mMutex};
+    mRepeatWindow = aRepeatWindow;
+    mRateLimit    = aRateLimit;
+}
+
+std::size_t BroadcastGovernor::KeyHash::operator()(const Key& aKey) const
+{
+    // Mac addresses only use the lower 48 bits, leaving room for the EtherType
+    return std::hash<uint64_t>{}(aKey.mSourceMac ^ (uint64_t{aKey.mEtherType} << 48U)) ^ aKey.mPayloadHash;
+}
+
+bool BroadcastGovernor::Allow(std::string_view aData, Clock::time_point aNow)
+{
+    bool lReturn{true};
+
+    if (aData.size() >= Net_8023_Constants::cHeaderLength &&
+        (static_cast<uint8_t>(aData.at(Net_8023_Constants::cDestinationAddressIndex)) &
+         Net_Constants::cGroupAddressBit) != 0) {
+        Key lKey{GetRawData<uint64_t>(aData, Net_8023_Constants::cSourceAddressIndex) & Net_Constants::cBroadcastMac,
+                 GetRawData<uint16_t>(aData, Net_8023_Constants::cEtherTypeIndex),
+                 std::hash<std::string_view>{}(aData.substr(Net_8023_Constants::cDataIndex))};
+
+        std::scoped_lock lLock{mMutex};
+
+        if (aNow >= mNextSweep) {
+            Sweep(aNow);
+            mNextSweep = aNow + cForgetTime;
+        }
+
+        auto lLastForwarded{mLastForwarded.find(lKey)};
+        if (lLastForwarded != mLastForwarded.end() && (aNow - lLastForwarded->second) < mRepeatWindow) {
+            mStatistics.Repeats++;
+            lReturn = false;
+        } else if (mRateLimit > 0) {
+            // A new source starts with a full bucket, a second worth of broadcasts
+            auto [lBucket, lNew]{mBuckets.try_emplace(lKey.mSourceMac, Bucket{double(mRateLimit), aNow})};
+            if (!lNew) {
+                std::chrono::duration<double> lElapsed{aNow - lBucket->second.mLastRefill};
+                lBucket->second.mTokens     = std::min(double(mRateLimit),
+                                                   lBucket->second.mTokens + lElapsed.count() * mRateLimit);
+                lBucket->second.mLastRefill = aNow;
+            }
+
+            if (lBucket->second.mTokens >= 1) {
+                lBucket->second.mTokens -= 1;
+            } else {
+                mStatistics.RateLimited++;
+                lReturn = false;
+            }
+        }
+
+        if (lReturn) {
+            mLastForwarded.insert_or_assign(lKey, aNow);
+            mStatistics.Forwarded++;
+        }
+    }
+
+    return lReturn;
+}
+
+BroadcastGovernor_Constants::Statistics BroadcastGovernor::GetStatistics() const
+{
+    std::scoped_lock lLock{mMutex};
+    return mStatistics;
+}
+
+void BroadcastGovernor::Sweep(Clock::time_point aNow)
+{
+    std::erase_if(mLastForwarded, [&](const auto& aEntry) {
+        return (aNow - aEntry.second) >= std::max<Clock::duration>(mRepeatWindow, cForgetTime);
+    });
+    std::erase_if(mBuckets, [&](const auto& aEntry) { return (aNow - aEntry.second.mLastRefill) >= cForgetTime; });
+}
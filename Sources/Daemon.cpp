@@ -0,0 +1,442 @@
+/* Copyright (c) 2022 [Rick de Bondt] - Daemon.cpp */
+
+#include "Daemon.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <iomanip>
+#include <sstream>
+
+#include "HardwareCounters.h"
+#include "Logger.h"
+
+using namespace Daemon_Constants;
+using HardwareCounters_Constants::Counter;
+
+namespace
+{
+    // Averages of the hardware counters as statistics, every key starting with aPrefix
+    std::string CreateCounterStatistics(std::string_view                              aPrefix,
+                                        const HardwareCounters_Constants::Statistics& aStatistics)
+    {
+        std::stringstream lReturn{};
+        lReturn << std::fixed << std::setprecision(1) << " " << aPrefix << "cycles_per_packet "
+                << aStatistics.GetPerPacket(Counter::Cycles) << " " << aPrefix << "instructions_per_packet "
+                << aStatistics.GetPerPacket(Counter::Instructions) << " " << aPrefix << "cache_misses_per_packet "
+                << aStatistics.GetPerPacket(Counter::CacheMisses) << " " << aPrefix << "branch_misses_per_packet "
+                << aStatistics.GetPerPacket(Counter::BranchMisses);
+        return lReturn.str();
+    }
+}  // namespace
+
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+/**
+ * A single connection to the control socket, reads commands line by line and writes the replies in order.
+ */
+class Daemon::Session : public std::enable_shared_from_this<Daemon::Session>
+{
+public:
+    Session(Daemon& aDaemon, boost::asio::local::stream_protocol::socket aSocket) :
+        mDaemon(aDaemon), mSocket(std::move(aSocket))
+    {}
+
+    void Read()
+    {
+        boost::asio::async_read_until(
+            mSocket,
+            mBuffer,
+            '\n',
+            [lSelf = shared_from_this()](const boost::system::error_code& aError, std::size_t aLength) {
+                lSelf->ReadCallback(aError, aLength);
+            });
+    }
+
+private:
+    void ReadCallback(const boost::system::error_code& aError, std::size_t aLength)
+    {
+        // Errors include lines longer than cMaxCommandLength, just drop the connection in that case
+        if (!aError) {
+            std::string lLine{boost::asio::buffers_begin(mBuffer.data()),
+                              boost::asio::buffers_begin(mBuffer.data()) + static_cast<std::ptrdiff_t>(aLength)};
+            mBuffer.consume(aLength);
+
+            while (!lLine.empty() && (lLine.back() == '\n' || lLine.back() == '\r')) {
+                lLine.pop_back();
+            }
+
+            std::optional<Request> lRequest{ParseRequest(lLine)};
+            if (lRequest.has_value()) {
+                // Replies come from the thread running the daemon, so hand them back to the io thread
+                mDaemon.Post({lRequest.value(), [lSelf = shared_from_this()](std::string aReply) {
+                                  boost::asio::post(lSelf->mSocket.get_executor(),
+                                                    [lSelf, lReply = std::move(aReply)] { lSelf->Write(lReply); });
+                              }});
+            } else {
+                Write(std::string(cReplyError) + "unknown command " + lLine);
+            }
+
+            Read();
+        }
+    }
+
+    void Write(std::string_view aReply)
+    {
+        mReplies.emplace_back(std::string(aReply) + "\n");
+
+        // Only one write can be in flight, the callback picks up the rest
+        if (mReplies.size() == 1) {
+            WriteNext();
+        }
+    }
+
+    void WriteNext()
+    {
+        boost::asio::async_write(
+            mSocket,
+            boost::asio::buffer(mReplies.front()),
+            [lSelf = shared_from_this()](const boost::system::error_code& aError, std::size_t /*aLength*/) {
+                lSelf->mReplies.pop_front();
+                if (!aError && !lSelf->mReplies.empty()) {
+                    lSelf->WriteNext();
+                }
+            });
+    }
+
+    Daemon&                                     mDaemon;
+    boost::asio::local::stream_protocol::socket mSocket;
+    boost::asio::streambuf                      mBuffer{cMaxCommandLength};
+    std::deque<std::string>                     mReplies{};
+};
+#endif
+
+Daemon::Daemon(WindowModel& aModel) : mModel(aModel), mEngine(aModel) {}
+
+Daemon::~Daemon()
+{
+    mIoService.stop();
+    if (mIoThread.joinable()) {
+        mIoThread.join();
+    }
+
+    // These can hold on to sessions, which have to go before the io service does
+    mRequests.clear();
+    mStartReplies.clear();
+
+    if (!mSocketPath.empty()) {
+        std::remove(mSocketPath.c_str());
+    }
+}
+
+bool Daemon::Open(std::string_view aPath)
+{
+    bool lReturn{false};
+
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+    try {
+        // A socket file left behind by an earlier run would make binding fail
+        mSocketPath = aPath;
+        std::remove(mSocketPath.c_str());
+
+        mAcceptor = std::make_unique<boost::asio::local::stream_protocol::acceptor>(mIoService);
+        mAcceptor->open();
+        mAcceptor->bind(boost::asio::local::stream_protocol::endpoint(mSocketPath));
+
+        // The daemon runs as root, so only root gets to send it commands. Restricted before listening, so nobody
+        // can connect in between.
+        std::error_code lError{};
+        std::filesystem::permissions(
+            mSocketPath, std::filesystem::perms::owner_read | std::filesystem::perms::owner_write, lError);
+        if (!lError) {
+            mAcceptor->listen();
+            Accept();
+
+            mIoThread = std::thread([&] { mIoService.run(); });
+
+            Logger::GetInstance().Log("Control socket opened on " + mSocketPath, Logger::Level::INFO);
+            lReturn = true;
+        } else {
+            Logger::GetInstance().Log(
+                "Could not restrict access to control socket " + mSocketPath + ": " + lError.message(),
+                Logger::Level::ERROR);
+            mAcceptor = nullptr;
+            std::remove(mSocketPath.c_str());
+            mSocketPath.clear();
+        }
+    } catch (const boost::system::system_error& lException) {
+        Logger::GetInstance().Log("Could not open control socket " + std::string(aPath) + ": " + lException.what(),
+                                  Logger::Level::ERROR);
+        mSocketPath.clear();
+    }
+#else
+    Logger::GetInstance().Log("Control sockets are not supported on this platform", Logger::Level::ERROR);
+#endif
+
+    return lReturn;
+}
+
+void Daemon::Accept()
+{
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+    mAcceptor->async_accept([&](const boost::system::error_code&             aError,
+                                boost::asio::local::stream_protocol::socket aSocket) {
+        if (!aError) {
+            std::make_shared<Session>(*this, std::move(aSocket))->Read();
+            Accept();
+        } else if (aError != boost::asio::error::operation_aborted && mAcceptor->is_open()) {
+            // Mostly out of file descriptors, trying again right away would only spin
+            Logger::GetInstance().Log("Could not accept control connection: " + aError.message(),
+                                      Logger::Level::WARNING);
+            mAcceptRetryTimer.expires_after(cAcceptRetryTime);
+            mAcceptRetryTimer.async_wait([&](const boost::system::error_code& aTimerError) {
+                if (!aTimerError) {
+                    Accept();
+                }
+            });
+        }
+    });
+#endif
+}
+
+std::optional<Request> Daemon::ParseRequest(std::string_view aLine)
+{
+    std::optional<Request> lReturn{};
+
+    std::string_view lCommand{aLine.substr(0, aLine.find(' '))};
+    std::string_view lArgument{};
+    if (lCommand.size() < aLine.size()) {
+        lArgument = aLine.substr(lCommand.size() + 1);
+    }
+
+    if (lArgument.empty()) {
+        if (lCommand == cCommandStart) {
+            lReturn = Request{Command::Start};
+        } else if (lCommand == cCommandStop) {
+            lReturn = Request{Command::Stop};
+        } else if (lCommand == cCommandReConnect) {
+            lReturn = Request{Command::ReConnect};
+        } else if (lCommand == cCommandStats) {
+            lReturn = Request{Command::Stats};
+        } else if (lCommand == cCommandStatus) {
+            lReturn = Request{Command::Status};
+        }
+    } else if (lCommand == cCommandHosting && (lArgument == cArgumentOn || lArgument == cArgumentOff)) {
+        lReturn = Request{Command::Hosting, lArgument == cArgumentOn};
+    }
+
+    return lReturn;
+}
+
+void Daemon::Post(PendingRequest aRequest)
+{
+    {
+        std::scoped_lock lLock{mMutex};
+        mRequests.emplace_back(std::move(aRequest));
+    }
+
+    mCondition.notify_one();
+}
+
+void Daemon::Stop()
+{
+    {
+        std::scoped_lock lLock{mMutex};
+        mStopCommand = true;
+    }
+
+    mCondition.notify_one();
+}
+
+void Daemon::Run()
+{
+    // Same as verbose mode, start right away
+    PendingRequest lStart{Request{Command::Start}, nullptr};
+    Handle(lStart);
+
+    std::unique_lock lLock{mMutex};
+    while (!mStopCommand) {
+        // Only wake up for requests, unless the engine is starting or a retry is planned
+        auto lWakeUp{[&] { return mStopCommand || !mRequests.empty(); }};
+        if (mEngine.IsStarting()) {
+            mCondition.wait_for(lLock, std::chrono::milliseconds(100), lWakeUp);
+        } else if (mRetryTime.has_value()) {
+            mCondition.wait_until(lLock, mRetryTime.value(), lWakeUp);
+        } else {
+            mCondition.wait(lLock, lWakeUp);
+        }
+
+        std::deque<PendingRequest> lRequests{};
+        lRequests.swap(mRequests);
+
+        // Don't hold the lock while working on the engine, so requests can still be queued
+        lLock.unlock();
+
+        if (mEngine.IsStarting()) {
+            std::optional<Engine_Constants::StartResult> lResult{mEngine.GetStartResult()};
+            if (lResult.has_value()) {
+                HandleStartResult(lResult.value());
+            }
+        } else if (mRetryTime.has_value() && std::chrono::steady_clock::now() >= mRetryTime.value()) {
+            mRetryTime.reset();
+            mEngine.StartAsync();
+        }
+
+        for (auto& lRequest : lRequests) {
+            Handle(lRequest);
+        }
+
+        lLock.lock();
+    }
+
+    lLock.unlock();
+
+    mModel.mEngineStatus.Set(WindowModel_Constants::EngineStatus::Idle);
+    mEngine.Stop();
+}
+
+void Daemon::Handle(PendingRequest& aRequest)
+{
+    std::string lReply{cReplyOk};
+
+    switch (aRequest.mRequest.Type) {
+        case Command::Start:
+            if (mEngine.IsStarting()) {
+                // Reply when the start that is already running is done
+                mStartReplies.emplace_back(aRequest.mReply);
+                aRequest.mReply = nullptr;
+            } else if (mModel.mEngineStatus.Get() == WindowModel_Constants::EngineStatus::Running) {
+                lReply = std::string(cReplyError) + "already running";
+            } else {
+                if (mModel.mLogLevel != Logger::GetInstance().GetLogLevel()) {
+                    Logger::GetInstance().SetLogLevel(mModel.mLogLevel);
+                }
+
+                mRetryTime.reset();
+                mModel.mEngineStatus.Set(WindowModel_Constants::EngineStatus::Starting);
+                mEngine.StartAsync();
+                mStartReplies.emplace_back(aRequest.mReply);
+                aRequest.mReply = nullptr;
+            }
+            break;
+        case Command::Stop:
+            // Waits for a start that is still running
+            mRetryTime.reset();
+            mEngine.Stop();
+            ReplyToStart(std::string(cReplyError) + "stopped");
+            mModel.mCurrentlyConnectedNetwork.Set("");
+            mModel.mEngineStatus.Set(WindowModel_Constants::EngineStatus::Idle);
+            break;
+        case Command::ReConnect:
+            if (mModel.mEngineStatus.Get() == WindowModel_Constants::EngineStatus::Running) {
+                mEngine.ReConnect();
+            } else {
+                lReply = std::string(cReplyError) + "not running";
+            }
+            break;
+        case Command::Hosting:
+            mModel.mHosting = aRequest.mRequest.Hosting;
+            mEngine.SetHosting(mModel.mHosting);
+            break;
+        case Command::Stats:
+            lReply = CreateStatistics() + lReply;
+            break;
+        case Command::Status:
+            lReply = std::string(WindowModel_Constants::cEngineStatusTexts.at(mModel.mEngineStatus.Get())) + "\n" +
+                     lReply;
+            break;
+    }
+
+    if (aRequest.mReply != nullptr) {
+        aRequest.mReply(lReply);
+    }
+}
+
+void Daemon::HandleStartResult(Engine_Constants::StartResult aResult)
+{
+    std::string lReply{cReplyOk};
+
+    switch (aResult) {
+        case Engine_Constants::StartResult::Success:
+            mModel.mEngineStatus.Set(WindowModel_Constants::EngineStatus::Running);
+            break;
+        case Engine_Constants::StartResult::ConnectorFailed:
+            Logger::GetInstance().Log("Failed to open connection to XLink Kai, retrying in 10 seconds!",
+                                      Logger::Level::ERROR);
+            mModel.mEngineStatus.Set(WindowModel_Constants::EngineStatus::Starting);
+            mRetryTime           = std::chrono::steady_clock::now() + cRetryTime;
+            lReply               = std::string(cReplyError) + "could not connect to XLink Kai, retrying";
+            break;
+        case Engine_Constants::StartResult::DeviceFailed:
+            mModel.mEngineStatus.Set(WindowModel_Constants::EngineStatus::Error);
+            mEngine.Stop();
+            lReply = std::string(cReplyError) + "could not start the adapters";
+            break;
+        case Engine_Constants::StartResult::UnknownMethod:
+            mModel.mEngineStatus.Set(WindowModel_Constants::EngineStatus::Error);
+            lReply               = std::string(cReplyError) + "connection method not supported";
+            break;
+        case Engine_Constants::StartResult::Cancelled:
+            lReply = std::string(cReplyError) + "stopped";
+            break;
+    }
+
+    ReplyToStart(lReply);
+}
+
+void Daemon::ReplyToStart(const std::string& aReply)
+{
+    for (auto& lStartReply : mStartReplies) {
+        if (lStartReply != nullptr) {
+            lStartReply(aReply);
+        }
+    }
+
+    mStartReplies.clear();
+}
+
+std::string Daemon::CreateStatistics() const
+{
+    std::string lReturn{};
+
+    // The adapters are only safe to look at when the engine is not busy starting
+    if (!mEngine.IsStarting()) {
+        for (const auto& lStatistics : mEngine.GetStatistics()) {
+            lReturn += "adapter " + lStatistics.Name + " network " + lStatistics.ConnectedNetwork + " received " +
+                       std::to_string(lStatistics.Device.PacketsReceived) + " " +
+                       std::to_string(lStatistics.Device.BytesReceived) + " sent " +
+                       std::to_string(lStatistics.Device.PacketsSent) + " " +
+                       std::to_string(lStatistics.Device.BytesSent) + " errors " +
+                       std::to_string(lStatistics.Device.SendErrors) + " rtt_us " +
+                       std::to_string(lStatistics.Link.RoundTripTime.count()) + " keepalive_us " +
+                       std::to_string(lStatistics.Link.KeepAliveInterval.count()) + " jitter_us " +
+                       std::to_string(lStatistics.Link.KeepAliveJitter.count()) + " reconnects " +
+                       std::to_string(lStatistics.Link.ReconnectAttempts) + " macs " +
+                       std::to_string(lStatistics.Link.MacAddresses) + " looped " +
+                       std::to_string(lStatistics.Link.LoopedFrames) + " unknown_unicast " +
+                       std::to_string(lStatistics.Link.UnknownUnicastFrames) + " queue_drops " +
+                       std::to_string(lStatistics.Link.QueueDrops) + " broadcast_repeats " +
+                       std::to_string(lStatistics.Link.SuppressedRepeats) + " broadcast_limited " +
+                       std::to_string(lStatistics.Link.RateLimitedBroadcasts);
+
+            // Only there in the instrumentation mode, reading the counters costs time
+            if (HardwareCounters::IsEnabled()) {
+                lReturn += CreateCounterStatistics("", lStatistics.Device.Cpu) +
+                           CreateCounterStatistics("kai_", lStatistics.Link.Cpu);
+            }
+
+            lReturn += "\n";
+        }
+    }
+
+    for (const auto& lReadiness : mEngine.GetReadiness()) {
+        std::string_view lState{"pending"};
+        if (lReadiness.State == Engine_Constants::Readiness::Ready) {
+            lState = "ready";
+        } else if (lReadiness.State == Engine_Constants::Readiness::Failed) {
+            lState = "failed";
+        }
+
+        lReturn += "component " + lReadiness.Name + " " + std::string(lState) + "\n";
+    }
+
+    return lReturn;
+}
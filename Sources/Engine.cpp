@@ -0,0 +1,488 @@
+/* Copyright (c) 2022 [Rick de Bondt] - Engine.cpp */
+
+#include "Engine.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+
+#include "FlightRecorder.h"
+#include "HardwareCounters.h"
+#include "Logger.h"
+#include "MonitorDevice.h"
+#include "UDPSocketWrapper.h"
+#include "NetConversionFunctions.h"
+#include "WirelessPSPPluginDevice.h"
+#include "WirelessPromiscuousDevice.h"
+
+#if defined(__linux__)
+#include "XDPPCapWrapperLinux.h"
+#endif
+
+#if defined(ENABLE_IO_URING)
+#include "IOUringPCapWrapperLinux.h"
+#include "IOUringUDPSocketWrapperLinux.h"
+#endif
+
+using namespace Engine_Constants;
+using HardwareCounters_Constants::Counter;
+
+Engine::Engine(WindowModel& aModel) : mModel(aModel)
+{
+    // Next to the log, instead of wherever the program happened to be started from
+    if (!mModel.mProgramPath.empty()) {
+        FlightRecorder::GetInstance().SetDumpDirectory(mModel.mProgramPath);
+    }
+}
+
+Engine::~Engine()
+{
+    Stop();
+}
+
+std::shared_ptr<IPCapWrapper> Engine::CreatePCapWrapper() const
+{
+#if defined(__linux__)
+    // Monitor mode captures 802.11 frames, which the steering program does not understand
+    if (mModel.mUseXDP && mConnectionMethod != WindowModel_Constants::ConnectionMethod::Monitor) {
+        return std::make_shared<XDPPCapWrapper>();
+    }
+#endif
+
+#if defined(ENABLE_IO_URING)
+    if (mModel.mUseIOUring) {
+        return std::make_shared<IOUringPCapWrapper>();
+    }
+#endif
+    return std::make_shared<PCapWrapper>();
+}
+
+std::shared_ptr<IUDPSocketWrapper> Engine::CreateSocketWrapper() const
+{
+#if defined(ENABLE_IO_URING)
+    if (mModel.mUseIOUring) {
+        return std::make_shared<IOUringUDPSocketWrapper>();
+    }
+#else
+    if (mModel.mUseIOUring) {
+        Logger::GetInstance().Log("This build has no io_uring support, using regular sockets", Logger::Level::WARNING);
+    }
+#endif
+    return std::make_shared<UDPSocketWrapper>();
+}
+
+std::shared_ptr<IPCapDevice> Engine::CreateDevice(Property<std::string>* aCurrentlyConnectedNetwork)
+{
+    std::shared_ptr<IPCapDevice> lDevice{nullptr};
+
+    switch (mConnectionMethod) {
+        case WindowModel_Constants::ConnectionMethod::Plugin:
+            lDevice = std::make_shared<WirelessPSPPluginDevice>(
+                mModel.mAutoDiscoverPSPVitaNetworks,
+                std::chrono::seconds(std::stoi(mModel.mReConnectionTimeOutS)),
+                aCurrentlyConnectedNetwork,
+                std::make_shared<HandlerPSPPlugin>(),
+                CreatePCapWrapper());
+
+            Logger::GetInstance().Log("Plugin Device created!", Logger::Level::INFO);
+            break;
+        case WindowModel_Constants::ConnectionMethod::Promiscuous:
+            lDevice = std::make_shared<WirelessPromiscuousDevice>(
+                mModel.mAutoDiscoverPSPVitaNetworks,
+                std::chrono::seconds(std::stoi(mModel.mReConnectionTimeOutS)),
+                aCurrentlyConnectedNetwork,
+                std::make_shared<Handler8023>(),
+                CreatePCapWrapper());
+            std::static_pointer_cast<WirelessPromiscuousDevice>(lDevice)->SetArpProxy(
+                mModel.mArpProxy, mModel.mArpProxy && mModel.mArpProxyRemote);
+
+            Logger::GetInstance().Log("Promiscuous Device created!", Logger::Level::INFO);
+            break;
+#if not defined(_WIN32) && not defined(_WIN64)
+        case WindowModel_Constants::ConnectionMethod::Monitor:
+            lDevice = std::make_shared<MonitorDevice>(MacToInt(mModel.mOnlyAcceptFromMac),
+                                                      mModel.mAcknowledgeDataFrames,
+                                                      aCurrentlyConnectedNetwork,
+                                                      CreatePCapWrapper());
+
+            Logger::GetInstance().Log("Monitor Device created!", Logger::Level::INFO);
+            break;
+#endif
+        default:
+            Logger::GetInstance().Log("Unknown method!", Logger::Level::ERROR);
+            break;
+    }
+
+    return lDevice;
+}
+
+bool Engine::CreateAdapters()
+{
+    bool lReturn{true};
+
+    if (mAdapters.empty()) {
+        for (const auto& lName : mModel.GetWifiAdapters()) {
+            auto lAdapter{std::make_shared<Adapter>()};
+            lAdapter->mName = lName;
+
+            // The first adapter is the one shown in the user interface
+            lAdapter->mDevice = CreateDevice(mAdapters.empty() ? &mModel.mCurrentlyConnectedNetwork :
+                                                                 &lAdapter->mCurrentlyConnectedNetwork);
+
+            if (lAdapter->mDevice != nullptr) {
+                // When sharing, every adapter uses the connection of the first adapter
+                lAdapter->mConnection = (mModel.mSharedXLinkKaiConnection && !mAdapters.empty()) ?
+                                            mAdapters.front()->mConnection :
+                                            std::make_shared<XLinkKaiConnection>(CreateSocketWrapper());
+                mAdapters.emplace_back(lAdapter);
+            } else {
+                lReturn = false;
+                break;
+            }
+        }
+
+        if (!lReturn) {
+            mAdapters.clear();
+        }
+    }
+
+    return lReturn;
+}
+
+StartResult Engine::Start()
+{
+    StartResult lReturn{StartResult::Success};
+
+    // Completely reset the devices and xlink kai connections on a mode switch
+    if (mConnectionMethod != mModel.mConnectionMethod) {
+        for (auto& lConnection : GetConnections()) {
+            lConnection->Close();
+        }
+        mAdapters.clear();
+    }
+
+    mConnectionMethod = mModel.mConnectionMethod;
+    HardwareCounters::SetEnabled(mModel.mHardwareCounters);
+
+    if (CreateAdapters()) {
+        mSSIDFilters.clear();
+
+        // If we are auto discovering PSP/VITA networks add those to the filter list
+        if (mModel.mAutoDiscoverPSPVitaNetworks) {
+            mSSIDFilters.emplace_back(Net_Constants::cPSPSSIDFilterName.data());
+            mSSIDFilters.emplace_back(Net_Constants::cVitaSSIDFilterName.data());
+        }
+
+        for (auto& lAdapter : mAdapters) {
+            lAdapter->mConnection->SetPaceTransmissions(mModel.mPaceTransmissions);
+            if (mModel.mSharedXLinkKaiConnection) {
+                lAdapter->mDevice->SetConnector(lAdapter->mConnection->AddIncomingConnection(lAdapter->mDevice));
+            } else {
+                lAdapter->mConnection->SetIncomingConnection(lAdapter->mDevice);
+                lAdapter->mDevice->SetConnector(lAdapter->mConnection);
+            }
+        }
+
+        // The handshake with XLink Kai runs in the receiver threads of the connections, while the adapters are opened
+        lReturn = StartConnections();
+
+        if (lReturn == StartResult::Success && !mStopRequested) {
+            lReturn = StartAdapters();
+        }
+
+        // Whatever did get started is closed by Stop
+        if (mStopRequested) {
+            lReturn = StartResult::Cancelled;
+        }
+
+        if (lReturn == StartResult::Success) {
+            for (auto& lConnection : GetConnections()) {
+                lConnection->SetDeliveryEnabled(true);
+            }
+        }
+    } else {
+        lReturn = StartResult::UnknownMethod;
+    }
+
+    return lReturn;
+}
+
+StartResult Engine::StartConnections()
+{
+    StartResult lReturn{StartResult::Success};
+
+    // Set the XLink Kai connections up, if we are autodiscovering we don't need to provide an IP
+    std::vector<std::shared_ptr<XLinkKaiConnection>> lConnections{GetConnections()};
+    for (std::size_t lCount = 0; lCount < lConnections.size(); lCount++) {
+        auto&       lConnection{lConnections.at(lCount)};
+        std::string lName{"XLink Kai" + (lCount > 0 ? " " + std::to_string(lCount + 1) : "")};
+
+        SetReadiness(lName, Readiness::Pending, lConnection);
+        lConnection->SetUseHostSSID(mModel.mUseSSIDFromHost);
+        lConnection->SetDeliveryEnabled(false);
+
+        bool lSuccess{false};
+        try {
+            lConnection->SetBroadcastLimits(std::chrono::milliseconds(std::stoi(mModel.mBroadcastRepeatWindowMs)),
+                                            std::stoi(mModel.mBroadcastRateLimit));
+            lConnection->SetSocketOptions({std::stoi(mModel.mXLinkReceiveBufferSize),
+                                           std::stoi(mModel.mXLinkSendBufferSize),
+                                           std::stoi(mModel.mXLinkBusyPollUs)});
+
+            if (!mModel.mAutoDiscoverXLinkKaiInstance) {
+                lSuccess = lConnection->Open(mModel.mXLinkIp, std::stoi(mModel.mXLinkPort));
+            } else {
+                lSuccess = lConnection->Open("");
+            }
+        } catch (std::exception& aException) {
+            // The config file gets checked when loading, but the port can still be typed in wrong
+            Logger::GetInstance().Log(std::string("Invalid XLink Kai setting: ") + aException.what(),
+                                      Logger::Level::ERROR);
+        }
+
+        if (lSuccess && !lConnection->StartReceiverThread()) {
+            Logger::GetInstance().Log("Failed to start XLink Kai receiver thread", Logger::Level::ERROR);
+            lSuccess = false;
+        }
+
+        if (!lSuccess) {
+            SetReadiness(lName, Readiness::Failed, lConnection);
+            lReturn = StartResult::ConnectorFailed;
+            break;
+        }
+    }
+
+    // Don't leave half of the connections running when retrying
+    if (lReturn != StartResult::Success) {
+        for (auto& lConnection : lConnections) {
+            lConnection->Close();
+        }
+    }
+
+    return lReturn;
+}
+
+StartResult Engine::StartAdapters()
+{
+    StartResult lReturn{StartResult::Success};
+
+    // Now set up the wifi interfaces, all at the same time because opening one can include scanning for networks
+    unsigned int                   lCPUCount{std::thread::hardware_concurrency()};
+    unsigned int                   lIndex{0};
+    std::vector<std::future<bool>> lResults{};
+    for (auto& lAdapter : mAdapters) {
+        if (mModel.mPinCaptureThreads && lCPUCount > 0) {
+            lAdapter->mDevice->SetReceiverThreadAffinity(static_cast<int>(lIndex % lCPUCount));
+        }
+
+        lAdapter->mSSIDFilter = mSSIDFilters;
+        SetReadiness(lAdapter->mName, Readiness::Pending);
+        lResults.emplace_back(std::async(std::launch::async, [this, lAdapter] { return StartAdapter(*lAdapter); }));
+
+        lIndex++;
+    }
+
+    for (auto& lResult : lResults) {
+        if (!lResult.get()) {
+            lReturn = StartResult::DeviceFailed;
+        }
+    }
+
+    return lReturn;
+}
+
+bool Engine::StartAdapter(Adapter& aAdapter)
+{
+    bool                                  lReturn{false};
+    std::chrono::steady_clock::time_point lStart{std::chrono::steady_clock::now()};
+
+    if (mStopRequested) {
+        Logger::GetInstance().Log("Not starting " + aAdapter.mName + ", the engine is stopping", Logger::Level::DEBUG);
+    } else if (aAdapter.mDevice->Open(aAdapter.mName, aAdapter.mSSIDFilter)) {
+        if (aAdapter.mDevice->StartReceiverThread()) {
+            lReturn = true;
+        } else {
+            Logger::GetInstance().Log("Failed to start receiver thread for " + aAdapter.mName, Logger::Level::ERROR);
+        }
+    } else {
+        Logger::GetInstance().Log("Failed to activate interface " + aAdapter.mName, Logger::Level::ERROR);
+    }
+
+    if (lReturn) {
+        auto lElapsed{std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - lStart)};
+        Logger::GetInstance().Log(
+            "Adapter " + aAdapter.mName + " ready after " + std::to_string(lElapsed.count()) + "ms",
+            Logger::Level::INFO);
+    }
+
+    SetReadiness(aAdapter.mName, lReturn ? Readiness::Ready : Readiness::Failed);
+
+    return lReturn;
+}
+
+void Engine::StartAsync()
+{
+    if (!mStartResult.valid()) {
+        mStartResult = std::async(std::launch::async, [this] { return Start(); });
+    }
+}
+
+bool Engine::IsStarting() const
+{
+    return mStartResult.valid();
+}
+
+std::optional<StartResult> Engine::GetStartResult()
+{
+    std::optional<StartResult> lReturn{};
+
+    if (mStartResult.valid() && mStartResult.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+        lReturn = mStartResult.get();
+    }
+
+    return lReturn;
+}
+
+void Engine::SetReadiness(std::string_view                    aName,
+                          Readiness                           aState,
+                          std::shared_ptr<XLinkKaiConnection> aConnection)
+{
+    std::scoped_lock lLock{mComponentsMutex};
+
+    auto lComponent{std::find_if(mComponents.begin(), mComponents.end(), [&aName](const Component& aComponent) {
+        return aComponent.mReadiness.Name == aName;
+    })};
+
+    if (lComponent == mComponents.end()) {
+        lComponent = mComponents.emplace(mComponents.end(), Component{{std::string(aName), aState}, aConnection});
+    } else {
+        lComponent->mReadiness.State = aState;
+        lComponent->mConnection      = aConnection;
+    }
+}
+
+std::vector<ComponentReadiness> Engine::GetReadiness() const
+{
+    std::vector<ComponentReadiness> lReturn{};
+    std::scoped_lock                lLock{mComponentsMutex};
+
+    for (const auto& lComponent : mComponents) {
+        ComponentReadiness lReadiness{lComponent.mReadiness};
+
+        // A running connection is only ready once XLink Kai confirmed it
+        if (lComponent.mConnection != nullptr && lReadiness.State == Readiness::Pending &&
+            lComponent.mConnection->IsConnected()) {
+            lReadiness.State = Readiness::Ready;
+        }
+
+        lReturn.emplace_back(lReadiness);
+    }
+
+    return lReturn;
+}
+
+void Engine::Stop()
+{
+    // A start running in the background has to finish first, it is still setting the adapters up
+    mStopRequested = true;
+    if (mStartResult.valid()) {
+        mStartResult.get();
+    }
+    mStopRequested = false;
+
+    LogStatistics();
+
+    for (auto& lConnection : GetConnections()) {
+        lConnection->Close();
+    }
+
+    for (auto& lAdapter : mAdapters) {
+        lAdapter->mDevice->Close();
+    }
+
+    // Let's actually just remove the devices, easier this way
+    mAdapters.clear();
+    mSSIDFilters.clear();
+
+    std::scoped_lock lLock{mComponentsMutex};
+    mComponents.clear();
+}
+
+void Engine::ReConnect()
+{
+    for (auto& lAdapter : mAdapters) {
+        lAdapter->mDevice->Connect("");
+    }
+}
+
+void Engine::SetHosting(bool aHosting)
+{
+    for (auto& lConnection : GetConnections()) {
+        lConnection->SetHosting(aHosting);
+    }
+}
+
+std::vector<std::shared_ptr<XLinkKaiConnection>> Engine::GetConnections() const
+{
+    std::vector<std::shared_ptr<XLinkKaiConnection>> lReturn{};
+
+    for (const auto& lAdapter : mAdapters) {
+        if (std::find(lReturn.begin(), lReturn.end(), lAdapter->mConnection) == lReturn.end()) {
+            lReturn.emplace_back(lAdapter->mConnection);
+        }
+    }
+
+    return lReturn;
+}
+
+std::vector<AdapterStatistics> Engine::GetStatistics() const
+{
+    std::vector<AdapterStatistics> lReturn{};
+
+    for (std::size_t lCount = 0; lCount < mAdapters.size(); lCount++) {
+        AdapterStatistics lStatistics{};
+        lStatistics.Name             = mAdapters.at(lCount)->mName;
+        lStatistics.ConnectedNetwork = (lCount == 0) ? mModel.mCurrentlyConnectedNetwork.Get() :
+                                                       mAdapters.at(lCount)->mCurrentlyConnectedNetwork.Get();
+        lStatistics.Device           = mAdapters.at(lCount)->mDevice->GetStatistics();
+        if (mAdapters.at(lCount)->mConnection != nullptr) {
+            lStatistics.Link = mAdapters.at(lCount)->mConnection->GetLinkStatistics();
+        }
+        lReturn.emplace_back(lStatistics);
+    }
+
+    return lReturn;
+}
+
+void Engine::LogStatistics() const
+{
+    for (const auto& lStatistics : GetStatistics()) {
+        Logger::GetInstance().Log(
+            "Adapter " + lStatistics.Name + ": received " + std::to_string(lStatistics.Device.PacketsReceived) +
+                " packets (" + std::to_string(lStatistics.Device.BytesReceived) + " bytes), sent " +
+                std::to_string(lStatistics.Device.PacketsSent) + " packets (" +
+                std::to_string(lStatistics.Device.BytesSent) + " bytes), " +
+                std::to_string(lStatistics.Device.SendErrors) + " send errors, XLink Kai round trip " +
+                std::to_string(lStatistics.Link.RoundTripTime.count()) + " us, keepalive interval " +
+                std::to_string(lStatistics.Link.KeepAliveInterval.count()) + " us (jitter " +
+                std::to_string(lStatistics.Link.KeepAliveJitter.count()) + " us)",
+            Logger::Level::INFO);
+
+        if (HardwareCounters::IsEnabled()) {
+            std::stringstream lCounters{};
+            lCounters << std::fixed << std::setprecision(1) << "Adapter " << lStatistics.Name << ": per packet "
+                      << lStatistics.Device.Cpu.GetPerPacket(Counter::Cycles) << " cycles, "
+                      << lStatistics.Device.Cpu.GetPerPacket(Counter::Instructions) << " instructions, "
+                      << lStatistics.Device.Cpu.GetPerPacket(Counter::CacheMisses) << " cache misses, "
+                      << lStatistics.Device.Cpu.GetPerPacket(Counter::BranchMisses)
+                      << " branch misses, per packet from XLink Kai "
+                      << lStatistics.Link.Cpu.GetPerPacket(Counter::Cycles) << " cycles, "
+                      << lStatistics.Link.Cpu.GetPerPacket(Counter::Instructions) << " instructions, "
+                      << lStatistics.Link.Cpu.GetPerPacket(Counter::CacheMisses) << " cache misses, "
+                      << lStatistics.Link.Cpu.GetPerPacket(Counter::BranchMisses) << " branch misses";
+            Logger::GetInstance().Log(lCounters.str(), Logger::Level::INFO);
+        }
+    }
+}
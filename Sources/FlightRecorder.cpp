@@ -0,0 +1,245 @@
+/* Copyright (c) 2022 [Rick de Bondt] - FlightRecorder.cpp */
+
+#include "FlightRecorder.h"
+
+#include <algorithm>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+
+#include "Logger.h"
+
+using namespace FlightRecorder_Constants;
+
+namespace
+{
+    struct InterfaceDescription
+    {
+        std::string_view mName{};
+        uint16_t         mLinkType{0};
+    };
+
+    // In the order of FlightRecorder::Interface
+    constexpr std::array<InterfaceDescription, static_cast<std::size_t>(FlightRecorder::Interface::Count)> cInterfaces{
+        {{"Air", cLinkTypeEthernet}, {"Air (RadioTap)", cLinkTypeRadioTap}, {"XLink Kai", cLinkTypeEthernet}}};
+
+    // Flags of an enhanced packet block, in the lowest two bits
+    constexpr uint32_t cFlagInbound{1};
+    constexpr uint32_t cFlagOutbound{2};
+
+    // Interface, direction and length of a frame share a word in a slot
+    constexpr unsigned int cInterfaceShift{32};
+    constexpr unsigned int cDirectionShift{40};
+    constexpr uint64_t     cLengthMask{0xFFFFFFFF};
+    constexpr uint64_t     cByteMask{0xFF};
+
+    template<typename T> void AddValue(std::string& aBlock, T aValue)
+    {
+        aBlock.append(reinterpret_cast<const char*>(&aValue), sizeof(aValue));
+    }
+
+    // Everything in pcapng is padded to 32 bits
+    void AddPadding(std::string& aBlock)
+    {
+        aBlock.append((4 - (aBlock.size() % 4)) % 4, '\0');
+    }
+
+    void AddOption(std::string& aBlock, uint16_t aCode, std::string_view aValue)
+    {
+        AddValue<uint16_t>(aBlock, aCode);
+        AddValue<uint16_t>(aBlock, static_cast<uint16_t>(aValue.size()));
+        aBlock.append(aValue);
+        AddPadding(aBlock);
+    }
+
+    void WriteBlock(std::ostream& aStream, uint32_t aType, std::string_view aBody)
+    {
+        // Type, the length at the start and the length at the end
+        auto lLength{static_cast<uint32_t>(aBody.size() + 3 * sizeof(uint32_t))};
+
+        aStream.write(reinterpret_cast<const char*>(&aType), sizeof(aType));
+        aStream.write(reinterpret_cast<const char*>(&lLength), sizeof(lLength));
+        aStream.write(aBody.data(), static_cast<std::streamsize>(aBody.size()));
+        aStream.write(reinterpret_cast<const char*>(&lLength), sizeof(lLength));
+    }
+
+    int64_t ToNanoseconds(FlightRecorder::Clock::time_point aTime)
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(aTime.time_since_epoch()).count();
+    }
+}  // namespace
+
+void FlightRecorder::Record(Interface aInterface, Direction aDirection, std::string_view aData)
+{
+    uint64_t                     lTicket{mHead.fetch_add(1, std::memory_order_relaxed)};
+    Slot&                        lSlot{mSlots.at(lTicket & (cSlots - 1))};
+    std::array<uint64_t, cWords> lData{};
+
+    memcpy(lData.data(), aData.data(), std::min(aData.size(), cSnapLength));
+
+    // The ticket goes into the sequence number as well, so a reader also notices a slot was reused
+    lSlot.mSequence.store((lTicket * 2) + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    lSlot.mTimestamp.store(ToNanoseconds(Clock::now()), std::memory_order_relaxed);
+    lSlot.mInfo.store((aData.size() & cLengthMask) | (uint64_t{static_cast<uint8_t>(aInterface)} << cInterfaceShift) |
+                          (uint64_t{static_cast<uint8_t>(aDirection)} << cDirectionShift),
+                      std::memory_order_relaxed);
+    for (std::size_t lIndex = 0; lIndex < cWords; lIndex++) {
+        lSlot.mData.at(lIndex).store(lData.at(lIndex), std::memory_order_relaxed);
+    }
+
+    lSlot.mSequence.store((lTicket * 2) + 2, std::memory_order_release);
+}
+
+bool FlightRecorder::Dump(std::string_view aReason)
+{
+    bool    lReturn{false};
+    auto    lNow{Clock::now()};
+    int64_t lLastDump{mLastDump.load()};
+
+    {
+        std::scoped_lock lLock{mDumpMutex};
+        if (!mDumpDirectory.has_value()) {
+            return false;
+        }
+    }
+
+    // Only one of the threads running into the same problem gets to save it
+    if ((lLastDump == 0 ||
+         (ToNanoseconds(lNow) - lLastDump) >= std::chrono::nanoseconds(cMinimumDumpInterval).count()) &&
+        mLastDump.compare_exchange_strong(lLastDump, ToNanoseconds(lNow))) {
+        std::scoped_lock lLock{mDumpMutex};
+
+        std::time_t       lTimeAsTimeT{Clock::to_time_t(lNow)};
+        std::stringstream lFileName;
+        lFileName << cFilePrefix << std::put_time(std::gmtime(&lTimeAsTimeT), "%Y%m%d-%H%M%S") << cFileExtension;
+
+        std::filesystem::path lPath{std::filesystem::path(mDumpDirectory.value_or("")) / lFileName.str()};
+        std::ofstream         lFile{lPath, std::ios::binary};
+
+        if (lFile.is_open() && Write(lFile, aReason, lNow)) {
+            Logger::GetInstance().Log("Saved flight recorder to " + lPath.string() + " because of: " +
+                                          std::string(aReason),
+                                      Logger::Level::INFO);
+            lReturn = true;
+        } else {
+            Logger::GetInstance().Log("Could not save flight recorder to " + lPath.string(), Logger::Level::ERROR);
+        }
+
+        lFile.close();
+        RemoveOldDumps();
+    }
+
+    return lReturn;
+}
+
+void FlightRecorder::RemoveOldDumps() const
+{
+    std::error_code                    lError{};
+    std::vector<std::filesystem::path> lDumps{};
+    std::filesystem::path              lDirectory{mDumpDirectory.value_or("")};
+
+    for (const auto& lEntry : std::filesystem::directory_iterator(lDirectory.empty() ? "." : lDirectory, lError)) {
+        std::string lName{lEntry.path().filename().string()};
+        if (lEntry.is_regular_file(lError) && lName.rfind(cFilePrefix, 0) == 0 &&
+            lEntry.path().extension() == cFileExtension) {
+            lDumps.emplace_back(lEntry.path());
+        }
+    }
+
+    // The time in the name sorts the same as the time itself
+    std::sort(lDumps.begin(), lDumps.end());
+    for (std::size_t lIndex = 0; lIndex + cMaxDumps < lDumps.size(); lIndex++) {
+        if (!std::filesystem::remove(lDumps.at(lIndex), lError)) {
+            Logger::GetInstance().Log("Could not remove old flight recorder dump " + lDumps.at(lIndex).string(),
+                                      Logger::Level::WARNING);
+        }
+    }
+}
+
+bool FlightRecorder::Write(std::ostream& aStream, std::string_view aReason, Clock::time_point aNow) const
+{
+    std::vector<Frame> lFrames{};
+    int64_t            lOldest{ToNanoseconds(aNow - cWindow)};
+
+    for (const auto& lSlot : mSlots) {
+        Frame lFrame{};
+        lFrame.mSequence = lSlot.mSequence.load(std::memory_order_acquire);
+
+        lFrame.mTimestamp = lSlot.mTimestamp.load(std::memory_order_relaxed);
+        uint64_t lInfo{lSlot.mInfo.load(std::memory_order_relaxed)};
+        for (std::size_t lIndex = 0; lIndex < cWords; lIndex++) {
+            lFrame.mData.at(lIndex) = lSlot.mData.at(lIndex).load(std::memory_order_relaxed);
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        // Skip empty slots and slots that are written to while reading them
+        if (lFrame.mSequence != 0 && (lFrame.mSequence % 2) == 0 &&
+            lFrame.mSequence == lSlot.mSequence.load(std::memory_order_relaxed) && lFrame.mTimestamp >= lOldest) {
+            lFrame.mLength    = static_cast<uint32_t>(lInfo & cLengthMask);
+            lFrame.mInterface = static_cast<Interface>((lInfo >> cInterfaceShift) & cByteMask);
+            lFrame.mDirection = static_cast<Direction>((lInfo >> cDirectionShift) & cByteMask);
+            lFrames.emplace_back(lFrame);
+        }
+    }
+
+    std::sort(lFrames.begin(), lFrames.end(), [](const Frame& aFirst, const Frame& aSecond) {
+        return aFirst.mSequence < aSecond.mSequence;
+    });
+
+    std::string lSectionHeader{};
+    AddValue<uint32_t>(lSectionHeader, cByteOrderMagic);
+    AddValue<uint16_t>(lSectionHeader, 1);
+    AddValue<uint16_t>(lSectionHeader, 0);
+    // Section length is not known up front
+    AddValue<int64_t>(lSectionHeader, -1);
+    AddOption(lSectionHeader, cOptionComment, aReason);
+    AddOption(lSectionHeader, cOptionEnd, "");
+    WriteBlock(aStream, cSectionHeaderBlock, lSectionHeader);
+
+    for (const auto& lInterface : cInterfaces) {
+        std::string lInterfaceDescription{};
+        AddValue<uint16_t>(lInterfaceDescription, lInterface.mLinkType);
+        AddValue<uint16_t>(lInterfaceDescription, 0);
+        AddValue<uint32_t>(lInterfaceDescription, static_cast<uint32_t>(cSnapLength));
+        AddOption(lInterfaceDescription, cOptionInterfaceName, lInterface.mName);
+        AddOption(lInterfaceDescription,
+                  cOptionTimestampResolution,
+                  std::string_view(reinterpret_cast<const char*>(&cNanosecondResolution), 1));
+        AddOption(lInterfaceDescription, cOptionEnd, "");
+        WriteBlock(aStream, cInterfaceDescriptionBlock, lInterfaceDescription);
+    }
+
+    for (const auto& lFrame : lFrames) {
+        auto        lTimestamp{static_cast<uint64_t>(lFrame.mTimestamp)};
+        auto        lCaptured{static_cast<uint32_t>(std::min<std::size_t>(lFrame.mLength, cSnapLength))};
+        uint32_t    lFlags{(lFrame.mDirection == Direction::Inbound) ? cFlagInbound : cFlagOutbound};
+        std::string lPacket{};
+
+        AddValue<uint32_t>(lPacket, static_cast<uint32_t>(lFrame.mInterface));
+        AddValue<uint32_t>(lPacket, static_cast<uint32_t>(lTimestamp >> 32U));
+        AddValue<uint32_t>(lPacket, static_cast<uint32_t>(lTimestamp & cLengthMask));
+        AddValue<uint32_t>(lPacket, lCaptured);
+        AddValue<uint32_t>(lPacket, lFrame.mLength);
+        lPacket.append(reinterpret_cast<const char*>(lFrame.mData.data()), lCaptured);
+        AddPadding(lPacket);
+        AddOption(lPacket, cOptionFlags, std::string_view(reinterpret_cast<const char*>(&lFlags), sizeof(lFlags)));
+        AddOption(lPacket, cOptionEnd, "");
+        WriteBlock(aStream, cEnhancedPacketBlock, lPacket);
+    }
+
+    aStream.flush();
+    return aStream.good();
+}
+
+void FlightRecorder::SetDumpDirectory(std::string_view aDirectory)
+{
+    std::scoped_lock lLock{mDumpMutex};
+    mDumpDirectory = aDirectory;
+}
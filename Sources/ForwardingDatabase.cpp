@@ -0,0 +1,131 @@
+/* Copyright (c) 2022 [Rick de Bondt] - ForwardingDatabase.cpp */
+
+#include "ForwardingDatabase.h"
+
+#include <algorithm>
+#include <string>
+#include <utility>
+
+#include "Logger.h"
+#include "NetConversionFunctions.h"
+#include "NetworkingHeaders.h"
+
+using namespace ForwardingDatabase_Constants;
+
+ForwardingDatabase::ForwardingDatabase(Clock::duration aAgingTime) : mAgingTime(aAgingTime) {}
+
+bool ForwardingDatabase::Learn(
+    uint64_t aMac, Side aSide, IPCapDevice* aDevice, std::size_t aBytes, Clock::time_point aNow)
+{
+    bool lReturn{true};
+
+    // A group address as source is bogus, it can never be sent to
+    if ((aMac & Net_Constants::cGroupAddressBit) == 0) {
+        std::scoped_lock lLock{mMutex};
+
+        if (aNow >= mNextSweep) {
+            Sweep(aNow);
+            mNextSweep = aNow + mAgingTime;
+        }
+
+        auto lEntry{mEntries.find(aMac)};
+        if (lEntry != mEntries.end() && (aNow - lEntry->second.mLastSeen) < mAgingTime) {
+            if (lEntry->second.mSide == aSide) {
+                // A local Mac address can move from one device to another
+                lEntry->second.mDevice   = aDevice;
+                lEntry->second.mLastSeen = aNow;
+                lEntry->second.mPackets++;
+                lEntry->second.mBytes += aBytes;
+            } else {
+                lReturn = false;
+            }
+        } else {
+            if (lEntry == mEntries.end() && mEntries.size() >= cMaxEntries) {
+                Sweep(aNow);
+                if (mEntries.size() >= cMaxEntries) {
+                    EvictOldest();
+                }
+            }
+
+            // An aged entry that was not swept out yet may still live on the other side
+            if (lEntry != mEntries.end() && lEntry->second.mSide != aSide) {
+                NotifyChange(aMac, lEntry->second.mSide, false);
+            }
+
+            mEntries.insert_or_assign(aMac, Entry{aSide, aDevice, aNow, 1, aBytes});
+
+            Logger::GetInstance().Log(std::string("Learned ") + ((aSide == Side::Local) ? "local" : "remote") +
+                                          " Mac address " + IntToMac(aMac),
+                                      Logger::Level::DEBUG);
+            NotifyChange(aMac, aSide, true);
+        }
+    }
+
+    return lReturn;
+}
+
+std::optional<ForwardingDatabase::Entry> ForwardingDatabase::Find(uint64_t aMac, Clock::time_point aNow) const
+{
+    std::optional<Entry> lReturn{std::nullopt};
+
+    std::scoped_lock lLock{mMutex};
+    auto             lEntry{mEntries.find(aMac)};
+    if (lEntry != mEntries.end() && (aNow - lEntry->second.mLastSeen) < mAgingTime) {
+        lReturn = lEntry->second;
+    }
+
+    return lReturn;
+}
+
+void ForwardingDatabase::Clear()
+{
+    std::scoped_lock lLock{mMutex};
+    for (const auto& [lMac, lEntry] : mEntries) {
+        NotifyChange(lMac, lEntry.mSide, false);
+    }
+    mEntries.clear();
+}
+
+void ForwardingDatabase::SetChangeHandler(ChangeHandler aHandler)
+{
+    std::scoped_lock lLock{mMutex};
+    mChangeHandler = std::move(aHandler);
+}
+
+std::size_t ForwardingDatabase::GetSize() const
+{
+    std::scoped_lock lLock{mMutex};
+    return mEntries.size();
+}
+
+void ForwardingDatabase::Sweep(Clock::time_point aNow)
+{
+    for (auto lEntry = mEntries.begin(); lEntry != mEntries.end();) {
+        if ((aNow - lEntry->second.mLastSeen) >= mAgingTime) {
+            Logger::GetInstance().Log("Mac address " + IntToMac(lEntry->first) + " aged out", Logger::Level::DEBUG);
+            NotifyChange(lEntry->first, lEntry->second.mSide, false);
+            lEntry = mEntries.erase(lEntry);
+        } else {
+            lEntry++;
+        }
+    }
+}
+
+void ForwardingDatabase::EvictOldest()
+{
+    auto lOldest{std::min_element(mEntries.begin(), mEntries.end(), [](const auto& aFirst, const auto& aSecond) {
+        return aFirst.second.mLastSeen < aSecond.second.mLastSeen;
+    })};
+
+    if (lOldest != mEntries.end()) {
+        NotifyChange(lOldest->first, lOldest->second.mSide, false);
+        mEntries.erase(lOldest);
+    }
+}
+
+void ForwardingDatabase::NotifyChange(uint64_t aMac, Side aSide, bool aKnown) const
+{
+    if (mChangeHandler != nullptr) {
+        mChangeHandler(aMac, aSide, aKnown);
+    }
+}
@@ -4,6 +4,7 @@
 
 #include "Logger.h"
 #include "NetConversionFunctions.h"
+#include "Tracer.h"
 
 Handler80211::Handler80211(PhysicalDeviceHeaderType aType)
 {
@@ -16,10 +17,12 @@ Handler80211::Handler80211(PhysicalDeviceHeaderType aType)
 
 std::string Handler80211::ConvertPacketOut()
 {
+    TRACE_SCOPE("Handler80211::ConvertPacketOut");
+
     std::string lConvertedPacket{};
 
     // Only important if Data type
-    if ((mPhysicalDeviceHeaderReader != nullptr) && (mMainPacketType == Main80211PacketType::Data)) {
+    if ((mPhysicalDeviceHeaderReader != nullptr) && (mFrameClassification.MainType == Main80211PacketType::Data)) {
         unsigned int lFCSLength =
             ((mPhysicalDeviceHeaderReader->GetFlags() & RadioTap_Constants::cFCSAvailableFlag) != 0) ? 4 : 0;
 
@@ -30,17 +33,11 @@ std::string Handler80211::ConvertPacketOut()
         unsigned int lTypeIndex = Net_80211_Constants::cEtherTypeIndex + mPhysicalDeviceHeaderReader->GetLength();
         unsigned int lDataIndex = Net_80211_Constants::cDataIndex + mPhysicalDeviceHeaderReader->GetLength();
 
-        // If there is QOS data added to the 80211 header, we need to skip past that as well
-        switch (mDataPacketType) {
-            case Data80211PacketType::QoSData:
-                lTypeIndex += sizeof(uint8_t) * Net_80211_Constants::cDataQOSLength;
-                lDataIndex += sizeof(uint8_t) * Net_80211_Constants::cDataQOSLength;
-                break;
-            default:
-                break;
-        }
+        // If there is QOS data or a fourth address added to the 80211 header, we need to skip past that as well
+        lTypeIndex += mHeaderLength - Net_80211_Constants::c80211DataHeaderLength;
+        lDataIndex += mHeaderLength - Net_80211_Constants::c80211DataHeaderLength;
 
-        switch (mDataPacketType) {
+        switch (mFrameClassification.DataType) {
             case Data80211PacketType::QoSNull:
             case Data80211PacketType::Null:
                 break;
@@ -145,19 +142,8 @@ bool Handler80211::ShouldSend() const
 
 bool Handler80211::IsSSIDAllowed(std::string_view aSSID)
 {
-    bool lReturn{false};
-
-    if (mSSIDList.empty()) {
-        lReturn = true;
-    } else {
-        for (auto& lSSID : mSSIDList) {
-            if (aSSID.find(lSSID) != std::string::npos) {
-                lReturn = true;
-            }
-        }
-    }
-
-    return lReturn;
+    std::shared_ptr<const SSIDMatcher> lMatcher{std::atomic_load(&mSSIDMatcher)};
+    return lMatcher->IsEmpty() || lMatcher->Matches(aSSID);
 }
 
 bool Handler80211::IsDropped() const
@@ -177,13 +163,15 @@ void Handler80211::SetBSSID(uint64_t aBSSID)
     mLockedBSSID = aBSSID;
 }
 
-void Handler80211::SetSSIDFilterList(std::vector<std::string>& aSSIDList)
+void Handler80211::SetSSIDFilterList(const std::vector<std::string>& aSSIDList)
 {
-    mSSIDList = std::move(aSSIDList);
+    std::atomic_store(&mSSIDMatcher, std::make_shared<const SSIDMatcher>(aSSIDList));
 }
 
 void Handler80211::Update(std::string_view aPacket)
 {
+    TRACE_SCOPE("Handler80211::Update");
+
     // Save data in object and fill RadioTap parameters.
     mLastReceivedData = aPacket;
 
@@ -197,17 +185,15 @@ void Handler80211::Update(std::string_view aPacket)
         mPhysicalDeviceHeaderReader->FillRadioTapParameters(aPacket);
     }
 
-    UpdateMainPacketType();
+    UpdateFrameControl();
 
-    switch (mMainPacketType) {
+    switch (mFrameClassification.MainType) {
         case Main80211PacketType::Control:
             UpdateDestinationMac();
 
             // Blacklisted Macs will have a destination Mac in XLink Kai, so only copy info about these packets
             if (GetBlackList().IsMacBlackListed(mDestinationMac)) {
-                UpdateControlPacketType();
-
-                if (mControlPacketType == Control80211PacketType::ACK) {
+                if (mFrameClassification.ControlType == Control80211PacketType::ACK) {
                     Logger::GetInstance().Log("Saving parameters for a Control packet type", Logger::Level::TRACE);
                     SavePhysicalDeviceParameters(mPhysicalDeviceParametersControl);
                     mIsDropped = false;
@@ -225,14 +211,12 @@ void Handler80211::Update(std::string_view aPacket)
                 mIsBroadcastPacket = mDestinationMac == Net_Constants::cBroadcastMac;
 
                 UpdateAckable();
-                UpdateDataPacketType();
-                UpdateRetry();
 
                 mEtherType = GetRawData<uint16_t>(mLastReceivedData, Net_8023_Constants::cEtherTypeIndex);
 
                 // Only save parameters on normal data types.
                 if (!mRetry) {
-                    switch (mDataPacketType) {
+                    switch (mFrameClassification.DataType) {
                         case Data80211PacketType::Data:
                             Logger::GetInstance().Log("Saving parameters for a Data packet type", Logger::Level::TRACE);
                             SavePhysicalDeviceParameters(mPhysicalDeviceParametersData);
@@ -254,15 +238,13 @@ void Handler80211::Update(std::string_view aPacket)
             UpdateSourceMac();
 
             if (GetBlackList().IsMacAllowed(mSourceMac)) {
-                UpdateManagementPacketType();
-
-                if (mManagementPacketType == Management80211PacketType::Beacon) {
-                    mParameter80211Reader->Update(mLastReceivedData);
-                    if (IsSSIDAllowed(mParameter80211Reader->GetSSID())) {
-                        UpdateBSSID();
+                if (mFrameClassification.ManagementType == Management80211PacketType::Beacon) {
+                    UpdateBSSID();
+                    const BeaconInformation& lBeacon{ClassifyBeacon()};
+                    if (lBeacon.mSSIDAllowed) {
                         if (mBSSID != mLockedBSSID) {
                             mLockedBSSID = mBSSID;
-                            mLockedSSID  = mParameter80211Reader->GetSSID().data();
+                            mLockedSSID  = lBeacon.mSSID;
 
                             Logger::GetInstance().Log(
                                 std::string("SSID switched:") + mLockedSSID + ", BSSID: " + IntToMac(mBSSID),
@@ -279,145 +261,99 @@ void Handler80211::Update(std::string_view aPacket)
     }
 }
 
-void Handler80211::UpdateAckable()
+const Handler80211::BeaconInformation& Handler80211::ClassifyBeacon()
 {
-    // TODO: Filter multicast
-    // Not a broadcast
-    if (!mIsBroadcastPacket) {
-        mAckable = true;
+    std::size_t                        lFingerprint{GetBeaconFingerprint()};
+    std::shared_ptr<const SSIDMatcher> lMatcher{std::atomic_load(&mSSIDMatcher)};
+
+    if (mBeaconCache.size() >= Handler80211_Constants::cMaxBeaconCacheSize && !mBeaconCache.contains(mBSSID)) {
+        mBeaconCache.clear();
     }
-}
 
-void Handler80211::UpdateBSSID()
-{
-    uint64_t lBSSID{0};
-    if (mPhysicalDeviceHeaderReader != nullptr) {
-        lBSSID = GetRawData<uint64_t>(mLastReceivedData,
-                                      mPhysicalDeviceHeaderReader->GetLength() + Net_80211_Constants::cBSSIDIndex);
-        lBSSID &= Net_Constants::cBroadcastMac;  // it's actually a uint48.
+    auto [lIterator, lInserted] = mBeaconCache.try_emplace(mBSSID);
+    BeaconInformation& lBeacon{lIterator->second};
 
-        mBSSID = lBSSID;
-    }
-}
+    if (lInserted || lBeacon.mFingerprint != lFingerprint) {
+        mParameter80211Reader->Update(mLastReceivedData);
 
-void Handler80211::UpdateControlPacketType()
-{
-    Control80211PacketType lResult{Control80211PacketType::None};
+        lBeacon.mFingerprint = lFingerprint;
+        lBeacon.mSSID        = mParameter80211Reader->GetSSID();
+        lBeacon.mMatcher     = nullptr;
+    }
 
-    // Makes more sense if you read this: https://en.wikipedia.org/wiki/802.11_Frame_Types#Frame_Control
-    if (mPhysicalDeviceHeaderReader != nullptr) {
-        uint8_t lControlType{static_cast<uint8_t>(
-            GetRawData<uint8_t>(mLastReceivedData, mPhysicalDeviceHeaderReader->GetLength()) >> 4U)};
-        if ((lControlType & 0b1111U) == 0b1000U) {
-            lResult = Control80211PacketType::BlockAckRequest;
-        } else if ((lControlType & 0b1111U) == 0b1001U) {
-            lResult = Control80211PacketType::BlockAck;
-        } else if ((lControlType & 0b1111U) == 0b1101U) {
-            lResult = Control80211PacketType::ACK;
-        } else {
-            Logger::GetInstance().Log("Could not determine control packet type: " + std::to_string(lControlType),
-                                      Logger::Level::DEBUG);
-        }
+    // Remembered verdicts made with an older filter don't count
+    if (lBeacon.mMatcher != lMatcher) {
+        lBeacon.mSSIDAllowed = lMatcher->IsEmpty() || lMatcher->Matches(lBeacon.mSSID);
+        lBeacon.mMatcher     = lMatcher;
     }
 
-    mControlPacketType = lResult;
+    return lBeacon;
 }
 
-void Handler80211::UpdateDataPacketType()
+std::size_t Handler80211::GetBeaconFingerprint() const
 {
-    Data80211PacketType lResult{Data80211PacketType::None};
+    std::size_t lStart{Net_80211_Constants::cFixedParameterTypeSSIDIndex};
+    std::size_t lFCSLength{0};
 
-    // Makes more sense if you read this: https://en.wikipedia.org/wiki/802.11_Frame_Types#Frame_Control
     if (mPhysicalDeviceHeaderReader != nullptr) {
-        uint8_t lDataType{static_cast<uint8_t>(
-            GetRawData<uint8_t>(mLastReceivedData, mPhysicalDeviceHeaderReader->GetLength()) >> 4U)};
-
-        if ((lDataType & 0b1111U) == 0b0000U) {
-            lResult = Data80211PacketType::Data;
-        } else if ((lDataType & 0b1111U) == 0b0100U) {
-            lResult = Data80211PacketType::Null;
-        } else if ((lDataType & 0b1111U) == 0b1000U) {
-            lResult = Data80211PacketType::QoSData;
-        } else if ((lDataType & 0b1111U) == 0b1100U) {
-            lResult = Data80211PacketType::QoSNull;
-        } else {
-            Logger::GetInstance().Log("Could not determine data packet type: " + std::to_string(lDataType),
-                                      Logger::Level::DEBUG);
-        }
+        lStart += mPhysicalDeviceHeaderReader->GetLength();
+        lFCSLength = ((mPhysicalDeviceHeaderReader->GetFlags() & RadioTap_Constants::cFCSAvailableFlag) != 0) ? 4 : 0;
+    }
+
+    std::size_t lReturn{0};
+    if (mLastReceivedData.size() > lStart + lFCSLength) {
+        lReturn = std::hash<std::string_view>{}(
+            std::string_view(mLastReceivedData).substr(lStart, mLastReceivedData.size() - lStart - lFCSLength));
     }
 
-    mDataPacketType = lResult;
+    return lReturn;
 }
 
-void Handler80211::UpdateMainPacketType()
+void Handler80211::UpdateAckable()
 {
-    Main80211PacketType lResult{Main80211PacketType::None};
-
-    // Makes more sense if you read this: https://en.wikipedia.org/wiki/802.11_Frame_Types#Frame_Control
-    if (mPhysicalDeviceHeaderReader != nullptr) {
-        uint8_t lMainType{static_cast<uint8_t>(
-            GetRawData<uint8_t>(mLastReceivedData, mPhysicalDeviceHeaderReader->GetLength()) >> 2U)};
-        if ((lMainType & 0b11U) == 0b00U) {
-            lResult = Main80211PacketType::Management;
-        } else if ((lMainType & 0b11U) == 0b01U) {
-            lResult = Main80211PacketType::Control;
-        } else if ((lMainType & 0b11U) == 0b10U) {
-            lResult = Main80211PacketType::Data;
-        }
-        // Ignore extensions
+    // TODO: Filter multicast
+    // Not a broadcast
+    if (!mIsBroadcastPacket) {
+        mAckable = true;
     }
-
-    mMainPacketType = lResult;
 }
 
-void Handler80211::UpdateManagementPacketType()
+void Handler80211::UpdateBSSID()
 {
-    Management80211PacketType lResult{Management80211PacketType::None};
-
-    // Makes more sense if you read this: https://en.wikipedia.org/wiki/802.11_Frame_Types#Frame_Control
+    uint64_t lBSSID{0};
     if (mPhysicalDeviceHeaderReader != nullptr) {
-        uint8_t lManagementType{static_cast<uint8_t>(
-            (GetRawData<uint8_t>(mLastReceivedData, mPhysicalDeviceHeaderReader->GetLength())) >> 4U)};
-
-        if ((lManagementType & 0b1111U) == 0b0000U) {
-            lResult = Management80211PacketType::AssociationRequest;
-        } else if ((lManagementType & 0b1111U) == 0b0001U) {
-            lResult = Management80211PacketType::AssociationResponse;
-        } else if ((lManagementType & 0b1111U) == 0b0010U) {
-            lResult = Management80211PacketType::ReassociationRequest;
-        } else if ((lManagementType & 0b1111U) == 0b0011U) {
-            lResult = Management80211PacketType::ReassociationResponse;
-        } else if ((lManagementType & 0b1111U) == 0b0100U) {
-            lResult = Management80211PacketType::ProbeRequest;
-        } else if ((lManagementType & 0b1111U) == 0b0101U) {
-            lResult = Management80211PacketType::ProbeResponse;
-        } else if ((lManagementType & 0b1111U) == 0b1000U) {
-            lResult = Management80211PacketType::Beacon;
-        } else if ((lManagementType & 0b1111U) == 0b1010U) {
-            lResult = Management80211PacketType::Disassociation;
-        } else if ((lManagementType & 0b1111U) == 0b1011U) {
-            lResult = Management80211PacketType::Authentication;
-        } else if ((lManagementType & 0b1111U) == 0b1100U) {
-            lResult = Management80211PacketType::Deauthentication;
-        } else if ((lManagementType & 0b1111U) == 0b1101U) {
-            lResult = Management80211PacketType::Action;
-        } else if ((lManagementType & 0b1111U) == 0b1110U) {
-            lResult = Management80211PacketType::ActionNoAck;
-        } else {
-            Logger::GetInstance().Log("Could not determine management packet type: " + std::to_string(lManagementType),
-                                      Logger::Level::DEBUG);
-        }
-        // Ignore the rest
-    }
+        lBSSID = GetRawData<uint64_t>(mLastReceivedData,
+                                      mPhysicalDeviceHeaderReader->GetLength() + Net_80211_Constants::cBSSIDIndex);
+        lBSSID &= Net_Constants::cBroadcastMac;  // it's actually a uint48.
 
-    mManagementPacketType = lResult;
+        mBSSID = lBSSID;
+    }
 }
 
-void Handler80211::UpdateRetry()
+void Handler80211::UpdateFrameControl()
 {
-    if (mPhysicalDeviceHeaderReader != nullptr) {
-        mRetry = GetRawData<uint8_t>(mLastReceivedData, mPhysicalDeviceHeaderReader->GetLength() + 1) ==
-                 Net_80211_Constants::cDataRetryFlag;
+    mFrameClassification = Handler80211_Constants::FrameClassification{};
+    mHeaderLength        = 0;
+    mRetry               = false;
+    mToDS                = false;
+    mFromDS              = false;
+
+    if (mPhysicalDeviceHeaderReader != nullptr &&
+        mLastReceivedData.size() >= mPhysicalDeviceHeaderReader->GetLength() + Net_80211_Constants::cTypeLength) {
+        // Both frame control bytes in one load, the first byte is the lowest on little endian
+        auto    lFrameControl{GetRawData<uint16_t>(mLastReceivedData, mPhysicalDeviceHeaderReader->GetLength())};
+        uint8_t lFlags{static_cast<uint8_t>(lFrameControl >> 8U)};
+
+        mFrameClassification = Handler80211_Constants::cFrameClassificationTable.at(lFrameControl & 0xFFU);
+        mRetry               = (lFlags & Net_80211_Constants::cDataRetryFlag) != 0;
+        mToDS                = (lFlags & Net_80211_Constants::cToDSFlag) != 0;
+        mFromDS              = (lFlags & Net_80211_Constants::cFromDSFlag) != 0;
+
+        // Only data frames between distribution systems carry a fourth address
+        mHeaderLength = mFrameClassification.HeaderLength;
+        if (mFrameClassification.MainType == Main80211PacketType::Data && mToDS && mFromDS) {
+            mHeaderLength += Net_80211_Constants::cAddress4Length;
+        }
     }
 }
 
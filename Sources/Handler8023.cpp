@@ -4,9 +4,12 @@
 
 #include "Logger.h"
 #include "NetConversionFunctions.h"
+#include "Tracer.h"
 
 std::string Handler8023::ConvertPacketOut(uint64_t aBSSID, RadioTapReader::PhysicalDeviceParameters aParameters)
 {
+    TRACE_SCOPE("Handler8023::ConvertPacketOut");
+
     std::string lReturn;
     if (mLastReceivedData.size() > Net_8023_Constants::cHeaderLength) {
         unsigned int lIeee80211HeaderSize{sizeof(ieee80211_hdr)};
@@ -88,6 +91,8 @@ bool Handler8023::IsBroadcastPacket() const
 
 void Handler8023::Update(std::string_view aPacket)
 {
+    TRACE_SCOPE("Handler8023::Update");
+
     // Save data in object and fill RadioTap parameters.
     mLastReceivedData = aPacket;
 
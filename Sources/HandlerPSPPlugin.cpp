@@ -6,9 +6,12 @@
 
 #include "Logger.h"
 #include "NetConversionFunctions.h"
+#include "Tracer.h"
 
 std::string HandlerPSPPlugin::ConvertPacketOut()
 {
+    TRACE_SCOPE("HandlerPSPPlugin::ConvertPacketOut");
+
     std::string lReturn{mLastReceivedData.data(), mLastReceivedData.size()};
 
     // With the plugin the destination mac is kept at the end of the packet
@@ -67,6 +70,8 @@ uint16_t HandlerPSPPlugin::GetEtherType() const
 
 void HandlerPSPPlugin::Update(std::string_view aPacket)
 {
+    TRACE_SCOPE("HandlerPSPPlugin::Update");
+
     mLastReceivedData = aPacket;
     mEtherType        = 0;
 
@@ -0,0 +1,198 @@
+/* Copyright (c) 2022 [Rick de Bondt] - HardwareCounters.cpp */
+
+#include "HardwareCounters.h"
+
+#if defined(__linux__)
+#include <cerrno>
+#include <cstring>
+#include <string>
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "Logger.h"
+#endif
+
+using namespace HardwareCounters_Constants;
+
+namespace
+{
+    std::atomic<bool> gEnabled{false};
+
+#if defined(__linux__)
+    // In the order of HardwareCounters_Constants::Counter
+    constexpr std::array<uint64_t, cCounters> cEvents{
+        PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+
+    /**
+     * The counters of a single thread. They are opened as a group, so they are read with a single system call.
+     */
+    class ThreadCounters
+    {
+    public:
+        ThreadCounters()
+        {
+            for (std::size_t lIndex = 0; lIndex < cCounters; lIndex++) {
+                mDescriptors.at(lIndex) = Open(cEvents.at(lIndex), mDescriptors.front());
+
+                if (mDescriptors.at(lIndex) != -1) {
+                    mPositions.at(lIndex) = mOpened;
+                    mOpened++;
+                } else if (lIndex == 0) {
+                    // Without the cycles there is no group to add the others to
+                    Logger::GetInstance().Log("Could not open hardware counters: " + std::string(strerror(errno)),
+                                              Logger::Level::WARNING);
+                    break;
+                } else {
+                    // Not every processor has every counter, the others are still useful
+                    Logger::GetInstance().Log("Hardware counter " + std::to_string(lIndex) +
+                                                  " not available: " + std::string(strerror(errno)),
+                                              Logger::Level::DEBUG);
+                }
+            }
+
+            if (IsOpen()) {
+                ioctl(mDescriptors.front(), PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+                ioctl(mDescriptors.front(), PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+            }
+        }
+
+        ~ThreadCounters()
+        {
+            for (int lDescriptor : mDescriptors) {
+                if (lDescriptor != -1) {
+                    close(lDescriptor);
+                }
+            }
+        }
+
+        ThreadCounters(const ThreadCounters& aThreadCounters)            = delete;
+        ThreadCounters& operator=(const ThreadCounters& aThreadCounters) = delete;
+
+        [[nodiscard]] bool IsOpen() const
+        {
+            return mDescriptors.front() != -1;
+        }
+
+        bool Read(std::array<uint64_t, cCounters>& aValues) const
+        {
+            bool lReturn{false};
+
+            // Amount of counters followed by their values
+            std::array<uint64_t, cCounters + 1> lBuffer{};
+
+            if (IsOpen() && read(mDescriptors.front(), lBuffer.data(), sizeof(lBuffer)) > 0 &&
+                lBuffer.front() == mOpened) {
+                for (std::size_t lIndex = 0; lIndex < cCounters; lIndex++) {
+                    aValues.at(lIndex) = (mDescriptors.at(lIndex) != -1) ? lBuffer.at(mPositions.at(lIndex) + 1) : 0;
+                }
+                lReturn = true;
+            }
+
+            return lReturn;
+        }
+
+    private:
+        static int Open(uint64_t aEvent, int aGroup)
+        {
+            perf_event_attr lAttributes{};
+            lAttributes.size        = sizeof(lAttributes);
+            lAttributes.type        = PERF_TYPE_HARDWARE;
+            lAttributes.config      = aEvent;
+            lAttributes.read_format = PERF_FORMAT_GROUP;
+            lAttributes.exclude_hv  = 1;
+            // The group is enabled at once when it is complete
+            lAttributes.disabled = (aGroup == -1) ? 1 : 0;
+
+            // Only this thread, on whatever processor it runs
+            auto lDescriptor{static_cast<int>(syscall(SYS_perf_event_open, &lAttributes, 0, -1, aGroup, 0))};
+
+            // Counting the kernel as well is not allowed without privileges
+            if (lDescriptor == -1 && (errno == EACCES || errno == EPERM)) {
+                lAttributes.exclude_kernel = 1;
+
+                lDescriptor = static_cast<int>(syscall(SYS_perf_event_open, &lAttributes, 0, -1, aGroup, 0));
+            }
+
+            return lDescriptor;
+        }
+
+        std::array<int, cCounters>         mDescriptors{-1, -1, -1, -1};
+        std::array<std::size_t, cCounters> mPositions{};
+        std::size_t                        mOpened{0};
+    };
+
+    ThreadCounters& GetThreadCounters()
+    {
+        thread_local ThreadCounters lCounters{};
+        return lCounters;
+    }
+#endif
+
+    bool ReadThreadCounters(std::array<uint64_t, cCounters>& aValues)
+    {
+#if defined(__linux__)
+        return GetThreadCounters().Read(aValues);
+#else
+        return false;
+#endif
+    }
+}  // namespace
+
+void HardwareCounters::SetEnabled(bool aEnabled)
+{
+    gEnabled = aEnabled;
+}
+
+bool HardwareCounters::IsEnabled()
+{
+    return gEnabled;
+}
+
+bool HardwareCounters::IsAvailable()
+{
+#if defined(__linux__)
+    return GetThreadCounters().IsOpen();
+#else
+    return false;
+#endif
+}
+
+HardwareCounters::Measurement::Measurement(HardwareCounters& aCounters)
+{
+    if (gEnabled.load(std::memory_order_relaxed) && ReadThreadCounters(mStart)) {
+        mCounters = &aCounters;
+    }
+}
+
+HardwareCounters::Measurement::~Measurement()
+{
+    std::array<uint64_t, cCounters> lEnd{};
+
+    if (mCounters != nullptr && ReadThreadCounters(lEnd)) {
+        for (std::size_t lIndex = 0; lIndex < cCounters; lIndex++) {
+            lEnd.at(lIndex) -= mStart.at(lIndex);
+        }
+        mCounters->Add(lEnd);
+    }
+}
+
+Statistics HardwareCounters::GetStatistics() const
+{
+    Statistics lReturn{};
+    lReturn.Packets = mPackets;
+    for (std::size_t lIndex = 0; lIndex < cCounters; lIndex++) {
+        lReturn.Totals.at(lIndex) = mTotals.at(lIndex);
+    }
+    return lReturn;
+}
+
+void HardwareCounters::Add(const std::array<uint64_t, cCounters>& aValues)
+{
+    for (std::size_t lIndex = 0; lIndex < cCounters; lIndex++) {
+        mTotals.at(lIndex).fetch_add(aValues.at(lIndex), std::memory_order_relaxed);
+    }
+    mPackets.fetch_add(1, std::memory_order_relaxed);
+}
@@ -0,0 +1,396 @@
+/* Copyright (c) 2022 [Rick de Bondt] - IOUringLinux.cpp */
+
+#if defined(ENABLE_IO_URING)
+#include "IOUringLinux.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "Logger.h"
+
+using namespace IOUring_Constants;
+
+namespace
+{
+    int Setup(unsigned int aEntries, io_uring_params& aParameters)
+    {
+        return static_cast<int>(syscall(__NR_io_uring_setup, aEntries, &aParameters));
+    }
+
+    int Register(int aFd, unsigned int aOperation, const void* aArgument, unsigned int aCount)
+    {
+        return static_cast<int>(syscall(__NR_io_uring_register, aFd, aOperation, aArgument, aCount));
+    }
+
+    void* Map(std::size_t aSize, int aFd, off_t aOffset)
+    {
+        void* lReturn{mmap(nullptr, aSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, aFd, aOffset)};
+        return (lReturn == MAP_FAILED) ? nullptr : lReturn;
+    }
+}  // namespace
+
+IOUring::~IOUring()
+{
+    Close();
+}
+
+bool IOUring::IsSupported(const std::vector<uint8_t>& aOperations)
+{
+    bool            lReturn{false};
+    io_uring_params lParameters{};
+    int             lFd{Setup(1, lParameters)};
+
+    if (lFd >= 0) {
+        // The probe ends with a flexible array of operations
+        std::size_t          lSize{sizeof(io_uring_probe) + IORING_OP_LAST * sizeof(io_uring_probe_op)};
+        std::vector<uint8_t> lMemory(lSize);
+        auto*                lProbe{reinterpret_cast<io_uring_probe*>(lMemory.data())};
+
+        if (Register(lFd, IORING_REGISTER_PROBE, lProbe, IORING_OP_LAST) >= 0) {
+            lReturn = true;
+            for (uint8_t lOperation : aOperations) {
+                if (lOperation > lProbe->last_op || (lProbe->ops[lOperation].flags & IO_URING_OP_SUPPORTED) == 0) {
+                    lReturn = false;
+                }
+            }
+        }
+
+        close(lFd);
+    }
+
+    return lReturn;
+}
+
+bool IOUring::Open(unsigned int aEntries)
+{
+    Close();
+
+    io_uring_params lParameters{};
+    mFd = Setup(aEntries, lParameters);
+    if (mFd < 0) {
+        Logger::GetInstance().Log(std::string("io_uring_setup failed: ") + strerror(errno), Logger::Level::DEBUG);
+        return false;
+    }
+
+    mSubmissionRingSize = lParameters.sq_off.array + lParameters.sq_entries * sizeof(uint32_t);
+    mCompletionRingSize = lParameters.cq_off.cqes + lParameters.cq_entries * sizeof(io_uring_cqe);
+
+    // Newer kernels map both rings at once
+    if ((lParameters.features & IORING_FEAT_SINGLE_MMAP) != 0) {
+        mSubmissionRingSize = std::max(mSubmissionRingSize, mCompletionRingSize);
+        mSubmissionRing     = Map(mSubmissionRingSize, mFd, IORING_OFF_SQ_RING);
+        mCompletionRing     = mSubmissionRing;
+    } else {
+        mSubmissionRing = Map(mSubmissionRingSize, mFd, IORING_OFF_SQ_RING);
+        mCompletionRing = Map(mCompletionRingSize, mFd, IORING_OFF_CQ_RING);
+    }
+
+    mSubmissionsSize = lParameters.sq_entries * sizeof(io_uring_sqe);
+    mSubmissions     = static_cast<io_uring_sqe*>(Map(mSubmissionsSize, mFd, IORING_OFF_SQES));
+
+    if (mSubmissionRing == nullptr || mCompletionRing == nullptr || mSubmissions == nullptr) {
+        Logger::GetInstance().Log("Could not map io_uring", Logger::Level::DEBUG);
+        Close();
+        return false;
+    }
+
+    auto* lSubmissionRing{static_cast<char*>(mSubmissionRing)};
+    auto* lCompletionRing{static_cast<char*>(mCompletionRing)};
+
+    mSubmissionHead    = reinterpret_cast<uint32_t*>(lSubmissionRing + lParameters.sq_off.head);
+    mSubmissionTail    = reinterpret_cast<uint32_t*>(lSubmissionRing + lParameters.sq_off.tail);
+    mSubmissionMask    = reinterpret_cast<uint32_t*>(lSubmissionRing + lParameters.sq_off.ring_mask);
+    mSubmissionEntries = lParameters.sq_entries;
+    mLocalTail         = *mSubmissionTail;
+    mPublishedTail     = mLocalTail;
+
+    // Submission entries are used in order, so the indirection array maps every index onto itself
+    auto* lArray{reinterpret_cast<uint32_t*>(lSubmissionRing + lParameters.sq_off.array)};
+    for (uint32_t lIndex = 0; lIndex < mSubmissionEntries; lIndex++) {
+        lArray[lIndex] = lIndex;
+    }
+
+    mCompletionHead = reinterpret_cast<uint32_t*>(lCompletionRing + lParameters.cq_off.head);
+    mCompletionTail = reinterpret_cast<uint32_t*>(lCompletionRing + lParameters.cq_off.tail);
+    mCompletionMask = reinterpret_cast<uint32_t*>(lCompletionRing + lParameters.cq_off.ring_mask);
+    mCompletions    = reinterpret_cast<io_uring_cqe*>(lCompletionRing + lParameters.cq_off.cqes);
+
+    return true;
+}
+
+void IOUring::Close()
+{
+    // Closing the ring cancels whatever is still in flight, so that has to happen before the memory goes
+    if (mFd >= 0) {
+        close(mFd);
+        mFd = -1;
+    }
+
+    if (mBufferRing != nullptr) {
+        munmap(mBufferRing, mBufferRingSize);
+        mBufferRing = nullptr;
+    }
+
+    if (mSubmissions != nullptr) {
+        munmap(mSubmissions, mSubmissionsSize);
+        mSubmissions = nullptr;
+    }
+
+    if (mCompletionRing != nullptr && mCompletionRing != mSubmissionRing) {
+        munmap(mCompletionRing, mCompletionRingSize);
+    }
+    mCompletionRing = nullptr;
+
+    if (mSubmissionRing != nullptr) {
+        munmap(mSubmissionRing, mSubmissionRingSize);
+        mSubmissionRing = nullptr;
+    }
+}
+
+bool IOUring::IsOpen() const
+{
+    return mFd >= 0;
+}
+
+io_uring_sqe* IOUring::GetSubmissionEntry()
+{
+    io_uring_sqe* lReturn{nullptr};
+    uint32_t      lHead{std::atomic_ref<uint32_t>(*mSubmissionHead).load(std::memory_order_acquire)};
+
+    if (mLocalTail - lHead < mSubmissionEntries) {
+        lReturn = &mSubmissions[mLocalTail & *mSubmissionMask];
+        memset(lReturn, 0, sizeof(io_uring_sqe));
+        mLocalTail++;
+    }
+
+    return lReturn;
+}
+
+unsigned int IOUring::Publish()
+{
+    unsigned int lReturn{mLocalTail - mPublishedTail};
+
+    std::atomic_ref<uint32_t>(*mSubmissionTail).store(mLocalTail, std::memory_order_release);
+    mPublishedTail = mLocalTail;
+
+    return lReturn;
+}
+
+int IOUring::Enter(unsigned int aCount, unsigned int aMinimumCompletions)
+{
+    unsigned int lFlags{(aMinimumCompletions > 0) ? IORING_ENTER_GETEVENTS : 0U};
+    int lReturn{static_cast<int>(syscall(__NR_io_uring_enter, mFd, aCount, aMinimumCompletions, lFlags, nullptr, 0))};
+    return (lReturn < 0) ? -errno : lReturn;
+}
+
+bool IOUring::RegisterBuffers(const std::vector<iovec>& aBuffers)
+{
+    return Register(mFd, IORING_REGISTER_BUFFERS, aBuffers.data(), static_cast<unsigned int>(aBuffers.size())) >= 0;
+}
+
+bool IOUring::RegisterBufferRing(uint16_t aGroup, uint16_t aEntries)
+{
+    mBufferRingSize = aEntries * sizeof(io_uring_buf);
+
+    // Has to be page aligned, which anonymous mappings always are
+    void* lMemory{mmap(nullptr, mBufferRingSize, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, -1, 0)};
+    if (lMemory == MAP_FAILED) {
+        return false;
+    }
+
+    mBufferRing     = static_cast<io_uring_buf_ring*>(lMemory);
+    mBufferRingMask = static_cast<uint16_t>(aEntries - 1);
+    mBufferRingTail = 0;
+
+    io_uring_buf_reg lRegistration{};
+    lRegistration.ring_addr    = reinterpret_cast<uint64_t>(mBufferRing);
+    lRegistration.ring_entries = aEntries;
+    lRegistration.bgid         = aGroup;
+
+    if (Register(mFd, IORING_REGISTER_PBUF_RING, &lRegistration, 1) < 0) {
+        Logger::GetInstance().Log(std::string("Registering buffer ring failed: ") + strerror(errno),
+                                  Logger::Level::DEBUG);
+        munmap(mBufferRing, mBufferRingSize);
+        mBufferRing = nullptr;
+        return false;
+    }
+
+    return true;
+}
+
+void IOUring::ProvideBuffer(char* aBuffer, unsigned int aLength, uint16_t aId)
+{
+    // Not through bufs, in C++ the empty struct the kernel header puts in front of it takes up space
+    io_uring_buf& lBuffer{reinterpret_cast<io_uring_buf*>(mBufferRing)[mBufferRingTail & mBufferRingMask]};
+    lBuffer.addr = reinterpret_cast<uint64_t>(aBuffer);
+    lBuffer.len  = aLength;
+    lBuffer.bid  = aId;
+    mBufferRingTail++;
+}
+
+void IOUring::CommitBuffers()
+{
+    std::atomic_ref<uint16_t>(mBufferRing->tail).store(mBufferRingTail, std::memory_order_release);
+}
+
+bool IOUringSender::Open(int aFd)
+{
+    std::scoped_lock lLock{mMutex};
+
+    mRing.Close();
+    mFd                = aFd;
+    mSubmitting        = false;
+    mUnsubmitted       = 0;
+    mUnreportedFailure = false;
+
+    if (!IOUring::IsSupported({IORING_OP_WRITE, IORING_OP_WRITE_FIXED}) || !mRing.Open(cSendSlots)) {
+        return false;
+    }
+
+    mSlots.resize(cSendSlots);
+    mFreeSlots.clear();
+    std::vector<iovec> lBuffers{};
+    for (uint16_t lIndex = 0; lIndex < cSendSlots; lIndex++) {
+        lBuffers.push_back({mSlots.at(lIndex).data(), cSendSlotLength});
+        mFreeSlots.push_back(lIndex);
+    }
+
+    // Registering can fail when there is not enough lockable memory, plain writes still save the system calls
+    mFixedBuffers = mRing.RegisterBuffers(lBuffers);
+    if (!mFixedBuffers) {
+        Logger::GetInstance().Log("Could not register send buffers, using unregistered buffers",
+                                  Logger::Level::DEBUG);
+    }
+
+    return true;
+}
+
+void IOUringSender::Close()
+{
+    std::scoped_lock lLock{mMutex};
+
+    if (mFailedSends > 0) {
+        Logger::GetInstance().Log("io_uring sends failed: " + std::to_string(mFailedSends), Logger::Level::WARNING);
+        mFailedSends = 0;
+    }
+
+    mRing.Close();
+}
+
+bool IOUringSender::IsOpen() const
+{
+    return mRing.IsOpen();
+}
+
+void IOUringSender::HandleCompletions()
+{
+    mRing.ForEachCompletion([&](const io_uring_cqe& aCompletion) {
+        if (aCompletion.res < 0) {
+            mFailedSends++;
+            mUnreportedFailure = true;
+            Logger::GetInstance().Log(std::string("io_uring send failed: ") + strerror(-aCompletion.res),
+                                      Logger::Level::DEBUG);
+        }
+        mFreeSlots.push_back(static_cast<uint16_t>(aCompletion.user_data));
+    });
+}
+
+bool IOUringSender::WaitForCompletion(std::unique_lock<std::mutex>& aLock)
+{
+    // Entries nobody is submitting yet are submitted along, otherwise nothing might complete
+    unsigned int lCount{mSubmitting ? 0 : mUnsubmitted};
+    mUnsubmitted -= lCount;
+
+    aLock.unlock();
+    int lResult{mRing.Enter(lCount, 1)};
+    aLock.lock();
+
+    if (lResult < 0 && lResult != -EINTR) {
+        mUnsubmitted += lCount;
+        Logger::GetInstance().Log(std::string("io_uring_enter failed: ") + strerror(-lResult), Logger::Level::DEBUG);
+        return false;
+    }
+
+    HandleCompletions();
+    return true;
+}
+
+SendResult IOUringSender::Send(std::string_view aData)
+{
+    std::unique_lock lLock{mMutex};
+
+    if (!mRing.IsOpen() || aData.size() > cSendSlotLength) {
+        return SendResult::NotQueued;
+    }
+
+    HandleCompletions();
+
+    // Sending this synchronously instead would make it overtake everything in flight
+    io_uring_sqe* lEntry{nullptr};
+    while (lEntry == nullptr) {
+        lEntry = mFreeSlots.empty() ? nullptr : mRing.GetSubmissionEntry();
+        if (lEntry == nullptr && (!WaitForCompletion(lLock) || !mRing.IsOpen())) {
+            return SendResult::Failed;
+        }
+    }
+
+    uint16_t lSlot{mFreeSlots.back()};
+    mFreeSlots.pop_back();
+    memcpy(mSlots.at(lSlot).data(), aData.data(), aData.size());
+
+    lEntry->opcode    = mFixedBuffers ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE;
+    lEntry->fd        = mFd;
+    lEntry->addr      = reinterpret_cast<uint64_t>(mSlots.at(lSlot).data());
+    lEntry->len       = static_cast<uint32_t>(aData.size());
+    lEntry->off       = static_cast<uint64_t>(-1);  // Sockets have no offset
+    lEntry->buf_index = mFixedBuffers ? lSlot : 0;
+    lEntry->user_data = lSlot;
+    mUnsubmitted += mRing.Publish();
+
+    SendResult lReturn{SendResult::Queued};
+
+    // Another thread is in the kernel already, it submits this entry together with its own when it comes back
+    if (!mSubmitting) {
+        mSubmitting = true;
+        while (mUnsubmitted > 0) {
+            unsigned int lCount{mUnsubmitted};
+            mUnsubmitted = 0;
+
+            lLock.unlock();
+            int lResult{mRing.Enter(lCount)};
+            lLock.lock();
+
+            if (lResult < 0) {
+                // Still in the submission queue, the next send tries again
+                mUnsubmitted += lCount;
+                Logger::GetInstance().Log(std::string("io_uring_enter failed: ") + strerror(-lResult),
+                                          Logger::Level::DEBUG);
+                lReturn = SendResult::Failed;
+                break;
+            }
+
+            if (static_cast<unsigned int>(lResult) < lCount) {
+                // Left in the submission queue by the kernel, try again with the next round
+                mUnsubmitted += lCount - static_cast<unsigned int>(lResult);
+                if (lResult == 0) {
+                    break;
+                }
+            }
+        }
+        mSubmitting = false;
+    }
+
+    // Failures of earlier sends are only known now, they still have to reach the error counters of the caller
+    if (mUnreportedFailure) {
+        mUnreportedFailure = false;
+        lReturn            = SendResult::Failed;
+    }
+
+    return lReturn;
+}
+#endif
@@ -0,0 +1,92 @@
+/* Copyright (c) 2022 [Rick de Bondt] - IOUringPCapWrapperLinux.cpp */
+
+#if defined(ENABLE_IO_URING)
+#include "IOUringPCapWrapperLinux.h"
+
+#include <cerrno>
+#include <cstring>
+
+#include <linux/if_packet.h>
+#include <net/if.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "Logger.h"
+
+pcap_t* IOUringPCapWrapper::Create(const char* source, char* errbuf)
+{
+    mSource = source;
+    return PCapWrapper::Create(source, errbuf);
+}
+
+int IOUringPCapWrapper::Activate()
+{
+    int lReturn{PCapWrapper::Activate()};
+
+    if (lReturn >= 0 && (!OpenSendSocket() || !mSender.Open(mSendSocket))) {
+        Logger::GetInstance().Log("io_uring not supported for sending, using libpcap directly", Logger::Level::INFO);
+    }
+
+    return lReturn;
+}
+
+bool IOUringPCapWrapper::OpenSendSocket()
+{
+    // Protocol 0, so the kernel never queues received packets on this socket
+    mSendSocket = socket(AF_PACKET, SOCK_RAW, 0);
+    if (mSendSocket < 0) {
+        Logger::GetInstance().Log(std::string("Could not open packet socket: ") + strerror(errno),
+                                  Logger::Level::DEBUG);
+        return false;
+    }
+
+    sockaddr_ll lAddress{};
+    lAddress.sll_family  = AF_PACKET;
+    lAddress.sll_ifindex = static_cast<int>(if_nametoindex(mSource.c_str()));
+
+    if (lAddress.sll_ifindex == 0 ||
+        bind(mSendSocket, reinterpret_cast<sockaddr*>(&lAddress), sizeof(lAddress)) != 0) {
+        Logger::GetInstance().Log("Could not bind packet socket to " + mSource, Logger::Level::DEBUG);
+        close(mSendSocket);
+        mSendSocket = -1;
+        return false;
+    }
+
+    return true;
+}
+
+void IOUringPCapWrapper::Close()
+{
+    mSender.Close();
+
+    if (mSendSocket >= 0) {
+        close(mSendSocket);
+        mSendSocket = -1;
+    }
+
+    PCapWrapper::Close();
+}
+
+int IOUringPCapWrapper::SendPacket(std::string_view buffer)
+{
+    int lReturn{0};
+
+    switch (mSender.Send(buffer)) {
+        case IOUring_Constants::SendResult::Queued:
+            break;
+        case IOUring_Constants::SendResult::NotQueued:
+            lReturn = PCapWrapper::SendPacket(buffer);
+            break;
+        case IOUring_Constants::SendResult::Failed:
+            lReturn = -1;
+            break;
+    }
+
+    return lReturn;
+}
+
+bool IOUringPCapWrapper::IsSendingThroughRing() const
+{
+    return mSender.IsOpen();
+}
+#endif
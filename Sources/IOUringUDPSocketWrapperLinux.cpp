@@ -0,0 +1,191 @@
+/* Copyright (c) 2022 [Rick de Bondt] - IOUringUDPSocketWrapperLinux.cpp */
+
+#if defined(ENABLE_IO_URING)
+#include "IOUringUDPSocketWrapperLinux.h"
+
+#include <cerrno>
+#include <cstring>
+
+#include "Logger.h"
+#include "Tracer.h"
+
+using namespace IOUringUDPSocketWrapper_Constants;
+
+bool IOUringUDPSocketWrapper::Open(std::string_view aIp, unsigned int aPort)
+{
+    bool lWasOpen{IsOpen()};
+    bool lReturn{UDPSocketWrapper::Open(aIp, aPort)};
+
+    if (lReturn && !lWasOpen) {
+        // Connected, so the sender can use plain writes and the kernel only hands us datagrams from XLink Kai
+        boost::system::error_code lError{};
+        mSocket.connect(mEndpoint, lError);
+
+        if (lError) {
+            Logger::GetInstance().Log("Could not connect socket, not using io_uring: " + lError.message(),
+                                      Logger::Level::WARNING);
+        } else {
+            if (!mSender.Open(mSocket.native_handle())) {
+                Logger::GetInstance().Log("io_uring not supported for sending, using the socket directly",
+                                          Logger::Level::INFO);
+            }
+
+            if (!OpenReceiveRing()) {
+                Logger::GetInstance().Log("io_uring not supported for receiving, using the socket directly",
+                                          Logger::Level::INFO);
+            }
+        }
+    }
+
+    return lReturn;
+}
+
+bool IOUringUDPSocketWrapper::OpenReceiveRing()
+{
+    mReceiveArmed     = false;
+    mReceivedAnything = false;
+
+    if (!IOUring::IsSupported({IORING_OP_RECVMSG}) || !mReceiveRing.Open(cReceiveBuffers)) {
+        return false;
+    }
+
+    if (!mReceiveRing.RegisterBufferRing(cBufferGroup, cReceiveBuffers)) {
+        mReceiveRing.Close();
+        return false;
+    }
+
+    mReceiveBuffers.resize(cReceiveBuffers * cReceiveBufferLength);
+    for (uint16_t lIndex = 0; lIndex < cReceiveBuffers; lIndex++) {
+        mReceiveRing.ProvideBuffer(&mReceiveBuffers.at(lIndex * cReceiveBufferLength), cReceiveBufferLength, lIndex);
+    }
+    mReceiveRing.CommitBuffers();
+
+    // No address or control data, the buffers only hold the header and the datagram
+    mMessage = msghdr{};
+
+    return true;
+}
+
+void IOUringUDPSocketWrapper::Close()
+{
+    mSender.Close();
+    mReceiveRing.Close();
+    mReceiveArmed = false;
+
+    UDPSocketWrapper::Close();
+}
+
+std::size_t IOUringUDPSocketWrapper::SendTo(std::string_view aData)
+{
+    TRACE_SCOPE("Socket send");
+
+    std::size_t lReturn{aData.size()};
+
+    switch (mSender.Send(aData)) {
+        case IOUring_Constants::SendResult::Queued:
+            break;
+        case IOUring_Constants::SendResult::NotQueued:
+            lReturn = UDPSocketWrapper::SendTo(aData);
+            break;
+        case IOUring_Constants::SendResult::Failed:
+            // Same as a failing synchronous send, so the caller counts it
+            throw boost::system::system_error(boost::system::errc::make_error_code(boost::system::errc::io_error));
+    }
+
+    return lReturn;
+}
+
+void IOUringUDPSocketWrapper::AsyncReceiveFrom(IUDPReceiveHandler& aHandler)
+{
+    if (mReceiveRing.IsOpen()) {
+        mHandler = &aHandler;
+        if (!mReceiveArmed) {
+            ArmReceive();
+        }
+    } else {
+        UDPSocketWrapper::AsyncReceiveFrom(aHandler);
+    }
+}
+
+void IOUringUDPSocketWrapper::ArmReceive()
+{
+    io_uring_sqe* lEntry{mReceiveRing.GetSubmissionEntry()};
+
+    if (lEntry != nullptr) {
+        lEntry->opcode    = IORING_OP_RECVMSG;
+        lEntry->fd        = mSocket.native_handle();
+        lEntry->addr      = reinterpret_cast<uint64_t>(&mMessage);
+        lEntry->len       = 1;
+        lEntry->ioprio    = IORING_RECV_MULTISHOT;
+        lEntry->flags     = IOSQE_BUFFER_SELECT;
+        lEntry->buf_group = cBufferGroup;
+
+        mReceiveArmed = mReceiveRing.Enter(mReceiveRing.Publish()) > 0;
+    }
+}
+
+void IOUringUDPSocketWrapper::PollThread()
+{
+    UDPSocketWrapper::PollThread();
+
+    if (mReceiveRing.IsOpen()) {
+        HandleCompletions();
+    }
+}
+
+void IOUringUDPSocketWrapper::HandleCompletions()
+{
+    TRACE_SCOPE("Socket receive");
+
+    bool lUnsupported{false};
+
+    unsigned int lHandled{mReceiveRing.ForEachCompletion([&](const io_uring_cqe& aCompletion) {
+        if ((aCompletion.flags & IORING_CQE_F_MORE) == 0) {
+            // Ran out of buffers or hit an error, rearmed on the next AsyncReceiveFrom
+            mReceiveArmed = false;
+        }
+
+        if ((aCompletion.flags & IORING_CQE_F_BUFFER) != 0) {
+            auto  lId{static_cast<uint16_t>(aCompletion.flags >> IORING_CQE_BUFFER_SHIFT)};
+            char* lBuffer{&mReceiveBuffers.at(lId * cReceiveBufferLength)};
+
+            if (aCompletion.res >= static_cast<int>(sizeof(io_uring_recvmsg_out))) {
+                io_uring_recvmsg_out lHeader{};
+                memcpy(&lHeader, lBuffer, sizeof(lHeader));
+
+                std::size_t lOffset{sizeof(io_uring_recvmsg_out) + lHeader.namelen + lHeader.controllen};
+                std::size_t lLength{std::min<std::size_t>(lHeader.payloadlen, aCompletion.res - lOffset)};
+                if (mHandler != nullptr) {
+                    mHandler->HandleDatagram(std::string_view(lBuffer + lOffset, lLength));
+                }
+                mReceivedAnything = true;
+            }
+
+            mReceiveRing.ProvideBuffer(lBuffer, cReceiveBufferLength, lId);
+        } else if (aCompletion.res == -EINVAL && !mReceivedAnything) {
+            // Kernels before 6.0 know recvmsg, but not the multishot variant
+            lUnsupported = true;
+        }
+    })};
+
+    if (lHandled > 0) {
+        mReceiveRing.CommitBuffers();
+    }
+
+    if (lUnsupported) {
+        Logger::GetInstance().Log("Multishot receive not supported, using the socket directly", Logger::Level::INFO);
+        mReceiveRing.Close();
+        mReceiveArmed = false;
+    }
+}
+
+bool IOUringUDPSocketWrapper::IsReceivingThroughRing() const
+{
+    return mReceiveRing.IsOpen();
+}
+
+bool IOUringUDPSocketWrapper::IsSendingThroughRing() const
+{
+    return mSender.IsOpen();
+}
+#endif
@@ -0,0 +1,46 @@
+/* Copyright (c) 2022 [Rick de Bondt] - LatencyEstimator.cpp */
+
+#include "LatencyEstimator.h"
+
+using namespace LatencyEstimator_Constants;
+
+void LatencyEstimator::AddSample(std::chrono::microseconds aSample)
+{
+    if (mHasSamples) {
+        // The variation is updated with the old smoothed value, as RFC 6298 prescribes
+        std::chrono::microseconds lDeviation{(mSmoothed > aSample) ? (mSmoothed - aSample) : (aSample - mSmoothed)};
+        mVariation += (lDeviation - mVariation) / cVariationDivisor;
+        mSmoothed += (aSample - mSmoothed) / cSmoothingDivisor;
+    } else {
+        mSmoothed   = aSample;
+        mVariation  = aSample / 2;
+        mHasSamples = true;
+    }
+}
+
+void LatencyEstimator::Reset()
+{
+    mSmoothed   = std::chrono::microseconds(0);
+    mVariation  = std::chrono::microseconds(0);
+    mHasSamples = false;
+}
+
+bool LatencyEstimator::HasSamples() const
+{
+    return mHasSamples;
+}
+
+std::chrono::microseconds LatencyEstimator::GetSmoothed() const
+{
+    return mSmoothed;
+}
+
+std::chrono::microseconds LatencyEstimator::GetVariation() const
+{
+    return mVariation;
+}
+
+std::chrono::microseconds LatencyEstimator::GetUpperBound() const
+{
+    return mSmoothed + cVariationMultiplier * mVariation;
+}
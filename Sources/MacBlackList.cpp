@@ -2,34 +2,58 @@
 
 #include "MacBlackList.h"
 
+#include <algorithm>
+#include <mutex>
+
 #include "Logger.h"
 #include "NetConversionFunctions.h"
 
 void MacBlackList::AddToMacBlackList(uint64_t aMac)
 {
-    if (IsMacAllowed(aMac)) {
+    std::unique_lock lLock{mMutex};
+    if (IsMacAllowedLocked(aMac)) {
         Logger::GetInstance().Log("Added: " + IntToMac(aMac) + " to blacklist.", Logger::Level::TRACE);
         mBlackList.push_back(aMac);
     }
 }
 
+void MacBlackList::RemoveFromMacBlackList(uint64_t aMac)
+{
+    std::unique_lock lLock{mMutex};
+    auto             lEntry{std::find(mBlackList.begin(), mBlackList.end(), aMac)};
+    if (lEntry != mBlackList.end()) {
+        Logger::GetInstance().Log("Removed: " + IntToMac(aMac) + " from blacklist.", Logger::Level::TRACE);
+        mBlackList.erase(lEntry);
+    }
+}
+
 void MacBlackList::AddToMacWhiteList(uint64_t aMac)
 {
     Logger::GetInstance().Log("Added: " + IntToMac(aMac) + " to whitelist.", Logger::Level::TRACE);
+
+    std::unique_lock lLock{mMutex};
     mWhiteList.push_back(aMac);
 }
 
 void MacBlackList::ClearMacBlackList()
 {
+    std::unique_lock lLock{mMutex};
     mBlackList.clear();
 }
 
 void MacBlackList::ClearMacWhiteList()
 {
+    std::unique_lock lLock{mMutex};
     mWhiteList.clear();
 }
 
-bool MacBlackList::IsMacAllowed(uint64_t aMac)
+bool MacBlackList::IsMacAllowed(uint64_t aMac) const
+{
+    std::shared_lock lLock{mMutex};
+    return IsMacAllowedLocked(aMac);
+}
+
+bool MacBlackList::IsMacAllowedLocked(uint64_t aMac) const
 {
     bool lReturn{false};
 
@@ -50,6 +74,7 @@ bool MacBlackList::IsMacBlackListed(uint64_t aMac) const
 {
     bool lReturn{false};
 
+    std::shared_lock lLock{mMutex};
     if (std::find(mBlackList.begin(), mBlackList.end(), aMac) != mBlackList.end()) {
         lReturn = true;
     }
@@ -59,10 +84,12 @@ bool MacBlackList::IsMacBlackListed(uint64_t aMac) const
 
 void MacBlackList::SetMacBlackList(std::vector<uint64_t>& aBlackList)
 {
+    std::unique_lock lLock{mMutex};
     mBlackList = std::move(aBlackList);
 }
 
 void MacBlackList::SetMacWhiteList(std::vector<uint64_t>& aWhiteList)
 {
+    std::unique_lock lLock{mMutex};
     mWhiteList = std::move(aWhiteList);
-}
\ No newline at end of file
+}
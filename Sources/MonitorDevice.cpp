@@ -7,7 +7,9 @@
 #include <string>
 #include <thread>
 
+#include "FlightRecorder.h"
 #include "NetConversionFunctions.h"
+#include "Tracer.h"
 #include "XLinkKaiConnection.h"
 namespace
 {
@@ -19,7 +21,7 @@ using namespace std::chrono;
 
 MonitorDevice::MonitorDevice(uint64_t                      aSourceMacToFilter,
                              bool                          aAcknowledgeDataFrames,
-                             std::string*                  aCurrentlyConnectedNetwork,
+                             Property<std::string>*        aCurrentlyConnectedNetwork,
                              std::shared_ptr<IPCapWrapper> aPcapWrapper) :
     mAcknowledgePackets(aAcknowledgeDataFrames),
     mCurrentlyConnectedNetwork(aCurrentlyConnectedNetwork), mPcapWrapper(aPcapWrapper)
@@ -69,6 +71,11 @@ void MonitorDevice::BlackList(uint64_t aMac)
     mPacketHandler.GetBlackList().AddToMacBlackList(aMac);
 }
 
+void MonitorDevice::RemoveFromBlackList(uint64_t aMac)
+{
+    mPacketHandler.GetBlackList().RemoveFromMacBlackList(aMac);
+}
+
 void MonitorDevice::Close()
 {
     mConnected = false;
@@ -89,7 +96,8 @@ void MonitorDevice::Close()
 
 bool MonitorDevice::ReadCallback(const unsigned char* aData, const pcap_pkthdr* aHeader)
 {
-    bool lReturn{false};
+    HardwareCounters::Measurement lMeasurement{GetHardwareCounters()};
+    bool                          lReturn{false};
 
     // Load all needed information into the handler
     std::string lData{DataToString(aData, aHeader)};
@@ -100,6 +108,8 @@ bool MonitorDevice::ReadCallback(const unsigned char* aData, const pcap_pkthdr*
     if (!mPacketHandler.IsDropped()) {
         ShowPacketStatistics(aHeader);
         Logger::GetInstance().Log("Received: " + PrettyHexString(lData), Logger::Level::TRACE);
+        FlightRecorder::GetInstance().Record(
+            FlightRecorder::Interface::AirRadioTap, FlightRecorder::Direction::Inbound, lData);
     }
 
     if (mAcknowledgePackets && mPacketHandler.IsAckable()) {
@@ -122,7 +132,7 @@ bool MonitorDevice::ReadCallback(const unsigned char* aData, const pcap_pkthdr*
     if (lOldSSID != mPacketHandler.GetLockedSSID()) {
         // For use in userinterface
         if (mCurrentlyConnectedNetwork != nullptr) {
-            *mCurrentlyConnectedNetwork = mPacketHandler.GetLockedSSID();
+            mCurrentlyConnectedNetwork->Set(mPacketHandler.GetLockedSSID());
         }
 
         GetConnector()->SendESSID(mPacketHandler.GetLockedSSID());
@@ -149,12 +159,17 @@ bool MonitorDevice::Send(std::string_view aData)
     if (mPcapWrapper->IsActivated()) {
         if (!aData.empty()) {
             Logger::GetInstance().Log(std::string("Sent: ") + PrettyHexString(aData), Logger::Level::TRACE);
+            FlightRecorder::GetInstance().Record(
+                FlightRecorder::Interface::AirRadioTap, FlightRecorder::Direction::Outbound, aData);
 
             if (mPcapWrapper->SendPacket(aData) == 0) {
+                IncreaseSentPacketCount(aData.size());
                 lReturn = true;
             } else {
+                IncreaseSendErrorCount();
                 Logger::GetInstance().Log("pcap_sendpacket failed, " + std::string(mPcapWrapper->GetError()),
                                           Logger::Level::ERROR);
+                FlightRecorder::GetInstance().Dump("Injecting a frame failed");
             }
         }
     } else {
@@ -172,6 +187,9 @@ bool MonitorDevice::StartReceiverThread()
         // Run
         if (mReceiverThread == nullptr) {
             mReceiverThread = std::make_shared<std::thread>([&] {
+                TRACE_THREAD_NAME("Monitor receiver");
+                ApplyReceiverThreadAffinity();
+
                 // If we're receiving data from the receiver thread, send it off as well.
                 bool lSendReceivedDataOld = mSendReceivedData;
                 mSendReceivedData         = true;
@@ -183,9 +201,15 @@ bool MonitorDevice::StartReceiverThread()
                     };
 
                 while (mConnected && (mPcapWrapper->IsActivated())) {
+                    TRACE_START(lDispatchStart);
+
                     // Use pcap_dispatch instead of pcap_next_ex so that as many packets as possible will be processed
                     // in a single cycle.
-                    if (mPcapWrapper->Dispatch(-1, lCallbackFunction, reinterpret_cast<u_char*>(this)) == -1) {
+                    int lPackets{mPcapWrapper->Dispatch(-1, lCallbackFunction, reinterpret_cast<u_char*>(this))};
+                    if (lPackets > 0) {
+                        // Polls that came back empty would drown out everything else in the trace
+                        TRACE_EVENT("Dispatch", lDispatchStart);
+                    } else if (lPackets == -1) {
                         Logger::GetInstance().Log(
                             "Error occurred while reading packet: " + std::string(mPcapWrapper->GetError()),
                             Logger::Level::DEBUG);
@@ -2,6 +2,13 @@
 
 #include "PCapDeviceBase.h"
 
+#if defined(_WIN32) || defined(_WIN64)
+#include <Windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
 #include "Logger.h"
 #include "PCapWrapper.h"
 
@@ -10,6 +17,46 @@ void PCapDeviceBase::SetConnector(std::shared_ptr<IConnector> aDevice)
     mConnector = aDevice;
 }
 
+void PCapDeviceBase::SetReceiverThreadAffinity(int aCPU)
+{
+    mReceiverThreadAffinity = aCPU;
+}
+
+void PCapDeviceBase::ApplyReceiverThreadAffinity()
+{
+    if (mReceiverThreadAffinity >= 0) {
+        bool lSuccess{false};
+#if defined(_WIN32) || defined(_WIN64)
+        lSuccess = SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR{1} << mReceiverThreadAffinity) != 0;
+#elif defined(__linux__)
+        cpu_set_t lCPUSet;
+        CPU_ZERO(&lCPUSet);
+        CPU_SET(mReceiverThreadAffinity, &lCPUSet);
+        lSuccess = pthread_setaffinity_np(pthread_self(), sizeof(lCPUSet), &lCPUSet) == 0;
+#endif
+        if (lSuccess) {
+            Logger::GetInstance().Log("Pinned receiver thread to CPU " + std::to_string(mReceiverThreadAffinity),
+                                      Logger::Level::DEBUG);
+        } else {
+            Logger::GetInstance().Log("Could not pin receiver thread to CPU " +
+                                          std::to_string(mReceiverThreadAffinity),
+                                      Logger::Level::WARNING);
+        }
+    }
+}
+
+IPCapDevice_Constants::DeviceStatistics PCapDeviceBase::GetStatistics() const
+{
+    IPCapDevice_Constants::DeviceStatistics lStatistics{};
+    lStatistics.PacketsReceived = mPacketCount;
+    lStatistics.BytesReceived   = mBytesReceived;
+    lStatistics.PacketsSent     = mPacketsSent;
+    lStatistics.BytesSent       = mBytesSent;
+    lStatistics.SendErrors      = mSendErrors;
+    lStatistics.Cpu             = mHardwareCounters.GetStatistics();
+    return lStatistics;
+}
+
 void PCapDeviceBase::ShowPacketStatistics(const pcap_pkthdr* aHeader) const
 {
     Logger::GetInstance().Log("Packet # " + std::to_string(mPacketCount), Logger::Level::TRACE);
@@ -29,9 +76,14 @@ void PCapDeviceBase::ShowPacketStatistics(const pcap_pkthdr* aHeader) const
     }
 }
 
-std::shared_ptr<IConnector> PCapDeviceBase::GetConnector()
+IConnector* PCapDeviceBase::GetConnector()
 {
-    return mConnector;
+    return mConnector.get();
+}
+
+HardwareCounters& PCapDeviceBase::GetHardwareCounters()
+{
+    return mHardwareCounters;
 }
 
 const unsigned char* PCapDeviceBase::GetData()
@@ -47,6 +99,21 @@ const pcap_pkthdr* PCapDeviceBase::GetHeader()
 void PCapDeviceBase::IncreasePacketCount()
 {
     mPacketCount++;
+
+    if (mHeader != nullptr) {
+        mBytesReceived += mHeader->caplen;
+    }
+}
+
+void PCapDeviceBase::IncreaseSendErrorCount()
+{
+    mSendErrors++;
+}
+
+void PCapDeviceBase::IncreaseSentPacketCount(size_t aBytes)
+{
+    mPacketsSent++;
+    mBytesSent += aBytes;
 }
 
 void PCapDeviceBase::SetData(const unsigned char* aData)
@@ -65,10 +132,7 @@ std::string PCapDeviceBase::DataToString(const unsigned char* aData, const pcap_
     std::string lData{};
 
     if ((aData != nullptr) && (aHeader != nullptr)) {
-        lData.resize(aHeader->caplen);
-        for (unsigned int lCount = 0; lCount < aHeader->caplen; lCount++) {
-            lData.at(lCount) = static_cast<char>(aData[lCount]);
-        }
+        lData.assign(reinterpret_cast<const char*>(aData), aHeader->caplen);
     }
 
     return lData;
@@ -20,9 +20,15 @@ PCapReader::PCapReader(bool                          aMonitorCapture,
 
 void PCapReader::BlackList(uint64_t aMac)
 {
-    auto lHandler = std::dynamic_pointer_cast<Handler80211>(mPacketHandler);
-    if (lHandler != nullptr) {
-        mPacketHandler->GetBlackList().AddToMacBlackList(aMac);
+    if (mMonitorHandler != nullptr) {
+        mMonitorHandler->GetBlackList().AddToMacBlackList(aMac);
+    }
+}
+
+void PCapReader::RemoveFromBlackList(uint64_t aMac)
+{
+    if (mMonitorHandler != nullptr) {
+        mMonitorHandler->GetBlackList().RemoveFromMacBlackList(aMac);
     }
 }
 
@@ -51,11 +57,8 @@ uint64_t PCapReader::GetBSSID() const
 {
     uint64_t lBSSID{mBSSID};
 
-    if (mMonitorCapture) {
-        auto lHandler = std::dynamic_pointer_cast<Handler80211>(mPacketHandler);
-        if (lHandler != nullptr) {
-            lBSSID = lHandler->GetLockedBSSID();
-        }
+    if (mMonitorCapture && mMonitorHandler != nullptr) {
+        lBSSID = mMonitorHandler->GetLockedBSSID();
     }
 
     return lBSSID;
@@ -70,12 +73,9 @@ std::shared_ptr<RadioTapReader::PhysicalDeviceParameters> PCapReader::GetDataPar
 {
     std::shared_ptr<RadioTapReader::PhysicalDeviceParameters> lParameters{mParameters};
 
-    if (mMonitorCapture) {
-        auto lHandler = std::dynamic_pointer_cast<Handler80211>(mPacketHandler);
-        if (lHandler != nullptr) {
-            lParameters =
-                std::make_shared<RadioTapReader::PhysicalDeviceParameters>(lHandler->GetDataPacketParameters());
-        }
+    if (mMonitorCapture && mMonitorHandler != nullptr) {
+        lParameters =
+            std::make_shared<RadioTapReader::PhysicalDeviceParameters>(mMonitorHandler->GetDataPacketParameters());
     }
 
     return lParameters;
@@ -90,7 +90,9 @@ bool PCapReader::Open(std::string_view aArgument)
 {
     mMonitorCapture = false;
     // Create an 8023 handler, this is going to be a promiscuous capture
-    mPacketHandler = std::make_shared<Handler8023>();
+    mPromiscuousHandler = std::make_shared<Handler8023>();
+    mMonitorHandler     = nullptr;
+    mPacketHandler      = mPromiscuousHandler;
 
     bool                               lReturn{true};
     std::array<char, PCAP_ERRBUF_SIZE> lErrorBuffer{};
@@ -110,15 +112,15 @@ bool PCapReader::Open(std::string_view aName, std::vector<std::string>& aSSIDFil
 {
     mMonitorCapture = true;
     // Create an 80211 handler, this is going to ge a monitor capture
-    mPacketHandler = std::make_shared<Handler80211>();
+    mMonitorHandler     = std::make_shared<Handler80211>();
+    mPromiscuousHandler = nullptr;
+    mPacketHandler      = mMonitorHandler;
 
     bool                               lReturn{true};
     std::array<char, PCAP_ERRBUF_SIZE> lErrorBuffer{};
     mWrapper->OpenOffline(aName.data(), lErrorBuffer.data());
     if (mWrapper->IsActivated()) {
-        // If we have a monitor device we want the 80211 handler.
-        auto lHandler{std::dynamic_pointer_cast<Handler80211>(mPacketHandler)};
-        lHandler->SetSSIDFilterList(aSSIDFilter);
+        mMonitorHandler->SetSSIDFilterList(aSSIDFilter);
     } else {
         lReturn = false;
         Logger::GetInstance().Log("pcap_open_offline failed, " + std::string(lErrorBuffer.data()),
@@ -138,37 +140,33 @@ bool PCapReader::ReadCallback(const unsigned char* aData, const pcap_pkthdr* aHe
     mPacketHandler->Update(lData);
 
     if (mMonitorCapture) {
-        // If we have a monitor device we want the 80211 handler.
-        auto lHandler{std::dynamic_pointer_cast<Handler80211>(mPacketHandler)};
-
-        if (lHandler != nullptr) {
-            mESSID = lHandler->GetLockedSSID();
+        // If we have a monitor device we have the 80211 handler, resolved when opening.
+        Handler80211& lHandler{*mMonitorHandler};
+        mESSID = lHandler.GetLockedSSID();
 
-            if (!lHandler->IsDropped()) {
-                ShowPacketStatistics(aHeader);
-                Logger::GetInstance().Log("Received: " + PrettyHexString(lData), Logger::Level::TRACE);
-            }
+        if (!lHandler.IsDropped()) {
+            ShowPacketStatistics(aHeader);
+            Logger::GetInstance().Log("Received: " + PrettyHexString(lData), Logger::Level::TRACE);
+        }
 
-            if (mAcknowledgePackets && lHandler->IsAckable()) {
-                std::string lAcknowledgementFrame = ConstructAcknowledgementFrame(
-                    mPacketHandler->GetSourceMac(), lHandler->GetControlPacketParameters());
+        if (mAcknowledgePackets && lHandler.IsAckable()) {
+            std::string lAcknowledgementFrame =
+                ConstructAcknowledgementFrame(lHandler.GetSourceMac(), lHandler.GetControlPacketParameters());
 
-                Logger::GetInstance().Log("Sent ACK", Logger::Level::TRACE);
-                Send(lAcknowledgementFrame);
-            }
+            Logger::GetInstance().Log("Sent ACK", Logger::Level::TRACE);
+            Send(lAcknowledgementFrame);
+        }
 
-            // If this packet is convertible to something XLink can understand, send
-            if (lHandler->ShouldSend()) {
-                GetConnector()->Send(lHandler->ConvertPacketOut());
-            }
+        // If this packet is convertible to something XLink can understand, send
+        if (lHandler.ShouldSend()) {
+            GetConnector()->Send(lHandler.ConvertPacketOut());
         }
     } else {
         // Pretending to be XLink Kai or other outgoing connector
         if (mIncomingConnection != nullptr) {
             if (mMonitorOutput) {
-                auto lHandler = std::dynamic_pointer_cast<Handler8023>(mPacketHandler);
-                if (lHandler != nullptr) {
-                    mIncomingConnection->Send(lHandler->ConvertPacketOut(mBSSID, *mParameters));
+                if (mPromiscuousHandler != nullptr) {
+                    mIncomingConnection->Send(mPromiscuousHandler->ConvertPacketOut(mBSSID, *mParameters));
                 }
             } else {
                 mIncomingConnection->Send(lData);
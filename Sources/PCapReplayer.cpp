@@ -0,0 +1,204 @@
+/* Copyright (c) 2022 [Rick de Bondt] - PCapReplayer.cpp */
+
+#include "PCapReplayer.h"
+
+#include <algorithm>
+
+#include "Logger.h"
+#include "NetworkingHeaders.h"
+
+using namespace std::chrono;
+using namespace PCapReplayer_Constants;
+
+PCapReplayer::PCapReplayer(std::shared_ptr<IPCapWrapper> aWrapper) : mWrapper(aWrapper) {}
+
+PCapReplayer::~PCapReplayer()
+{
+    Stop();
+}
+
+bool PCapReplayer::Open(std::string_view aFileName)
+{
+    bool                               lReturn{false};
+    std::array<char, PCAP_ERRBUF_SIZE> lErrorBuffer{};
+
+    mPackets.clear();
+    mWrapper->OpenOffline(aFileName.data(), lErrorBuffer.data());
+
+    if (mWrapper->IsActivated()) {
+        pcap_pkthdr*         lHeader{nullptr};
+        const unsigned char* lData{nullptr};
+
+        while (mWrapper->NextEx(&lHeader, &lData) >= 0) {
+            Packet lPacket{};
+            lPacket.mData.assign(reinterpret_cast<const char*>(lData), lHeader->caplen);
+            lPacket.mTimeStamp = microseconds(lHeader->ts.tv_sec * 1000000 + lHeader->ts.tv_usec);
+            mPackets.emplace_back(lPacket);
+        }
+
+        mWrapper->Close();
+
+        if (!mPackets.empty()) {
+            Logger::GetInstance().Log("Loaded " + std::to_string(mPackets.size()) + " packets for replay",
+                                      Logger::Level::DEBUG);
+            lReturn = true;
+        } else {
+            Logger::GetInstance().Log("Capture has no packets to replay: " + std::string(aFileName),
+                                      Logger::Level::ERROR);
+        }
+    } else {
+        Logger::GetInstance().Log("pcap_open_offline failed, " + std::string(lErrorBuffer.data()),
+                                  Logger::Level::ERROR);
+    }
+
+    return lReturn;
+}
+
+void PCapReplayer::SetConnector(std::shared_ptr<IConnector> aConnector)
+{
+    mConnector = aConnector;
+}
+
+void PCapReplayer::SetIncomingConnection(std::shared_ptr<IPCapDevice> aDevice)
+{
+    mIncomingConnection = aDevice;
+}
+
+bool PCapReplayer::Start(const ReplaySettings& aSettings)
+{
+    bool lReturn{false};
+
+    if (mPackets.empty()) {
+        Logger::GetInstance().Log("Can't replay without a loaded capture!", Logger::Level::ERROR);
+    } else if (mConnector == nullptr && mIncomingConnection == nullptr) {
+        Logger::GetInstance().Log("Can't replay without a connector or device to replay to!", Logger::Level::ERROR);
+    } else if (aSettings.Streams == 0 || aSettings.SpeedMultiplier < cMaxSpeed) {
+        Logger::GetInstance().Log("Invalid replay settings", Logger::Level::ERROR);
+    } else if (aSettings.Streams > cMaxStreams) {
+        Logger::GetInstance().Log("Can't replay more than " + std::to_string(cMaxStreams) + " streams",
+                                  Logger::Level::ERROR);
+    } else {
+        Stop();
+
+        mSettings = aSettings;
+        mStreamStatistics.assign(mSettings.Streams, StreamStatistics{});
+        mStreamsRunning = mSettings.Streams;
+
+        for (unsigned int lStream = 0; lStream < mSettings.Streams; lStream++) {
+            mStreamThreads.emplace_back([this, lStream] { ReplayStream(lStream); });
+        }
+
+        lReturn = true;
+    }
+
+    return lReturn;
+}
+
+void PCapReplayer::Stop()
+{
+    mStopCommand = true;
+
+    for (auto& lThread : mStreamThreads) {
+        if (lThread.joinable()) {
+            lThread.join();
+        }
+    }
+
+    mStreamThreads.clear();
+    mStopCommand = false;
+}
+
+bool PCapReplayer::IsDone() const
+{
+    return mStreamsRunning == 0;
+}
+
+void PCapReplayer::RewriteMacAddresses(std::string& aPacket, unsigned int aStream)
+{
+    if (aStream > 0 && aPacket.size() >= Net_8023_Constants::cHeaderLength) {
+        for (unsigned int lIndex : {Net_8023_Constants::cDestinationAddressIndex,
+                                    Net_8023_Constants::cSourceAddressIndex}) {
+            // Group addresses (broadcast and multicast) have the lowest bit of the first byte set
+            if ((static_cast<uint8_t>(aPacket.at(lIndex)) & Net_Constants::cGroupAddressBit) == 0) {
+                char& lByte{aPacket.at(lIndex + cStreamMacByte)};
+                lByte = static_cast<char>(static_cast<uint8_t>(lByte) ^ static_cast<uint8_t>(aStream));
+            }
+        }
+    }
+}
+
+void PCapReplayer::ReplayStream(unsigned int aStream)
+{
+    StreamStatistics& lStatistics{mStreamStatistics.at(aStream)};
+
+    // Rewrite up front, so the replay itself only measures the bridge
+    std::vector<std::string> lPackets{};
+    lPackets.reserve(mPackets.size());
+    for (const auto& lPacket : mPackets) {
+        lPackets.emplace_back(lPacket.mData);
+        RewriteMacAddresses(lPackets.back(), aStream);
+    }
+
+    time_point<steady_clock> lStreamStart{steady_clock::now()};
+    unsigned int             lLoop{0};
+
+    while (!mStopCommand && (mSettings.Loops == 0 || lLoop < mSettings.Loops)) {
+        time_point<steady_clock> lLoopStart{steady_clock::now()};
+
+        for (std::size_t lIndex = 0; lIndex < lPackets.size() && !mStopCommand; lIndex++) {
+            if (mSettings.SpeedMultiplier > cMaxSpeed) {
+                duration<double, std::micro> lOffset{
+                    static_cast<double>((mPackets.at(lIndex).mTimeStamp - mPackets.front().mTimeStamp).count()) /
+                    mSettings.SpeedMultiplier};
+
+                time_point<steady_clock> lScheduled{lLoopStart + duration_cast<nanoseconds>(lOffset)};
+                std::this_thread::sleep_until(lScheduled);
+                lStatistics.mMaxLateness =
+                    std::max(lStatistics.mMaxLateness, duration_cast<nanoseconds>(steady_clock::now() - lScheduled));
+            }
+
+            time_point<steady_clock> lSendStart{steady_clock::now()};
+            if (mConnector != nullptr) {
+                mConnector->Send(lPackets.at(lIndex));
+            } else {
+                mIncomingConnection->Send(lPackets.at(lIndex));
+            }
+            nanoseconds lLatency{duration_cast<nanoseconds>(steady_clock::now() - lSendStart)};
+
+            lStatistics.mPackets++;
+            lStatistics.mBytes += lPackets.at(lIndex).size();
+            lStatistics.mTotalLatency += lLatency;
+            lStatistics.mMaxLatency = std::max(lStatistics.mMaxLatency, lLatency);
+        }
+
+        lLoop++;
+    }
+
+    lStatistics.mDuration = duration_cast<nanoseconds>(steady_clock::now() - lStreamStart);
+    mStreamsRunning--;
+}
+
+ReplayStatistics PCapReplayer::GetStatistics() const
+{
+    ReplayStatistics lReturn{};
+    nanoseconds      lTotalLatency{0};
+
+    for (const auto& lStatistics : mStreamStatistics) {
+        lReturn.Packets += lStatistics.mPackets;
+        lReturn.Bytes += lStatistics.mBytes;
+        lTotalLatency += lStatistics.mTotalLatency;
+        lReturn.Duration    = std::max(lReturn.Duration, lStatistics.mDuration);
+        lReturn.MaxLatency  = std::max(lReturn.MaxLatency, lStatistics.mMaxLatency);
+        lReturn.MaxLateness = std::max(lReturn.MaxLateness, lStatistics.mMaxLateness);
+    }
+
+    if (lReturn.Packets > 0) {
+        lReturn.AverageLatency = lTotalLatency / lReturn.Packets;
+    }
+
+    if (lReturn.Duration.count() > 0) {
+        lReturn.PacketsPerSecond = static_cast<double>(lReturn.Packets) / duration<double>(lReturn.Duration).count();
+    }
+
+    return lReturn;
+}
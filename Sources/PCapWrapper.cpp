@@ -120,3 +120,8 @@ int PCapWrapper::SetTimeOut(int timeout)
 {
     return pcap_set_timeout(mHandler, timeout);
 }
+
+bool PCapWrapper::WaitsForPackets()
+{
+    return false;
+}
@@ -0,0 +1,80 @@
+/* Copyright (c) 2022 [Rick de Bondt] - PacedSender.cpp */
+
+#include "PacedSender.h"
+
+#include "Tracer.h"
+
+PacedSender::PacedSender(SendFunction aSend) : mSend(std::move(aSend)), mThread([this] { Run(); }) {}
+
+PacedSender::~PacedSender()
+{
+    Stop();
+}
+
+void PacedSender::Start()
+{
+    if (!mThread.joinable()) {
+        mStopping = false;
+        mThread   = std::thread([this] { Run(); });
+    }
+}
+
+void PacedSender::Stop()
+{
+    {
+        std::scoped_lock lLock{mMutex};
+        mStopping = true;
+    }
+    mWakeUp.notify_one();
+
+    if (mThread.joinable()) {
+        mThread.join();
+    }
+}
+
+void PacedSender::Send(std::string_view aData, uint8_t aDataRate)
+{
+    {
+        std::scoped_lock lLock{mMutex};
+        mQueue.Push(aData, aDataRate, TransmitQueue::Clock::now());
+    }
+
+    mWakeUp.notify_one();
+}
+
+TransmitQueue_Constants::Statistics PacedSender::GetStatistics() const
+{
+    std::scoped_lock lLock{mMutex};
+
+    TransmitQueue_Constants::Statistics lReturn{mQueue.GetStatistics()};
+    lReturn.SendErrors = mSendErrors;
+    return lReturn;
+}
+
+void PacedSender::Run()
+{
+    TRACE_THREAD_NAME("Paced sender");
+
+    std::unique_lock lLock{mMutex};
+
+    while (!mStopping) {
+        if (mQueue.IsEmpty()) {
+            mWakeUp.wait(lLock, [&] { return mStopping || !mQueue.IsEmpty(); });
+        } else if (TransmitQueue::Clock::now() < mQueue.GetNextSendTime()) {
+            // New frames do not change when the air is free again
+            mWakeUp.wait_until(lLock, mQueue.GetNextSendTime(), [&] { return mStopping; });
+        } else {
+            std::optional<std::string> lFrame{mQueue.Pop(TransmitQueue::Clock::now())};
+            if (lFrame.has_value()) {
+                lLock.unlock();
+                bool lSent{mSend(lFrame.value())};
+                lLock.lock();
+
+                // The device logs and counts the failure itself, the airtime is spent regardless
+                if (!lSent) {
+                    mSendErrors++;
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,83 @@
+/* Copyright (c) 2022 [Rick de Bondt] - SSIDMatcher.cpp */
+
+#include "SSIDMatcher.h"
+
+#include <queue>
+
+using namespace SSIDMatcher_Constants;
+
+SSIDMatcher::SSIDMatcher(const std::vector<std::string>& aFilters) : mEmpty(aFilters.empty())
+{
+    // Build a trie of all filters first, 0 doubles as "no edge" because nothing ever goes back to the root in a trie
+    mTransitions.assign(cAlphabetSize, cRootState);
+    mAccepting.assign(1, false);
+
+    for (const auto& lFilter : aFilters) {
+        uint32_t lState{cRootState};
+        for (char lCharacter : lFilter) {
+            uint32_t& lNext{mTransitions.at(lState * cAlphabetSize + static_cast<uint8_t>(lCharacter))};
+            if (lNext == cRootState) {
+                lNext = static_cast<uint32_t>(mAccepting.size());
+                mTransitions.resize(mTransitions.size() + cAlphabetSize, cRootState);
+                mAccepting.push_back(false);
+            }
+            // Resizing may have moved the table, so read the state back through the index
+            lState = mTransitions.at(lState * cAlphabetSize + static_cast<uint8_t>(lCharacter));
+        }
+        mAccepting.at(lState) = true;
+    }
+
+    // Then turn the trie into an automaton, breadth first so failure states are always complete before they are used
+    std::vector<uint32_t> lFailure(mAccepting.size(), cRootState);
+    std::queue<uint32_t>  lQueue{};
+
+    for (std::size_t lCharacter = 0; lCharacter < cAlphabetSize; lCharacter++) {
+        uint32_t lNext{mTransitions.at(lCharacter)};
+        if (lNext != cRootState) {
+            lQueue.push(lNext);
+        }
+    }
+
+    while (!lQueue.empty()) {
+        uint32_t lState{lQueue.front()};
+        lQueue.pop();
+
+        for (std::size_t lCharacter = 0; lCharacter < cAlphabetSize; lCharacter++) {
+            uint32_t& lNext{mTransitions.at(lState * cAlphabetSize + lCharacter)};
+            uint32_t  lFailureNext{mTransitions.at(lFailure.at(lState) * cAlphabetSize + lCharacter)};
+
+            if (lNext != cRootState) {
+                lFailure.at(lNext) = lFailureNext;
+                if (mAccepting.at(lFailureNext)) {
+                    mAccepting.at(lNext) = true;
+                }
+                lQueue.push(lNext);
+            } else {
+                lNext = lFailureNext;
+            }
+        }
+    }
+}
+
+bool SSIDMatcher::IsEmpty() const
+{
+    return mEmpty;
+}
+
+bool SSIDMatcher::Matches(std::string_view aSSID) const
+{
+    bool lReturn{false};
+
+    if (!mEmpty) {
+        // An empty filter matches everything
+        uint32_t lState{cRootState};
+        lReturn = mAccepting[lState];
+
+        for (std::size_t lIndex = 0; lIndex < aSSID.size() && !lReturn; lIndex++) {
+            lState  = mTransitions[lState * cAlphabetSize + static_cast<uint8_t>(aSSID[lIndex])];
+            lReturn = mAccepting[lState];
+        }
+    }
+
+    return lReturn;
+}
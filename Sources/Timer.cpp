@@ -7,7 +7,7 @@
 bool Timer::Start()
 {
     if (mTimeOut > std::chrono::milliseconds(0)) {
-        mStartTime = std::chrono::system_clock::now();
+        mStartTime = std::chrono::steady_clock::now();
         mStarted   = true;
         return true;
     }
@@ -28,7 +28,7 @@ void Timer::Stop()
 
 bool Timer::IsTimedOut()
 {
-    if (mStarted && (std::chrono::system_clock::now() - mTimeOut) > mStartTime) {
+    if (mStarted && (std::chrono::steady_clock::now() - mTimeOut) > mStartTime) {
         mStarted = false;
         return true;
     }
@@ -38,7 +38,7 @@ bool Timer::IsTimedOut()
 std::chrono::milliseconds Timer::GetTimeLeft()
 {
     if (mStarted) {
-        auto lDelta = std::chrono::system_clock::now() - mTimeOut - mStartTime;
+        auto lDelta = std::chrono::steady_clock::now() - mTimeOut - mStartTime;
         return (lDelta > std::chrono::milliseconds(0)) ? std::chrono::duration_cast<std::chrono::milliseconds>(lDelta) :
                                                          std::chrono::milliseconds(0);
     }
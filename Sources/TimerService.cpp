@@ -0,0 +1,80 @@
+/* Copyright (c) 2022 [Rick de Bondt] - TimerService.cpp */
+
+#include "TimerService.h"
+
+#include "Tracer.h"
+
+TimerService::TimerService() : mThread([this] { Run(); }) {}
+
+TimerService::~TimerService()
+{
+    {
+        std::scoped_lock lLock{mMutex};
+        mStopping = true;
+    }
+    mWakeUp.notify_one();
+
+    if (mThread.joinable()) {
+        mThread.join();
+    }
+}
+
+TimerWheel::Id TimerService::Schedule(std::chrono::milliseconds aDelay, TimerWheel::Callback aCallback)
+{
+    return ScheduleAt(TimerWheel::Clock::now() + aDelay, std::move(aCallback));
+}
+
+TimerWheel::Id TimerService::ScheduleAt(TimerWheel::Clock::time_point aDeadline, TimerWheel::Callback aCallback)
+{
+    TimerWheel::Id lReturn{0};
+
+    {
+        std::scoped_lock lLock{mMutex};
+        lReturn  = mWheel.Schedule(aDeadline, std::move(aCallback));
+        mChanged = true;
+    }
+
+    // The thread may be sleeping until a later moment
+    mWakeUp.notify_one();
+
+    return lReturn;
+}
+
+bool TimerService::Cancel(TimerWheel::Id aId)
+{
+    std::unique_lock lLock{mMutex};
+    bool             lReturn{mWheel.Cancel(aId)};
+
+    if (aId != 0 && std::this_thread::get_id() != mThread.get_id()) {
+        mCallbackDone.wait(lLock, [&] { return mRunning != aId; });
+    }
+
+    return lReturn;
+}
+
+void TimerService::Run()
+{
+    TRACE_THREAD_NAME("Timers");
+
+    std::unique_lock lLock{mMutex};
+
+    while (!mStopping) {
+        for (auto& [lId, lCallback] : mWheel.Advance(TimerWheel::Clock::now())) {
+            mRunning = lId;
+            lLock.unlock();
+            lCallback();
+            lLock.lock();
+            mRunning = 0;
+            mCallbackDone.notify_all();
+        }
+
+        std::optional<TimerWheel::Clock::time_point> lWakeUp{mWheel.GetNextWakeUp()};
+        auto lPredicate{[&] { return mStopping || mChanged; }};
+        if (lWakeUp.has_value()) {
+            mWakeUp.wait_until(lLock, lWakeUp.value(), lPredicate);
+        } else {
+            mWakeUp.wait(lLock, lPredicate);
+        }
+        mChanged = false;
+    }
+}
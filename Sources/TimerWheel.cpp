@@ -0,0 +1,140 @@
+/* Copyright (c) 2022 [Rick de Bondt] - TimerWheel.cpp */
+
+#include "TimerWheel.h"
+
+#include <algorithm>
+
+using namespace TimerWheel_Constants;
+
+TimerWheel::TimerWheel(Clock::time_point aNow) : mStart(aNow) {}
+
+TimerWheel::Id TimerWheel::Schedule(Clock::time_point aDeadline, Callback aCallback)
+{
+    // Round up, so the timer never fires early
+    uint64_t lTick{mCurrentTick + 1};
+    if (aDeadline > GetTime(lTick)) {
+        lTick = static_cast<uint64_t>((aDeadline - mStart + cTick - Clock::duration(1)) / cTick);
+    }
+
+    Id lId{mNextId++};
+    mEntries.emplace(lId, Entry{lTick, std::move(aCallback)});
+    Place(lId, lTick);
+
+    return lId;
+}
+
+bool TimerWheel::Cancel(Id aId)
+{
+    // The id stays behind in its slot and is skipped when the slot comes up
+    return mEntries.erase(aId) > 0;
+}
+
+void TimerWheel::Place(Id aId, uint64_t aTick)
+{
+    // Too far away to tell apart, park it in the highest level and look again when it cascades
+    uint64_t lTick{std::min(aTick, mCurrentTick + cRange - 1)};
+    uint64_t lDelta{lTick - mCurrentTick};
+
+    unsigned int lLevel{0};
+    while (lLevel < cLevels - 1 && lDelta >= (uint64_t{1} << (cSlotBits * (lLevel + 1)))) {
+        lLevel++;
+    }
+
+    mLevels.at(lLevel).at((lTick >> (cSlotBits * lLevel)) & (cSlots - 1)).emplace_back(aId);
+}
+
+void TimerWheel::Cascade(unsigned int aLevel)
+{
+    Slot lSlot{};
+    lSlot.swap(mLevels.at(aLevel).at((mCurrentTick >> (cSlotBits * aLevel)) & (cSlots - 1)));
+
+    for (Id lId : lSlot) {
+        auto lEntry{mEntries.find(lId)};
+        if (lEntry != mEntries.end()) {
+            Place(lId, lEntry->second.mTick);
+        }
+    }
+}
+
+TimerWheel::Expired TimerWheel::Advance(Clock::time_point aNow)
+{
+    Expired  lReturn{};
+    uint64_t lTarget{(aNow > mStart) ? static_cast<uint64_t>((aNow - mStart) / cTick) : 0};
+
+    while (mCurrentTick < lTarget) {
+        if (mEntries.empty()) {
+            // Nothing to do, skip ahead
+            mCurrentTick = lTarget;
+            break;
+        }
+
+        mCurrentTick++;
+
+        // When a level wraps around, the next slot of the level above it comes close enough to move down
+        unsigned int lLevel{1};
+        while (lLevel < cLevels && (mCurrentTick & ((uint64_t{1} << (cSlotBits * lLevel)) - 1)) == 0) {
+            lLevel++;
+        }
+        for (unsigned int lCascade = lLevel - 1; lCascade > 0; lCascade--) {
+            Cascade(lCascade);
+        }
+
+        Slot lSlot{};
+        lSlot.swap(mLevels.at(0).at(mCurrentTick & (cSlots - 1)));
+
+        for (Id lId : lSlot) {
+            auto lEntry{mEntries.find(lId)};
+            if (lEntry != mEntries.end()) {
+                lReturn.emplace_back(lId, std::move(lEntry->second.mCallback));
+                mEntries.erase(lEntry);
+            }
+        }
+    }
+
+    return lReturn;
+}
+
+std::optional<TimerWheel::Clock::time_point> TimerWheel::GetNextWakeUp() const
+{
+    std::optional<Clock::time_point> lReturn{std::nullopt};
+
+    if (!mEntries.empty()) {
+        for (unsigned int lLevel = 0; lLevel < cLevels; lLevel++) {
+            unsigned int lShift{cSlotBits * lLevel};
+
+            // The slot the wheel is at has been handled already, a full turn later it comes up again
+            for (uint64_t lStep = 1; lStep <= cSlots; lStep++) {
+                uint64_t lSlotTick{((mCurrentTick >> lShift) + lStep) << lShift};
+                if (HasEntries(mLevels.at(lLevel).at((lSlotTick >> lShift) & (cSlots - 1)))) {
+                    if (!lReturn.has_value() || GetTime(lSlotTick) < lReturn.value()) {
+                        lReturn = GetTime(lSlotTick);
+                    }
+                    break;
+                }
+            }
+        }
+    }
+
+    return lReturn;
+}
+
+std::size_t TimerWheel::GetSize() const
+{
+    return mEntries.size();
+}
+
+TimerWheel::Clock::time_point TimerWheel::GetTime(uint64_t aTick) const
+{
+    return mStart + aTick * cTick;
+}
+
+bool TimerWheel::HasEntries(const Slot& aSlot) const
+{
+    for (Id lId : aSlot) {
+        if (mEntries.find(lId) != mEntries.end()) {
+            return true;
+        }
+    }
+
+    return false;
+}
@@ -0,0 +1,137 @@
+/* Copyright (c) 2022 [Rick de Bondt] - Tracer.cpp */
+
+#include "Tracer.h"
+
+#include <atomic>
+#include <fstream>
+#include <iomanip>
+
+#include "Logger.h"
+
+using namespace Tracer_Constants;
+
+namespace
+{
+    // Microseconds, which the Chrome trace format uses
+    double ToMicroseconds(Tracer::Clock::duration aDuration)
+    {
+        return std::chrono::duration<double, std::micro>(aDuration).count();
+    }
+
+    std::string EscapeJson(std::string_view aText)
+    {
+        std::string lReturn{};
+        for (char lCharacter : aText) {
+            if (lCharacter == '"' || lCharacter == '\\') {
+                lReturn += '\\';
+                lReturn += lCharacter;
+            } else if (static_cast<unsigned char>(lCharacter) >= ' ') {
+                lReturn += lCharacter;
+            }
+        }
+        return lReturn;
+    }
+}  // namespace
+
+void Tracer::AddEvent(const char* aName, Clock::time_point aStart, Clock::time_point aEnd)
+{
+    Event         lEvent{aName, aStart, aEnd - aStart};
+    ThreadBuffer& lBuffer{GetThreadBuffer()};
+
+    std::scoped_lock lLock{lBuffer.mMutex};
+    if (lBuffer.mEvents.size() < cMaxEvents) {
+        lBuffer.mEvents.emplace_back(lEvent);
+    } else {
+        lBuffer.mEvents.at(lBuffer.mNextEvent) = lEvent;
+        lBuffer.mNextEvent                     = (lBuffer.mNextEvent + 1) % cMaxEvents;
+    }
+}
+
+void Tracer::SetThreadName(std::string_view aName)
+{
+    uint32_t lThread{GetThreadNumber()};
+
+    std::scoped_lock lLock{mMutex};
+    mThreadNames.insert_or_assign(lThread, std::string(aName));
+}
+
+bool Tracer::Write(std::ostream& aStream) const
+{
+    std::scoped_lock lLock{mMutex};
+
+    aStream << R"({"displayTimeUnit":"ns","traceEvents":[)";
+
+    bool lFirst{true};
+    for (const auto& [lThread, lName] : mThreadNames) {
+        aStream << (lFirst ? "" : ",") << R"({"name":"thread_name","ph":"M","pid":1,"tid":)" << lThread
+                << R"(,"args":{"name":")" << EscapeJson(lName) << R"("}})";
+        lFirst = false;
+    }
+
+    aStream << std::fixed << std::setprecision(3);
+    for (const auto& [lThread, lBuffer] : mBuffers) {
+        std::scoped_lock lBufferLock{lBuffer->mMutex};
+        for (const auto& lEvent : lBuffer->mEvents) {
+            aStream << (lFirst ? "" : ",") << R"({"name":")" << EscapeJson(lEvent.mName) << R"(","cat":")"
+                    << cCategory << R"(","ph":"X","pid":1,"tid":)" << lThread
+                    << R"(,"ts":)" << ToMicroseconds(lEvent.mStart - mCreated)
+                    << R"(,"dur":)" << ToMicroseconds(lEvent.mDuration) << "}";
+            lFirst = false;
+        }
+    }
+
+    aStream << "]}\n";
+    aStream.flush();
+
+    return aStream.good();
+}
+
+bool Tracer::Save(const std::string& aFileName) const
+{
+    bool          lReturn{false};
+    std::ofstream lFile{aFileName};
+
+    if (lFile.is_open() && Write(lFile)) {
+        Logger::GetInstance().Log("Saved trace to " + aFileName, Logger::Level::INFO);
+        lReturn = true;
+    } else {
+        Logger::GetInstance().Log("Could not save trace to " + aFileName, Logger::Level::ERROR);
+    }
+
+    return lReturn;
+}
+
+uint32_t Tracer::GetThreadNumber()
+{
+    static std::atomic<uint32_t> lNextThread{1};
+    thread_local uint32_t        lThread{lNextThread++};
+    return lThread;
+}
+
+uint64_t Tracer::GetNextId()
+{
+    static std::atomic<uint64_t> lNextId{1};
+    return lNextId++;
+}
+
+Tracer::ThreadBuffer& Tracer::GetThreadBuffer()
+{
+    // Remembers the buffer last used by this thread, so only switching tracers has to take the shared lock
+    thread_local uint64_t                      lTracer{0};
+    thread_local std::shared_ptr<ThreadBuffer> lBuffer{};
+
+    if (lTracer != mId) {
+        uint32_t         lThread{GetThreadNumber()};
+        std::scoped_lock lLock{mMutex};
+
+        auto& lEntry{mBuffers[lThread]};
+        if (lEntry == nullptr) {
+            lEntry = std::make_shared<ThreadBuffer>();
+        }
+
+        lBuffer = lEntry;
+        lTracer = mId;
+    }
+
+    return *lBuffer;
+}
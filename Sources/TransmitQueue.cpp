@@ -0,0 +1,128 @@
+/* Copyright (c) 2022 [Rick de Bondt] - TransmitQueue.cpp */
+
+#include "TransmitQueue.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace TransmitQueue_Constants;
+
+void TransmitQueue::Push(std::string_view aData, uint8_t aDataRate, Clock::time_point aNow)
+{
+    if (mFrames.size() >= cMaximumFrames) {
+        mFrames.pop_front();
+        mStatistics.Overflows++;
+    }
+
+    mFrames.emplace_back(Frame{std::string(aData), aDataRate, aNow});
+}
+
+std::optional<TransmitQueue::Frame> TransmitQueue::TakeFront(Clock::time_point aNow, bool& aOkToDrop)
+{
+    std::optional<Frame> lReturn{std::nullopt};
+    aOkToDrop = false;
+
+    // Way too old to be of any use, regardless of what CoDel thinks
+    while (!mFrames.empty() && (aNow - mFrames.front().mQueued) > cMaximumAge) {
+        mFrames.pop_front();
+        mStatistics.AgeDrops++;
+    }
+
+    if (!mFrames.empty()) {
+        lReturn = std::move(mFrames.front());
+        mFrames.pop_front();
+
+        // A single frame waiting is no standing queue
+        if ((aNow - lReturn->mQueued) < cTarget || mFrames.empty()) {
+            mFirstAboveTime.reset();
+        } else if (!mFirstAboveTime.has_value()) {
+            mFirstAboveTime = aNow + cInterval;
+        } else if (aNow >= mFirstAboveTime.value()) {
+            aOkToDrop = true;
+        }
+    } else {
+        mFirstAboveTime.reset();
+    }
+
+    return lReturn;
+}
+
+TransmitQueue::Clock::time_point TransmitQueue::GetNextDropTime(Clock::time_point aTime) const
+{
+    return aTime + std::chrono::duration_cast<Clock::duration>(cInterval / std::sqrt(std::max(mCount, 1U)));
+}
+
+std::optional<std::string> TransmitQueue::Pop(Clock::time_point aNow)
+{
+    std::optional<std::string> lReturn{std::nullopt};
+
+    bool                 lOkToDrop{false};
+    std::optional<Frame> lFrame{TakeFront(aNow, lOkToDrop)};
+
+    if (!lFrame.has_value()) {
+        mDropping = false;
+    } else if (mDropping) {
+        if (!lOkToDrop) {
+            mDropping = false;
+        }
+
+        while (lFrame.has_value() && mDropping && aNow >= mDropNext) {
+            mStatistics.AgeDrops++;
+            mCount++;
+            lFrame = TakeFront(aNow, lOkToDrop);
+            if (!lOkToDrop) {
+                mDropping = false;
+            } else {
+                mDropNext = GetNextDropTime(mDropNext);
+            }
+        }
+    } else if (lOkToDrop) {
+        mStatistics.AgeDrops++;
+        lFrame    = TakeFront(aNow, lOkToDrop);
+        mDropping = true;
+
+        // Carry on with the drop rate of the last time the queue was too long, if that was not long ago
+        unsigned int lDelta{mCount - mLastCount};
+        mCount     = (lDelta > 1 && (aNow - mDropNext) < 16 * cInterval) ? lDelta : 1;
+        mDropNext  = GetNextDropTime(aNow);
+        mLastCount = mCount;
+    }
+
+    if (lFrame.has_value()) {
+        mNextSendTime = std::max(mNextSendTime, aNow) + GetAirtime(lFrame->mData.size(), lFrame->mDataRate);
+        mStatistics.Sent++;
+        lReturn = std::move(lFrame->mData);
+    }
+
+    return lReturn;
+}
+
+TransmitQueue::Clock::time_point TransmitQueue::GetNextSendTime() const
+{
+    return mNextSendTime;
+}
+
+bool TransmitQueue::IsEmpty() const
+{
+    return mFrames.empty();
+}
+
+Statistics TransmitQueue::GetStatistics() const
+{
+    return mStatistics;
+}
+
+TransmitQueue::Clock::duration TransmitQueue::GetAirtime(std::size_t aSize, uint8_t aDataRate)
+{
+    Clock::duration lReturn{0};
+
+    if (aDataRate > 0) {
+        // 1, 2, 5.5 and 11 Mbps are the 802.11b rates, everything else is OFDM
+        bool lDSSS{aDataRate == 2 || aDataRate == 4 || aDataRate == 11 || aDataRate == 22};
+
+        // Rate is in units of 500 kbps, so every byte takes 16 / rate microseconds
+        lReturn = (lDSSS ? cDSSSOverhead : cOFDMOverhead) + std::chrono::microseconds(aSize * 16 / aDataRate);
+    }
+
+    return lReturn;
+}
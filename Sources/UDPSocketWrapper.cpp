@@ -2,13 +2,25 @@
 
 #include "UDPSocketWrapper.h"
 
-#include <boost/bind/bind.hpp>
 #include <boost/exception/exception.hpp>
 #include <boost/system/error_code.hpp>
 
 #include "Logger.h"
+#include "Tracer.h"
 
-using namespace boost::placeholders;
+using namespace UDPSocketWrapper_Constants;
+
+UDPSocketWrapper::UDPSocketWrapper()
+{
+#if defined(__linux__)
+    for (std::size_t lIndex = 0; lIndex < cBatchSize; lIndex++) {
+        mVectors.at(lIndex).iov_base            = mBuffers.at(lIndex).data();
+        mVectors.at(lIndex).iov_len             = cMaxDatagramLength;
+        mMessages.at(lIndex).msg_hdr.msg_iov    = &mVectors.at(lIndex);
+        mMessages.at(lIndex).msg_hdr.msg_iovlen = 1;
+    }
+#endif
+}
 
 bool UDPSocketWrapper::IsOpen()
 {
@@ -32,13 +44,69 @@ bool UDPSocketWrapper::Open(std::string_view aIp, unsigned int aPort)
             Logger::GetInstance().Log("Failed to open socket: " + std::string(lException.what()), Logger::Level::ERROR);
             return false;
         }
+
+        // Not being able to apply the options is logged, but the socket still works with the defaults
+        ApplyOptions();
     }
 
     return true;
 }
 
+bool UDPSocketWrapper::SetOptions(const SocketOptions& aOptions)
+{
+    mOptions = aOptions;
+
+    bool lReturn{true};
+    if (mSocket.is_open()) {
+        lReturn = ApplyOptions();
+    }
+
+    return lReturn;
+}
+
+bool UDPSocketWrapper::ApplyOptions()
+{
+    bool                      lReturn{true};
+    boost::system::error_code lError{};
+
+    if (mOptions.ReceiveBufferSize > 0) {
+        mSocket.set_option(boost::asio::socket_base::receive_buffer_size(mOptions.ReceiveBufferSize), lError);
+        if (lError) {
+            Logger::GetInstance().Log("Failed to set receive buffer size: " + lError.message(), Logger::Level::WARNING);
+            lReturn = false;
+        }
+    }
+
+    if (mOptions.SendBufferSize > 0) {
+        mSocket.set_option(boost::asio::socket_base::send_buffer_size(mOptions.SendBufferSize), lError);
+        if (lError) {
+            Logger::GetInstance().Log("Failed to set send buffer size: " + lError.message(), Logger::Level::WARNING);
+            lReturn = false;
+        }
+    }
+
+    if (mOptions.BusyPoll > 0) {
+#if defined(SO_BUSY_POLL)
+        mSocket.set_option(boost::asio::detail::socket_option::integer<SOL_SOCKET, SO_BUSY_POLL>(mOptions.BusyPoll),
+                           lError);
+        if (lError) {
+            // Raising the busy poll time above the system default needs CAP_NET_ADMIN
+            Logger::GetInstance().Log("Failed to set busy poll: " + lError.message(), Logger::Level::WARNING);
+            lReturn = false;
+        }
+#else
+        Logger::GetInstance().Log("Busy poll is not supported on this platform", Logger::Level::WARNING);
+        lReturn = false;
+#endif
+    }
+
+    return lReturn;
+}
+
 size_t UDPSocketWrapper::SendTo(std::string_view aData)
 {
+    TRACE_SCOPE("Socket send");
+
     return mSocket.send_to(boost::asio::buffer(aData, aData.size()), mEndpoint);
 }
 
@@ -47,22 +115,57 @@ size_t UDPSocketWrapper::ReceiveFrom(char* aDataBuffer, size_t aDataBufferSize)
     return mSocket.receive_from(boost::asio::buffer(aDataBuffer, aDataBufferSize), mEndpoint);
 }
 
-void UDPSocketWrapper::ReceiveCallBack(const boost::system::error_code& /*aError*/, size_t aBufferSize)
+void UDPSocketWrapper::AsyncReceiveFrom(IUDPReceiveHandler& aHandler)
 {
-    mCallBack(aBufferSize);
+    mHandler = &aHandler;
+
+    if (!mReceivePending && mSocket.is_open()) {
+        mReceivePending = true;
+        mSocket.async_wait(boost::asio::ip::udp::socket::wait_read,
+                           [this](const boost::system::error_code& aError) { ReceiveBatch(aError); });
+    }
 }
 
-void UDPSocketWrapper::AsyncReceiveFrom(char*                       aDataBuffer,
-                                        size_t                      aDataBufferSize,
-                                        std::function<void(size_t)> aCallBack)
+void UDPSocketWrapper::ReceiveBatch(const boost::system::error_code& aError)
 {
-    mCallBack = std::move(aCallBack);
-    return mSocket.async_receive_from(boost::asio::buffer(aDataBuffer, aDataBufferSize),
-                                      mEndpoint,
-                                      boost::bind(&UDPSocketWrapper::ReceiveCallBack,
-                                                  this,
-                                                  boost::asio::placeholders::error,
-                                                  boost::asio::placeholders::bytes_transferred));
+    TRACE_SCOPE("Socket receive");
+
+    mReceivePending = false;
+
+    if (!aError && mHandler != nullptr) {
+        std::size_t lReceived{ReceiveIntoBuffers()};
+        for (std::size_t lIndex = 0; lIndex < lReceived; lIndex++) {
+            mHandler->HandleDatagram(std::string_view(mBuffers.at(lIndex).data(), mSizes.at(lIndex)));
+        }
+    }
+}
+
+std::size_t UDPSocketWrapper::ReceiveIntoBuffers()
+{
+    std::size_t lReceived{0};
+
+#if defined(__linux__)
+    int lResult{recvmmsg(
+        mSocket.native_handle(), mMessages.data(), static_cast<unsigned int>(cBatchSize), MSG_DONTWAIT, nullptr)};
+    if (lResult > 0) {
+        lReceived = static_cast<std::size_t>(lResult);
+        for (std::size_t lIndex = 0; lIndex < lReceived; lIndex++) {
+            mSizes.at(lIndex) = mMessages.at(lIndex).msg_len;
+        }
+    }
+#else
+    // The socket is readable, so the first receive does not block, after that only receive what is already there
+    boost::system::error_code lError{};
+    do {
+        mSizes.at(lReceived) =
+            mSocket.receive(boost::asio::buffer(mBuffers.at(lReceived).data(), cMaxDatagramLength), 0, lError);
+        if (!lError) {
+            lReceived++;
+        }
+    } while (!lError && lReceived < cBatchSize && mSocket.available(lError) > 0);
+#endif
+
+    return lReceived;
 }
 
 bool UDPSocketWrapper::IsThreadStopped()
@@ -85,4 +188,4 @@ void UDPSocketWrapper::StopThread()
 void UDPSocketWrapper::PollThread()
 {
     mThread.poll();
-}
\ No newline at end of file
+}
@@ -118,17 +118,20 @@ void HUDWindow::SetUp()
         return ScalePicture(GetHeightReference(), GetWidthReference(), *mActivePicture);
     })});
 
+    mOldConnected = GetModel().mCurrentlyConnectedNetwork.Get();
     AddObject({std::make_shared<String>(
         *this,
-        "Connected to: " + GetModel().mCurrentlyConnectedNetwork,
-        [&] { return ScaleConnectedTo(GetWidthReference(), GetModel().mCurrentlyConnectedNetwork); },
-        !GetModel().mCurrentlyConnectedNetwork.empty())});
+        "Connected to: " + mOldConnected,
+        [&] { return ScaleConnectedTo(GetWidthReference(), mOldConnected); },
+        !mOldConnected.empty())});
 
     AddObject({std::make_shared<String>(
-        *this, "Status: " + std::string(WindowModel_Constants::cEngineStatusTexts.at(GetModel().mEngineStatus)), [&] {
+        *this,
+        "Status: " + std::string(WindowModel_Constants::cEngineStatusTexts.at(GetModel().mEngineStatus.Get())),
+        [&] {
             return ScaleEngineStatus(GetHeightReference(),
                                      GetWidthReference(),
-                                     WindowModel_Constants::cEngineStatusTexts.at(GetModel().mEngineStatus));
+                                     WindowModel_Constants::cEngineStatusTexts.at(GetModel().mEngineStatus.Get()));
         })});
 
     AddObject({std::make_shared<Button>(
@@ -145,7 +148,7 @@ void HUDWindow::SetUp()
         "Re-Connect",
         [&] { return ScaleReConnectionButton(); },
         [&] {
-            GetModel().mCommand = WindowModel_Constants::Command::ReConnect;
+            GetModel().mCommand.Set(WindowModel_Constants::Command::ReConnect);
             return true;
         },
         false,
@@ -158,10 +161,11 @@ void HUDWindow::SetUp()
         "Start Engine",
         [&] { return ScaleStartEngineButton(GetHeightReference(), GetWidthReference()); },
         [&] {
-            if (GetModel().mEngineStatus == WindowModel_Constants::EngineStatus::Idle) {
-                GetModel().mCommand = WindowModel_Constants::Command::StartEngine;
-            } else if (GetModel().mEngineStatus == WindowModel_Constants::EngineStatus::Running) {
-                GetModel().mCommand = WindowModel_Constants::Command::StopEngine;
+            WindowModel_Constants::EngineStatus lEngineStatus{GetModel().mEngineStatus.Get()};
+            if (lEngineStatus == WindowModel_Constants::EngineStatus::Idle) {
+                GetModel().mCommand.Set(WindowModel_Constants::Command::StartEngine);
+            } else if (lEngineStatus == WindowModel_Constants::EngineStatus::Running) {
+                GetModel().mCommand.Set(WindowModel_Constants::Command::StopEngine);
             }
             return true;
         })});
@@ -170,48 +174,73 @@ void HUDWindow::SetUp()
         *this, "Hosting", [&] { return ScaleHostingButton(); }, GetModel().mHosting)});
 
     AddObject(CreateQuitText(*this, GetHeightReference()));
+
+    // Called from the engine and device threads, the objects themselves are only updated in Draw
+    auto lModelChanged{[&](const auto& /*aValue*/) {
+        mModelChanged = true;
+        SetDirty();
+    }};
+    mEngineStatusSubscription = GetModel().mEngineStatus.Subscribe(lModelChanged);
+    mConnectedSubscription    = GetModel().mCurrentlyConnectedNetwork.Subscribe(lModelChanged);
 }
 
 void HUDWindow::Draw()
 {
-    if (GetModel().mEngineStatus == WindowModel_Constants::EngineStatus::Idle) {
-        // TODO: This still needs a better method
-        mActivePicture = &mOffPicture;
-        GetObjects().at(0)->SetName(*mActivePicture);
-        GetObjects().at(0)->Scale();
-        GetObjects().at(5)->SetName("Start Engine");
-    } else if (GetModel().mEngineStatus == WindowModel_Constants::EngineStatus::Running) {
-        mActivePicture = &mOnPicture;
-        GetObjects().at(0)->SetName(*mActivePicture);
-        GetObjects().at(0)->Scale();
+    if (mModelChanged.exchange(false)) {
+        UpdateEngineStatus();
+        UpdateConnected();
+    }
+
+    if (mOldHosting != GetModel().mHosting) {
+        mOldHosting = GetModel().mHosting;
+        // Tell the engine to start broadcasting ssids
+        GetModel().mCommand.Set(WindowModel_Constants::Command::SetHosting);
+    }
+
+    Window::Draw();
+}
 
-        auto lStartStopButton = std::dynamic_pointer_cast<Button>(GetObjects().at(5));
+void HUDWindow::UpdateEngineStatus()
+{
+    WindowModel_Constants::EngineStatus lEngineStatus{GetModel().mEngineStatus.Get()};
+    if (mOldEngineStatus != lEngineStatus) {
+        mOldEngineStatus = lEngineStatus;
+
+        if (lEngineStatus == WindowModel_Constants::EngineStatus::Idle) {
+            mActivePicture = &mOffPicture;
+            GetObjects().at(5)->SetName("Start Engine");
+        } else if (lEngineStatus == WindowModel_Constants::EngineStatus::Running) {
+            mActivePicture = &mOnPicture;
+            auto lStartStopButton = GetObjects().at(5);
+
+            // Clear line so you won't get double text
+            ClearLine(lStartStopButton->GetYCoord(),
+                      lStartStopButton->GetXCoord(),
+                      static_cast<int>(std::string("[ Start Engine ]").length()));
+
+            lStartStopButton->SetName("Stop Engine");
+        }
 
-        // Clear line so you won't get double text
-        ClearLine(lStartStopButton->GetYCoord(),
-                  lStartStopButton->GetXCoord(),
-                  static_cast<int>(std::string("[ Start Engine ]").length()));
+        GetObjects().at(0)->SetName(*mActivePicture);
+        GetObjects().at(0)->Scale();
 
-        lStartStopButton->SetName("Stop Engine");
+        // The status texts differ in length, the border gets drawn again afterwards
+        ClearLine(GetObjects().at(2)->GetYCoord(), 1, GetWidthReference() - 2);
+        GetObjects().at(2)->SetName(std::string("Status: ") +
+                                    std::string(WindowModel_Constants::cEngineStatusTexts.at(lEngineStatus)));
+        GetObjects().at(2)->Scale();
     }
+}
 
-    if (mOldConnected != GetModel().mCurrentlyConnectedNetwork) {
+void HUDWindow::UpdateConnected()
+{
+    std::string lConnected{GetModel().mCurrentlyConnectedNetwork.Get()};
+    if (mOldConnected != lConnected) {
         // The Connected to: will otherwise show up multiple times
         ClearLine(1, 1, GetWidthReference() - 1);
-        mOldConnected = GetModel().mCurrentlyConnectedNetwork;
-        GetObjects().at(1)->SetVisible(!GetModel().mCurrentlyConnectedNetwork.empty());
-        GetObjects().at(1)->SetName("Connected to: " + GetModel().mCurrentlyConnectedNetwork);
+        mOldConnected = lConnected;
+        GetObjects().at(1)->SetVisible(!mOldConnected.empty());
+        GetObjects().at(1)->SetName("Connected to: " + mOldConnected);
         GetObjects().at(1)->Scale();
     }
-
-    if (mOldHosting != GetModel().mHosting) {
-        mOldHosting = GetModel().mHosting;
-        // Tell the engine to start broadcasting ssids
-        GetModel().mCommand = WindowModel_Constants::Command::SetHosting;
-    }
-
-    GetObjects().at(2)->SetName(std::string("Status: ") +
-                                std::string(WindowModel_Constants::cEngineStatusTexts.at(GetModel().mEngineStatus)));
-
-    Window::Draw();
 }
@@ -48,8 +48,11 @@ void UIObject::SetHasUpAction(bool aHasAction)
 void UIObject::Scale()
 {
     Window::Dimensions lParameters{mScaleCalculation()};
-    mYCoord = lParameters.at(0);
-    mXCoord = lParameters.at(1);
+    if (mYCoord != lParameters.at(0) || mXCoord != lParameters.at(1)) {
+        mYCoord = lParameters.at(0);
+        mXCoord = lParameters.at(1);
+        mWindow.SetDirty();
+    }
 }
 
 bool UIObject::IsSelected() const
@@ -65,11 +68,14 @@ void UIObject::SetSelected(bool /*aSelected*/)
 
 void UIObject::SetVisible(bool aVisible)
 {
-    mVisible = aVisible;
+    if (mVisible != aVisible) {
+        mVisible = aVisible;
 
-    // Also clear the line that this is on.
-    if (!mVisible) {
-        mWindow.ClearLine(mYCoord, 0, mWindow.GetSize().second);
+        // Also clear the line that this is on.
+        if (!mVisible) {
+            mWindow.ClearLine(mYCoord, 0, mWindow.GetSize().second);
+        }
+        mWindow.SetDirty();
     }
 }
 
@@ -90,7 +96,10 @@ std::string_view UIObject::GetName()
 
 void UIObject::SetName(std::string_view aName)
 {
-    mName = aName;
+    if (mName != aName) {
+        mName = aName;
+        mWindow.SetDirty();
+    }
 }
 
 bool UIObject::IsSelectable() const
@@ -31,6 +31,9 @@ bool Window::HandleKey(unsigned int aKeyCode)
 {
     bool lReturn{false};
 
+    // Keys can change anything in the window, so just draw it again
+    SetDirty();
+
     switch (aKeyCode) {
         case cCombinedKeypadUp:
         case KEY_UP:
@@ -59,6 +62,11 @@ bool Window::HandleKey(unsigned int aKeyCode)
 
 void Window::Draw()
 {
+    // Cleared before drawing, so changes made while drawing are picked up on the next frame
+    if (!mDirty.exchange(false)) {
+        return;
+    }
+
     if (mDrawBorder) {
         box(mNCursesWindow.get(), 0, 0);
         DrawString(0, 0, 7, mTitle);
@@ -107,7 +115,17 @@ void Window::AddObject(std::shared_ptr<IUIObject> aObject)
 
 void Window::Refresh()
 {
-    wrefresh(mNCursesWindow.get());
+    wnoutrefresh(mNCursesWindow.get());
+}
+
+void Window::SetDirty()
+{
+    mDirty = true;
+}
+
+bool Window::IsDirty()
+{
+    return mDirty;
 }
 
 bool Window::Move(int aYCoord, int aXCoord)
@@ -146,6 +164,8 @@ bool Window::Scale()
             lReturn = true;
         }
 
+        SetDirty();
+
         for (auto& lObject : mObjects) {
             lObject->Scale();
         }
@@ -173,6 +193,7 @@ bool Window::SetSelection(int aSelection)
         mObjects.at(mSelectedObject)->SetSelected(false);
         mSelectedObject = aSelection;
         mObjects.at(mSelectedObject)->SetSelected(true);
+        SetDirty();
         lReturn = true;
     }
 
@@ -341,6 +362,8 @@ void Window::DeSelect()
     for (auto& lObject : mObjects) {
         lObject->SetSelected(false);
     }
+
+    SetDirty();
 }
 
 bool Window::IsExclusive()
@@ -360,6 +383,9 @@ bool Window::IsVisible()
 
 void Window::SetVisible(bool aVisible)
 {
+    if (aVisible && !mVisible) {
+        SetDirty();
+    }
     mVisible = aVisible;
 }
 
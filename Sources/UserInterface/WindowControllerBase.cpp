@@ -2,6 +2,8 @@
 
 #include "UserInterface/WindowControllerBase.h"
 
+#include "Tracer.h"
+
 WindowControllerBase::WindowControllerBase(WindowModel& aWindowModel) : mWindowModel(aWindowModel) {}
 
 const int& WindowControllerBase::GetHeightReference()
@@ -70,6 +72,8 @@ bool WindowControllerBase::Process()
 
     if (!mWindowModel.mStopProgram) {
         if (mSubController == nullptr) {
+            TRACE_SCOPE("Draw");
+
             int lHeight{0};
             int lWidth{0};
             getmaxyx(stdscr, lHeight, lWidth);
@@ -90,6 +94,8 @@ bool WindowControllerBase::Process()
             }
 #endif
 
+            // Windows only queue their changes, the terminal gets updated once for all of them
+            wnoutrefresh(stdscr);
             for (auto& lWindow : mWindows) {
                 if (lWindow->IsVisible()) {
                     if (mDimensionsChanged) {
@@ -100,7 +106,7 @@ bool WindowControllerBase::Process()
                 }
             }
 
-            refresh();
+            doupdate();
             curs_set(0);
         }
 
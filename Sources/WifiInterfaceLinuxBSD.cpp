@@ -12,6 +12,7 @@
 #include "Logger.h"
 #include "NetConversionFunctions.h"
 #include "Timer.h"
+#include "Tracer.h"
 
 #ifdef __linux__
 #include <netpacket/packet.h>
@@ -509,6 +510,8 @@ std::vector<IWifiInterface::WifiInformation>& WifiInterface::GetAdhocNetworks()
 
 std::vector<IWifiInterface::WifiInformation>& WifiInterface::GetAdhocNetworks(std::shared_ptr<ITimer> aTimer)
 {
+    TRACE_SCOPE("Netlink scan");
+
     // Clear previous scan info
     mLastReceivedScanInformation.clear();
 
@@ -560,6 +563,8 @@ std::vector<IWifiInterface::WifiInformation>& WifiInterface::GetAdhocNetworks(st
 
 bool WifiInterface::Connect(const IWifiInterface::WifiInformation& aConnection)
 {
+    TRACE_SCOPE("Netlink join");
+
     bool lReturn{};
 
     // Allocate the messages and callback handler.
@@ -3,7 +3,9 @@
 #include "WindowModel.h"
 
 #include <algorithm>
+#include <charconv>
 #include <iostream>
+#include <limits>
 
 using namespace WindowModel_Constants;
 std::string BoolToString(bool aBool)
@@ -24,6 +26,35 @@ static ConnectionMethod ConvertConnectionMethodText(std::string_view aLevel)
     return lReturn;
 }
 
+/**
+ * Checks a number read from the config file, a bad one would otherwise only turn up when the engine starts.
+ * @param aOption - Name of the option, for the warning.
+ * @param aValue - The number as read.
+ * @param aDefault - Value to use instead when aValue is not a number in range.
+ * @param aMinimum - Lowest allowed value.
+ * @param aMaximum - Highest allowed value.
+ * @return aValue if it is a number in range, aDefault otherwise.
+ */
+static std::string ValidateNumber(std::string_view aOption,
+                                  std::string_view aValue,
+                                  std::string_view aDefault,
+                                  int              aMinimum = 0,
+                                  int              aMaximum = std::numeric_limits<int>::max())
+{
+    std::string lReturn{aValue};
+    int         lNumber{0};
+
+    auto [lEnd, lError]{std::from_chars(aValue.data(), aValue.data() + aValue.size(), lNumber)};
+    if (lError != std::errc() || lEnd != aValue.data() + aValue.size() || lNumber < aMinimum || lNumber > aMaximum) {
+        Logger::GetInstance().Log(std::string("Option:") + std::string(aOption) + " has invalid value " +
+                                      std::string(aValue) + ", using " + std::string(aDefault),
+                                  Logger::Level::WARNING);
+        lReturn = aDefault;
+    }
+
+    return lReturn;
+}
+
 static bool StringToBool(std::string_view aString)
 {
     bool lReturn{false};
@@ -35,6 +66,28 @@ static bool StringToBool(std::string_view aString)
     return lReturn;
 }
 
+std::vector<std::string> WindowModel::GetWifiAdapters() const
+{
+    std::vector<std::string> lReturn{mWifiAdapter};
+
+    std::size_t lStart{0};
+    while (lStart < mAdditionalWifiAdapters.size()) {
+        std::size_t lEnd{mAdditionalWifiAdapters.find(cWifiAdapterSeparator, lStart)};
+        if (lEnd == std::string::npos) {
+            lEnd = mAdditionalWifiAdapters.size();
+        }
+
+        std::string lAdapter{mAdditionalWifiAdapters.substr(lStart, lEnd - lStart)};
+        if (!lAdapter.empty() && std::find(lReturn.begin(), lReturn.end(), lAdapter) == lReturn.end()) {
+            lReturn.emplace_back(lAdapter);
+        }
+
+        lStart = lEnd + 1;
+    }
+
+    return lReturn;
+}
+
 bool WindowModel::SaveToFile(std::string_view aPath) const
 {
     bool          lReturn{false};
@@ -43,20 +96,34 @@ bool WindowModel::SaveToFile(std::string_view aPath) const
 
     if (lFile.is_open() && lFile.good()) {
         lFile << cSaveAcknowledgeDataFrames << ": " << BoolToString(mAcknowledgeDataFrames) << std::endl;
+        lFile << cSaveAdditionalWifiAdapters << ": \"" << mAdditionalWifiAdapters << "\"" << std::endl;
+        lFile << cSaveArpProxy << ": " << BoolToString(mArpProxy) << std::endl;
+        lFile << cSaveArpProxyRemote << ": " << BoolToString(mArpProxyRemote) << std::endl;
         lFile << cSaveAutoDiscoverPSPVita << ": " << BoolToString(mAutoDiscoverPSPVitaNetworks) << std::endl;
         lFile << cSaveAutoDiscoverXLinkKai << ": " << BoolToString(mAutoDiscoverXLinkKaiInstance) << std::endl;
+        lFile << cSaveBroadcastRateLimit << ": \"" << mBroadcastRateLimit << "\"" << std::endl;
+        lFile << cSaveBroadcastRepeatWindowMs << ": \"" << mBroadcastRepeatWindowMs << "\"" << std::endl;
         lFile << cSaveChannel << ": \"" << mChannel << "\"" << std::endl;
         lFile << cSaveConnectionMethod << ": \"" << cConnectionMethodTexts.at(mConnectionMethod) << "\"" << std::endl;
+        lFile << cSaveHardwareCounters << ": " << BoolToString(mHardwareCounters) << std::endl;
         lFile << cSaveLogLevel << ": \"" << Logger::ConvertLogLevelToString(mLogLevel) << "\"" << std::endl;
         lFile << cSaveOnlyAcceptFromMac << ": \"" << mOnlyAcceptFromMac << "\"" << std::endl;
+        lFile << cSavePaceTransmissions << ": " << BoolToString(mPaceTransmissions) << std::endl;
+        lFile << cSavePinCaptureThreads << ": " << BoolToString(mPinCaptureThreads) << std::endl;
         lFile << cSaveReConnectionTimeOutS << ": \"" << mReConnectionTimeOutS << "\"" << std::endl;
+        lFile << cSaveSharedXLinkKaiConnection << ": " << BoolToString(mSharedXLinkKaiConnection) << std::endl;
         lFile << cSaveTheme << ": \"" << mTheme << "\"" << std::endl;
+        lFile << cSaveUseIOUring << ": " << BoolToString(mUseIOUring) << std::endl;
         lFile << cSaveUseSSIDFromHost << ": " << BoolToString(mUseSSIDFromHost) << std::endl;
         lFile << cSaveUseSSIDFromXLinkKai << ": " << BoolToString(mUseSSIDFromXLinkKai) << std::endl;
+        lFile << cSaveUseXDP << ": " << BoolToString(mUseXDP) << std::endl;
         lFile << cSaveUseXLinkKaiHints << ": " << BoolToString(mUseXLinkKaiHints) << std::endl;
         lFile << cSaveWifiAdapter << ": \"" << mWifiAdapter << "\"" << std::endl;
+        lFile << cSaveXLinkBusyPollUs << ": \"" << mXLinkBusyPollUs << "\"" << std::endl;
         lFile << cSaveXLinkIp << ": \"" << mXLinkIp << "\"" << std::endl;
         lFile << cSaveXLinkPort << ": \"" << mXLinkPort << "\"" << std::endl;
+        lFile << cSaveXLinkReceiveBufferSize << ": \"" << mXLinkReceiveBufferSize << "\"" << std::endl;
+        lFile << cSaveXLinkSendBufferSize << ": \"" << mXLinkSendBufferSize << "\"" << std::endl;
         lFile.close();
 
         if (lFile.good()) {
@@ -94,34 +161,72 @@ bool WindowModel::LoadFromFile(std::string_view aPath)
                     if (!lResult.empty()) {
                         if (lOption == cSaveAcknowledgeDataFrames) {
                             mAcknowledgeDataFrames = StringToBool(lResult);
+                        } else if (lOption == cSaveAdditionalWifiAdapters) {
+                            mAdditionalWifiAdapters = lResult.substr(1, lResult.size() - 2);
+                        } else if (lOption == cSaveArpProxy) {
+                            mArpProxy = StringToBool(lResult);
+                        } else if (lOption == cSaveArpProxyRemote) {
+                            mArpProxyRemote = StringToBool(lResult);
                         } else if (lOption == cSaveAutoDiscoverPSPVita) {
                             mAutoDiscoverPSPVitaNetworks = StringToBool(lResult);
                         } else if (lOption == cSaveAutoDiscoverXLinkKai) {
                             mAutoDiscoverXLinkKaiInstance = StringToBool(lResult);
+                        } else if (lOption == cSaveBroadcastRateLimit) {
+                            mBroadcastRateLimit = ValidateNumber(
+                                lOption, lResult.substr(1, lResult.size() - 2), cDefaultBroadcastRateLimit);
+                        } else if (lOption == cSaveBroadcastRepeatWindowMs) {
+                            mBroadcastRepeatWindowMs = ValidateNumber(
+                                lOption, lResult.substr(1, lResult.size() - 2), cDefaultBroadcastRepeatWindowMs);
                         } else if (lOption == cSaveChannel) {
                             mChannel = lResult.substr(1, lResult.size() - 2);
                         } else if (lOption == cSaveConnectionMethod) {
                             mConnectionMethod = ConvertConnectionMethodText(lResult.substr(1, lResult.size() - 2));
+                        } else if (lOption == cSaveHardwareCounters) {
+                            mHardwareCounters = StringToBool(lResult);
                         } else if (lOption == cSaveLogLevel) {
                             mLogLevel = Logger::ConvertLogLevelStringToLevel(lResult.substr(1, lResult.size() - 2));
                         } else if (lOption == cSaveOnlyAcceptFromMac) {
                             mOnlyAcceptFromMac = lResult.substr(1, lResult.size() - 2);
+                        } else if (lOption == cSavePaceTransmissions) {
+                            mPaceTransmissions = StringToBool(lResult);
+                        } else if (lOption == cSavePinCaptureThreads) {
+                            mPinCaptureThreads = StringToBool(lResult);
                         } else if (lOption == cSaveReConnectionTimeOutS) {
-                            mReConnectionTimeOutS = lResult.substr(1, lResult.size() - 2);
+                            mReConnectionTimeOutS = ValidateNumber(
+                                lOption, lResult.substr(1, lResult.size() - 2), cDefaultReConnectionTimeOutS);
+                        } else if (lOption == cSaveSharedXLinkKaiConnection) {
+                            mSharedXLinkKaiConnection = StringToBool(lResult);
                         } else if (lOption == cSaveTheme) {
                             mTheme = lResult.substr(1, lResult.size() - 2);
+                        } else if (lOption == cSaveUseIOUring) {
+                            mUseIOUring = StringToBool(lResult);
                         } else if (lOption == cSaveUseSSIDFromHost) {
                             mUseSSIDFromHost = StringToBool(lResult);
                         } else if (lOption == cSaveUseSSIDFromXLinkKai) {
                             mUseSSIDFromXLinkKai = StringToBool(lResult);
+                        } else if (lOption == cSaveUseXDP) {
+                            mUseXDP = StringToBool(lResult);
                         } else if (lOption == cSaveUseXLinkKaiHints) {
                             mUseXLinkKaiHints = StringToBool(lResult);
                         } else if (lOption == cSaveWifiAdapter) {
                             mWifiAdapter = lResult.substr(1, lResult.size() - 2);
+                        } else if (lOption == cSaveXLinkBusyPollUs) {
+                            mXLinkBusyPollUs = ValidateNumber(
+                                lOption, lResult.substr(1, lResult.size() - 2), cDefaultXLinkBusyPollUs);
                         } else if (lOption == cSaveXLinkIp) {
                             mXLinkIp = lResult.substr(1, lResult.size() - 2);
                         } else if (lOption == cSaveXLinkPort) {
-                            mXLinkPort = lResult.substr(1, lResult.size() - 2);
+                            mXLinkPort = ValidateNumber(lOption,
+                                                        lResult.substr(1, lResult.size() - 2),
+                                                        cDefaultXLinkPort,
+                                                        1,
+                                                        std::numeric_limits<uint16_t>::max());
+                        } else if (lOption == cSaveXLinkReceiveBufferSize) {
+                            mXLinkReceiveBufferSize = ValidateNumber(
+                                lOption, lResult.substr(1, lResult.size() - 2), cDefaultXLinkReceiveBufferSize);
+                        } else if (lOption == cSaveXLinkSendBufferSize) {
+                            mXLinkSendBufferSize = ValidateNumber(
+                                lOption, lResult.substr(1, lResult.size() - 2), cDefaultXLinkSendBufferSize);
                         } else {
                             Logger::GetInstance().Log(std::string("Option:") + lOption + " unknown",
                                                       Logger::Level::DEBUG);
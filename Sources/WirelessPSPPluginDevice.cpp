@@ -5,6 +5,7 @@
 #include <chrono>
 #include <string>
 
+#include "FlightRecorder.h"
 #include "NetConversionFunctions.h"
 #include "XLinkKaiConnection.h"
 
@@ -14,13 +15,13 @@ using namespace std::chrono;
  * Constructor for the PSP plugin device.
  * @param aAutoConnect - Whether or not to connect to networks automatically.
  * @param aReconnectionTimeOut - How long to wait when the connection is stale to reconnect.
- * @param aCurrentlyConnected - Reference to string where the currently connected SSID is stored.
+ * @param aCurrentlyConnected - Property where the currently connected SSID is stored.
  * @param aPacketHandler - The packet handler used to do the conversion from and to plugin mode.
  * @param aPCapWrapper - Shared pointer to the wrapper with pcap functions.
  */
 WirelessPSPPluginDevice::WirelessPSPPluginDevice(bool                              aAutoConnect,
                                                  std::chrono::seconds              aReconnectionTimeOut,
-                                                 std::string*                      aCurrentlyConnected,
+                                                 Property<std::string>*            aCurrentlyConnected,
                                                  std::shared_ptr<HandlerPSPPlugin> aHandler,
                                                  std::shared_ptr<IPCapWrapper>     aPcapWrapper) :
     WirelessPromiscuousBase(aAutoConnect, aReconnectionTimeOut, aCurrentlyConnected, aPcapWrapper),
@@ -46,20 +47,24 @@ void WirelessPSPPluginDevice::ObtainTitleId()
 
 bool WirelessPSPPluginDevice::ReadCallback(const unsigned char* aData, const pcap_pkthdr* aHeader)
 {
-    bool lReturn{false};
+    HardwareCounters::Measurement lMeasurement{GetHardwareCounters()};
+    bool                          lReturn{false};
 
     // Load all needed information into the handler
     std::string lData{DataToString(aData, aHeader)};
     mPacketHandler->Update(lData);
 
     if (!mPacketHandler->GetBlackList().IsMacBlackListed(mPacketHandler->GetSourceMac())) {
+        FlightRecorder::GetInstance().Record(
+            FlightRecorder::Interface::Air, FlightRecorder::Direction::Inbound, lData);
+
         // If the packet is a broadcast packet from the psp, go ahead and handshake
         if (mPacketHandler->IsBroadcastPacket() && mPacketHandler->GetEtherType() == Net_Constants::cPSPEtherType) {
             // Log
             Logger::GetInstance().Log("Received: " + PrettyHexString(lData), Logger::Level::TRACE);
 
             // Reset the timer so it will not time out
-            GetReadWatchdog() = std::chrono::system_clock::now();
+            GetReadWatchdog() = std::chrono::steady_clock::now();
 
             // If it's an information packet, just save the information, otherwise we probably need to handshake
             std::string lPacket{ConstructPSPPluginHandshake(mPacketHandler->GetSourceMac(), GetAdapterMacAddress())};
@@ -73,7 +78,7 @@ bool WirelessPSPPluginDevice::ReadCallback(const unsigned char* aData, const pca
             Logger::GetInstance().Log("Received: " + PrettyHexString(lData), Logger::Level::TRACE);
 
             // Reset the timer so it will not time out
-            GetReadWatchdog() = std::chrono::system_clock::now();
+            GetReadWatchdog() = std::chrono::steady_clock::now();
 
             if (mPacketHandler->GetPacket().substr(Net_8023_Constants::cDataIndex,
                                                    Net_Constants::cInfoToken.length()) == Net_Constants::cInfoToken) {
@@ -104,6 +109,13 @@ void WirelessPSPPluginDevice::BlackList(uint64_t aMac)
     }
 }
 
+void WirelessPSPPluginDevice::RemoveFromBlackList(uint64_t aMac)
+{
+    if (mPacketHandler != nullptr) {
+        mPacketHandler->GetBlackList().RemoveFromMacBlackList(aMac);
+    }
+}
+
 bool WirelessPSPPluginDevice::Send(std::string_view aData)
 {
     return Send(aData, true);
@@ -122,10 +134,14 @@ bool WirelessPSPPluginDevice::Send(std::string_view aData, bool aModifyData)
             }
 
             Logger::GetInstance().Log(std::string("Sent: ") + PrettyHexString(lData), Logger::Level::TRACE);
+            FlightRecorder::GetInstance().Record(
+                FlightRecorder::Interface::Air, FlightRecorder::Direction::Outbound, lData);
 
             if (GetWrapper()->SendPacket(lData) == 0) {
+                IncreaseSentPacketCount(lData.size());
                 lReturn = true;
             } else {
+                IncreaseSendErrorCount();
                 Logger::GetInstance().Log("pcap_sendpacket failed, " + std::string(GetWrapper()->GetError()),
                                           Logger::Level::ERROR);
             }
@@ -7,7 +7,11 @@
 #include <string>
 #include <thread>
 
+#include "FlightRecorder.h"
 #include "NetConversionFunctions.h"
+#include "SSIDMatcher.h"
+#include "TimerService.h"
+#include "Tracer.h"
 #include "XLinkKaiConnection.h"
 
 using namespace std::chrono;
@@ -17,12 +21,12 @@ using namespace WirelessPromiscuousBase_Constants;
  * Constructor for the Promiscuous base device.
  * @param aAutoConnect - Whether or not to connect to networks automatically.
  * @param aReconnectionTimeOut - How long to wait when the connection is stale to reconnect.
- * @param aCurrentlyConnected - Reference to string where the currently connected SSID is stored.
+ * @param aCurrentlyConnected - Property where the currently connected SSID is stored.
  * @param aPCapWrapper - Shared pointer to the wrapper with pcap functions.
  */
 WirelessPromiscuousBase::WirelessPromiscuousBase(bool                          aAutoConnect,
                                                  std::chrono::seconds          aReconnectionTimeOut,
-                                                 std::string*                  aCurrentlyConnected,
+                                                 Property<std::string>*        aCurrentlyConnected,
                                                  std::shared_ptr<IPCapWrapper> aPcapWrapper) :
     mAutoConnect(aAutoConnect),
     mWrapper(aPcapWrapper), mReConnectionTimeOut(aReconnectionTimeOut), mCurrentlyConnected(aCurrentlyConnected)
@@ -66,7 +70,7 @@ bool WirelessPromiscuousBase::Open(std::string_view                aName,
     }
 
     // Reset the timer
-    mReadWatchdog = std::chrono::system_clock::now();
+    mReadWatchdog = std::chrono::steady_clock::now();
 
     return lReturn;
 }
@@ -91,13 +95,18 @@ void WirelessPromiscuousBase::Close()
         mReceiverThread->join();
     }
 
-    if (mAutoConnect && mWifiTimeoutThread != nullptr) {
-        while (!mWifiTimeoutThread->joinable()) {
-            // Wait
-            std::this_thread::sleep_for(1ms);
-        }
+    // A running check may have scheduled the next one before seeing we are closing
+    TimerWheel::Id lTimer{0};
+    while ((lTimer = mReadWatchdogTimer.exchange(0)) != 0) {
+        TimerService::GetInstance().Cancel(lTimer);
+    }
 
-        mWifiTimeoutThread->join();
+    // Same goes for a reconnect that was still running
+    if (mReconnect.valid()) {
+        mReconnect.wait();
+        while ((lTimer = mReadWatchdogTimer.exchange(0)) != 0) {
+            TimerService::GetInstance().Cancel(lTimer);
+        }
     }
 
     mWrapper->Close();
@@ -138,20 +147,20 @@ bool WirelessPromiscuousBase::Connect(std::string_view aESSID)
         // If we are getting the SSID from the host, scanning is too slow, so rather than doing that, connect directly.
         // Apple devices can't connect without the network being in the scanned list, so they'll have to scan.
         if ((!mSSIDFromHost) || (!cCanConnectWithoutScan)) {
+            SSIDMatcher lMatcher{mSSIDFilter};
+
             std::vector<IWifiInterface::WifiInformation>& lNetworks = mWifiInterface->GetAdhocNetworks();
             for (const auto& lNetwork : lNetworks) {
-                for (const auto& lFilter : mSSIDFilter) {
-                    if (lNetwork.ssid.find(lFilter) != std::string::npos && lNetwork.isadhoc && !lNetwork.isconnected) {
-                        lReturn = mWifiInterface->Connect(lNetwork);
-                        if (mCurrentlyConnected != nullptr) {
-                            *mCurrentlyConnected = lNetwork.ssid;
-                        }
+                if (lNetwork.isadhoc && !lNetwork.isconnected && lMatcher.Matches(lNetwork.ssid)) {
+                    lReturn = mWifiInterface->Connect(lNetwork);
+                    if (mCurrentlyConnected != nullptr) {
+                        mCurrentlyConnected->Set(lNetwork.ssid);
+                    }
 
-                        mCurrentlyConnectedInfo = lNetwork;
-                        lDidConnect             = true;
+                    mCurrentlyConnectedInfo = lNetwork;
+                    lDidConnect             = true;
 
-                        GetConnector()->SendESSID(lNetwork.ssid);
-                    }
+                    GetConnector()->SendESSID(lNetwork.ssid);
                 }
                 lCount++;
             }
@@ -175,7 +184,7 @@ bool WirelessPromiscuousBase::Connect(std::string_view aESSID)
 
             lReturn = mWifiInterface->Connect(lInformation);
             if (mCurrentlyConnected != nullptr) {
-                *mCurrentlyConnected = lInformation.ssid;
+                mCurrentlyConnected->Set(lInformation.ssid);
             }
 
             GetConnector()->SendESSID(lInformation.ssid);
@@ -184,7 +193,7 @@ bool WirelessPromiscuousBase::Connect(std::string_view aESSID)
 
     // Reset the timer, so it won't autoconnect anyway, unless we are hosting
     if (!mSSIDFromHost) {
-        mReadWatchdog      = std::chrono::system_clock::now();
+        mReadWatchdog      = std::chrono::steady_clock::now();
         mPausedAutoConnect = false;
     }
     return lReturn;
@@ -195,7 +204,7 @@ uint64_t& WirelessPromiscuousBase::GetAdapterMacAddress()
     return mAdapterMacAddress;
 }
 
-std::chrono::time_point<std::chrono::system_clock>& WirelessPromiscuousBase::GetReadWatchdog()
+std::chrono::time_point<std::chrono::steady_clock>& WirelessPromiscuousBase::GetReadWatchdog()
 {
     return mReadWatchdog;
 }
@@ -212,26 +221,19 @@ bool WirelessPromiscuousBase::StartReceiverThread()
     if (mWrapper->IsActivated()) {
         // Run
         if (mReceiverThread == nullptr) {
-            if (mAutoConnect && mWifiTimeoutThread == nullptr && mReConnectionTimeOut.count() > 0) {
-                mWifiTimeoutThread = std::make_shared<std::thread>([&] {
-                    while (mConnected) {
-                        if (!mPausedAutoConnect &&
-                            std::chrono::system_clock::now() > (mReadWatchdog + mReConnectionTimeOut)) {
-                            Logger::GetInstance().Log("Switching networks due to timeout!", Logger::Level::DEBUG);
-                            // Read timed out try to connect to another network.
-                            Connect();
-                            mReadWatchdog = std::chrono::system_clock::now();
-                        }
-                        std::this_thread::sleep_for(1s);
-                    }
-                });
+            if (mAutoConnect && mReadWatchdogTimer == 0 && mReConnectionTimeOut.count() > 0) {
+                mReadWatchdogTimer = TimerService::GetInstance().ScheduleAt(mReadWatchdog + mReConnectionTimeOut,
+                                                                            [this] { CheckReadWatchdog(); });
             }
 
             mReceiverThread = std::make_shared<std::thread>([&] {
+                TRACE_THREAD_NAME("Promiscuous receiver");
+                ApplyReceiverThreadAffinity();
+
                 // If we're receiving data from the receiver thread, send it off as well.
                 bool lSendReceivedDataOld = mSendReceivedData;
                 mSendReceivedData         = true;
-                mReadWatchdog             = std::chrono::system_clock::now();
+                mReadWatchdog             = std::chrono::steady_clock::now();
 
                 auto lCallbackFunction =
                     [](unsigned char* aThis, const pcap_pkthdr* aHeader, const unsigned char* aPacket) {
@@ -240,14 +242,24 @@ bool WirelessPromiscuousBase::StartReceiverThread()
                     };
 
                 while (mConnected && (mWrapper->IsActivated())) {
-                    // Use pcap_dispatch instead of pcap_next_ex so that as many packets as possible will be processed
-                    // in a single cycle.
-                    if (mWrapper->Dispatch(0, lCallbackFunction, reinterpret_cast<u_char*>(this)) == -1) {
+                    TRACE_START(lDispatchStart);
+
+                    // Use pcap_dispatch instead of pcap_next_ex so that as many packets as possible will be
+                    // processed in a single cycle.
+                    int lPackets{mWrapper->Dispatch(0, lCallbackFunction, reinterpret_cast<u_char*>(this))};
+                    if (lPackets > 0) {
+                        // Polls that came back empty would drown out everything else in the trace
+                        TRACE_EVENT("Dispatch", lDispatchStart);
+                    } else if (lPackets == -1) {
                         Logger::GetInstance().Log(
                             "Error occurred while reading packet: " + std::string(mWrapper->GetError()),
                             Logger::Level::DEBUG);
                     }
-                    std::this_thread::sleep_for(100us);
+
+                    // Wrappers that wait for packets themselves would only be slowed down by this
+                    if (!mWrapper->WaitsForPackets()) {
+                        std::this_thread::sleep_for(100us);
+                    }
                 }
 
                 mSendReceivedData = lSendReceivedDataOld;
@@ -261,6 +273,38 @@ bool WirelessPromiscuousBase::StartReceiverThread()
     return lReturn;
 }
 
+void WirelessPromiscuousBase::CheckReadWatchdog()
+{
+    TRACE_SCOPE("CheckReadWatchdog");
+
+    if (mConnected) {
+        auto lNow{std::chrono::steady_clock::now()};
+        if (!mPausedAutoConnect && lNow >= (mReadWatchdog + mReConnectionTimeOut)) {
+            Logger::GetInstance().Log("Switching networks due to timeout!", Logger::Level::DEBUG);
+            FlightRecorder::GetInstance().Dump("Nothing received on the wireless adapter, switching networks");
+            // Read timed out try to connect to another network, the next check gets scheduled once that is done.
+            mReconnect = std::async(std::launch::async, [this] { Reconnect(); });
+        } else {
+            // While paused there is no deadline to wait for, so look again in a second
+            auto lNext{mPausedAutoConnect ? lNow + 1s : mReadWatchdog + mReConnectionTimeOut};
+            mReadWatchdogTimer = TimerService::GetInstance().ScheduleAt(lNext, [this] { CheckReadWatchdog(); });
+        }
+    }
+}
+
+void WirelessPromiscuousBase::Reconnect()
+{
+    TRACE_SCOPE("Reconnect");
+
+    Connect();
+    mReadWatchdog = std::chrono::steady_clock::now();
+
+    if (mConnected) {
+        auto lNext{mPausedAutoConnect ? std::chrono::steady_clock::now() + 1s : mReadWatchdog + mReConnectionTimeOut};
+        mReadWatchdogTimer = TimerService::GetInstance().ScheduleAt(lNext, [this] { CheckReadWatchdog(); });
+    }
+}
+
 std::string WirelessPromiscuousBase::GetESSID()
 {
     return mCurrentlyConnectedInfo.ssid;
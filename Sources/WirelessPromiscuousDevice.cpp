@@ -5,6 +5,7 @@
 #include <chrono>
 #include <string>
 
+#include "FlightRecorder.h"
 #include "NetConversionFunctions.h"
 
 using namespace std::chrono;
@@ -13,13 +14,13 @@ using namespace std::chrono;
  * Constructor for the PSP plugin device.
  * @param aAutoConnect - Whether or not to connect to networks automatically.
  * @param aReconnectionTimeOut - How long to wait when the connection is stale to reconnect.
- * @param aCurrentlyConnected - Reference to string where the currently connected SSID is stored.
+ * @param aCurrentlyConnected - Property where the currently connected SSID is stored.
  * @param aPacketHandler - The packet handler used to grab things like Mac addresses.
  * @param aPCapWrapper - Shared pointer to the wrapper with pcap functions.
  */
 WirelessPromiscuousDevice::WirelessPromiscuousDevice(bool                          aAutoConnect,
                                                      std::chrono::seconds          aReconnectionTimeOut,
-                                                     std::string*                  aCurrentlyConnected,
+                                                     Property<std::string>*        aCurrentlyConnected,
                                                      std::shared_ptr<Handler8023>  aHandler,
                                                      std::shared_ptr<IPCapWrapper> aPcapWrapper) :
     WirelessPromiscuousBase(aAutoConnect, aReconnectionTimeOut, aCurrentlyConnected, aPcapWrapper),
@@ -28,7 +29,8 @@ WirelessPromiscuousDevice::WirelessPromiscuousDevice(bool
 
 bool WirelessPromiscuousDevice::ReadCallback(const unsigned char* aData, const pcap_pkthdr* aHeader)
 {
-    bool lReturn{false};
+    HardwareCounters::Measurement lMeasurement{GetHardwareCounters()};
+    bool                          lReturn{false};
 
     // Load all needed information into the handler
     std::string lData{DataToString(aData, aHeader)};
@@ -37,11 +39,19 @@ bool WirelessPromiscuousDevice::ReadCallback(const unsigned char* aData, const p
     if (!mPacketHandler->GetBlackList().IsMacBlackListed(mPacketHandler->GetSourceMac())) {
         // Log
         Logger::GetInstance().Log("Received: " + PrettyHexString(lData), Logger::Level::TRACE);
+        FlightRecorder::GetInstance().Record(
+            FlightRecorder::Interface::Air, FlightRecorder::Direction::Inbound, lData);
 
         // Reset the timer so it will not time out
-        GetReadWatchdog() = std::chrono::system_clock::now();
-
-        GetConnector()->Send(lData);
+        GetReadWatchdog() = std::chrono::steady_clock::now();
+
+        // Requests for hosts behind XLink Kai can be answered right here
+        std::optional<std::string> lReply{mArpProxy.Handle(lData, ArpProxy::Side::Local)};
+        if (lReply.has_value()) {
+            SendPacket(lReply.value());
+        } else {
+            GetConnector()->Send(lData);
+        }
 
         SetData(aData);
         SetHeader(aHeader);
@@ -58,6 +68,18 @@ void WirelessPromiscuousDevice::BlackList(uint64_t aMac)
     }
 }
 
+void WirelessPromiscuousDevice::RemoveFromBlackList(uint64_t aMac)
+{
+    if (mPacketHandler != nullptr) {
+        mPacketHandler->GetBlackList().RemoveFromMacBlackList(aMac);
+    }
+}
+
+void WirelessPromiscuousDevice::SetArpProxy(bool aAnswerLocal, bool aAnswerRemote)
+{
+    mArpProxy.SetEnabled(aAnswerLocal, aAnswerRemote);
+}
+
 bool WirelessPromiscuousDevice::Send(std::string_view aData)
 {
     bool lReturn{false};
@@ -86,13 +108,20 @@ bool WirelessPromiscuousDevice::Send(std::string_view aData)
                 }
             }
 
-            Logger::GetInstance().Log(std::string("Sent: ") + PrettyHexString(lData), Logger::Level::TRACE);
-
-            if (GetWrapper()->SendPacket(lData) == 0) {
-                lReturn = true;
+            // Learned after the replacement above, as that is the Mac address hosts on the air get to see
+            std::optional<std::string> lReply{mArpProxy.Handle(lData, ArpProxy::Side::Remote)};
+            if (lReply.has_value()) {
+                // Answered without going over the air, addressed to the sender as XLink Kai knows it, not to the
+                // adapter Mac address it got replaced by above
+                memcpy(lReply->data() + Net_8023_Constants::cDestinationAddressIndex,
+                       aData.data() + Net_8023_Constants::cSourceAddressIndex,
+                       Net_Constants::cMacAddressLength);
+                memcpy(lReply->data() + Net_Constants::Arp::cTargetMacIndex,
+                       aData.data() + Net_Constants::Arp::cSenderMacIndex,
+                       Net_Constants::cMacAddressLength);
+                lReturn = GetConnector()->Send(lReply.value());
             } else {
-                Logger::GetInstance().Log("pcap_sendpacket failed, " + std::string(GetWrapper()->GetError()),
-                                          Logger::Level::ERROR);
+                lReturn = SendPacket(lData);
             }
         }
     } else {
@@ -100,5 +129,24 @@ bool WirelessPromiscuousDevice::Send(std::string_view aData)
                                   Logger::Level::ERROR);
     }
 
+    return lReturn;
+}
+
+bool WirelessPromiscuousDevice::SendPacket(std::string_view aData)
+{
+    bool lReturn{false};
+
+    Logger::GetInstance().Log(std::string("Sent: ") + PrettyHexString(aData), Logger::Level::TRACE);
+    FlightRecorder::GetInstance().Record(FlightRecorder::Interface::Air, FlightRecorder::Direction::Outbound, aData);
+
+    if (GetWrapper()->SendPacket(aData) == 0) {
+        IncreaseSentPacketCount(aData.size());
+        lReturn = true;
+    } else {
+        IncreaseSendErrorCount();
+        Logger::GetInstance().Log("pcap_sendpacket failed, " + std::string(GetWrapper()->GetError()),
+                                  Logger::Level::ERROR);
+    }
+
     return lReturn;
 }
\ No newline at end of file
@@ -0,0 +1,106 @@
+/* Copyright (c) 2022 [Rick de Bondt] - XDPPCapWrapperLinux.cpp */
+
+#if defined(__linux__)
+#include "XDPPCapWrapperLinux.h"
+
+#include <array>
+#include <cerrno>
+
+#include <poll.h>
+#include <sys/time.h>
+
+#include "Logger.h"
+
+pcap_t* XDPPCapWrapper::Create(const char* source, char* errbuf)
+{
+    mSource  = source;
+    mHandler = PCapWrapper::Create(source, errbuf);
+    return mHandler;
+}
+
+int XDPPCapWrapper::Activate()
+{
+    int lReturn{PCapWrapper::Activate()};
+
+    if (lReturn >= 0 && !mSocket.Open(mSource)) {
+        Logger::GetInstance().Log("AF_XDP not supported on " + mSource + ", using libpcap directly",
+                                  Logger::Level::INFO);
+    }
+
+    return lReturn;
+}
+
+void XDPPCapWrapper::Close()
+{
+    mSocket.Close();
+    PCapWrapper::Close();
+}
+
+int XDPPCapWrapper::Dispatch(int cnt, pcap_handler callback, unsigned char* user)
+{
+    if (!mSocket.IsOpen()) {
+        return PCapWrapper::Dispatch(cnt, callback, user);
+    }
+
+    // Everything that is not steered to the socket still comes in through libpcap
+    int                   lPCapFd{pcap_get_selectable_fd(mHandler)};
+    std::array<pollfd, 2> lPollFds{{{mSocket.GetFd(), POLLIN, 0}, {lPCapFd, POLLIN, 0}}};
+    if (poll(lPollFds.data(), lPollFds.size(), mTimeOut) < 0) {
+        return (errno == EINTR) ? 0 : -1;
+    }
+
+    int lReturn{0};
+
+    if ((lPollFds[0].revents & POLLIN) != 0) {
+        pcap_pkthdr lHeader{};
+        gettimeofday(&lHeader.ts, nullptr);
+
+        lReturn = static_cast<int>(mSocket.ForEachFrame([&](std::string_view aFrame) {
+            lHeader.caplen = aFrame.size();
+            lHeader.len    = aFrame.size();
+            callback(user, &lHeader, reinterpret_cast<const unsigned char*>(aFrame.data()));
+        }));
+    }
+
+    if (lPCapFd < 0 || (lPollFds[1].revents & (POLLIN | POLLERR)) != 0) {
+        int lPCapReturn{PCapWrapper::Dispatch(cnt, callback, user)};
+        lReturn = (lPCapReturn < 0) ? lPCapReturn : lReturn + lPCapReturn;
+    }
+
+    return lReturn;
+}
+
+int XDPPCapWrapper::SendPacket(std::string_view buffer)
+{
+    int lReturn{0};
+
+    switch (mSocket.Send(buffer)) {
+        case XDPSocket_Constants::SendResult::Queued:
+            break;
+        case XDPSocket_Constants::SendResult::NotQueued:
+            lReturn = PCapWrapper::SendPacket(buffer);
+            break;
+        case XDPSocket_Constants::SendResult::Failed:
+            lReturn = -1;
+            break;
+    }
+
+    return lReturn;
+}
+
+int XDPPCapWrapper::SetTimeOut(int timeout)
+{
+    mTimeOut = timeout;
+    return PCapWrapper::SetTimeOut(timeout);
+}
+
+bool XDPPCapWrapper::WaitsForPackets()
+{
+    return mSocket.IsOpen();
+}
+
+bool XDPPCapWrapper::IsUsingXDP() const
+{
+    return mSocket.IsOpen();
+}
+#endif
@@ -0,0 +1,450 @@
+/* Copyright (c) 2022 [Rick de Bondt] - XDPSocketLinux.cpp */
+
+#if defined(__linux__)
+#include "XDPSocketLinux.h"
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+
+#include <linux/bpf.h>
+#include <linux/if_link.h>
+#include <net/if.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "Logger.h"
+#include "NetworkingHeaders.h"
+
+using namespace XDPSocket_Constants;
+
+namespace
+{
+    int Bpf(int aCommand, bpf_attr& aAttributes)
+    {
+        return static_cast<int>(syscall(__NR_bpf, aCommand, &aAttributes, sizeof(aAttributes)));
+    }
+
+    int CreateMap(bpf_map_type aType, uint32_t aKeySize, uint32_t aValueSize, uint32_t aEntries)
+    {
+        bpf_attr lAttributes{};
+        lAttributes.map_type    = aType;
+        lAttributes.key_size    = aKeySize;
+        lAttributes.value_size  = aValueSize;
+        lAttributes.max_entries = aEntries;
+
+        return Bpf(BPF_MAP_CREATE, lAttributes);
+    }
+
+    bool UpdateMap(int aMap, const void* aKey, const void* aValue)
+    {
+        bpf_attr lAttributes{};
+        lAttributes.map_fd = static_cast<uint32_t>(aMap);
+        lAttributes.key    = reinterpret_cast<uint64_t>(aKey);
+        lAttributes.value  = reinterpret_cast<uint64_t>(aValue);
+
+        return Bpf(BPF_MAP_UPDATE_ELEM, lAttributes) == 0;
+    }
+
+    constexpr bpf_insn Instruction(
+        uint8_t aCode, uint8_t aDestination, uint8_t aSource, int16_t aOffset, int32_t aValue)
+    {
+        return bpf_insn{aCode, aDestination, aSource, aOffset, aValue};
+    }
+
+    constexpr bpf_insn Move(uint8_t aDestination, uint8_t aSource)
+    {
+        return Instruction(BPF_ALU64 | BPF_MOV | BPF_X, aDestination, aSource, 0, 0);
+    }
+
+    constexpr bpf_insn MoveValue(uint8_t aDestination, int32_t aValue)
+    {
+        return Instruction(BPF_ALU64 | BPF_MOV | BPF_K, aDestination, 0, 0, aValue);
+    }
+
+    constexpr bpf_insn Load(uint8_t aSize, uint8_t aDestination, uint8_t aSource, int16_t aOffset)
+    {
+        return Instruction(BPF_LDX | aSize | BPF_MEM, aDestination, aSource, aOffset, 0);
+    }
+
+    constexpr bpf_insn Store(uint8_t aSize, uint8_t aDestination, uint8_t aSource, int16_t aOffset)
+    {
+        return Instruction(BPF_STX | aSize | BPF_MEM, aDestination, aSource, aOffset, 0);
+    }
+
+    constexpr bpf_insn Calculate(uint8_t aOperation, uint8_t aDestination, int32_t aValue)
+    {
+        return Instruction(BPF_ALU64 | aOperation | BPF_K, aDestination, 0, 0, aValue);
+    }
+
+    constexpr bpf_insn CalculateWith(uint8_t aOperation, uint8_t aDestination, uint8_t aSource)
+    {
+        return Instruction(BPF_ALU64 | aOperation | BPF_X, aDestination, aSource, 0, 0);
+    }
+
+    constexpr bpf_insn JumpIf(uint8_t aOperation, uint8_t aDestination, int32_t aValue, int16_t aOffset)
+    {
+        return Instruction(BPF_JMP | aOperation | BPF_K, aDestination, 0, aOffset, aValue);
+    }
+
+    constexpr bpf_insn JumpIfWith(uint8_t aOperation, uint8_t aDestination, uint8_t aSource, int16_t aOffset)
+    {
+        return Instruction(BPF_JMP | aOperation | BPF_X, aDestination, aSource, aOffset, 0);
+    }
+
+    constexpr bpf_insn Call(int32_t aFunction)
+    {
+        return Instruction(BPF_JMP | BPF_CALL, 0, 0, 0, aFunction);
+    }
+
+    constexpr bpf_insn Exit()
+    {
+        return Instruction(BPF_JMP | BPF_EXIT, 0, 0, 0, 0);
+    }
+
+    // Loading a map takes two instructions, the second one is empty
+    constexpr bpf_insn LoadMap(uint8_t aDestination, int aMap)
+    {
+        return Instruction(BPF_LD | BPF_DW | BPF_IMM, aDestination, BPF_PSEUDO_MAP_FD, 0, aMap);
+    }
+
+    void* Map(std::size_t aSize, int aFd, off_t aOffset)
+    {
+        void* lReturn{mmap(nullptr, aSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, aFd, aOffset)};
+        return (lReturn == MAP_FAILED) ? nullptr : lReturn;
+    }
+}  // namespace
+
+XDPSocket::~XDPSocket()
+{
+    Close();
+}
+
+bool XDPSocket::Open(std::string_view aInterface)
+{
+    Close();
+
+    mInterfaceIndex = if_nametoindex(std::string(aInterface).c_str());
+    if (mInterfaceIndex == 0) {
+        Logger::GetInstance().Log("Could not find adapter " + std::string(aInterface), Logger::Level::DEBUG);
+        return false;
+    }
+
+    mFd = socket(AF_XDP, SOCK_RAW, 0);
+    if (mFd < 0) {
+        Logger::GetInstance().Log(std::string("Could not open AF_XDP socket: ") + strerror(errno),
+                                  Logger::Level::DEBUG);
+        return false;
+    }
+
+    // The memory frames are copied into and sent from, shared with the kernel
+    void* lMemory{mmap(nullptr, cFrames * cFrameSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0)};
+    if (lMemory == MAP_FAILED) {
+        Close();
+        return false;
+    }
+    mMemory = static_cast<char*>(lMemory);
+
+    xdp_umem_reg lRegistration{};
+    lRegistration.addr       = reinterpret_cast<uint64_t>(mMemory);
+    lRegistration.len        = cFrames * cFrameSize;
+    lRegistration.chunk_size = cFrameSize;
+
+    uint32_t lReceiveEntries{cReceiveFrames};
+    uint32_t lSendEntries{cSendFrames};
+    if (setsockopt(mFd, SOL_XDP, XDP_UMEM_REG, &lRegistration, sizeof(lRegistration)) != 0 ||
+        setsockopt(mFd, SOL_XDP, XDP_UMEM_FILL_RING, &lReceiveEntries, sizeof(lReceiveEntries)) != 0 ||
+        setsockopt(mFd, SOL_XDP, XDP_UMEM_COMPLETION_RING, &lSendEntries, sizeof(lSendEntries)) != 0 ||
+        setsockopt(mFd, SOL_XDP, XDP_RX_RING, &lReceiveEntries, sizeof(lReceiveEntries)) != 0 ||
+        setsockopt(mFd, SOL_XDP, XDP_TX_RING, &lSendEntries, sizeof(lSendEntries)) != 0) {
+        Logger::GetInstance().Log(std::string("Could not set up AF_XDP rings: ") + strerror(errno),
+                                  Logger::Level::DEBUG);
+        Close();
+        return false;
+    }
+
+    xdp_mmap_offsets lOffsets{};
+    socklen_t        lOffsetsSize{sizeof(lOffsets)};
+    if (getsockopt(mFd, SOL_XDP, XDP_MMAP_OFFSETS, &lOffsets, &lOffsetsSize) != 0 ||
+        !MapRing(mFillRing, lOffsets.fr, XDP_UMEM_PGOFF_FILL_RING, cReceiveFrames, sizeof(uint64_t)) ||
+        !MapRing(mCompletionRing, lOffsets.cr, XDP_UMEM_PGOFF_COMPLETION_RING, cSendFrames, sizeof(uint64_t)) ||
+        !MapRing(mReceiveRing, lOffsets.rx, XDP_PGOFF_RX_RING, cReceiveFrames, sizeof(xdp_desc)) ||
+        !MapRing(mSendRing, lOffsets.tx, XDP_PGOFF_TX_RING, cSendFrames, sizeof(xdp_desc))) {
+        Logger::GetInstance().Log("Could not map AF_XDP rings", Logger::Level::DEBUG);
+        Close();
+        return false;
+    }
+
+    // The first frames are for receiving and all handed to the kernel, the others are for sending
+    mFillProducer = *mFillRing.mProducer;
+    for (uint32_t lFrame = 0; lFrame < cReceiveFrames; lFrame++) {
+        Refill(static_cast<uint64_t>(lFrame) * cFrameSize);
+    }
+    std::atomic_ref<uint32_t>(*mFillRing.mProducer).store(mFillProducer, std::memory_order_release);
+
+    mFreeFrames.clear();
+    for (uint32_t lFrame = cReceiveFrames; lFrame < cFrames; lFrame++) {
+        mFreeFrames.emplace_back(static_cast<uint64_t>(lFrame) * cFrameSize);
+    }
+
+    // Copy mode, zero copy needs driver support which wireless drivers do not have
+    sockaddr_xdp lAddress{};
+    lAddress.sxdp_family   = AF_XDP;
+    lAddress.sxdp_ifindex  = mInterfaceIndex;
+    lAddress.sxdp_queue_id = cQueue;
+    lAddress.sxdp_flags    = XDP_COPY;
+
+    if (bind(mFd, reinterpret_cast<sockaddr*>(&lAddress), sizeof(lAddress)) != 0) {
+        Logger::GetInstance().Log(std::string("Could not bind AF_XDP socket: ") + strerror(errno),
+                                  Logger::Level::DEBUG);
+        Close();
+        return false;
+    }
+
+    if (!LoadProgram() || !AttachProgram()) {
+        Close();
+        return false;
+    }
+
+    return true;
+}
+
+bool XDPSocket::MapRing(
+    Ring& aRing, const xdp_ring_offset& aOffsets, off_t aPageOffset, uint32_t aEntries, std::size_t aEntrySize)
+{
+    aRing.mMapSize = aOffsets.desc + aEntries * aEntrySize;
+    aRing.mMap     = Map(aRing.mMapSize, mFd, aPageOffset);
+
+    if (aRing.mMap != nullptr) {
+        char* lBase{static_cast<char*>(aRing.mMap)};
+        aRing.mProducer    = reinterpret_cast<uint32_t*>(lBase + aOffsets.producer);
+        aRing.mConsumer    = reinterpret_cast<uint32_t*>(lBase + aOffsets.consumer);
+        aRing.mDescriptors = lBase + aOffsets.desc;
+        aRing.mMask        = aEntries - 1;
+    }
+
+    return aRing.mMap != nullptr;
+}
+
+bool XDPSocket::LoadProgram()
+{
+    mSocketMap  = CreateMap(BPF_MAP_TYPE_XSKMAP, sizeof(uint32_t), sizeof(int), cMaxQueues);
+    mConsoleMap = CreateMap(BPF_MAP_TYPE_HASH, sizeof(uint32_t), sizeof(uint8_t), cConsoleVendors.size());
+    if (mSocketMap < 0 || mConsoleMap < 0) {
+        Logger::GetInstance().Log(std::string("Could not create XDP maps: ") + strerror(errno), Logger::Level::DEBUG);
+        return false;
+    }
+
+    uint32_t lQueue{cQueue};
+    uint8_t  lPresent{1};
+    bool     lReturn{UpdateMap(mSocketMap, &lQueue, &mFd)};
+    for (const auto& lVendor : cConsoleVendors) {
+        // Same order the program puts the bytes in
+        uint32_t lKey{static_cast<uint32_t>(lVendor.at(0) | (lVendor.at(1) << 8) | (lVendor.at(2) << 16))};
+        lReturn = lReturn && UpdateMap(mConsoleMap, &lKey, &lPresent);
+    }
+
+    if (!lReturn) {
+        Logger::GetInstance().Log(std::string("Could not fill XDP maps: ") + strerror(errno), Logger::Level::DEBUG);
+        return false;
+    }
+
+    // R6: context, R2: start of the frame, R3: end of the frame
+    const std::array<bpf_insn, 30> lProgram{
+        Move(BPF_REG_6, BPF_REG_1),
+        Load(BPF_W, BPF_REG_2, BPF_REG_6, offsetof(xdp_md, data)),
+        Load(BPF_W, BPF_REG_3, BPF_REG_6, offsetof(xdp_md, data_end)),
+        Move(BPF_REG_4, BPF_REG_2),
+        Calculate(BPF_ADD, BPF_REG_4, Net_8023_Constants::cHeaderLength),
+        JumpIfWith(BPF_JGT, BPF_REG_4, BPF_REG_3, 22),  // Too short, pass
+
+        // PSP plugin frames
+        Load(BPF_H, BPF_REG_4, BPF_REG_2, Net_8023_Constants::cEtherTypeIndex),
+        JumpIf(BPF_JEQ, BPF_REG_4, Net_Constants::cPSPEtherType, 14),  // Redirect
+
+        // Frames sent by consoles, look up the vendor part of the source mac address
+        Load(BPF_B, BPF_REG_4, BPF_REG_2, Net_8023_Constants::cSourceAddressIndex),
+        Load(BPF_B, BPF_REG_5, BPF_REG_2, Net_8023_Constants::cSourceAddressIndex + 1),
+        Calculate(BPF_LSH, BPF_REG_5, 8),
+        CalculateWith(BPF_OR, BPF_REG_4, BPF_REG_5),
+        Load(BPF_B, BPF_REG_5, BPF_REG_2, Net_8023_Constants::cSourceAddressIndex + 2),
+        Calculate(BPF_LSH, BPF_REG_5, 16),
+        CalculateWith(BPF_OR, BPF_REG_4, BPF_REG_5),
+        Store(BPF_W, BPF_REG_10, BPF_REG_4, -4),
+        LoadMap(BPF_REG_1, mConsoleMap),
+        bpf_insn{},
+        Move(BPF_REG_2, BPF_REG_10),
+        Calculate(BPF_ADD, BPF_REG_2, -4),
+        Call(BPF_FUNC_map_lookup_elem),
+        JumpIf(BPF_JEQ, BPF_REG_0, 0, 6),  // Pass
+
+        // Redirect, falls back to passing when there is no socket on the queue
+        Load(BPF_W, BPF_REG_2, BPF_REG_6, offsetof(xdp_md, rx_queue_index)),
+        LoadMap(BPF_REG_1, mSocketMap),
+        bpf_insn{},
+        MoveValue(BPF_REG_3, XDP_PASS),
+        Call(BPF_FUNC_redirect_map),
+        Exit(),
+
+        // Pass
+        MoveValue(BPF_REG_0, XDP_PASS),
+        Exit()};
+
+    static constexpr std::string_view cLicense{"Dual MIT/GPL"};
+
+    bpf_attr lAttributes{};
+    lAttributes.prog_type            = BPF_PROG_TYPE_XDP;
+    lAttributes.expected_attach_type = BPF_XDP;
+    lAttributes.insns                = reinterpret_cast<uint64_t>(lProgram.data());
+    lAttributes.insn_cnt             = lProgram.size();
+    lAttributes.license              = reinterpret_cast<uint64_t>(cLicense.data());
+
+    mProgram = Bpf(BPF_PROG_LOAD, lAttributes);
+    if (mProgram < 0) {
+        Logger::GetInstance().Log(std::string("Could not load XDP program: ") + strerror(errno), Logger::Level::DEBUG);
+        return false;
+    }
+
+    return true;
+}
+
+bool XDPSocket::AttachProgram()
+{
+    // Attached through a link, so the program is detached when the link is closed, even if we crash
+    bpf_attr lAttributes{};
+    lAttributes.link_create.prog_fd        = static_cast<uint32_t>(mProgram);
+    lAttributes.link_create.target_ifindex = mInterfaceIndex;
+    lAttributes.link_create.attach_type    = BPF_XDP;
+    lAttributes.link_create.flags          = XDP_FLAGS_SKB_MODE;
+
+    mLink = Bpf(BPF_LINK_CREATE, lAttributes);
+    if (mLink < 0) {
+        Logger::GetInstance().Log(std::string("Could not attach XDP program: ") + strerror(errno),
+                                  Logger::Level::DEBUG);
+        return false;
+    }
+
+    return true;
+}
+
+void XDPSocket::Close()
+{
+    for (int* lFd : {&mLink, &mProgram, &mConsoleMap, &mSocketMap, &mFd}) {
+        if (*lFd >= 0) {
+            close(*lFd);
+            *lFd = -1;
+        }
+    }
+
+    for (Ring* lRing : {&mFillRing, &mCompletionRing, &mReceiveRing, &mSendRing}) {
+        if (lRing->mMap != nullptr) {
+            munmap(lRing->mMap, lRing->mMapSize);
+        }
+        *lRing = Ring{};
+    }
+
+    if (mMemory != nullptr) {
+        munmap(mMemory, cFrames * cFrameSize);
+        mMemory = nullptr;
+    }
+
+    if (mFailedSends > 0) {
+        Logger::GetInstance().Log("AF_XDP sends failed: " + std::to_string(mFailedSends), Logger::Level::DEBUG);
+        mFailedSends = 0;
+    }
+
+    mFreeFrames.clear();
+}
+
+bool XDPSocket::IsOpen() const
+{
+    return mLink >= 0;
+}
+
+int XDPSocket::GetFd() const
+{
+    return mFd;
+}
+
+void XDPSocket::Refill(uint64_t aAddress)
+{
+    // The kernel hands out addresses past the start of the frame
+    auto* lAddresses{static_cast<uint64_t*>(mFillRing.mDescriptors)};
+    lAddresses[mFillProducer & mFillRing.mMask] = aAddress & ~uint64_t{cFrameSize - 1};
+    mFillProducer++;
+}
+
+void XDPSocket::HandleCompletions()
+{
+    unsigned int lProducer{std::atomic_ref<uint32_t>(*mCompletionRing.mProducer).load(std::memory_order_acquire)};
+    unsigned int lConsumer{*mCompletionRing.mConsumer};
+    auto*        lAddresses{static_cast<const uint64_t*>(mCompletionRing.mDescriptors)};
+
+    for (unsigned int lIndex = lConsumer; lIndex != lProducer; lIndex++) {
+        mFreeFrames.emplace_back(lAddresses[lIndex & mCompletionRing.mMask]);
+    }
+
+    std::atomic_ref<uint32_t>(*mCompletionRing.mConsumer).store(lProducer, std::memory_order_release);
+}
+
+void XDPSocket::Kick()
+{
+    // In copy mode the kernel only sends when asked to, busy means it is still sending the previous frames
+    if (sendto(mFd, nullptr, 0, MSG_DONTWAIT, nullptr, 0) < 0 && errno != EAGAIN && errno != EBUSY &&
+        errno != ENOBUFS) {
+        Logger::GetInstance().Log(std::string("AF_XDP send failed: ") + strerror(errno), Logger::Level::DEBUG);
+    }
+}
+
+bool XDPSocket::HasSendRoom() const
+{
+    unsigned int lProducer{*mSendRing.mProducer};
+    unsigned int lConsumer{std::atomic_ref<uint32_t>(*mSendRing.mConsumer).load(std::memory_order_acquire)};
+    return !mFreeFrames.empty() && lProducer - lConsumer <= mSendRing.mMask;
+}
+
+SendResult XDPSocket::Send(std::string_view aData)
+{
+    if (aData.size() > cFrameSize) {
+        return SendResult::NotQueued;
+    }
+
+    std::lock_guard<std::mutex> lLock{mSendMutex};
+
+    if (!IsOpen()) {
+        return SendResult::NotQueued;
+    }
+
+    HandleCompletions();
+
+    // Handing this frame to libpcap instead would make it overtake everything still on the ring
+    auto lDeadline{std::chrono::steady_clock::now() + std::chrono::milliseconds(cSendWaitMs)};
+    while (!HasSendRoom()) {
+        if (std::chrono::steady_clock::now() >= lDeadline) {
+            mFailedSends++;
+            return SendResult::Failed;
+        }
+
+        Kick();
+        pollfd lPollFd{mFd, POLLOUT, 0};
+        poll(&lPollFd, 1, 1);
+        HandleCompletions();
+    }
+
+    unsigned int lProducer{*mSendRing.mProducer};
+    uint64_t     lAddress{mFreeFrames.back()};
+    mFreeFrames.pop_back();
+    memcpy(mMemory + lAddress, aData.data(), aData.size());
+
+    static_cast<xdp_desc*>(mSendRing.mDescriptors)[lProducer & mSendRing.mMask] =
+        xdp_desc{lAddress, static_cast<uint32_t>(aData.size()), 0};
+    std::atomic_ref<uint32_t>(*mSendRing.mProducer).store(lProducer + 1, std::memory_order_release);
+
+    Kick();
+
+    return SendResult::Queued;
+}
+#endif
@@ -2,6 +2,7 @@
 
 #include "XLinkKaiConnection.h"
 
+#include <algorithm>
 #include <chrono>
 #include <cstring>
 #include <iostream>
@@ -10,22 +11,97 @@
 
 #include <boost/exception/diagnostic_information.hpp>
 
+#include "FlightRecorder.h"
 #include "IPCapDevice.h"
 #include "Logger.h"
 #include "MonitorDevice.h"
 #include "NetConversionFunctions.h"
 #include "Timer.h"
+#include "Tracer.h"
 #include "UDPSocketWrapper.h"
 
 using namespace std::chrono_literals;
 
+namespace
+{
+    /**
+     * Connector handed to a device that shares an XLink Kai connection with other devices, it tells the connection
+     * which device data came from.
+     */
+    class DeviceConnector : public IConnector
+    {
+    public:
+        DeviceConnector(XLinkKaiConnection& aConnection, IPCapDevice& aDevice) :
+            mConnection(aConnection), mDevice(aDevice)
+        {}
+
+        // The shared connection is opened, closed and read by its owner
+        bool Open(std::string_view /*aArgument*/) override
+        {
+            return true;
+        }
+
+        void Close() override {}
+
+        bool ReadNextData() override
+        {
+            return false;
+        }
+
+        bool Send(std::string_view aData) override
+        {
+            return mConnection.SendFromDevice(aData, mDevice);
+        }
+
+        bool Send(std::string_view aCommand, std::string_view aData) override
+        {
+            return mConnection.Send(aCommand, aData);
+        }
+
+        void SendTitleId(std::string_view aTitleId) override
+        {
+            mConnection.SendTitleId(aTitleId);
+        }
+
+        void SendESSID(std::string_view aESSID) override
+        {
+            mConnection.SendESSID(aESSID);
+        }
+
+        void SetIncomingConnection(std::shared_ptr<IPCapDevice> /*aDevice*/) override {}
+
+        bool StartReceiverThread() override
+        {
+            return true;
+        }
+
+    private:
+        XLinkKaiConnection& mConnection;
+        IPCapDevice&        mDevice;
+    };
+}  // namespace
+
 XLinkKaiConnection::XLinkKaiConnection(std::shared_ptr<IUDPSocketWrapper> aSocketWrapper,
                                        std::shared_ptr<ITimer>            aConnectionTimer,
                                        std::shared_ptr<ITimer>            aKeepAliveTimer) :
     mSocketWrapper(aSocketWrapper ? aSocketWrapper : std::make_shared<UDPSocketWrapper>()),
     mConnectionTimer(aConnectionTimer ? aConnectionTimer : std::make_shared<Timer>()),
     mKeepAliveTimer(aKeepAliveTimer ? aKeepAliveTimer : std::make_shared<Timer>())
-{}
+{
+    // Data from XLink Kai gets picked up again after it is sent over the air, the devices drop it right away as long
+    // as its source is known to live behind XLink Kai
+    mForwardingDatabase.SetChangeHandler([this](uint64_t aMac, ForwardingDatabase::Side aSide, bool aKnown) {
+        if (aSide == ForwardingDatabase::Side::Remote) {
+            for (const auto& lTarget : mDeliveryTargets) {
+                if (aKnown) {
+                    lTarget.mDevice->BlackList(aMac);
+                } else {
+                    lTarget.mDevice->RemoveFromBlackList(aMac);
+                }
+            }
+        }
+    });
+}
 
 XLinkKaiConnection::~XLinkKaiConnection()
 {
@@ -58,6 +134,9 @@ bool XLinkKaiConnection::Connect()
     if (Send(cConnectString, "")) {
         // Start the timer for receiving a confirmation from XLink Kai.
         mConnectInitiated = true;
+
+        std::scoped_lock lLock{mLinkMutex};
+        mConnectSentTime = std::chrono::steady_clock::now();
     } else {
         // Logging in send function
         lReturn = false;
@@ -76,6 +155,8 @@ bool XLinkKaiConnection::Send(std::string_view aCommand, std::string_view aData)
                 if (aCommand == cEthernetDataString) {
                     Logger::GetInstance().Log("Sent: " + std::string(aCommand) + PrettyHexString(aData),
                                               Logger::Level::TRACE);
+                    FlightRecorder::GetInstance().Record(
+                        FlightRecorder::Interface::XLinkKai, FlightRecorder::Direction::Outbound, aData);
                 } else {
                     Logger::GetInstance().Log("Sent: " + std::string(aCommand) + std::string(aData),
                                               Logger::Level::DEBUG);
@@ -102,7 +183,34 @@ bool XLinkKaiConnection::Send(std::string_view aCommand, std::string_view aData)
 
 bool XLinkKaiConnection::Send(std::string_view aData)
 {
-    return Send(cEthernetDataString, aData);
+    // Without a connector in between the data comes from the only device this connection serves
+    IPCapDevice* lDevice{(mDeliveryTargets.size() == 1) ? mDeliveryTargets.front().mDevice : nullptr};
+
+    // Dropping looped or suppressed data is not a failure of the device that sent it
+    return !LearnFromDevice(aData, lDevice) || !mBroadcastGovernor.Allow(aData) || Send(cEthernetDataString, aData);
+}
+
+bool XLinkKaiConnection::SendFromDevice(std::string_view aData, IPCapDevice& aDevice)
+{
+    return !LearnFromDevice(aData, &aDevice) || !mBroadcastGovernor.Allow(aData) || Send(cEthernetDataString, aData);
+}
+
+bool XLinkKaiConnection::LearnFromDevice(std::string_view aData, IPCapDevice* aDevice)
+{
+    bool lReturn{true};
+
+    if (aData.size() >= Net_8023_Constants::cHeaderLength) {
+        uint64_t lSourceMac{GetRawData<uint64_t>(aData, Net_8023_Constants::cSourceAddressIndex) &
+                            Net_Constants::cBroadcastMac};
+
+        // Data from XLink Kai that was sent over the air gets picked up again by the devices
+        if (!mForwardingDatabase.Learn(lSourceMac, ForwardingDatabase::Side::Local, aDevice, aData.size())) {
+            mLoopedFrames++;
+            lReturn = false;
+        }
+    }
+
+    return lReturn;
 }
 
 void XLinkKaiConnection::SendESSID(std::string_view aESSID)
@@ -143,20 +251,22 @@ bool XLinkKaiConnection::ReadNextData()
     size_t lBytesReceived{mSocketWrapper->ReceiveFrom(mData.data(), cMaxLength)};
 
     if (lBytesReceived > 0) {
-        ReceiveCallback(lBytesReceived);
+        HandleDatagram(std::string_view(mData.data(), lBytesReceived));
     }
 
     return lReturn;
 }
 
-void XLinkKaiConnection::ReceiveCallback(size_t aBytesReceived)
+void XLinkKaiConnection::HandleDatagram(std::string_view aData)
 {
-    std::string lData{mData.begin(), mData.begin() + aBytesReceived};
+    std::string lData{aData};
 
     // If we actually received anything useful, react.
     if (!lData.empty()) {
+        std::chrono::steady_clock::time_point lNow{std::chrono::steady_clock::now()};
+
         // Make sure the keepalive timer gets tickled so it doesn't bite.
-        mKeepAliveTimer->Start(cKeepAliveTimeout);
+        mKeepAliveTimer->Start(GetKeepAliveTimeout());
         std::size_t lFirstSeparator{lData.find(cSeparator)};
         std::string lCommand{lData.substr(0, lFirstSeparator + 1)};
 
@@ -170,12 +280,28 @@ void XLinkKaiConnection::ReceiveCallback(size_t aBytesReceived)
                 Logger::GetInstance().Log("XLink Kai succesfully connected: " + lCommand, Logger::Level::INFO);
                 mConnectInitiated = false;
                 mConnected        = true;
+                mReconnectDelay   = cMinimumReconnectDelay;
+
+                std::scoped_lock lLock{mLinkMutex};
+                mRoundTripTime.AddSample(
+                    std::chrono::duration_cast<std::chrono::microseconds>(lNow - mConnectSentTime));
+                mLastKeepAlive.reset();
             }
         }
 
         // If no connection confirmation has been sent on XLink Kai's side, Don't care about any other message yet
         if (mConnected) {
             if (lCommand == cKeepAliveString) {
+                {
+                    std::scoped_lock lLock{mLinkMutex};
+                    if (mLastKeepAlive.has_value()) {
+                        mKeepAliveInterval.AddSample(
+                            std::chrono::duration_cast<std::chrono::microseconds>(lNow - mLastKeepAlive.value()));
+                    }
+                    mLastKeepAlive = lNow;
+                    mKeepAlivesReceived++;
+                }
+
                 HandleKeepAlive();
             } else if (lCommand == std::string(cEthernetDataFormat) + cSeparator.data()) {
                 // For data XLink Kai uses e;e; which doesn't filter all that well, so if we find e; just check if this
@@ -185,26 +311,45 @@ void XLinkKaiConnection::ReceiveCallback(size_t aBytesReceived)
                 Logger::GetInstance().Log("Received: " + PrettyHexString(lData.substr(cEthernetDataString.length())),
                                           Logger::Level::TRACE);
 
-                if (lCommand == cEthernetDataString) {
-                    if (mIncomingConnection != nullptr) {
-                        // Strip e;e;
-                        mEthernetData =
-                            lData.substr(cEthernetDataString.length(), lData.length() - cEthernetDataString.length());
-
-                        mPacketHandler.Update(mEthernetData);
-
-                        std::shared_ptr<MonitorDevice> lMonitorDevice =
-                            std::dynamic_pointer_cast<MonitorDevice>(mIncomingConnection);
-
-                        // If it is actually a monitor device, do convert.
-                        if (lMonitorDevice != nullptr) {
-                            mEthernetData = mPacketHandler.ConvertPacketOut(lMonitorDevice->GetLockedBSSID(),
-                                                                            lMonitorDevice->GetDataPacketParameters());
+                // Data arriving while the devices are still being opened is dropped
+                if (lCommand == cEthernetDataString && mDeliveryEnabled) {
+                    HardwareCounters::Measurement lMeasurement{mHardwareCounters};
+
+                    // Strip e;e;, every device gets a view on the same received data
+                    std::string_view lEthernetData{std::string_view(lData).substr(cEthernetDataString.length())};
+                    FlightRecorder::GetInstance().Record(
+                        FlightRecorder::Interface::XLinkKai, FlightRecorder::Direction::Inbound, lEthernetData);
+                    mPacketHandler.Update(lEthernetData);
+
+                    uint64_t lDestinationMac{mPacketHandler.GetDestinationMac()};
+                    if (!mForwardingDatabase.Learn(mPacketHandler.GetSourceMac(),
+                                                   ForwardingDatabase::Side::Remote,
+                                                   nullptr,
+                                                   lEthernetData.size(),
+                                                   lNow)) {
+                        // A device sent this to XLink Kai, which sent it back
+                        mLoopedFrames++;
+                    } else if ((lDestinationMac & Net_Constants::cGroupAddressBit) != 0) {
+                        // Group addresses are never learned, so those go to every device
+                        for (const auto& lTarget : mDeliveryTargets) {
+                            Deliver(lTarget, lEthernetData);
+                        }
+                    } else {
+                        // Unicast only goes over the air when the destination is known to be there, nothing would
+                        // acknowledge it otherwise
+                        std::optional<ForwardingDatabase::Entry> lDestination{
+                            mForwardingDatabase.Find(lDestinationMac, lNow)};
+                        const DeliveryTarget* lTarget{nullptr};
+
+                        if (lDestination.has_value() && lDestination->mSide == ForwardingDatabase::Side::Local) {
+                            lTarget = FindDeliveryTarget(lDestination->mDevice);
                         }
 
-                        // Data from XLink Kai should never be caught in the receiver thread
-                        mIncomingConnection->BlackList(mPacketHandler.GetSourceMac());
-                        mIncomingConnection->Send(mEthernetData);
+                        if (lTarget != nullptr) {
+                            Deliver(*lTarget, lEthernetData);
+                        } else {
+                            mUnknownUnicastFrames++;
+                        }
                     }
                 } else if (lCommand == cEthernetDataMetaString) {
                     if (lData.substr(cEthernetDataMetaString.length(), cSetESSIDFormat.length()) == cSetESSIDFormat) {
@@ -216,8 +361,10 @@ void XLinkKaiConnection::ReceiveCallback(size_t aBytesReceived)
                         Logger::GetInstance().Log("XLink Kai gave us the following ESSID: " + lESSID,
                                                   Logger::Level::DEBUG);
 
-                        if (!mHosting && mUseHostSSID) {
-                            mIncomingConnection->Connect(lESSID);
+                        if (!mHosting && mUseHostSSID && mDeliveryEnabled) {
+                            for (auto& lDevice : mIncomingConnections) {
+                                lDevice->Connect(lESSID);
+                            }
                         }
                     } else {
                         Logger::GetInstance().Log(std::string("Unrecognized e;d message from XLink Kai: ") + lData,
@@ -242,38 +389,53 @@ bool XLinkKaiConnection::StartReceiverThread()
     if (mSocketWrapper->IsOpen()) {
         // Run
         if (mReceiverThread == nullptr) {
+            // Stopped when the connection was closed before
+            for (const auto& lTarget : mDeliveryTargets) {
+                if (lTarget.mSender != nullptr) {
+                    lTarget.mSender->Start();
+                }
+            }
+
             mReceiverThread = std::make_shared<std::thread>([&] {
+                TRACE_THREAD_NAME("XLink Kai");
                 mSocketWrapper->StartThread();
 
                 // Try to connect to XLink Kai for the first time before going into the while loop.
                 Connect();
 
                 // Also set the timeout
-                mConnectionTimer->Start(cConnectionTimeout);
+                mConnectionTimer->Start(GetConnectionTimeout());
 
                 while (!mSocketWrapper->IsThreadStopped()) {
-                    mSocketWrapper->AsyncReceiveFrom(
-                        mData.data(), cMaxLength, [&](size_t aBufferSize) { ReceiveCallback(aBufferSize); });
+                    mSocketWrapper->AsyncReceiveFrom(*this);
 
-                    if ((!mConnected && !mConnectInitiated)) {
+                    // After a failed attempt the connection timer counts down to the next attempt, traffic keeps
+                    // being handled in the meantime
+                    if (!mConnected && !mConnectInitiated && (!mReconnectScheduled || mConnectionTimer->IsTimedOut())) {
+                        mReconnectScheduled = false;
                         Close(false);
                         Open(mIp, mPort);
                         Connect();
 
+                        {
+                            std::scoped_lock lLock{mLinkMutex};
+                            mReconnectAttempts++;
+                        }
+
                         // Also reset the timeout
-                        mConnectionTimer->Start(cConnectionTimeout);
+                        mConnectionTimer->Start(GetConnectionTimeout());
                     } else if ((!mConnected) && mConnectInitiated && mConnectionTimer->IsTimedOut()) {
                         Logger::GetInstance().Log("Timeout waiting for XLink Kai to connect", Logger::Level::ERROR);
                         mConnectInitiated = false;
                         mConnected        = false;
                         mSettingsSent     = false;
 
-                        // Retry in 10 seconds
-                        std::this_thread::sleep_for(10s);
+                        ScheduleReconnect();
                     } else if (mConnected && (!mConnectInitiated) && mKeepAliveTimer->IsTimedOut()) {
                         // KaiEngine stopped sending keepalive messages, must've died.
                         Logger::GetInstance().Log("It seems KaiEngine has stopped responding, resetting connection ...",
                                                   Logger::Level::ERROR);
+                        FlightRecorder::GetInstance().Dump("XLink Kai stopped sending keepalives");
                         mConnected        = false;
                         mConnectInitiated = false;
                         mSettingsSent     = false;
@@ -281,12 +443,21 @@ bool XLinkKaiConnection::StartReceiverThread()
                         Send(cSettingDDSOnlyString, "");
 
                         // Cache the title ID and ESSID because they get destroyed in the devices.
-                        std::string lTitleId = mIncomingConnection->GetTitleId().empty() ?
-                                                   mLastTitleId :
-                                                   mIncomingConnection->GetTitleId();
+                        std::string lTitleId{mLastTitleId};
+                        std::string lESSID{mLastESSID};
+                        for (auto& lDevice : mIncomingConnections) {
+                            if (!lDevice->GetTitleId().empty()) {
+                                lTitleId = lDevice->GetTitleId();
+                                break;
+                            }
+                        }
 
-                        std::string lESSID =
-                            mIncomingConnection->GetESSID().empty() ? mLastESSID : mIncomingConnection->GetESSID();
+                        for (auto& lDevice : mIncomingConnections) {
+                            if (!lDevice->GetESSID().empty()) {
+                                lESSID = lDevice->GetESSID();
+                                break;
+                            }
+                        }
 
                         if (!lTitleId.empty()) {
                             SendTitleId(lTitleId);
@@ -343,6 +514,18 @@ void XLinkKaiConnection::Close(bool aKillThread)
         mConnected        = false;
         mConnectInitiated = false;
 
+        if (aKillThread) {
+            mReconnectScheduled = false;
+            mReconnectDelay     = cMinimumReconnectDelay;
+
+            // Nothing may be sent to the devices anymore once this returns, as they get closed next
+            for (const auto& lTarget : mDeliveryTargets) {
+                if (lTarget.mSender != nullptr) {
+                    lTarget.mSender->Stop();
+                }
+            }
+        }
+
         mSocketWrapper->Close();
 
         // Settings need to be resent
@@ -358,11 +541,106 @@ void XLinkKaiConnection::SetHosting(bool aHosting)
     mHosting = aHosting;
 }
 
+void XLinkKaiConnection::SetDeliveryEnabled(bool aEnabled)
+{
+    mDeliveryEnabled = aEnabled;
+}
+
+void XLinkKaiConnection::SetPaceTransmissions(bool aPaceTransmissions)
+{
+    mPaceTransmissions = aPaceTransmissions;
+}
+
+void XLinkKaiConnection::SetBroadcastLimits(std::chrono::milliseconds aRepeatWindow, unsigned int aRateLimit)
+{
+    mBroadcastGovernor.SetLimits(aRepeatWindow, aRateLimit);
+}
+
+bool XLinkKaiConnection::IsConnected() const
+{
+    return mConnected;
+}
+
+LinkStatistics XLinkKaiConnection::GetLinkStatistics() const
+{
+    LinkStatistics lReturn{};
+
+    std::scoped_lock lLock{mLinkMutex};
+    lReturn.RoundTripTime          = mRoundTripTime.GetSmoothed();
+    lReturn.RoundTripTimeVariation = mRoundTripTime.GetVariation();
+    lReturn.KeepAliveInterval      = mKeepAliveInterval.GetSmoothed();
+    lReturn.KeepAliveJitter        = mKeepAliveInterval.GetVariation();
+    lReturn.KeepAlivesReceived     = mKeepAlivesReceived;
+    lReturn.ReconnectAttempts      = mReconnectAttempts;
+    lReturn.MacAddresses           = mForwardingDatabase.GetSize();
+    lReturn.LoopedFrames           = mLoopedFrames;
+    lReturn.UnknownUnicastFrames   = mUnknownUnicastFrames;
+
+    BroadcastGovernor_Constants::Statistics lBroadcastStatistics{mBroadcastGovernor.GetStatistics()};
+    lReturn.SuppressedRepeats     = lBroadcastStatistics.Repeats;
+    lReturn.RateLimitedBroadcasts = lBroadcastStatistics.RateLimited;
+    lReturn.Cpu                   = mHardwareCounters.GetStatistics();
+
+    for (const auto& lTarget : mDeliveryTargets) {
+        if (lTarget.mSender != nullptr) {
+            TransmitQueue_Constants::Statistics lQueueStatistics{lTarget.mSender->GetStatistics()};
+            lReturn.QueueDrops += lQueueStatistics.Overflows + lQueueStatistics.AgeDrops;
+        }
+    }
+
+    return lReturn;
+}
+
+std::chrono::milliseconds XLinkKaiConnection::GetConnectionTimeout() const
+{
+    std::chrono::milliseconds lReturn{cConnectionTimeout};
+
+    std::scoped_lock lLock{mLinkMutex};
+    if (mRoundTripTime.HasSamples()) {
+        lReturn = std::clamp(std::chrono::duration_cast<std::chrono::milliseconds>(cConnectionRoundTrips *
+                                                                                   mRoundTripTime.GetUpperBound()),
+                             std::chrono::milliseconds(cMinimumConnectionTimeout),
+                             std::chrono::milliseconds(cConnectionTimeout));
+    }
+
+    return lReturn;
+}
+
+std::chrono::milliseconds XLinkKaiConnection::GetKeepAliveTimeout() const
+{
+    std::chrono::milliseconds lReturn{cKeepAliveTimeout};
+
+    // A keepalive that is a couple of intervals late means XLink Kai stalled, no need to wait for the full timeout
+    std::scoped_lock lLock{mLinkMutex};
+    if (mKeepAliveInterval.HasSamples()) {
+        lReturn = std::clamp(std::chrono::duration_cast<std::chrono::milliseconds>(cStalledKeepAliveIntervals *
+                                                                                   mKeepAliveInterval.GetUpperBound()),
+                             std::chrono::milliseconds(cMinimumKeepAliveTimeout),
+                             std::chrono::milliseconds(cKeepAliveTimeout));
+    }
+
+    return lReturn;
+}
+
+void XLinkKaiConnection::ScheduleReconnect()
+{
+    Logger::GetInstance().Log("Retrying in " + std::to_string(mReconnectDelay.count()) + " ms", Logger::Level::INFO);
+
+    mConnectionTimer->Start(mReconnectDelay);
+    mReconnectScheduled = true;
+    mReconnectDelay     = std::min<std::chrono::milliseconds>(mReconnectDelay * 2, cMaximumReconnectDelay);
+}
+
 void XLinkKaiConnection::SetUseHostSSID(bool aUseHostSSID)
 {
     mUseHostSSID = aUseHostSSID;
 }
 
+bool XLinkKaiConnection::SetSocketOptions(const UDPSocketWrapper_Constants::SocketOptions& aOptions)
+{
+    return mSocketWrapper->SetOptions(aOptions);
+}
+
 void XLinkKaiConnection::SetPort(unsigned int aPort)
 {
     mPort = aPort;
@@ -370,5 +648,92 @@ void XLinkKaiConnection::SetPort(unsigned int aPort)
 
 void XLinkKaiConnection::SetIncomingConnection(std::shared_ptr<IPCapDevice> aDevice)
 {
-    mIncomingConnection = aDevice;
+    // Lifts the blacklist on the devices that are still there
+    mForwardingDatabase.Clear();
+
+    // Targets first, their senders may still be sending to the devices
+    mDeliveryTargets.clear();
+    mIncomingConnections.clear();
+    if (aDevice != nullptr) {
+        mIncomingConnections.emplace_back(aDevice);
+        mDeliveryTargets.emplace_back(CreateDeliveryTarget(*aDevice, mPaceTransmissions));
+    }
+}
+
+std::shared_ptr<IConnector> XLinkKaiConnection::AddIncomingConnection(std::shared_ptr<IPCapDevice> aDevice)
+{
+    if (std::find(mIncomingConnections.begin(), mIncomingConnections.end(), aDevice) == mIncomingConnections.end()) {
+        mIncomingConnections.emplace_back(aDevice);
+        mDeliveryTargets.emplace_back(CreateDeliveryTarget(*aDevice, mPaceTransmissions));
+    }
+
+    return std::make_shared<DeviceConnector>(*this, *aDevice);
+}
+
+template<typename Device>
+void XLinkKaiConnection::DeliverToDevice(const DeliveryTarget& aTarget, std::string_view aData)
+{
+    // The adapter picks the data rate itself, so this can only be aged, not paced
+    if (aTarget.mSender != nullptr) {
+        aTarget.mSender->Send(aData);
+    } else {
+        aTarget.mDevice->Send(aData);
+    }
+}
+
+template<>
+void XLinkKaiConnection::DeliverToDevice<MonitorDevice>(const DeliveryTarget& aTarget, std::string_view /*aData*/)
+{
+    const RadioTapReader::PhysicalDeviceParameters& lParameters{aTarget.mMonitorDevice->GetDataPacketParameters()};
+    std::string lPacket{mPacketHandler.ConvertPacketOut(aTarget.mMonitorDevice->GetLockedBSSID(), lParameters)};
+
+    if (aTarget.mSender != nullptr) {
+        // Airtime of 802.11n rates is not worked out, those are only aged
+        aTarget.mSender->Send(lPacket, (lParameters.mKnownMCSInfo == 0) ? lParameters.mDataRate : 0);
+    } else {
+        aTarget.mDevice->Send(lPacket);
+    }
+}
+
+XLinkKaiConnection::DeliveryTarget XLinkKaiConnection::CreateDeliveryTarget(IPCapDevice& aDevice,
+                                                                             bool         aPaceTransmissions)
+{
+    DeliveryTarget lReturn{&aDevice, nullptr, &XLinkKaiConnection::DeliverToDevice<IPCapDevice>};
+
+    // If it is actually a monitor device, data has to be converted.
+    lReturn.mMonitorDevice = dynamic_cast<MonitorDevice*>(&aDevice);
+    if (lReturn.mMonitorDevice != nullptr) {
+        lReturn.mDeliver = &XLinkKaiConnection::DeliverToDevice<MonitorDevice>;
+    }
+
+    if (aPaceTransmissions) {
+        lReturn.mSender = std::make_shared<PacedSender>([&aDevice](std::string_view aData) {
+            return aDevice.Send(aData);
+        });
+    }
+
+    return lReturn;
+}
+
+void XLinkKaiConnection::Deliver(const DeliveryTarget& aTarget, std::string_view aData)
+{
+    (this->*aTarget.mDeliver)(aTarget, aData);
+}
+
+const XLinkKaiConnection::DeliveryTarget* XLinkKaiConnection::FindDeliveryTarget(const IPCapDevice* aDevice) const
+{
+    const DeliveryTarget* lReturn{nullptr};
+
+    // With a single device everything local is reached through it, even when the data came in without a connector
+    if (mDeliveryTargets.size() == 1) {
+        lReturn = &mDeliveryTargets.front();
+    } else {
+        auto lIsDevice{[aDevice](const DeliveryTarget& aTarget) { return aTarget.mDevice == aDevice; }};
+        auto lTarget{std::find_if(mDeliveryTargets.begin(), mDeliveryTargets.end(), lIsDevice)};
+        if (lTarget != mDeliveryTargets.end()) {
+            lReturn = &*lTarget;
+        }
+    }
+
+    return lReturn;
 }
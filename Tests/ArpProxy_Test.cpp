@@ -0,0 +1,91 @@
+/* Copyright (c) 2022 [Rick de Bondt] - ArpProxy_Test.cpp
+ * This file contains tests for the ArpProxy class.
+ **/
+
+#include "ArpProxy.h"
+
+#include <string>
+
+#include <gtest/gtest.h>
+
+using namespace std::chrono;
+using Side = ArpProxy::Side;
+
+// Mac and IPv4 addresses of a handheld on the air and of one behind XLink Kai
+static const std::string cLocalMac{"\x00\x01\x02\x03\x04\x05", 6};
+static const std::string cLocalIp{"\x0A\x00\x00\x01", 4};
+static const std::string cRemoteMac{"\x0A\x0B\x0C\x0D\x0E\x0F", 6};
+static const std::string cRemoteIp{"\x0A\x00\x00\x02", 4};
+static const std::string cBroadcastMac{"\xFF\xFF\xFF\xFF\xFF\xFF", 6};
+static const std::string cNoMac{"\x00\x00\x00\x00\x00\x00", 6};
+
+class ArpProxyTest : public ::testing::Test
+{
+public:
+    // Builds an ethernet frame with an ARP packet for IPv4
+    static std::string CreateArp(bool               aRequest,
+                                 const std::string& aDestinationMac,
+                                 const std::string& aSenderMac,
+                                 const std::string& aSenderIp,
+                                 const std::string& aTargetMac,
+                                 const std::string& aTargetIp)
+    {
+        return aDestinationMac + aSenderMac + std::string("\x08\x06\x00\x01\x08\x00\x06\x04\x00", 9) +
+               (aRequest ? "\x01" : "\x02") + aSenderMac + aSenderIp + aTargetMac + aTargetIp;
+    }
+
+    ArpProxy::Clock::time_point mStart{ArpProxy::Clock::now()};
+    ArpProxy                    mProxy{};
+};
+
+TEST_F(ArpProxyTest, AnswersLocalRequestsForRemoteHosts)
+{
+    mProxy.SetEnabled(true, false);
+
+    std::string lRequest{CreateArp(true, cBroadcastMac, cLocalMac, cLocalIp, cNoMac, cRemoteIp)};
+
+    // Nothing known yet, so the request has to go through XLink Kai
+    EXPECT_FALSE(mProxy.Handle(lRequest, Side::Local, mStart).has_value());
+
+    // The reply comes back, from now on the proxy knows
+    std::string lReply{CreateArp(false, cLocalMac, cRemoteMac, cRemoteIp, cLocalMac, cLocalIp)};
+    EXPECT_FALSE(mProxy.Handle(lReply, Side::Remote, mStart).has_value());
+
+    std::optional<std::string> lAnswer{mProxy.Handle(lRequest, Side::Local, mStart + seconds(1))};
+    ASSERT_TRUE(lAnswer.has_value());
+    EXPECT_EQ(lAnswer.value(), lReply);
+    EXPECT_EQ(mProxy.GetAnswered(), 1);
+
+    // Until the binding gets too old
+    EXPECT_FALSE(mProxy.Handle(lRequest, Side::Local, mStart + ArpProxy_Constants::cAgingTime).has_value());
+}
+
+TEST_F(ArpProxyTest, OnlyAnswersAcrossSides)
+{
+    mProxy.SetEnabled(true, true);
+
+    std::string lRemoteRequest{CreateArp(true, cBroadcastMac, cRemoteMac, cRemoteIp, cNoMac, cLocalIp)};
+    std::string lLocalRequest{CreateArp(true, cBroadcastMac, cLocalMac, cLocalIp, cNoMac, cRemoteIp)};
+
+    EXPECT_FALSE(mProxy.Handle(lRemoteRequest, Side::Remote, mStart).has_value());
+    EXPECT_TRUE(mProxy.Handle(lLocalRequest, Side::Local, mStart).has_value());
+
+    // The local host is known by now, so XLink Kai can be answered as well
+    EXPECT_EQ(mProxy.Handle(lRemoteRequest, Side::Remote, mStart).value(),
+              CreateArp(false, cRemoteMac, cLocalMac, cLocalIp, cRemoteMac, cRemoteIp));
+
+    // The remote host asking on the air means its own answer came back around, not something to learn from
+    EXPECT_FALSE(mProxy.Handle(lRemoteRequest, Side::Local, mStart).has_value());
+    EXPECT_EQ(mProxy.GetAnswered(), 2);
+}
+
+TEST_F(ArpProxyTest, DisabledByDefault)
+{
+    mProxy.Handle(CreateArp(false, cLocalMac, cRemoteMac, cRemoteIp, cLocalMac, cLocalIp), Side::Remote, mStart);
+    EXPECT_FALSE(
+        mProxy.Handle(CreateArp(true, cBroadcastMac, cLocalMac, cLocalIp, cNoMac, cRemoteIp), Side::Local, mStart)
+            .has_value());
+
+    // Not ARP at all
+    EXPECT_FALSE(mProxy.Handle(std::string(64, '\0'), Side::Local, mStart).has_value());
+}
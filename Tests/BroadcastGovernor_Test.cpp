@@ -0,0 +1,67 @@
+/* Copyright (c) 2022 [Rick de Bondt] - BroadcastGovernor_Test.cpp
+ * This file contains tests for the BroadcastGovernor class.
+ **/
+
+#include "BroadcastGovernor.h"
+
+#include <string>
+
+#include <gtest/gtest.h>
+
+using namespace std::chrono;
+using namespace BroadcastGovernor_Constants;
+
+// Destination Mac, source Mac and EtherType
+static const std::string cBroadcastHeader{"\xFF\xFF\xFF\xFF\xFF\xFF\x00\x01\x02\x03\x04\x05\x88\xC8", 14};
+static const std::string cOtherSourceHeader{"\xFF\xFF\xFF\xFF\xFF\xFF\x00\x01\x02\x03\x04\x06\x88\xC8", 14};
+static const std::string cUnicastHeader{"\x0A\x0B\x0C\x0D\x0E\x0F\x00\x01\x02\x03\x04\x05\x88\xC8", 14};
+
+class BroadcastGovernorTest : public ::testing::Test
+{
+public:
+    BroadcastGovernor::Clock::time_point mStart{BroadcastGovernor::Clock::now()};
+};
+
+TEST_F(BroadcastGovernorTest, SuppressesRepeats)
+{
+    BroadcastGovernor lGovernor{milliseconds(100), 0};
+
+    EXPECT_TRUE(lGovernor.Allow(cBroadcastHeader + "lobby", mStart));
+    EXPECT_FALSE(lGovernor.Allow(cBroadcastHeader + "lobby", mStart + milliseconds(50)));
+
+    // Anything that differs is not a repeat
+    EXPECT_TRUE(lGovernor.Allow(cBroadcastHeader + "lobby2", mStart + milliseconds(50)));
+    EXPECT_TRUE(lGovernor.Allow(cOtherSourceHeader + "lobby", mStart + milliseconds(50)));
+
+    // Suppressed repeats do not keep the window open
+    EXPECT_TRUE(lGovernor.Allow(cBroadcastHeader + "lobby", mStart + milliseconds(100)));
+
+    // Unicast is never held back
+    EXPECT_TRUE(lGovernor.Allow(cUnicastHeader + "data", mStart));
+    EXPECT_TRUE(lGovernor.Allow(cUnicastHeader + "data", mStart));
+
+    Statistics lStatistics{lGovernor.GetStatistics()};
+    EXPECT_EQ(lStatistics.Forwarded, 4);
+    EXPECT_EQ(lStatistics.Repeats, 1);
+    EXPECT_EQ(lStatistics.RateLimited, 0);
+}
+
+TEST_F(BroadcastGovernorTest, LimitsRatePerSource)
+{
+    BroadcastGovernor lGovernor{milliseconds(0), 10};
+
+    // A second worth of broadcasts can go at once
+    for (int lCount = 0; lCount < 10; lCount++) {
+        EXPECT_TRUE(lGovernor.Allow(cBroadcastHeader + std::to_string(lCount), mStart));
+    }
+    EXPECT_FALSE(lGovernor.Allow(cBroadcastHeader + "more", mStart));
+
+    // Other sources have their own limit
+    EXPECT_TRUE(lGovernor.Allow(cOtherSourceHeader + "more", mStart));
+
+    // After that, one every 100 ms
+    EXPECT_TRUE(lGovernor.Allow(cBroadcastHeader + "later", mStart + milliseconds(100)));
+    EXPECT_FALSE(lGovernor.Allow(cBroadcastHeader + "too soon", mStart + milliseconds(150)));
+
+    EXPECT_EQ(lGovernor.GetStatistics().RateLimited, 2);
+}
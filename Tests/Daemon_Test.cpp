@@ -0,0 +1,110 @@
+/* Copyright (c) 2022 [Rick de Bondt] - Daemon_Test.cpp
+ * This file contains tests for the control socket commands of the Daemon class.
+ **/
+
+#include "Daemon.h"
+
+#include <filesystem>
+#include <string>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+using namespace Daemon_Constants;
+
+class DaemonTest : public ::testing::Test
+{
+public:
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+    // Sends a command over the control socket and reads the reply up to and including its last line
+    static std::string SendCommand(std::string_view aCommand)
+    {
+        boost::asio::io_service                     lIoService{};
+        boost::asio::local::stream_protocol::socket lSocket{lIoService};
+        lSocket.connect(boost::asio::local::stream_protocol::endpoint(std::string(cSocketName)));
+        boost::asio::write(lSocket, boost::asio::buffer(std::string(aCommand) + "\n"));
+
+        std::string lReturn{};
+        std::string lBuffer{};
+        bool        lDone{false};
+        while (!lDone) {
+            std::size_t lLength{boost::asio::read_until(lSocket, boost::asio::dynamic_buffer(lBuffer), '\n')};
+            std::string lLine{lBuffer.substr(0, lLength - 1)};
+            lBuffer.erase(0, lLength);
+
+            lReturn += lLine + "\n";
+            lDone = (lLine == cReplyOk) || (lLine.rfind(cReplyError, 0) == 0);
+        }
+
+        return lReturn;
+    }
+#endif
+
+    static constexpr std::string_view cSocketName{"xlinkhandheldassistant_test.sock"};
+};
+
+TEST_F(DaemonTest, ParseCommands)
+{
+    EXPECT_EQ(Daemon::ParseRequest("start")->Type, Command::Start);
+    EXPECT_EQ(Daemon::ParseRequest("stop")->Type, Command::Stop);
+    EXPECT_EQ(Daemon::ParseRequest("reconnect")->Type, Command::ReConnect);
+    EXPECT_EQ(Daemon::ParseRequest("stats")->Type, Command::Stats);
+    EXPECT_EQ(Daemon::ParseRequest("status")->Type, Command::Status);
+
+    std::optional<Request> lHostingOn{Daemon::ParseRequest("hosting on")};
+    ASSERT_TRUE(lHostingOn.has_value());
+    EXPECT_EQ(lHostingOn->Type, Command::Hosting);
+    EXPECT_TRUE(lHostingOn->Hosting);
+
+    std::optional<Request> lHostingOff{Daemon::ParseRequest("hosting off")};
+    ASSERT_TRUE(lHostingOff.has_value());
+    EXPECT_FALSE(lHostingOff->Hosting);
+}
+
+TEST_F(DaemonTest, RejectInvalidCommands)
+{
+    EXPECT_FALSE(Daemon::ParseRequest("").has_value());
+    EXPECT_FALSE(Daemon::ParseRequest("Start").has_value());
+    EXPECT_FALSE(Daemon::ParseRequest("start now").has_value());
+    EXPECT_FALSE(Daemon::ParseRequest("hosting").has_value());
+    EXPECT_FALSE(Daemon::ParseRequest("hosting maybe").has_value());
+}
+
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+TEST_F(DaemonTest, EveryReplyEndsWithOkOrError)
+{
+    WindowModel lModel{};
+    lModel.mConnectionMethod             = WindowModel_Constants::ConnectionMethod::Plugin;
+    lModel.mWifiAdapter                  = "xlhatest0";
+    lModel.mAutoDiscoverPSPVitaNetworks  = false;
+    lModel.mAutoDiscoverXLinkKaiInstance = false;
+
+    Daemon lDaemon{lModel};
+    ASSERT_TRUE(lDaemon.Open(cSocketName));
+    std::thread lRunThread{[&] { lDaemon.Run(); }};
+
+    // The status itself comes first, then the line telling the command was handled
+    std::string lStatus{SendCommand(cCommandStatus)};
+    std::string lOk{"\n" + std::string(cReplyOk) + "\n"};
+    ASSERT_GT(lStatus.size(), lOk.size());
+    EXPECT_EQ(lStatus.substr(lStatus.size() - lOk.size()), lOk);
+
+    EXPECT_EQ(SendCommand("hosting on"), std::string(cReplyOk) + "\n");
+    EXPECT_EQ(SendCommand("nonsense"), std::string(cReplyError) + "unknown command nonsense\n");
+
+    lDaemon.Stop();
+    lRunThread.join();
+}
+#endif
+
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+TEST_F(DaemonTest, OnlyOwnerCanUseSocket)
+{
+    WindowModel lModel{};
+    Daemon      lDaemon{lModel};
+    ASSERT_TRUE(lDaemon.Open(cSocketName));
+
+    EXPECT_EQ(std::filesystem::status(std::string(cSocketName)).permissions(),
+              std::filesystem::perms::owner_read | std::filesystem::perms::owner_write);
+}
+#endif
@@ -0,0 +1,104 @@
+/* Copyright (c) 2022 [Rick de Bondt] - Engine_Test.cpp
+ * This file contains tests for starting the Engine in the background. Whether the adapter can be opened depends on
+ * the machine, so the tests only check that what is reported is consistent.
+ **/
+
+#include "Engine.h"
+
+#include <chrono>
+#include <optional>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+using namespace Engine_Constants;
+using namespace std::chrono;
+
+class EngineTest : public ::testing::Test
+{
+public:
+    void SetUp() override
+    {
+        mModel.mConnectionMethod             = WindowModel_Constants::ConnectionMethod::Plugin;
+        mModel.mWifiAdapter                  = "xlhatest0";
+        mModel.mAutoDiscoverPSPVitaNetworks  = false;
+        mModel.mAutoDiscoverXLinkKaiInstance = false;
+    }
+
+    // Polls for the result of StartAsync the same way the main loop does
+    static std::optional<StartResult> WaitForStart(Engine& aEngine)
+    {
+        std::optional<StartResult> lReturn{};
+        steady_clock::time_point   lEnd{steady_clock::now() + seconds(10)};
+
+        while (!lReturn.has_value() && steady_clock::now() < lEnd) {
+            lReturn = aEngine.GetStartResult();
+            std::this_thread::sleep_for(milliseconds(1));
+        }
+
+        return lReturn;
+    }
+
+    WindowModel mModel{};
+};
+
+TEST_F(EngineTest, StartAsyncReportsResult)
+{
+    mModel.mConnectionMethod = WindowModel_Constants::ConnectionMethod::USB;
+    Engine lEngine{mModel};
+
+    EXPECT_FALSE(lEngine.IsStarting());
+    EXPECT_FALSE(lEngine.GetStartResult().has_value());
+
+    lEngine.StartAsync();
+    EXPECT_TRUE(lEngine.IsStarting());
+
+    std::optional<StartResult> lResult{WaitForStart(lEngine)};
+    ASSERT_TRUE(lResult.has_value());
+    EXPECT_EQ(lResult.value(), StartResult::UnknownMethod);
+
+    // Picked up, so no longer starting
+    EXPECT_FALSE(lEngine.IsStarting());
+    EXPECT_FALSE(lEngine.GetStartResult().has_value());
+    EXPECT_TRUE(lEngine.GetReadiness().empty());
+}
+
+TEST_F(EngineTest, ReadinessPerComponent)
+{
+    Engine lEngine{mModel};
+    lEngine.StartAsync();
+
+    std::optional<StartResult> lResult{WaitForStart(lEngine)};
+    ASSERT_TRUE(lResult.has_value());
+    ASSERT_TRUE(lResult.value() == StartResult::Success || lResult.value() == StartResult::DeviceFailed);
+
+    // XLink Kai is not running, so the connection never gets confirmed
+    std::vector<ComponentReadiness> lReadiness{lEngine.GetReadiness()};
+    ASSERT_EQ(lReadiness.size(), 2);
+    EXPECT_EQ(lReadiness.at(0).Name, "XLink Kai");
+    EXPECT_EQ(lReadiness.at(0).State, Readiness::Pending);
+    EXPECT_EQ(lReadiness.at(1).Name, mModel.mWifiAdapter);
+    EXPECT_EQ(lReadiness.at(1).State,
+              (lResult.value() == StartResult::Success) ? Readiness::Ready : Readiness::Failed);
+
+    lEngine.Stop();
+    EXPECT_TRUE(lEngine.GetReadiness().empty());
+}
+
+TEST_F(EngineTest, StopDuringStart)
+{
+    Engine lEngine{mModel};
+    lEngine.StartAsync();
+    lEngine.Stop();
+
+    EXPECT_FALSE(lEngine.IsStarting());
+    EXPECT_TRUE(lEngine.GetReadiness().empty());
+
+    // Stopping does not keep the engine from starting again
+    lEngine.StartAsync();
+    std::optional<StartResult> lResult{WaitForStart(lEngine)};
+    ASSERT_TRUE(lResult.has_value());
+    EXPECT_NE(lResult.value(), StartResult::Cancelled);
+    EXPECT_FALSE(lEngine.GetReadiness().empty());
+    lEngine.Stop();
+}
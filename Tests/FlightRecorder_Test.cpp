@@ -0,0 +1,191 @@
+/* Copyright (c) 2022 [Rick de Bondt] - FlightRecorder_Test.cpp
+ * This file contains tests for the FlightRecorder class.
+ **/
+
+#include "FlightRecorder.h"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace std::chrono;
+using namespace FlightRecorder_Constants;
+
+class FlightRecorderTest : public ::testing::Test
+{
+public:
+    struct Block
+    {
+        uint32_t    mType{0};
+        std::string mBody{};
+    };
+
+    // Splits pcapng data in blocks, checking the length at both ends of every block
+    static std::vector<Block> ReadBlocks(const std::string& aData)
+    {
+        std::vector<Block> lBlocks{};
+        std::size_t        lIndex{0};
+
+        while (lIndex + 12 <= aData.size()) {
+            uint32_t lType{0};
+            uint32_t lLength{0};
+            uint32_t lTrailingLength{0};
+            memcpy(&lType, aData.data() + lIndex, sizeof(lType));
+            memcpy(&lLength, aData.data() + lIndex + 4, sizeof(lLength));
+            EXPECT_EQ(lLength % 4, 0);
+            EXPECT_LE(lIndex + lLength, aData.size());
+            memcpy(&lTrailingLength, aData.data() + lIndex + lLength - 4, sizeof(lTrailingLength));
+            EXPECT_EQ(lLength, lTrailingLength);
+
+            lBlocks.emplace_back(Block{lType, aData.substr(lIndex + 8, lLength - 12)});
+            lIndex += lLength;
+        }
+
+        EXPECT_EQ(lIndex, aData.size());
+        return lBlocks;
+    }
+
+    static uint32_t GetWord(std::string_view aBody, std::size_t aIndex)
+    {
+        uint32_t lReturn{0};
+        memcpy(&lReturn, aBody.data() + aIndex, sizeof(lReturn));
+        return lReturn;
+    }
+
+    // Too big for the stack of a test
+    std::unique_ptr<FlightRecorder> mRecorder{std::make_unique<FlightRecorder>()};
+};
+
+TEST_F(FlightRecorderTest, WritesPcapNg)
+{
+    std::string lLongFrame(300, 'x');
+
+    mRecorder->Record(FlightRecorder::Interface::Air, FlightRecorder::Direction::Inbound, "first");
+    mRecorder->Record(FlightRecorder::Interface::XLinkKai, FlightRecorder::Direction::Outbound, lLongFrame);
+    mRecorder->Record(FlightRecorder::Interface::AirRadioTap, FlightRecorder::Direction::Outbound, "third");
+
+    std::stringstream lStream{};
+    ASSERT_TRUE(mRecorder->Write(lStream, "Test reason"));
+
+    std::vector<Block> lBlocks{ReadBlocks(lStream.str())};
+    ASSERT_EQ(lBlocks.size(), 1 + static_cast<std::size_t>(FlightRecorder::Interface::Count) + 3);
+
+    EXPECT_EQ(lBlocks.at(0).mType, cSectionHeaderBlock);
+    EXPECT_EQ(GetWord(lBlocks.at(0).mBody, 0), cByteOrderMagic);
+    EXPECT_NE(lBlocks.at(0).mBody.find("Test reason"), std::string::npos);
+
+    EXPECT_EQ(lBlocks.at(1).mType, cInterfaceDescriptionBlock);
+    EXPECT_EQ(GetWord(lBlocks.at(1).mBody, 0) & 0xFFFF, cLinkTypeEthernet);
+    EXPECT_EQ(GetWord(lBlocks.at(2).mBody, 0) & 0xFFFF, cLinkTypeRadioTap);
+    EXPECT_NE(lBlocks.at(3).mBody.find("XLink Kai"), std::string::npos);
+
+    // Interface, timestamp, captured length, original length and the data
+    const Block& lFirst{lBlocks.at(4)};
+    EXPECT_EQ(lFirst.mType, cEnhancedPacketBlock);
+    EXPECT_EQ(GetWord(lFirst.mBody, 0), static_cast<uint32_t>(FlightRecorder::Interface::Air));
+    EXPECT_EQ(GetWord(lFirst.mBody, 12), 5);
+    EXPECT_EQ(GetWord(lFirst.mBody, 16), 5);
+    EXPECT_EQ(lFirst.mBody.substr(20, 5), "first");
+
+    // Frames are cut off at the snap length, but keep their original length
+    const Block& lLong{lBlocks.at(5)};
+    EXPECT_EQ(GetWord(lLong.mBody, 0), static_cast<uint32_t>(FlightRecorder::Interface::XLinkKai));
+    EXPECT_EQ(GetWord(lLong.mBody, 12), cSnapLength);
+    EXPECT_EQ(GetWord(lLong.mBody, 16), lLongFrame.size());
+    EXPECT_EQ(lLong.mBody.substr(20, cSnapLength), lLongFrame.substr(0, cSnapLength));
+    // The direction flags follow the data
+    EXPECT_EQ(GetWord(lLong.mBody, 20 + cSnapLength), cOptionFlags | (4U << 16U));
+    EXPECT_EQ(GetWord(lLong.mBody, 24 + cSnapLength), 2);
+
+    EXPECT_EQ(lBlocks.at(6).mBody.substr(20, 5), "third");
+}
+
+TEST_F(FlightRecorderTest, KeepsLatestFrames)
+{
+    for (std::size_t lCount = 0; lCount < cSlots + 10; lCount++) {
+        mRecorder->Record(FlightRecorder::Interface::Air,
+                          FlightRecorder::Direction::Inbound,
+                          std::to_string(lCount) + "frame");
+    }
+
+    std::stringstream lStream{};
+    ASSERT_TRUE(mRecorder->Write(lStream, ""));
+
+    std::vector<Block> lBlocks{ReadBlocks(lStream.str())};
+    ASSERT_EQ(lBlocks.size(), 1 + static_cast<std::size_t>(FlightRecorder::Interface::Count) + cSlots);
+    EXPECT_EQ(lBlocks.at(4).mBody.substr(20, 7), "10frame");
+    EXPECT_EQ(lBlocks.back().mBody.substr(20, 9), std::to_string(cSlots + 9) + "frame");
+
+    // Nothing is left once the frames are old enough
+    std::stringstream lLaterStream{};
+    ASSERT_TRUE(mRecorder->Write(lLaterStream, "", FlightRecorder::Clock::now() + cWindow + seconds(1)));
+    EXPECT_EQ(ReadBlocks(lLaterStream.str()).size(), 1 + static_cast<std::size_t>(FlightRecorder::Interface::Count));
+}
+
+TEST_F(FlightRecorderTest, DumpsOncePerBurst)
+{
+    std::filesystem::path lDirectory{std::filesystem::temp_directory_path() / "FlightRecorderTest"};
+    std::filesystem::remove_all(lDirectory);
+    std::filesystem::create_directories(lDirectory);
+    mRecorder->SetDumpDirectory(lDirectory.string());
+
+    mRecorder->Record(FlightRecorder::Interface::Air, FlightRecorder::Direction::Inbound, "frame");
+    EXPECT_TRUE(mRecorder->Dump("First"));
+    EXPECT_FALSE(mRecorder->Dump("Second"));
+
+    std::size_t lFiles{0};
+    for (const auto& lEntry : std::filesystem::directory_iterator(lDirectory)) {
+        EXPECT_EQ(lEntry.path().extension(), cFileExtension);
+        lFiles++;
+    }
+    EXPECT_EQ(lFiles, 1);
+
+    std::filesystem::remove_all(lDirectory);
+}
+
+TEST_F(FlightRecorderTest, NothingSavedWithoutDirectory)
+{
+    mRecorder->Record(FlightRecorder::Interface::Air, FlightRecorder::Direction::Inbound, "frame");
+    EXPECT_FALSE(mRecorder->Dump("Nowhere to go"));
+}
+
+TEST_F(FlightRecorderTest, KeepsNewestDumps)
+{
+    std::filesystem::path lDirectory{std::filesystem::temp_directory_path() / "FlightRecorderTest"};
+    std::filesystem::remove_all(lDirectory);
+    std::filesystem::create_directories(lDirectory);
+    mRecorder->SetDumpDirectory(lDirectory.string());
+
+    // Dumps of earlier runs, and a file that only looks a bit like one
+    std::vector<std::filesystem::path> lOldDumps{};
+    for (std::size_t lCount = 0; lCount < cMaxDumps; lCount++) {
+        lOldDumps.emplace_back(lDirectory / (std::string(cFilePrefix) + "20000101-0000" +
+                                             (lCount < 10 ? "0" : "") + std::to_string(lCount) +
+                                             std::string(cFileExtension)));
+        std::ofstream{lOldDumps.back()};
+    }
+    std::ofstream{lDirectory / "notes.pcapng"};
+
+    EXPECT_TRUE(mRecorder->Dump("Newest"));
+
+    // The oldest dump made room for the new one
+    EXPECT_FALSE(std::filesystem::exists(lOldDumps.front()));
+    for (std::size_t lCount = 1; lCount < lOldDumps.size(); lCount++) {
+        EXPECT_TRUE(std::filesystem::exists(lOldDumps.at(lCount)));
+    }
+    EXPECT_TRUE(std::filesystem::exists(lDirectory / "notes.pcapng"));
+
+    std::size_t lFiles{0};
+    for ([[maybe_unused]] const auto& lEntry : std::filesystem::directory_iterator(lDirectory)) {
+        lFiles++;
+    }
+    EXPECT_EQ(lFiles, cMaxDumps + 1);
+
+    std::filesystem::remove_all(lDirectory);
+}
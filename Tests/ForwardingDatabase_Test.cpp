@@ -0,0 +1,99 @@
+/* Copyright (c) 2022 [Rick de Bondt] - ForwardingDatabase_Test.cpp
+ * This file contains tests for the ForwardingDatabase class.
+ **/
+
+#include "ForwardingDatabase.h"
+
+#include <tuple>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "NetworkingHeaders.h"
+
+using namespace std::chrono;
+using Side = ForwardingDatabase::Side;
+
+class ForwardingDatabaseTest : public ::testing::Test
+{
+public:
+    ForwardingDatabase::Clock::time_point mStart{ForwardingDatabase::Clock::now()};
+    ForwardingDatabase                    mDatabase{seconds(10)};
+};
+
+TEST_F(ForwardingDatabaseTest, LearnsAndCounts)
+{
+    EXPECT_FALSE(mDatabase.Find(0x050403020100, mStart).has_value());
+
+    EXPECT_TRUE(mDatabase.Learn(0x050403020100, Side::Local, nullptr, 100, mStart));
+    EXPECT_TRUE(mDatabase.Learn(0x050403020100, Side::Local, nullptr, 50, mStart + seconds(1)));
+
+    std::optional<ForwardingDatabase::Entry> lEntry{mDatabase.Find(0x050403020100, mStart + seconds(1))};
+    ASSERT_TRUE(lEntry.has_value());
+    EXPECT_EQ(lEntry->mSide, Side::Local);
+    EXPECT_EQ(lEntry->mLastSeen, mStart + seconds(1));
+    EXPECT_EQ(lEntry->mPackets, 2);
+    EXPECT_EQ(lEntry->mBytes, 150);
+
+    // Group addresses are not something that can send data
+    EXPECT_TRUE(mDatabase.Learn(Net_Constants::cBroadcastMac, Side::Remote, nullptr, 100, mStart));
+    EXPECT_FALSE(mDatabase.Find(Net_Constants::cBroadcastMac, mStart).has_value());
+    EXPECT_EQ(mDatabase.GetSize(), 1);
+}
+
+TEST_F(ForwardingDatabaseTest, RefusesOtherSideUntilAged)
+{
+    EXPECT_TRUE(mDatabase.Learn(0x050403020100, Side::Remote, nullptr, 100, mStart));
+
+    // Looped around, the entry stays what it was
+    EXPECT_FALSE(mDatabase.Learn(0x050403020100, Side::Local, nullptr, 100, mStart + seconds(5)));
+    EXPECT_EQ(mDatabase.Find(0x050403020100, mStart + seconds(5))->mSide, Side::Remote);
+
+    // Once it has been silent long enough it may show up on the other side
+    EXPECT_FALSE(mDatabase.Find(0x050403020100, mStart + seconds(10)).has_value());
+    EXPECT_TRUE(mDatabase.Learn(0x050403020100, Side::Local, nullptr, 100, mStart + seconds(10)));
+    EXPECT_EQ(mDatabase.Find(0x050403020100, mStart + seconds(10))->mPackets, 1);
+}
+
+TEST_F(ForwardingDatabaseTest, StaysBounded)
+{
+    for (uint64_t lMac = 0; lMac < ForwardingDatabase_Constants::cMaxEntries + 10; lMac++) {
+        mDatabase.Learn(lMac << 8, Side::Remote, nullptr, 100, mStart + milliseconds(lMac));
+    }
+
+    // The first ones to be learned went first
+    EXPECT_EQ(mDatabase.GetSize(), ForwardingDatabase_Constants::cMaxEntries);
+    EXPECT_FALSE(mDatabase.Find(0, mStart + seconds(2)).has_value());
+    EXPECT_TRUE(mDatabase.Find(uint64_t{10} << 8, mStart + seconds(2)).has_value());
+
+    // Aged out ones are swept out as soon as something new is learned after the aging time
+    mDatabase.Learn(0x050403020100, Side::Remote, nullptr, 100, mStart + seconds(30));
+    EXPECT_EQ(mDatabase.GetSize(), 1);
+}
+
+TEST_F(ForwardingDatabaseTest, ReportsChanges)
+{
+    std::vector<std::tuple<uint64_t, Side, bool>> lChanges{};
+    mDatabase.SetChangeHandler([&lChanges](uint64_t aMac, Side aSide, bool aKnown) {
+        lChanges.emplace_back(aMac, aSide, aKnown);
+    });
+
+    // Only new Mac addresses are reported
+    mDatabase.Learn(0x050403020100, Side::Remote, nullptr, 100, mStart);
+    mDatabase.Learn(0x050403020100, Side::Remote, nullptr, 100, mStart + seconds(1));
+    mDatabase.Learn(0x0F0E0D0C0B0A, Side::Local, nullptr, 100, mStart + seconds(5));
+    ASSERT_EQ(lChanges.size(), 2);
+    EXPECT_EQ(lChanges.at(0), std::make_tuple(uint64_t{0x050403020100}, Side::Remote, true));
+    EXPECT_EQ(lChanges.at(1), std::make_tuple(uint64_t{0x0F0E0D0C0B0A}, Side::Local, true));
+
+    // Aging out and clearing are reported as well
+    lChanges.clear();
+    mDatabase.Learn(0x0F0E0D0C0B0A, Side::Local, nullptr, 100, mStart + seconds(11));
+    ASSERT_EQ(lChanges.size(), 1);
+    EXPECT_EQ(lChanges.at(0), std::make_tuple(uint64_t{0x050403020100}, Side::Remote, false));
+
+    lChanges.clear();
+    mDatabase.Clear();
+    ASSERT_EQ(lChanges.size(), 1);
+    EXPECT_EQ(lChanges.at(0), std::make_tuple(uint64_t{0x0F0E0D0C0B0A}, Side::Local, false));
+}
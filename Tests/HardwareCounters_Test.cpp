@@ -0,0 +1,59 @@
+/* Copyright (c) 2022 [Rick de Bondt] - HardwareCounters_Test.cpp
+ * This file contains tests for the HardwareCounters class.
+ **/
+
+#include "HardwareCounters.h"
+
+#include <gtest/gtest.h>
+
+using namespace HardwareCounters_Constants;
+
+class HardwareCountersTest : public ::testing::Test
+{
+public:
+    void TearDown() override
+    {
+        HardwareCounters::SetEnabled(false);
+    }
+
+    // Something to measure that the compiler cannot leave out
+    static uint64_t DoWork()
+    {
+        volatile uint64_t lSum{0};
+        for (uint64_t lCount = 0; lCount < 10000; lCount++) {
+            lSum = lSum + lCount;
+        }
+        return lSum;
+    }
+
+    HardwareCounters mCounters{};
+};
+
+TEST_F(HardwareCountersTest, NothingMeasuredWhenDisabled)
+{
+    {
+        HardwareCounters::Measurement lMeasurement{mCounters};
+        DoWork();
+    }
+
+    Statistics lStatistics{mCounters.GetStatistics()};
+    EXPECT_EQ(lStatistics.Packets, 0);
+    EXPECT_EQ(lStatistics.GetPerPacket(Counter::Cycles), 0);
+}
+
+TEST_F(HardwareCountersTest, MeasuresPackets)
+{
+    HardwareCounters::SetEnabled(true);
+    if (!HardwareCounters::IsAvailable()) {
+        GTEST_SKIP() << "Hardware counters cannot be opened on this machine";
+    }
+
+    for (int lPacket = 0; lPacket < 2; lPacket++) {
+        HardwareCounters::Measurement lMeasurement{mCounters};
+        DoWork();
+    }
+
+    Statistics lStatistics{mCounters.GetStatistics()};
+    EXPECT_EQ(lStatistics.Packets, 2);
+    EXPECT_GT(lStatistics.GetPerPacket(Counter::Cycles), 0);
+}
@@ -0,0 +1,129 @@
+/* Copyright (c) 2022 [Rick de Bondt] - IOUringLinux_Test.cpp
+ * This file contains tests for the io_uring based I/O, using sockets on the loopback interface. Skipped when the
+ * kernel does not support io_uring.
+ **/
+
+#if defined(ENABLE_IO_URING)
+#include "IOUringLinux.h"
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "IOUringUDPSocketWrapperLinux.h"
+
+using namespace std::chrono;
+
+namespace
+{
+    class RecordingHandler : public IUDPReceiveHandler
+    {
+    public:
+        void HandleDatagram(std::string_view aData) override
+        {
+            mDatagrams.emplace_back(aData);
+        }
+
+        std::vector<std::string> mDatagrams{};
+    };
+}  // namespace
+
+class IOUringTest : public ::testing::Test
+{
+public:
+    void SetUp() override
+    {
+        if (!IOUring::IsSupported({IORING_OP_RECVMSG, IORING_OP_WRITE})) {
+            GTEST_SKIP() << "io_uring is not supported";
+        }
+
+        mPeer.open(boost::asio::ip::udp::v4());
+        mPeer.bind(boost::asio::ip::udp::endpoint(boost::asio::ip::address_v4::loopback(), 0));
+        ASSERT_TRUE(mWrapper.Open("127.0.0.1", mPeer.local_endpoint().port()));
+    }
+
+    void TearDown() override
+    {
+        mWrapper.Close();
+        mPeer.close();
+    }
+
+    IOUringUDPSocketWrapper        mWrapper{};
+    boost::asio::io_service        mPeerService{};
+    boost::asio::ip::udp::socket   mPeer{mPeerService};
+    boost::asio::ip::udp::endpoint mWrapperEndpoint{};
+};
+
+// Everything sent while the kernel is busy should still arrive, in order
+TEST_F(IOUringTest, SendsThroughRing)
+{
+    ASSERT_TRUE(mWrapper.IsSendingThroughRing());
+
+    std::vector<std::string> lSent{};
+    for (int lCount = 0; lCount < 200; lCount++) {
+        lSent.emplace_back("e;e;" + std::to_string(lCount));
+        ASSERT_EQ(mWrapper.SendTo(lSent.back()), lSent.back().size());
+    }
+
+    std::vector<std::string> lReceived{};
+    std::array<char, 64>     lBuffer{};
+    while (lReceived.size() < lSent.size()) {
+        std::size_t lSize{mPeer.receive_from(boost::asio::buffer(lBuffer), mWrapperEndpoint)};
+        lReceived.emplace_back(lBuffer.data(), lSize);
+    }
+
+    EXPECT_EQ(lReceived, lSent);
+}
+
+// Sends the kernel refuses have to come back as failures, even though they complete after Send returned
+TEST_F(IOUringTest, ReportsFailedSends)
+{
+    // Not connected, so every write fails
+    boost::asio::ip::udp::socket lUnconnected{mPeerService, boost::asio::ip::udp::v4()};
+    IOUringSender                lSender{};
+    ASSERT_TRUE(lSender.Open(lUnconnected.native_handle()));
+
+    bool lFailed{false};
+    for (unsigned int lCount = 0; lCount < IOUring_Constants::cSendSlots * 4 && !lFailed; lCount++) {
+        lFailed = (lSender.Send("e;e;" + std::to_string(lCount)) == IOUring_Constants::SendResult::Failed);
+    }
+
+    EXPECT_TRUE(lFailed);
+    lSender.Close();
+}
+
+// A single multishot receive keeps handing out datagrams, also after the buffers have been used more than once
+TEST_F(IOUringTest, ReceivesThroughRing)
+{
+    // Let the peer learn the port of the wrapper
+    mWrapper.SendTo("hello");
+    std::array<char, 16> lBuffer{};
+    mPeer.receive_from(boost::asio::buffer(lBuffer), mWrapperEndpoint);
+
+    RecordingHandler         lHandler{};
+    std::vector<std::string> lExpected{};
+    for (unsigned int lCount = 0; lCount < IOUringUDPSocketWrapper_Constants::cReceiveBuffers * 3; lCount++) {
+        lExpected.emplace_back("e;e;" + std::to_string(lCount));
+    }
+
+    std::size_t              lSent{0};
+    steady_clock::time_point lEnd{steady_clock::now() + seconds(2)};
+    while (lHandler.mDatagrams.size() < lExpected.size() && steady_clock::now() < lEnd) {
+        // Send in small bursts, so the buffers get handed back in between
+        for (int lBurst = 0; lBurst < 8 && lSent < lExpected.size(); lBurst++, lSent++) {
+            mPeer.send_to(boost::asio::buffer(lExpected.at(lSent)), mWrapperEndpoint);
+        }
+
+        mWrapper.StartThread();
+        mWrapper.AsyncReceiveFrom(lHandler);
+        std::this_thread::sleep_for(milliseconds(1));
+        mWrapper.PollThread();
+    }
+
+    EXPECT_TRUE(mWrapper.IsReceivingThroughRing());
+    EXPECT_EQ(lHandler.mDatagrams, lExpected);
+}
+#endif
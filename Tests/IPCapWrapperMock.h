@@ -30,4 +30,5 @@ public:
     MOCK_METHOD(int, SetPromiscuousMode, (int promiscuous));
     MOCK_METHOD(int, SetSnapLen, (int snaplen));
     MOCK_METHOD(int, SetTimeOut, (int timeout));
+    MOCK_METHOD(bool, WaitsForPackets, ());
 };
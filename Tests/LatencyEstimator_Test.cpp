@@ -0,0 +1,50 @@
+/* Copyright (c) 2022 [Rick de Bondt] - LatencyEstimator_Test.cpp
+ * This file contains tests for the LatencyEstimator class.
+ **/
+
+#include "LatencyEstimator.h"
+
+#include <gtest/gtest.h>
+
+using namespace std::chrono;
+
+class LatencyEstimatorTest : public ::testing::Test
+{};
+
+TEST_F(LatencyEstimatorTest, FirstSample)
+{
+    LatencyEstimator lEstimator{};
+    EXPECT_FALSE(lEstimator.HasSamples());
+    EXPECT_EQ(lEstimator.GetUpperBound(), microseconds(0));
+
+    lEstimator.AddSample(microseconds(800));
+
+    // The first sample is taken as is, with half of it as variation
+    EXPECT_TRUE(lEstimator.HasSamples());
+    EXPECT_EQ(lEstimator.GetSmoothed(), microseconds(800));
+    EXPECT_EQ(lEstimator.GetVariation(), microseconds(400));
+    EXPECT_EQ(lEstimator.GetUpperBound(), microseconds(2400));
+}
+
+TEST_F(LatencyEstimatorTest, SmoothsOutliers)
+{
+    LatencyEstimator lEstimator{};
+    lEstimator.AddSample(microseconds(1000));
+    lEstimator.AddSample(microseconds(9000));
+
+    // The smoothed value moves an eighth of the way, the variation a quarter
+    EXPECT_EQ(lEstimator.GetSmoothed(), microseconds(2000));
+    EXPECT_EQ(lEstimator.GetVariation(), microseconds(2375));
+
+    // A steady stream of samples makes the jitter die out
+    for (int lCount = 0; lCount < 100; lCount++) {
+        lEstimator.AddSample(microseconds(1000));
+    }
+
+    EXPECT_EQ(lEstimator.GetSmoothed(), microseconds(1007));
+    EXPECT_LE(lEstimator.GetVariation(), microseconds(10));
+
+    lEstimator.Reset();
+    EXPECT_FALSE(lEstimator.HasSamples());
+    EXPECT_EQ(lEstimator.GetSmoothed(), microseconds(0));
+}
@@ -0,0 +1,95 @@
+/* Copyright (c) 2022 [Rick de Bondt] - PCapReplayer_Test.cpp
+ * This file contains tests for the PCapReplayer class.
+ **/
+
+#include "PCapReplayer.h"
+
+#include <mutex>
+#include <set>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "IConnectorMock.h"
+#include "NetConversionFunctions.h"
+
+using ::testing::_;
+using ::testing::DoAll;
+using ::testing::Return;
+using ::testing::WithArg;
+
+class PCapReplayerTest : public ::testing::Test
+{};
+
+// Tests that every stream and loop gets replayed and every stream uses its own Mac addresses
+TEST_F(PCapReplayerTest, ReplayStreamsAtMaxSpeed)
+{
+    auto         lConnectorMock{std::make_shared<IConnectorMock>()};
+    PCapReplayer lReplayer{};
+
+    std::mutex         lMutex{};
+    std::set<uint64_t> lSourceMacs{};
+    uint64_t           lPacketCount{0};
+
+    EXPECT_CALL(*lConnectorMock, Send(_))
+        .WillRepeatedly(DoAll(WithArg<0>([&](std::string_view aMessage) {
+                                  std::scoped_lock lLock{lMutex};
+                                  lSourceMacs.insert(GetRawData<uint64_t>(aMessage,
+                                                                          Net_8023_Constants::cSourceAddressIndex) &
+                                                     Net_Constants::cBroadcastMac);
+                                  lPacketCount++;
+                              }),
+                              Return(true)));
+
+    ASSERT_TRUE(lReplayer.Open("../Tests/Input/PromiscuousTestDevice.pcap"));
+    lReplayer.SetConnector(lConnectorMock);
+
+    PCapReplayer_Constants::ReplaySettings lSettings{};
+    lSettings.SpeedMultiplier = PCapReplayer_Constants::cMaxSpeed;
+    lSettings.Loops           = 2;
+    lSettings.Streams         = 4;
+
+    ASSERT_TRUE(lReplayer.Start(lSettings));
+
+    while (!lReplayer.IsDone()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    lReplayer.Stop();
+
+    PCapReplayer_Constants::ReplayStatistics lStatistics{lReplayer.GetStatistics()};
+    ASSERT_GT(lPacketCount, 0U);
+    EXPECT_EQ(lStatistics.Packets, lPacketCount);
+    EXPECT_EQ(lPacketCount % (lSettings.Loops * lSettings.Streams), 0U);
+    EXPECT_GT(lStatistics.PacketsPerSecond, 0);
+
+    // Every stream should show up with its own set of source Mac addresses
+    EXPECT_EQ(lSourceMacs.size() % lSettings.Streams, 0U);
+    EXPECT_GE(lSourceMacs.size(), lSettings.Streams);
+}
+
+// Tests that group addresses are left alone and unicast addresses get the stream mixed in
+TEST_F(PCapReplayerTest, RewriteMacAddresses)
+{
+    const std::string lOriginal{"\xFF\xFF\xFF\xFF\xFF\xFF\x00\x01\x02\x03\x04\x05\x88\xC8", 14};
+    std::string       lPacket{lOriginal};
+
+    PCapReplayer::RewriteMacAddresses(lPacket, 0);
+    EXPECT_EQ(lPacket, lOriginal);
+
+    PCapReplayer::RewriteMacAddresses(lPacket, 2);
+    EXPECT_EQ(lPacket, std::string("\xFF\xFF\xFF\xFF\xFF\xFF\x00\x01\x02\x01\x04\x05\x88\xC8", 14));
+}
+
+// Streams beyond what one byte of the Mac address can tell apart are refused
+TEST_F(PCapReplayerTest, RefuseTooManyStreams)
+{
+    PCapReplayer lReplayer{};
+    ASSERT_TRUE(lReplayer.Open("../Tests/Input/PromiscuousTestDevice.pcap"));
+    lReplayer.SetConnector(std::make_shared<IConnectorMock>());
+
+    PCapReplayer_Constants::ReplaySettings lSettings{};
+    lSettings.Streams = PCapReplayer_Constants::cMaxStreams + 1;
+    EXPECT_FALSE(lReplayer.Start(lSettings));
+    EXPECT_TRUE(lReplayer.IsDone());
+}
@@ -107,6 +107,32 @@ TEST_F(PacketHandlingTest, MonitorToPromiscuous)
     lPCapExpectedReader.Close();
 }
 
+// Handing packets to the connector should not touch the reference count shared by every receiver thread
+TEST_F(PacketHandlingTest, ConnectorNotCopiedPerPacket)
+{
+    std::shared_ptr<IConnectorMock> lConnector{std::make_shared<IConnectorMock>()};
+    PCapReader                      lPCapReader{true, false, false};
+
+    std::vector<std::string> lSSIDFilter{"T#STNET"};
+    lPCapReader.Open("../Tests/Input/MonitorHelloWorld.pcapng", lSSIDFilter);
+    lPCapReader.SetConnector(lConnector);
+
+    // Held by this test and by the reader
+    std::vector<long> lUseCounts{};
+    EXPECT_CALL(*lConnector, Send(_))
+        .WillRepeatedly(DoAll(WithArg<0>([&](std::string_view /*aMessage*/) {
+                                  lUseCounts.push_back(lConnector.use_count());
+                              }),
+                              Return(true)));
+
+    lPCapReader.StartReceiverThread();
+    while (!lPCapReader.IsDoneReceiving()) {}
+    lPCapReader.Close();
+
+    ASSERT_FALSE(lUseCounts.empty());
+    EXPECT_EQ(lUseCounts, std::vector<long>(lUseCounts.size(), 2));
+}
+
 TEST_F(PacketHandlingTest, PromiscuousToMonitor)
 {
     std::shared_ptr<PCapReader>      lConnector{std::make_shared<PCapReader>(true, true, false)};
@@ -293,3 +319,73 @@ TEST_F(PacketHandlingTest, ConstructAcknowledgementFrame)
     lPCapReader.Close();
     lPCapExpectedReader.Close();
 }
+
+// Tests that remembered beacons are classified again after the SSID filter changes
+TEST_F(PacketHandlingTest, BeaconCacheFollowsSSIDFilter)
+{
+    PCapWrapper                        lWrapper;
+    std::array<char, PCAP_ERRBUF_SIZE> lErrorBuffer{};
+    std::vector<std::string>           lPackets{};
+
+    lWrapper.OpenOffline("../Tests/Input/MonitorHelloWorld.pcapng", lErrorBuffer.data());
+    ASSERT_TRUE(lWrapper.IsActivated());
+
+    pcap_pkthdr*         lHeader{nullptr};
+    const unsigned char* lData{nullptr};
+    while (lWrapper.NextEx(&lHeader, &lData) >= 0) {
+        lPackets.emplace_back(reinterpret_cast<const char*>(lData), lHeader->caplen);
+    }
+    lWrapper.Close();
+
+    std::vector<std::string> lSSIDFilter{"NotAnExistingNetwork"};
+    mHandler80211.SetSSIDFilterList(lSSIDFilter);
+
+    // Feed every packet twice so the second round is served from the cache
+    for (int lRound = 0; lRound < 2; lRound++) {
+        for (const auto& lPacket : lPackets) {
+            mHandler80211.Update(lPacket);
+        }
+    }
+    EXPECT_EQ(mHandler80211.GetLockedBSSID(), 0U);
+
+    lSSIDFilter = {"T#STNET"};
+    mHandler80211.SetSSIDFilterList(lSSIDFilter);
+
+    for (const auto& lPacket : lPackets) {
+        mHandler80211.Update(lPacket);
+    }
+    EXPECT_NE(mHandler80211.GetLockedBSSID(), 0U);
+    EXPECT_NE(mHandler80211.GetLockedSSID().find("T#STNET"), std::string::npos);
+}
+
+// Tests that the frame control table classifies the frames the handler cares about
+TEST_F(PacketHandlingTest, FrameClassificationTable)
+{
+    using Handler80211_Constants::cFrameClassificationTable;
+
+    const auto& lBeacon{cFrameClassificationTable.at(Net_80211_Constants::cBeaconType)};
+    EXPECT_EQ(lBeacon.MainType, Main80211PacketType::Management);
+    EXPECT_EQ(lBeacon.ManagementType, Management80211PacketType::Beacon);
+    EXPECT_EQ(lBeacon.HeaderLength, Net_80211_Constants::c80211DataHeaderLength);
+
+    const auto& lData{cFrameClassificationTable.at(Net_80211_Constants::cDataType)};
+    EXPECT_EQ(lData.MainType, Main80211PacketType::Data);
+    EXPECT_EQ(lData.DataType, Data80211PacketType::Data);
+    EXPECT_FALSE(lData.QoS);
+
+    const auto& lQoSData{cFrameClassificationTable.at(Net_80211_Constants::cDataQOSType)};
+    EXPECT_EQ(lQoSData.DataType, Data80211PacketType::QoSData);
+    EXPECT_TRUE(lQoSData.QoS);
+    EXPECT_EQ(lQoSData.HeaderLength, Net_80211_Constants::c80211DataHeaderLength + Net_80211_Constants::cDataQOSLength);
+
+    const auto& lNull{cFrameClassificationTable.at(Net_80211_Constants::cDataNullFuncType)};
+    EXPECT_EQ(lNull.DataType, Data80211PacketType::Null);
+
+    const auto& lAcknowledgement{cFrameClassificationTable.at(Net_80211_Constants::cAcknowledgementType)};
+    EXPECT_EQ(lAcknowledgement.MainType, Main80211PacketType::Control);
+    EXPECT_EQ(lAcknowledgement.ControlType, Control80211PacketType::ACK);
+    EXPECT_EQ(lAcknowledgement.HeaderLength, Net_80211_Constants::cControlShortHeaderLength);
+
+    // Extension frames are ignored
+    EXPECT_EQ(cFrameClassificationTable.at(0x0c).MainType, Main80211PacketType::None);
+}
@@ -2,6 +2,10 @@
  * This file contains tests for the WirelessPromiscuousDevice class.
  **/
 
+#include <atomic>
+#include <future>
+#include <thread>
+
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
@@ -10,11 +14,15 @@
 #include "IWifiInterfaceMock.h"
 #include "NetConversionFunctions.h"
 #include "PCapReader.h"
+#include "TimerService.h"
 #include "WirelessPromiscuousDevice.h"
 
+using namespace std::chrono;
+
 using ::testing::_;
 using ::testing::DoAll;
 using ::testing::Return;
+using ::testing::ReturnRef;
 using ::testing::WithArg;
 
 class PromiscuousPacketHandlingTest : public ::testing::Test
@@ -518,3 +526,100 @@ TEST_F(PromiscuousPacketHandlingTest, NormalPacketHandlingDeviceSide)
     lPCapExpectedReader.Close();
     lPromiscuousDevice.Close();
 }
+
+// An ARP request from XLink Kai on DDS gets its sender replaced by the adapter Mac, the answer from the ARP proxy
+// should still go back to the original sender.
+TEST_F(PromiscuousPacketHandlingTest, ArpProxyAnswersOriginalSenderOnDDS)
+{
+    std::shared_ptr<IWifiInterface> lWifiInterface{std::make_shared<IWifiInterfaceMock>()};
+    std::shared_ptr<IConnector>     lOutputConnector{std::make_shared<IConnectorMock>()};
+    std::vector<std::string>        lSSIDFilter{""};
+    auto                            lPCapWrapperMock{std::make_shared<::testing::NiceMock<IPCapWrapperMock>>()};
+    WirelessPromiscuousDevice       lPromiscuousDevice{false,
+                                                 WirelessPromiscuousBase_Constants::cReconnectionTimeOut,
+                                                 nullptr,
+                                                 std::make_shared<Handler8023>(),
+                                                 std::static_pointer_cast<IPCapWrapper>(lPCapWrapperMock)};
+
+    const std::string cLocalMac{"\x00\x01\x02\x03\x04\x05", 6};
+    const std::string cLocalIp{"\x0A\x00\x00\x01", 4};
+    const std::string cRemoteIp{"\x0A\x00\x00\x02", 4};
+    const std::string cVRRPMac{"\x00\x00\x5E\x00\x01\xFE", 6};
+    const std::string cBroadcastMac{"\xFF\xFF\xFF\xFF\xFF\xFF", 6};
+    const std::string cNoMac{"\x00\x00\x00\x00\x00\x00", 6};
+    const std::string cArpHeader{"\x08\x06\x00\x01\x08\x00\x06\x04\x00", 9};
+
+    std::vector<std::string> lOutputPackets{};
+
+    EXPECT_CALL(*std::static_pointer_cast<IWifiInterfaceMock>(lWifiInterface), GetAdapterMacAddress)
+        .WillOnce(Return(0xb03f29f81800));
+    ON_CALL(*lPCapWrapperMock, IsActivated()).WillByDefault(Return(true));
+    EXPECT_CALL(*lPCapWrapperMock, SendPacket(_)).Times(0);
+    EXPECT_CALL(*std::static_pointer_cast<IConnectorMock>(lOutputConnector), Send(_))
+        .WillRepeatedly(
+            DoAll(WithArg<0>([&](std::string_view aMessage) { lOutputPackets.emplace_back(std::string(aMessage)); }),
+                  Return(true)));
+
+    lPromiscuousDevice.SetConnector(lOutputConnector);
+    lPromiscuousDevice.Open("wlan0", lSSIDFilter, lWifiInterface);
+    lPromiscuousDevice.SetArpProxy(false, true);
+
+    // Teach the proxy about the handheld on the air with a gratuitous ARP
+    std::string lAnnouncement{cBroadcastMac + cLocalMac + cArpHeader + "\x01" + cLocalMac + cLocalIp + cNoMac +
+                              cLocalIp};
+    pcap_pkthdr lHeader{};
+    lHeader.caplen = lAnnouncement.size();
+    lHeader.len    = lAnnouncement.size();
+    lPromiscuousDevice.ReadCallback(reinterpret_cast<const unsigned char*>(lAnnouncement.data()), &lHeader);
+    ASSERT_EQ(lOutputPackets.size(), 1);
+
+    std::string lRequest{cBroadcastMac + cVRRPMac + cArpHeader + "\x01" + cVRRPMac + cRemoteIp + cNoMac + cLocalIp};
+    EXPECT_TRUE(lPromiscuousDevice.Send(lRequest));
+
+    std::string lExpected{cVRRPMac + cLocalMac + cArpHeader + "\x02" + cLocalMac + cLocalIp + cVRRPMac + cRemoteIp};
+    ASSERT_EQ(lOutputPackets.size(), 2);
+    EXPECT_EQ(lOutputPackets.at(1), lExpected);
+
+    lPromiscuousDevice.Close();
+}
+
+// Scanning for networks can take seconds, the reconnect after a read timeout should not hold up the other timers
+TEST_F(PromiscuousPacketHandlingTest, ReconnectDoesNotBlockTimers)
+{
+    std::shared_ptr<IWifiInterface> lWifiInterface{std::make_shared<::testing::NiceMock<IWifiInterfaceMock>>()};
+    std::vector<std::string>        lSSIDFilter{""};
+    auto                            lPCapWrapperMock{std::make_shared<::testing::NiceMock<IPCapWrapperMock>>()};
+    WirelessPromiscuousDevice       lPromiscuousDevice{true,
+                                                 seconds(1),
+                                                 nullptr,
+                                                 std::make_shared<Handler8023>(),
+                                                 std::static_pointer_cast<IPCapWrapper>(lPCapWrapperMock)};
+
+    std::vector<IWifiInterface::WifiInformation> lNetworks{};
+    std::atomic<int>                             lScans{0};
+
+    // The first scan is done by Open itself, the second one by the reconnect
+    ON_CALL(*std::static_pointer_cast<IWifiInterfaceMock>(lWifiInterface), GetAdhocNetworks)
+        .WillByDefault(DoAll([&] {
+                                 if (++lScans > 1) {
+                                     std::this_thread::sleep_for(2s);
+                                 }
+                             },
+                             ReturnRef(lNetworks)));
+    ON_CALL(*lPCapWrapperMock, IsActivated()).WillByDefault(Return(true));
+
+    ASSERT_TRUE(lPromiscuousDevice.Open("wlan0", lSSIDFilter, lWifiInterface));
+    ASSERT_TRUE(lPromiscuousDevice.StartReceiverThread());
+
+    auto lDeadline{steady_clock::now() + 5s};
+    while (lScans < 2 && steady_clock::now() < lDeadline) {
+        std::this_thread::sleep_for(10ms);
+    }
+    ASSERT_EQ(lScans, 2);
+
+    std::promise<void> lFired{};
+    TimerService::GetInstance().Schedule(0ms, [&] { lFired.set_value(); });
+    EXPECT_EQ(lFired.get_future().wait_for(500ms), std::future_status::ready);
+
+    lPromiscuousDevice.Close();
+}
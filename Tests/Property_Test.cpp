@@ -0,0 +1,70 @@
+/* Copyright (c) 2022 [Rick de Bondt] - Property_Test.cpp
+ * This file contains tests for the Property class.
+ **/
+
+#include "Property.h"
+
+#include <string>
+
+#include <gtest/gtest.h>
+
+class PropertyTest : public ::testing::Test
+{};
+
+TEST_F(PropertyTest, SetNotifiesOnChange)
+{
+    Property<std::string>    lProperty{"Initial"};
+    std::vector<std::string> lNotifications{};
+
+    Subscription lSubscription{
+        lProperty.Subscribe([&](const std::string& aValue) { lNotifications.emplace_back(aValue); })};
+
+    EXPECT_EQ(lProperty.Get(), "Initial");
+    EXPECT_TRUE(lProperty.Set("PSP_AULES00000_L_Test"));
+
+    // Setting the same value again is not a change
+    EXPECT_FALSE(lProperty.Set("PSP_AULES00000_L_Test"));
+    EXPECT_TRUE(lProperty.Set(""));
+
+    ASSERT_EQ(lNotifications.size(), 2);
+    EXPECT_EQ(lNotifications.at(0), "PSP_AULES00000_L_Test");
+    EXPECT_EQ(lNotifications.at(1), "");
+    EXPECT_EQ(lProperty.Get(), "");
+}
+
+TEST_F(PropertyTest, SubscriptionEndsWithScope)
+{
+    Property<int> lProperty{0};
+    int           lNotifications{0};
+
+    {
+        Subscription lSubscription{lProperty.Subscribe([&](const int& /*aValue*/) { lNotifications++; })};
+        lProperty.Set(1);
+    }
+    lProperty.Set(2);
+
+    Subscription lSubscription{lProperty.Subscribe([&](const int& /*aValue*/) { lNotifications++; })};
+    lProperty.Set(3);
+    lSubscription.Reset();
+    lProperty.Set(4);
+
+    EXPECT_EQ(lNotifications, 2);
+    EXPECT_EQ(lProperty.Get(), 4);
+}
+
+TEST_F(PropertyTest, CallbackCanUnsubscribeItself)
+{
+    Property<int> lProperty{0};
+    int           lNotifications{0};
+    Subscription  lSubscription{};
+
+    lSubscription = lProperty.Subscribe([&](const int& /*aValue*/) {
+        lNotifications++;
+        lSubscription.Reset();
+    });
+
+    lProperty.Set(1);
+    lProperty.Set(2);
+
+    EXPECT_EQ(lNotifications, 1);
+}
@@ -0,0 +1,79 @@
+/* Copyright (c) 2022 [Rick de Bondt] - SSIDMatcher_Test.cpp
+ * This file contains tests for the SSIDMatcher class.
+ **/
+
+#include "SSIDMatcher.h"
+
+#include <random>
+
+#include <gtest/gtest.h>
+
+class SSIDMatcherTest : public ::testing::Test
+{};
+
+TEST_F(SSIDMatcherTest, NoFilters)
+{
+    SSIDMatcher lMatcher{std::vector<std::string>{}};
+
+    EXPECT_TRUE(lMatcher.IsEmpty());
+    EXPECT_FALSE(lMatcher.Matches("PSP_AULES00000_L_Test"));
+    EXPECT_FALSE(lMatcher.Matches(""));
+}
+
+TEST_F(SSIDMatcherTest, PSPAndVitaFilters)
+{
+    SSIDMatcher lMatcher{std::vector<std::string>{"PSP_", "SCE_"}};
+
+    EXPECT_FALSE(lMatcher.IsEmpty());
+    EXPECT_TRUE(lMatcher.Matches("PSP_AULES00000_L_Test"));
+    EXPECT_TRUE(lMatcher.Matches("SCE_PCSB00000_Test"));
+    EXPECT_TRUE(lMatcher.Matches("xxPSP_"));
+    EXPECT_FALSE(lMatcher.Matches("PSP"));
+    EXPECT_FALSE(lMatcher.Matches("PSSCEP_"));
+    EXPECT_FALSE(lMatcher.Matches("HomeNetwork"));
+}
+
+// Filters that are part of each other only match through the failure links
+TEST_F(SSIDMatcherTest, OverlappingFilters)
+{
+    SSIDMatcher lMatcher{std::vector<std::string>{"he", "she", "his", "hers"}};
+
+    EXPECT_TRUE(lMatcher.Matches("ushers"));
+    EXPECT_TRUE(lMatcher.Matches("xhix his"));
+    EXPECT_TRUE(lMatcher.Matches("sh_he"));
+    EXPECT_FALSE(lMatcher.Matches("shx hi"));
+}
+
+TEST_F(SSIDMatcherTest, EmptyFilterMatchesEverything)
+{
+    SSIDMatcher lMatcher{std::vector<std::string>{"PSP_", ""}};
+
+    EXPECT_TRUE(lMatcher.Matches(""));
+    EXPECT_TRUE(lMatcher.Matches("HomeNetwork"));
+}
+
+// Compares the matcher against std::string::find on random SSIDs from a tiny alphabet, so there is lots of overlap
+TEST_F(SSIDMatcherTest, SameResultAsFind)
+{
+    const std::vector<std::string> lFilters{"abab", "bac", "cc", "abc", "b\xFF"};
+    SSIDMatcher                    lMatcher{lFilters};
+
+    std::mt19937                       lGenerator{1234};
+    std::uniform_int_distribution<int> lLength{0, 32};
+    std::uniform_int_distribution<int> lCharacter{0, 3};
+    const std::string                  lAlphabet{"abc\xFF"};
+
+    for (int lCount = 0; lCount < 10000; lCount++) {
+        std::string lSSID(static_cast<std::size_t>(lLength(lGenerator)), '\0');
+        for (auto& lSSIDCharacter : lSSID) {
+            lSSIDCharacter = lAlphabet.at(static_cast<std::size_t>(lCharacter(lGenerator)));
+        }
+
+        bool lExpected{false};
+        for (const auto& lFilter : lFilters) {
+            lExpected = lExpected || (lSSID.find(lFilter) != std::string::npos);
+        }
+
+        ASSERT_EQ(lMatcher.Matches(lSSID), lExpected) << lSSID;
+    }
+}
@@ -0,0 +1,133 @@
+/* Copyright (c) 2022 [Rick de Bondt] - TimerWheel_Test.cpp
+ * This file contains tests for the TimerWheel and TimerService classes.
+ **/
+
+#include "TimerWheel.h"
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "TimerService.h"
+
+using namespace std::chrono;
+
+class TimerWheelTest : public ::testing::Test
+{
+public:
+    // Sleeps the way the TimerService does, from wake up to wake up, and records when each timer fired
+    void RunUntilEmpty()
+    {
+        std::optional<TimerWheel::Clock::time_point> lWakeUp{mWheel.GetNextWakeUp()};
+        while (lWakeUp.has_value()) {
+            mWakeUps++;
+            mNow = lWakeUp.value();
+            for (auto& [lId, lCallback] : mWheel.Advance(mNow)) {
+                lCallback();
+            }
+            lWakeUp = mWheel.GetNextWakeUp();
+        }
+    }
+
+    void ScheduleRecorded(milliseconds aDelay, const std::string& aName)
+    {
+        mWheel.Schedule(mStart + aDelay, [this, aName] { mFired.emplace_back(aName, mNow - mStart); });
+    }
+
+    TimerWheel::Clock::time_point                                    mStart{TimerWheel::Clock::now()};
+    TimerWheel::Clock::time_point                                    mNow{mStart};
+    TimerWheel                                                       mWheel{mStart};
+    std::vector<std::pair<std::string, TimerWheel::Clock::duration>> mFired{};
+    unsigned int                                                     mWakeUps{0};
+};
+
+TEST_F(TimerWheelTest, FiresInOrderOnTime)
+{
+    EXPECT_FALSE(mWheel.GetNextWakeUp().has_value());
+
+    // Spread over all levels, and one beyond what the wheel can tell apart
+    ScheduleRecorded(milliseconds(5000), "5s");
+    ScheduleRecorded(milliseconds(1), "1ms");
+    ScheduleRecorded(hours(6), "6h");
+    ScheduleRecorded(milliseconds(70), "70ms");
+    ScheduleRecorded(milliseconds(300000), "5min");
+    ScheduleRecorded(milliseconds(64), "64ms");
+    EXPECT_EQ(mWheel.GetSize(), 6);
+
+    RunUntilEmpty();
+
+    std::vector<std::pair<std::string, TimerWheel::Clock::duration>> lExpected{{"1ms", milliseconds(1)},
+                                                                              {"64ms", milliseconds(64)},
+                                                                              {"70ms", milliseconds(70)},
+                                                                              {"5s", milliseconds(5000)},
+                                                                              {"5min", milliseconds(300000)},
+                                                                              {"6h", hours(6)}};
+    EXPECT_EQ(mFired, lExpected);
+    EXPECT_EQ(mWheel.GetSize(), 0);
+
+    // Only woken up to fire a timer or to move timers down a level, never just to look at the clock
+    EXPECT_LE(mWakeUps, 30);
+}
+
+TEST_F(TimerWheelTest, NeverFiresEarly)
+{
+    // Halfway a tick, so it has to be rounded up
+    mWheel.Schedule(mStart + microseconds(2500), [this] { mFired.emplace_back("timer", mNow - mStart); });
+
+    EXPECT_TRUE(mWheel.Advance(mStart + microseconds(2999)).empty());
+    EXPECT_EQ(mWheel.Advance(mStart + milliseconds(3)).size(), 1);
+}
+
+TEST_F(TimerWheelTest, CancelledTimerDoesNotFire)
+{
+    TimerWheel::Id lId{mWheel.Schedule(mStart + milliseconds(100), [] { FAIL(); })};
+    ScheduleRecorded(milliseconds(200), "kept");
+
+    EXPECT_TRUE(mWheel.Cancel(lId));
+    EXPECT_FALSE(mWheel.Cancel(lId));
+
+    // Nothing left to do at the moment of the cancelled timer
+    EXPECT_EQ(mWheel.GetNextWakeUp(), mStart + milliseconds(192));
+
+    RunUntilEmpty();
+    EXPECT_EQ(mFired.size(), 1);
+}
+
+TEST_F(TimerWheelTest, CallbacksCanScheduleAgain)
+{
+    int lCount{0};
+
+    std::function<void()> lRepeat{[&] {
+        lCount++;
+        if (lCount < 5) {
+            mWheel.Schedule(mNow + milliseconds(1000), lRepeat);
+        }
+    }};
+    mWheel.Schedule(mStart + milliseconds(1000), lRepeat);
+
+    RunUntilEmpty();
+    EXPECT_EQ(lCount, 5);
+    EXPECT_EQ(mNow - mStart, milliseconds(5000));
+}
+
+TEST_F(TimerWheelTest, ServiceRunsCallbacks)
+{
+    TimerService      lService{};
+    std::atomic<bool> lFired{false};
+    std::atomic<bool> lCancelledFired{false};
+
+    auto lScheduled{steady_clock::now()};
+    lService.Schedule(milliseconds(20), [&] { lFired = true; });
+    EXPECT_TRUE(lService.Cancel(lService.Schedule(milliseconds(10), [&] { lCancelledFired = true; })));
+
+    while (!lFired && steady_clock::now() < lScheduled + seconds(2)) {
+        std::this_thread::sleep_for(milliseconds(1));
+    }
+
+    EXPECT_TRUE(lFired);
+    EXPECT_GE(steady_clock::now() - lScheduled, milliseconds(20));
+    EXPECT_FALSE(lCancelledFired);
+}
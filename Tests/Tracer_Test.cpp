@@ -0,0 +1,89 @@
+/* Copyright (c) 2022 [Rick de Bondt] - Tracer_Test.cpp
+ * This file contains tests for the Tracer class.
+ **/
+
+#include "Tracer.h"
+
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+using namespace std::chrono;
+
+TEST(TracerTest, WritesChromeTrace)
+{
+    Tracer lTracer{};
+    auto   lStart{Tracer::Clock::now()};
+
+    lTracer.SetThreadName("Main \"thread\"");
+    lTracer.AddEvent("Update", lStart, lStart + microseconds(5));
+
+    std::thread lThread{[&] {
+        lTracer.SetThreadName("Receiver");
+        lTracer.AddEvent("Dispatch", lStart, lStart + microseconds(20));
+    }};
+    lThread.join();
+
+    std::stringstream lStream{};
+    ASSERT_TRUE(lTracer.Write(lStream));
+    std::string lTrace{lStream.str()};
+
+    EXPECT_EQ(lTrace.rfind(R"({"displayTimeUnit":"ns","traceEvents":[)", 0), 0);
+    EXPECT_NE(lTrace.find(R"("args":{"name":"Main \"thread\""})"), std::string::npos);
+    EXPECT_NE(lTrace.find(R"("args":{"name":"Receiver"})"), std::string::npos);
+    EXPECT_NE(lTrace.find(R"({"name":"Update","cat":"xlha","ph":"X")"), std::string::npos);
+    EXPECT_NE(lTrace.find(R"("dur":5.000})"), std::string::npos);
+    EXPECT_NE(lTrace.find(R"("dur":20.000})"), std::string::npos);
+    EXPECT_EQ(lTrace.substr(lTrace.size() - 3), "]}\n");
+}
+
+TEST(TracerTest, KeepsNewestEventsPerThread)
+{
+    Tracer lTracer{};
+    auto   lStart{Tracer::Clock::now()};
+
+    std::thread lThread{[&] { lTracer.AddEvent("Receiver", lStart, lStart + microseconds(1)); }};
+    lThread.join();
+
+    for (std::size_t lCount = 0; lCount < Tracer_Constants::cMaxEvents; lCount++) {
+        lTracer.AddEvent("Old", lStart, lStart + microseconds(1));
+    }
+    lTracer.AddEvent("New", lStart, lStart + microseconds(1));
+
+    // A thread adding a lot of events should not push out those of another thread
+    std::stringstream lStream{};
+    ASSERT_TRUE(lTracer.Write(lStream));
+    std::string lTrace{lStream.str()};
+
+    EXPECT_NE(lTrace.find(R"({"name":"Receiver")"), std::string::npos);
+    EXPECT_NE(lTrace.find(R"({"name":"New")"), std::string::npos);
+
+    std::size_t lEvents{0};
+    std::size_t lIndex{lTrace.find(R"("ph":"X")")};
+    while (lIndex != std::string::npos) {
+        lEvents++;
+        lIndex = lTrace.find(R"("ph":"X")", lIndex + 1);
+    }
+    EXPECT_EQ(lEvents, Tracer_Constants::cMaxEvents + 1);
+}
+
+TEST(TracerTest, KeepsTracersApart)
+{
+    auto lStart{Tracer::Clock::now()};
+
+    Tracer lFirst{};
+    lFirst.AddEvent("First", lStart, lStart + microseconds(1));
+
+    Tracer lSecond{};
+    lSecond.AddEvent("Second", lStart, lStart + microseconds(1));
+    lFirst.AddEvent("First again", lStart, lStart + microseconds(1));
+
+    std::stringstream lStream{};
+    ASSERT_TRUE(lSecond.Write(lStream));
+    std::string lTrace{lStream.str()};
+
+    EXPECT_NE(lTrace.find(R"({"name":"Second")"), std::string::npos);
+    EXPECT_EQ(lTrace.find(R"({"name":"First)"), std::string::npos);
+}
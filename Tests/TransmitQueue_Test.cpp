@@ -0,0 +1,151 @@
+/* Copyright (c) 2022 [Rick de Bondt] - TransmitQueue_Test.cpp
+ * This file contains tests for the TransmitQueue and PacedSender classes.
+ **/
+
+#include "TransmitQueue.h"
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "PacedSender.h"
+
+using namespace std::chrono;
+using namespace TransmitQueue_Constants;
+
+class TransmitQueueTest : public ::testing::Test
+{
+public:
+    // Sends frames as soon as the queue allows it, and records how long each of them waited
+    void Drain()
+    {
+        while (!mQueue.IsEmpty()) {
+            mNow = std::max(mNow, mQueue.GetNextSendTime());
+            std::optional<std::string> lFrame{mQueue.Pop(mNow)};
+            if (lFrame.has_value()) {
+                mWaited.emplace_back(mNow - mStart);
+            }
+        }
+    }
+
+    TransmitQueue::Clock::time_point            mStart{TransmitQueue::Clock::now()};
+    TransmitQueue::Clock::time_point            mNow{mStart};
+    TransmitQueue                               mQueue{};
+    std::vector<TransmitQueue::Clock::duration> mWaited{};
+};
+
+TEST_F(TransmitQueueTest, PacesToAirtime)
+{
+    // 1000 bytes at 2 Mbps is 4 ms of data, plus the overhead of 802.11b
+    EXPECT_EQ(TransmitQueue::GetAirtime(1000, 4), cDSSSOverhead + milliseconds(4));
+    EXPECT_EQ(TransmitQueue::GetAirtime(1000, 108), cOFDMOverhead + microseconds(148));
+    EXPECT_EQ(TransmitQueue::GetAirtime(1000, 0), TransmitQueue::Clock::duration(0));
+
+    std::string lFrame(1000, 'a');
+    for (int lCount = 0; lCount < 3; lCount++) {
+        mQueue.Push(lFrame, 4, mStart);
+    }
+
+    Drain();
+
+    std::vector<TransmitQueue::Clock::duration> lExpected{
+        {}, TransmitQueue::GetAirtime(1000, 4), 2 * TransmitQueue::GetAirtime(1000, 4)};
+    EXPECT_EQ(mWaited, lExpected);
+    EXPECT_EQ(mQueue.GetStatistics().Sent, 3);
+}
+
+TEST_F(TransmitQueueTest, DropsStaleFrames)
+{
+    mQueue.Push("old", 0, mStart);
+    mQueue.Push("fresh", 0, mStart + milliseconds(150));
+
+    std::optional<std::string> lFrame{mQueue.Pop(mStart + cMaximumAge + milliseconds(1))};
+    ASSERT_TRUE(lFrame.has_value());
+    EXPECT_EQ(lFrame.value(), "fresh");
+    EXPECT_EQ(mQueue.GetStatistics().AgeDrops, 1);
+}
+
+TEST_F(TransmitQueueTest, CoDelDropsFromStandingQueue)
+{
+    // A burst that takes longer than the CoDel interval to send, but where no frame gets too old to send
+    std::string lFrame(1000, 'a');
+    for (int lCount = 0; lCount < 30; lCount++) {
+        mQueue.Push(lFrame, 4, mStart);
+    }
+
+    Drain();
+
+    Statistics lStatistics{mQueue.GetStatistics()};
+    EXPECT_EQ(lStatistics.Sent + lStatistics.AgeDrops, 30);
+    EXPECT_GT(lStatistics.AgeDrops, 0);
+    for (const auto& lWaited : mWaited) {
+        EXPECT_LT(lWaited, cMaximumAge);
+    }
+}
+
+TEST_F(TransmitQueueTest, DropsOldestWhenFull)
+{
+    for (std::size_t lCount = 0; lCount <= cMaximumFrames; lCount++) {
+        mQueue.Push(std::to_string(lCount), 0, mStart);
+    }
+
+    EXPECT_EQ(mQueue.GetStatistics().Overflows, 1);
+    EXPECT_EQ(mQueue.Pop(mStart).value(), "1");
+}
+
+TEST_F(TransmitQueueTest, SenderSendsFromItsThread)
+{
+    std::atomic<int> lSent{0};
+    std::thread::id  lSendThread{};
+
+    auto        lStart{steady_clock::now()};
+    PacedSender lSender{[&](std::string_view /*aData*/) {
+        lSendThread = std::this_thread::get_id();
+        lSent++;
+        return true;
+    }};
+
+    std::string lFrame(1000, 'a');
+    for (int lCount = 0; lCount < 5; lCount++) {
+        lSender.Send(lFrame, 4);
+    }
+
+    while (lSent < 5 && steady_clock::now() < lStart + seconds(2)) {
+        std::this_thread::sleep_for(milliseconds(1));
+    }
+
+    EXPECT_EQ(lSent, 5);
+    EXPECT_NE(lSendThread, std::this_thread::get_id());
+
+    // The last frame only goes once the four before it are in the air
+    EXPECT_GE(steady_clock::now() - lStart, 4 * TransmitQueue::GetAirtime(1000, 4));
+    EXPECT_EQ(lSender.GetStatistics().Sent, 5);
+}
+
+TEST_F(TransmitQueueTest, SenderSendsNothingWhileStopped)
+{
+    std::atomic<int> lSent{0};
+    PacedSender      lSender{[&](std::string_view /*aData*/) {
+        lSent++;
+        return false;
+    }};
+
+    lSender.Stop();
+    lSender.Send("1");
+    std::this_thread::sleep_for(milliseconds(20));
+    EXPECT_EQ(lSent, 0);
+
+    // Frames queued while stopped go once started again, failures are counted
+    auto lStart{steady_clock::now()};
+    lSender.Start();
+    while (lSent < 1 && steady_clock::now() < lStart + seconds(2)) {
+        std::this_thread::sleep_for(milliseconds(1));
+    }
+
+    lSender.Stop();
+    EXPECT_EQ(lSent, 1);
+    EXPECT_EQ(lSender.GetStatistics().SendErrors, 1);
+}
@@ -0,0 +1,121 @@
+/* Copyright (c) 2022 [Rick de Bondt] - UDPSocketWrapper_Test.cpp
+ * This file contains tests for the UDPSocketWrapper class, using a socket on the loopback interface.
+ **/
+
+#include "UDPSocketWrapper.h"
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace std::chrono;
+
+namespace
+{
+    class RecordingHandler : public IUDPReceiveHandler
+    {
+    public:
+        void HandleDatagram(std::string_view aData) override
+        {
+            mDatagrams.emplace_back(aData);
+            mCalls++;
+        }
+
+        std::vector<std::string> mDatagrams{};
+        unsigned int             mCalls{0};
+    };
+}  // namespace
+
+class UDPSocketWrapperTest : public ::testing::Test
+{
+public:
+    void SetUp() override
+    {
+        mPeer.open(boost::asio::ip::udp::v4());
+        mPeer.bind(boost::asio::ip::udp::endpoint(boost::asio::ip::address_v4::loopback(), 0));
+
+        ASSERT_TRUE(mWrapper.Open("127.0.0.1", mPeer.local_endpoint().port()));
+
+        // Sending binds the wrapper to a port, the peer learns that port from the datagram
+        ASSERT_EQ(mWrapper.SendTo("hello"), 5);
+        std::array<char, 16> lBuffer{};
+        mPeer.receive_from(boost::asio::buffer(lBuffer), mWrapperEndpoint);
+    }
+
+    void TearDown() override
+    {
+        mWrapper.Close();
+        mPeer.close();
+    }
+
+    /**
+     * Polls the wrapper until the handler received the given amount of datagrams or a second passed.
+     */
+    void PollUntil(RecordingHandler& aHandler, std::size_t aCount)
+    {
+        mWrapper.StartThread();
+        steady_clock::time_point lEnd{steady_clock::now() + seconds(1)};
+        while (aHandler.mDatagrams.size() < aCount && steady_clock::now() < lEnd) {
+            mWrapper.AsyncReceiveFrom(aHandler);
+            mWrapper.PollThread();
+            std::this_thread::sleep_for(milliseconds(1));
+        }
+    }
+
+    UDPSocketWrapper               mWrapper{};
+    boost::asio::io_service        mPeerService{};
+    boost::asio::ip::udp::socket   mPeer{mPeerService};
+    boost::asio::ip::udp::endpoint mWrapperEndpoint{};
+};
+
+// Datagrams that are queued up together should all be handed out from one receive, in order
+TEST_F(UDPSocketWrapperTest, ReceivesQueuedDatagramsInOneBatch)
+{
+    std::vector<std::string> lExpected{"e;e;first", "e;e;second", "keepalive;", "e;e;fourth"};
+    for (const auto& lDatagram : lExpected) {
+        mPeer.send_to(boost::asio::buffer(lDatagram), mWrapperEndpoint);
+    }
+
+    // Give the loopback interface some time to queue everything
+    std::this_thread::sleep_for(milliseconds(50));
+
+    RecordingHandler lHandler{};
+    PollUntil(lHandler, lExpected.size());
+
+    EXPECT_EQ(lHandler.mDatagrams, lExpected);
+}
+
+// Asking for a receive while one is pending should not hand the same datagram out twice
+TEST_F(UDPSocketWrapperTest, IgnoresReceiveWhilePending)
+{
+    RecordingHandler lHandler{};
+    mWrapper.StartThread();
+    mWrapper.AsyncReceiveFrom(lHandler);
+    mWrapper.AsyncReceiveFrom(lHandler);
+    mWrapper.AsyncReceiveFrom(lHandler);
+
+    std::string lDatagram{"e;e;only"};
+    mPeer.send_to(boost::asio::buffer(lDatagram), mWrapperEndpoint);
+    std::this_thread::sleep_for(milliseconds(50));
+
+    steady_clock::time_point lEnd{steady_clock::now() + seconds(1)};
+    while (lHandler.mDatagrams.empty() && steady_clock::now() < lEnd) {
+        mWrapper.PollThread();
+        std::this_thread::sleep_for(milliseconds(1));
+    }
+    mWrapper.PollThread();
+
+    ASSERT_EQ(lHandler.mDatagrams.size(), 1);
+    EXPECT_EQ(lHandler.mDatagrams.front(), lDatagram);
+}
+
+TEST_F(UDPSocketWrapperTest, AppliesOptions)
+{
+    UDPSocketWrapper_Constants::SocketOptions lOptions{};
+    lOptions.ReceiveBufferSize = 256 * 1024;
+    lOptions.SendBufferSize    = 128 * 1024;
+    EXPECT_TRUE(mWrapper.SetOptions(lOptions));
+}
@@ -68,4 +68,28 @@ TEST_F(WindowModelTest, LoadModel)
     EXPECT_EQ(mWindowModel.mXLinkPort, WindowModel_Constants::cDefaultXLinkPort);
     EXPECT_EQ(mWindowModel.mAcknowledgeDataFrames, WindowModel_Constants::cDefaultAcknowledgeDataFrames);
     EXPECT_EQ(mWindowModel.mOnlyAcceptFromMac, WindowModel_Constants::cDefaultOnlyAcceptFromMac);
-}
\ No newline at end of file
+}
+
+// Numbers that are not numbers or out of range should fall back to their defaults, valid ones should stay
+TEST_F(WindowModelTest, LoadInvalidNumbers)
+{
+    ASSERT_TRUE(mWindowModel.LoadFromFile("../Tests/Input/config_invalid.txt"));
+
+    EXPECT_EQ(mWindowModel.mBroadcastRateLimit, WindowModel_Constants::cDefaultBroadcastRateLimit);
+    EXPECT_EQ(mWindowModel.mBroadcastRepeatWindowMs, "250");
+    EXPECT_EQ(mWindowModel.mReConnectionTimeOutS, WindowModel_Constants::cDefaultReConnectionTimeOutS);
+    EXPECT_EQ(mWindowModel.mXLinkBusyPollUs, WindowModel_Constants::cDefaultXLinkBusyPollUs);
+    EXPECT_EQ(mWindowModel.mXLinkPort, WindowModel_Constants::cDefaultXLinkPort);
+    EXPECT_EQ(mWindowModel.mXLinkReceiveBufferSize, WindowModel_Constants::cDefaultXLinkReceiveBufferSize);
+    EXPECT_EQ(mWindowModel.mXLinkSendBufferSize, "65536");
+}
+
+// Tests whether additional wifi adapters get split and deduplicated
+TEST_F(WindowModelTest, GetWifiAdapters)
+{
+    mWindowModel.mWifiAdapter            = "wlan0";
+    mWindowModel.mAdditionalWifiAdapters = "wlan1,,wlan0,wlan2";
+
+    std::vector<std::string> lExpected{"wlan0", "wlan1", "wlan2"};
+    EXPECT_EQ(mWindowModel.GetWifiAdapters(), lExpected);
+}
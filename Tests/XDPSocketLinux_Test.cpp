@@ -0,0 +1,100 @@
+/* Copyright (c) 2022 [Rick de Bondt] - XDPSocketLinux_Test.cpp
+ * This file contains tests for the AF_XDP socket, using the loopback interface. Skipped when the kernel does not
+ * support AF_XDP or when not allowed to attach XDP programs.
+ **/
+
+#include "XDPSocketLinux.h"
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <linux/if_packet.h>
+#include <net/if.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace std::chrono;
+
+namespace
+{
+    // Builds an ethernet frame with the given source mac address and EtherType, padded to the minimum size
+    std::string Frame(std::string_view aSourceMac, std::string_view aEtherType, std::string_view aPayload)
+    {
+        std::string lFrame{std::string("\xFF\xFF\xFF\xFF\xFF\xFF", 6)};
+        lFrame.append(aSourceMac);
+        lFrame.append(aEtherType);
+        lFrame.append(aPayload);
+        lFrame.resize(60, '\0');
+        return lFrame;
+    }
+
+    const std::string cPSPFrame{Frame(std::string("\x02\x11\x22\x33\x44\x55", 6), "\x88\xC8", "psp")};
+    const std::string cConsoleFrame{Frame(std::string("\x00\x1F\xA7\x33\x44\x55", 6), "\x08\x06", "console")};
+    const std::string cOtherFrame{Frame(std::string("\x02\x11\x22\x33\x44\x55", 6), "\x08\x06", "other")};
+}  // namespace
+
+class XDPSocketTest : public ::testing::Test
+{
+public:
+    void SetUp() override
+    {
+        if (!mSocket.Open("lo")) {
+            GTEST_SKIP() << "AF_XDP is not supported";
+        }
+
+        mInjector = socket(AF_PACKET, SOCK_RAW, 0);
+        sockaddr_ll lAddress{};
+        lAddress.sll_family  = AF_PACKET;
+        lAddress.sll_ifindex = static_cast<int>(if_nametoindex("lo"));
+        ASSERT_EQ(bind(mInjector, reinterpret_cast<sockaddr*>(&lAddress), sizeof(lAddress)), 0);
+    }
+
+    void TearDown() override
+    {
+        mSocket.Close();
+        if (mInjector >= 0) {
+            close(mInjector);
+        }
+    }
+
+    // Collects frames until aCount frames came in or a second passed
+    std::vector<std::string> Receive(std::size_t aCount)
+    {
+        std::vector<std::string> lFrames{};
+        steady_clock::time_point lEnd{steady_clock::now() + seconds(1)};
+        while (lFrames.size() < aCount && steady_clock::now() < lEnd) {
+            mSocket.ForEachFrame([&](std::string_view aFrame) { lFrames.emplace_back(aFrame); });
+            std::this_thread::sleep_for(milliseconds(1));
+        }
+        return lFrames;
+    }
+
+    XDPSocket mSocket{};
+    int       mInjector{-1};
+};
+
+// Only frames from the PSP plugin and from consoles should be steered to the socket
+TEST_F(XDPSocketTest, ReceivesSteeredFrames)
+{
+    for (const std::string& lFrame : {cOtherFrame, cPSPFrame, cOtherFrame, cConsoleFrame}) {
+        ASSERT_EQ(write(mInjector, lFrame.data(), lFrame.size()), static_cast<ssize_t>(lFrame.size()));
+    }
+
+    std::vector<std::string> lFrames{Receive(3)};
+    EXPECT_EQ(lFrames, (std::vector<std::string>{cPSPFrame, cConsoleFrame}));
+}
+
+// Frames sent through the socket go out on the adapter, on loopback they come right back in
+TEST_F(XDPSocketTest, SendsThroughRing)
+{
+    std::vector<std::string> lSent{};
+    for (int lCount = 0; lCount < 100; lCount++) {
+        lSent.emplace_back(Frame(std::string("\x02\x11\x22\x33\x44\x55", 6), "\x88\xC8", std::to_string(lCount)));
+        ASSERT_EQ(mSocket.Send(lSent.back()), XDPSocket_Constants::SendResult::Queued);
+    }
+
+    EXPECT_EQ(Receive(lSent.size()), lSent);
+}
@@ -13,7 +13,9 @@
 #include <gmock/gmock-spec-builders.h>
 #include <gtest/gtest.h>
 
+#include "IConnectorMock.h"
 #include "IPCapDeviceMock.h"
+#include "IPCapWrapperMock.h"
 #include "ITimerMock.h"
 #include "IUDPSocketWrapperMock.h"
 #include "MonitorDevice.h"
@@ -24,7 +26,6 @@ using testing::DoAll;
 using testing::Invoke;
 using testing::Return;
 using testing::ReturnPointee;
-using testing::SaveArg;
 
 constexpr std::string_view cDefaultTitleId = "ULES00125";
 constexpr std::string_view cDefaultESSID = "PSP_AULES00125_BOUTLLOB";
@@ -78,20 +79,19 @@ TEST_F(XLinkKaiConnectionTest, TestReceiverThreadConnectHappyFlow)
 {
     std::string_view lIPAddress{"127.0.0.1"};
 
-    bool                        lThreadStopCalled{false};
-    bool                        lOpened{false};
-    bool                        lEndTest{false};
-    int                         lThreadCallCount{0};
-    std::function<void(size_t)> lCallBack;
-    char*                       lBuffer = nullptr;
+    bool                lThreadStopCalled{false};
+    bool                lOpened{false};
+    bool                lEndTest{false};
+    int                 lThreadCallCount{0};
+    IUDPReceiveHandler* lHandler{nullptr};
 
     // Incoming connection will return these
     EXPECT_CALL(*mPCapDeviceMock, GetTitleId()).WillRepeatedly(Return(std::string(cDefaultTitleId)));
     EXPECT_CALL(*mPCapDeviceMock, GetESSID()).WillRepeatedly(Return(std::string(cDefaultESSID)));
 
-    // Save the arguments from here so we can use the private callback in xlink kai connection
-    EXPECT_CALL(*mSocketWrapperMock, AsyncReceiveFrom(_, _, _))
-        .WillRepeatedly(DoAll(SaveArg<0>(&lBuffer), SaveArg<2>(&lCallBack)));
+    // Save the handler from here so we can feed messages to xlink kai connection
+    EXPECT_CALL(*mSocketWrapperMock, AsyncReceiveFrom(_))
+        .WillRepeatedly(Invoke([&](IUDPReceiveHandler& aHandler) { lHandler = &aHandler; }));
 
     // General requirements
     EXPECT_CALL(*mSocketWrapperMock, IsOpen()).WillRepeatedly(ReturnPointee(&lOpened));
@@ -120,8 +120,7 @@ TEST_F(XLinkKaiConnectionTest, TestReceiverThreadConnectHappyFlow)
         if (lThreadCallCount == 1) {
             // Simulate a connection
             std::string lConnected{"connected;XLHA_Device;XLHA;"};
-            strcpy(lBuffer, lConnected.c_str());
-            lCallBack(lConnected.size());
+            lHandler->HandleDatagram(lConnected);
         } else if (lThreadCallCount == 2) {
             // Sending Settings
             // Also send a normal packet
@@ -157,20 +156,19 @@ TEST_F(XLinkKaiConnectionTest, TestReceiverThreadConnectionTimeout)
 
     std::string_view lIPAddress{"127.0.0.1"};
 
-    bool                        lThreadStopCalled{false};
-    bool                        lOpened{false};
-    bool                        lEndTest{false};
-    int                         lThreadCallCount{0};
-    std::function<void(size_t)> lCallBack;
-    char*                       lBuffer = nullptr;
+    bool                lThreadStopCalled{false};
+    bool                lOpened{false};
+    bool                lEndTest{false};
+    int                 lThreadCallCount{0};
+    IUDPReceiveHandler* lHandler{nullptr};
 
     // Incoming connection will return these
     EXPECT_CALL(*mPCapDeviceMock, GetTitleId()).WillRepeatedly(Return(std::string(cDefaultTitleId)));
     EXPECT_CALL(*mPCapDeviceMock, GetESSID()).WillRepeatedly(Return(std::string(cDefaultESSID)));
 
-    // Save the arguments from here so we can use the private callback in xlink kai connection
-    EXPECT_CALL(*mSocketWrapperMock, AsyncReceiveFrom(_, _, _))
-        .WillRepeatedly(DoAll(SaveArg<0>(&lBuffer), SaveArg<2>(&lCallBack)));
+    // Save the handler from here so we can feed messages to xlink kai connection
+    EXPECT_CALL(*mSocketWrapperMock, AsyncReceiveFrom(_))
+        .WillRepeatedly(Invoke([&](IUDPReceiveHandler& aHandler) { lHandler = &aHandler; }));
 
     // General requirements
     EXPECT_CALL(*mSocketWrapperMock, IsOpen()).WillRepeatedly(ReturnPointee(&lOpened));
@@ -201,25 +199,24 @@ TEST_F(XLinkKaiConnectionTest, TestReceiverThreadConnectionTimeout)
     // If the program wants to quit, the test should not stop it from doing so
     EXPECT_CALL(*mSocketWrapperMock, StopThread()).WillRepeatedly(Assign(&lThreadStopCalled, true));
 
-    // Expect the timer to be restarted when trying to reconnect
-    EXPECT_CALL(*mTimerMock, Start(_)).Times(2);
-    EXPECT_CALL(*mTimerMock, IsTimedOut()).WillOnce(Return(true));
+    // Expect the timer to be restarted when scheduling the reconnect and when trying to reconnect
+    EXPECT_CALL(*mTimerMock, Start(_)).Times(3);
+    EXPECT_CALL(*mTimerMock, IsTimedOut()).Times(2).WillRepeatedly(Return(true));
 
     // Try to sync actions with ReceiverThread
     EXPECT_CALL(*mSocketWrapperMock, PollThread()).WillRepeatedly(Invoke([&] {
         lThreadCallCount++;
 
         // (0) First run, connection is initiated
-        // (1) Second run, no response, timeout
-        // (2) Third run, reconnect
+        // (1) Second run, no response, timeout, reconnect scheduled
+        // (2) Third run, reconnect delay passed, reconnect
         // (3) Fourth run, send settings
         // (4) Fifth run, disconnect
 
         if (lThreadCallCount == 2) {
             // Simulate a connection
             std::string lConnected{"connected;XLHA_Device;XLHA;"};
-            strcpy(lBuffer, lConnected.c_str());
-            lCallBack(lConnected.size());
+            lHandler->HandleDatagram(lConnected);
         } else if (lThreadCallCount == 1 || lThreadCallCount == 3) {
             // Sending settings or doing nothing
         } else {
@@ -236,6 +233,8 @@ TEST_F(XLinkKaiConnectionTest, TestReceiverThreadConnectionTimeout)
         std::this_thread::sleep_for(std::chrono::milliseconds(10));
     }
 
+    EXPECT_EQ(mXLinkKaiConnection->GetLinkStatistics().ReconnectAttempts, 1);
+
     // Force connection to close before destructor of google test is called
     mXLinkKaiConnection->Close(true);
     mXLinkKaiConnection = nullptr;
@@ -251,20 +250,19 @@ TEST_F(XLinkKaiConnectionTest, TestReceiverThreadNoXlinkKaiResponse)
 
     std::string_view lIPAddress{"127.0.0.1"};
 
-    bool                        lThreadStopCalled{false};
-    bool                        lOpened{false};
-    bool                        lEndTest{false};
-    int                         lThreadCallCount{0};
-    std::function<void(size_t)> lCallBack;
-    char*                       lBuffer = nullptr;
+    bool                lThreadStopCalled{false};
+    bool                lOpened{false};
+    bool                lEndTest{false};
+    int                 lThreadCallCount{0};
+    IUDPReceiveHandler* lHandler{nullptr};
 
     // Incoming connection will return these
     EXPECT_CALL(*mPCapDeviceMock, GetTitleId()).WillRepeatedly(Return(std::string(cDefaultTitleId)));
     EXPECT_CALL(*mPCapDeviceMock, GetESSID()).WillRepeatedly(Return(std::string(cDefaultESSID)));
 
-    // Save the arguments from here so we can use the private callback in xlink kai connection
-    EXPECT_CALL(*mSocketWrapperMock, AsyncReceiveFrom(_, _, _))
-        .WillRepeatedly(DoAll(SaveArg<0>(&lBuffer), SaveArg<2>(&lCallBack)));
+    // Save the handler from here so we can feed messages to xlink kai connection
+    EXPECT_CALL(*mSocketWrapperMock, AsyncReceiveFrom(_))
+        .WillRepeatedly(Invoke([&](IUDPReceiveHandler& aHandler) { lHandler = &aHandler; }));
 
     // General requirements
     EXPECT_CALL(*mSocketWrapperMock, IsOpen()).WillRepeatedly(ReturnPointee(&lOpened));
@@ -309,8 +307,7 @@ TEST_F(XLinkKaiConnectionTest, TestReceiverThreadNoXlinkKaiResponse)
         if (lThreadCallCount == 1 || lThreadCallCount == 4) {
             // Simulate a connection
             std::string lConnected{"connected;XLHA_Device;XLHA;"};
-            strcpy(lBuffer, lConnected.c_str());
-            lCallBack(lConnected.size());
+            lHandler->HandleDatagram(lConnected);
         } else if (lThreadCallCount == 2 || lThreadCallCount == 3) {
             // Sending settings or doing nothing
         } else {
@@ -342,20 +339,19 @@ TEST_F(XLinkKaiConnectionTest, TestReceiverThreadKeepAlive)
 
     std::string_view lIPAddress{"127.0.0.1"};
 
-    bool                        lThreadStopCalled{false};
-    bool                        lOpened{false};
-    bool                        lEndTest{false};
-    int                         lThreadCallCount{0};
-    std::function<void(size_t)> lCallBack;
-    char*                       lBuffer = nullptr;
+    bool                lThreadStopCalled{false};
+    bool                lOpened{false};
+    bool                lEndTest{false};
+    int                 lThreadCallCount{0};
+    IUDPReceiveHandler* lHandler{nullptr};
 
     // Incoming connection will return these
     EXPECT_CALL(*mPCapDeviceMock, GetTitleId()).WillRepeatedly(Return(std::string(cDefaultTitleId)));
     EXPECT_CALL(*mPCapDeviceMock, GetESSID()).WillRepeatedly(Return(std::string(cDefaultESSID)));
 
-    // Save the arguments from here so we can use the private callback in xlink kai connection
-    EXPECT_CALL(*mSocketWrapperMock, AsyncReceiveFrom(_, _, _))
-        .WillRepeatedly(DoAll(SaveArg<0>(&lBuffer), SaveArg<2>(&lCallBack)));
+    // Save the handler from here so we can feed messages to xlink kai connection
+    EXPECT_CALL(*mSocketWrapperMock, AsyncReceiveFrom(_))
+        .WillRepeatedly(Invoke([&](IUDPReceiveHandler& aHandler) { lHandler = &aHandler; }));
 
     // General requirements
     EXPECT_CALL(*mSocketWrapperMock, IsOpen()).WillRepeatedly(ReturnPointee(&lOpened));
@@ -388,8 +384,7 @@ TEST_F(XLinkKaiConnectionTest, TestReceiverThreadKeepAlive)
         if (lThreadCallCount == 1) {
             // Simulate a connection
             std::string lConnected{"connected;XLHA_Device;XLHA;"};
-            strcpy(lBuffer, lConnected.c_str());
-            lCallBack(lConnected.size());
+            lHandler->HandleDatagram(lConnected);
         } else if (lThreadCallCount == 2) {
             // Sending Settings
         } else if (lThreadCallCount == 3) {
@@ -399,8 +394,7 @@ TEST_F(XLinkKaiConnectionTest, TestReceiverThreadKeepAlive)
 
             // Keep alive from xlink kai
             std::string lKeepAlive{cFullKeepAliveString};
-            strcpy(lBuffer, lKeepAlive.c_str());
-            lCallBack(lKeepAlive.size());
+            lHandler->HandleDatagram(lKeepAlive);
         } else {
             // Stop the connection regardless of success
             lEndTest = true;
@@ -415,6 +409,11 @@ TEST_F(XLinkKaiConnectionTest, TestReceiverThreadKeepAlive)
         std::this_thread::sleep_for(std::chrono::milliseconds(10));
     }
 
+    // Only the keepalive from XLink Kai is counted, the connection never had to be retried
+    XLinkKai_Constants::LinkStatistics lStatistics{mXLinkKaiConnection->GetLinkStatistics()};
+    EXPECT_EQ(lStatistics.KeepAlivesReceived, 1);
+    EXPECT_EQ(lStatistics.ReconnectAttempts, 0);
+
     // Force connection to close before destructor of google test is called
     mXLinkKaiConnection->Close(true);
     mXLinkKaiConnection = nullptr;
@@ -430,20 +429,19 @@ TEST_F(XLinkKaiConnectionTest, TestReceiverThreadNormalData)
 
     std::string_view lIPAddress{"127.0.0.1"};
 
-    bool                        lThreadStopCalled{false};
-    bool                        lOpened{false};
-    bool                        lEndTest{false};
-    int                         lThreadCallCount{0};
-    std::function<void(size_t)> lCallBack;
-    char*                       lBuffer = nullptr;
+    bool                lThreadStopCalled{false};
+    bool                lOpened{false};
+    bool                lEndTest{false};
+    int                 lThreadCallCount{0};
+    IUDPReceiveHandler* lHandler{nullptr};
 
     // Incoming connection will return these
     EXPECT_CALL(*mPCapDeviceMock, GetTitleId()).WillRepeatedly(Return(std::string(cDefaultTitleId)));
     EXPECT_CALL(*mPCapDeviceMock, GetESSID()).WillRepeatedly(Return(std::string(cDefaultESSID)));
 
-    // Save the arguments from here so we can use the private callback in xlink kai connection
-    EXPECT_CALL(*mSocketWrapperMock, AsyncReceiveFrom(_, _, _))
-        .WillRepeatedly(DoAll(SaveArg<0>(&lBuffer), SaveArg<2>(&lCallBack)));
+    // Save the handler from here so we can feed messages to xlink kai connection
+    EXPECT_CALL(*mSocketWrapperMock, AsyncReceiveFrom(_))
+        .WillRepeatedly(Invoke([&](IUDPReceiveHandler& aHandler) { lHandler = &aHandler; }));
 
     // General requirements
     EXPECT_CALL(*mSocketWrapperMock, IsOpen()).WillRepeatedly(ReturnPointee(&lOpened));
@@ -476,8 +474,7 @@ TEST_F(XLinkKaiConnectionTest, TestReceiverThreadNormalData)
         if (lThreadCallCount == 1) {
             // Simulate a connection
             std::string lConnected{"connected;XLHA_Device;XLHA;"};
-            strcpy(lBuffer, lConnected.c_str());
-            lCallBack(lConnected.size());
+            lHandler->HandleDatagram(lConnected);
         } else if (lThreadCallCount == 2) {
             // Sending Settings
         } else if (lThreadCallCount == 3) {
@@ -499,13 +496,10 @@ TEST_F(XLinkKaiConnectionTest, TestReceiverThreadNormalData)
             // Skip e;e; for the expected sent over the WiFI adapter result
             std::string_view lDataView{reinterpret_cast<char*>(&lData.at(4)), lData.size() - 4};
 
-            //  Should pass data to incoming connection and blacklist the source mac from being sent trhough the other
-            //  side
-            EXPECT_CALL(*mPCapDeviceMock, BlackList(0xb03f29f81800));
+            //  Should pass data to incoming connection
             EXPECT_CALL(*mPCapDeviceMock, Send(lDataView));
 
-            memcpy(lBuffer, lData.data(), lData.size());
-            lCallBack(lData.size());
+            lHandler->HandleDatagram(std::string_view(reinterpret_cast<const char*>(lData.data()), lData.size()));
 
         } else {
             // Stop the connection regardless of success
@@ -539,20 +533,19 @@ TEST_F(XLinkKaiConnectionTest, TestReceiverThreadMonitorData)
 
     std::string_view lIPAddress{"127.0.0.1"};
 
-    bool                        lThreadStopCalled{false};
-    bool                        lOpened{false};
-    bool                        lEndTest{false};
-    int                         lThreadCallCount{0};
-    std::function<void(size_t)> lCallBack;
-    char*                       lBuffer = nullptr;
+    bool                lThreadStopCalled{false};
+    bool                lOpened{false};
+    bool                lEndTest{false};
+    int                 lThreadCallCount{0};
+    IUDPReceiveHandler* lHandler{nullptr};
 
     // Incoming connection will return these
     EXPECT_CALL(*lMonitorDeviceDerived, GetTitleId()).WillRepeatedly(Return(std::string(cDefaultTitleId)));
     EXPECT_CALL(*lMonitorDeviceDerived, GetESSID()).WillRepeatedly(Return(std::string(cDefaultESSID)));
 
-    // Save the arguments from here so we can use the private callback in xlink kai connection
-    EXPECT_CALL(*mSocketWrapperMock, AsyncReceiveFrom(_, _, _))
-        .WillRepeatedly(DoAll(SaveArg<0>(&lBuffer), SaveArg<2>(&lCallBack)));
+    // Save the handler from here so we can feed messages to xlink kai connection
+    EXPECT_CALL(*mSocketWrapperMock, AsyncReceiveFrom(_))
+        .WillRepeatedly(Invoke([&](IUDPReceiveHandler& aHandler) { lHandler = &aHandler; }));
 
     // General requirements
     EXPECT_CALL(*mSocketWrapperMock, IsOpen()).WillRepeatedly(ReturnPointee(&lOpened));
@@ -585,8 +578,7 @@ TEST_F(XLinkKaiConnectionTest, TestReceiverThreadMonitorData)
         if (lThreadCallCount == 1) {
             // Simulate a connection
             std::string lConnected{"connected;XLHA_Device;XLHA;"};
-            strcpy(lBuffer, lConnected.c_str());
-            lCallBack(lConnected.size());
+            lHandler->HandleDatagram(lConnected);
         } else if (lThreadCallCount == 2) {
             // Sending Settings
         } else if (lThreadCallCount == 3) {
@@ -635,13 +627,10 @@ TEST_F(XLinkKaiConnectionTest, TestReceiverThreadMonitorData)
             std::string      lCompleteString{lHeaderString + lDataString};
             std::string_view lDataView{lCompleteString};
 
-            // Should pass data to incoming connection and blacklist the source mac from being sent through the other
-            // side
-            EXPECT_CALL(*lMonitorDeviceDerived, BlackList(0xb03f29f81800));
+            // Should pass data to incoming connection
             EXPECT_CALL(*lMonitorDeviceDerived, Send(lDataView));
 
-            memcpy(lBuffer, lData.data(), lData.size());
-            lCallBack(lData.size());
+            lHandler->HandleDatagram(std::string_view(reinterpret_cast<const char*>(lData.data()), lData.size()));
 
         } else {
             // Stop the connection regardless of success
@@ -716,20 +705,19 @@ TEST_F(XLinkKaiConnectionTest, TestSSIDSwitchFromXLinkKai)
 {
     std::string_view lIPAddress{"127.0.0.1"};
 
-    bool                        lThreadStopCalled{false};
-    bool                        lOpened{false};
-    bool                        lEndTest{false};
-    int                         lThreadCallCount{0};
-    std::function<void(size_t)> lCallBack;
-    char*                       lBuffer = nullptr;
+    bool                lThreadStopCalled{false};
+    bool                lOpened{false};
+    bool                lEndTest{false};
+    int                 lThreadCallCount{0};
+    IUDPReceiveHandler* lHandler{nullptr};
 
     // Incoming connection will return these
     EXPECT_CALL(*mPCapDeviceMock, GetTitleId()).WillRepeatedly(Return(std::string(cDefaultTitleId)));
     EXPECT_CALL(*mPCapDeviceMock, GetESSID()).WillRepeatedly(Return(std::string(cDefaultESSID)));
 
-    // Save the arguments from here so we can use the private callback in xlink kai connection
-    EXPECT_CALL(*mSocketWrapperMock, AsyncReceiveFrom(_, _, _))
-        .WillRepeatedly(DoAll(SaveArg<0>(&lBuffer), SaveArg<2>(&lCallBack)));
+    // Save the handler from here so we can feed messages to xlink kai connection
+    EXPECT_CALL(*mSocketWrapperMock, AsyncReceiveFrom(_))
+        .WillRepeatedly(Invoke([&](IUDPReceiveHandler& aHandler) { lHandler = &aHandler; }));
 
     // General requirements
     EXPECT_CALL(*mSocketWrapperMock, IsOpen()).WillRepeatedly(ReturnPointee(&lOpened));
@@ -761,8 +749,7 @@ TEST_F(XLinkKaiConnectionTest, TestSSIDSwitchFromXLinkKai)
         if (lThreadCallCount == 1) {
             // Simulate a connection
             std::string lConnected{"connected;XLHA_Device;XLHA;"};
-            strcpy(lBuffer, lConnected.c_str());
-            lCallBack(lConnected.size());
+            lHandler->HandleDatagram(lConnected);
         } else if (lThreadCallCount == 2) {
             // Sending Settings
         } else if (lThreadCallCount == 3) {
@@ -770,8 +757,7 @@ TEST_F(XLinkKaiConnectionTest, TestSSIDSwitchFromXLinkKai)
             EXPECT_CALL(*mPCapDeviceMock, Connect(cDefaultESSID));
 
             std::string lSetESSID{"e;d;setessid;PSP_AULES00125_BOUTLLOB;"};
-            strcpy(lBuffer, lSetESSID.c_str());
-            lCallBack(lSetESSID.size());
+            lHandler->HandleDatagram(lSetESSID);
         } else {
             // Stop the connection regardless of success
             lEndTest = true;
@@ -789,4 +775,148 @@ TEST_F(XLinkKaiConnectionTest, TestSSIDSwitchFromXLinkKai)
     // Force connection to close before destructor of google test is called
     mXLinkKaiConnection->Close(true);
     mXLinkKaiConnection = nullptr;
-}
\ No newline at end of file
+}
+
+// Tests that data from XLink Kai only goes to the device a Mac address was learned on, and broadcasts go to all devices
+TEST_F(XLinkKaiConnectionTest, TestMultiplexedDevices)
+{
+    std::shared_ptr<IPCapDeviceMock> lOtherDeviceMock{std::make_shared<IPCapDeviceMock>()};
+
+    // Destination Mac, source Mac, EtherType and some data
+    const std::string lFromDevice{"\x00\x01\x02\x03\x04\x05\x0A\x0B\x0C\x0D\x0E\x0F\x88\xC8hello", 19};
+    const std::string lToDevice{"\x0A\x0B\x0C\x0D\x0E\x0F\x00\x01\x02\x03\x04\x05\x88\xC8hello", 19};
+    const std::string lBroadcast{"\xFF\xFF\xFF\xFF\xFF\xFF\x00\x01\x02\x03\x04\x05\x88\xC8hello", 19};
+
+    std::vector<std::string> lMessages{
+        "connected;XLHA_Device;XLHA;", cEthernetDataString + lToDevice, cEthernetDataString + lBroadcast};
+    std::size_t lMessageIndex{0};
+
+    EXPECT_CALL(*mSocketWrapperMock, IsOpen()).WillRepeatedly(Return(true));
+    EXPECT_CALL(*mSocketWrapperMock, SendTo(_)).WillRepeatedly(Return(0));
+    EXPECT_CALL(*mSocketWrapperMock, Close()).WillRepeatedly(Return());
+    EXPECT_CALL(*mSocketWrapperMock, ReceiveFrom(_, _))
+        .WillRepeatedly(Invoke([&](char* aBuffer, size_t /*aBufferSize*/) {
+            const std::string& lMessage{lMessages.at(lMessageIndex++)};
+            memcpy(aBuffer, lMessage.data(), lMessage.size());
+            return lMessage.size();
+        }));
+
+    // The fixture already added the first device, adding it again should not make it receive data twice
+    std::shared_ptr<IConnector> lConnector{mXLinkKaiConnection->AddIncomingConnection(mPCapDeviceMock)};
+    mXLinkKaiConnection->AddIncomingConnection(lOtherDeviceMock);
+
+    EXPECT_CALL(*mPCapDeviceMock, Send(std::string_view(lToDevice))).WillOnce(Return(true));
+    EXPECT_CALL(*mPCapDeviceMock, Send(std::string_view(lBroadcast))).WillOnce(Return(true));
+    EXPECT_CALL(*lOtherDeviceMock, Send(std::string_view(lBroadcast))).WillOnce(Return(true));
+
+    // Connect, then let the first device forward something so its Mac address is learned
+    ASSERT_TRUE(mXLinkKaiConnection->ReadNextData());
+    ASSERT_TRUE(lConnector->Send(lFromDevice));
+
+    ASSERT_TRUE(mXLinkKaiConnection->ReadNextData());
+    ASSERT_TRUE(mXLinkKaiConnection->ReadNextData());
+}
+
+// Tests that unicast from XLink Kai only goes over the air for Mac addresses seen there, and that nothing loops back
+TEST_F(XLinkKaiConnectionTest, TestForwardingDatabase)
+{
+    // Destination Mac, source Mac, EtherType and some data
+    const std::string lToUnknown{"\x0A\x0B\x0C\x0D\x0E\x0F\x00\x01\x02\x03\x04\x05\x88\xC8hello", 19};
+    const std::string lFromDevice{"\x00\x01\x02\x03\x04\x05\x0A\x0B\x0C\x0D\x0E\x0F\x88\xC8hello", 19};
+    const std::string lToDevice{"\x0A\x0B\x0C\x0D\x0E\x0F\x00\x01\x02\x03\x04\x05\x88\xC8hello", 19};
+    const std::string lLoopedBack{"\x0A\x0B\x0C\x0D\x0E\x0F\x00\x01\x02\x03\x04\x05\x88\xC8" "again", 19};
+
+    std::vector<std::string> lMessages{
+        "connected;XLHA_Device;XLHA;", cEthernetDataString + lToUnknown, cEthernetDataString + lToDevice};
+    std::size_t lMessageIndex{0};
+
+    EXPECT_CALL(*mSocketWrapperMock, IsOpen()).WillRepeatedly(Return(true));
+    EXPECT_CALL(*mSocketWrapperMock, SendTo(_)).WillRepeatedly(Return(0));
+    EXPECT_CALL(*mSocketWrapperMock, Close()).WillRepeatedly(Return());
+    EXPECT_CALL(*mSocketWrapperMock, ReceiveFrom(_, _))
+        .WillRepeatedly(Invoke([&](char* aBuffer, size_t /*aBufferSize*/) {
+            const std::string& lMessage{lMessages.at(lMessageIndex++)};
+            memcpy(aBuffer, lMessage.data(), lMessage.size());
+            return lMessage.size();
+        }));
+
+    // Nobody on this side has sent anything yet, so there is nobody to deliver to
+    EXPECT_CALL(*mPCapDeviceMock, Send(_)).Times(0);
+    ASSERT_TRUE(mXLinkKaiConnection->ReadNextData());
+    ASSERT_TRUE(mXLinkKaiConnection->ReadNextData());
+    EXPECT_EQ(mXLinkKaiConnection->GetLinkStatistics().UnknownUnicastFrames, 1);
+
+    // Once the Mac address is learned it does get delivered
+    ASSERT_TRUE(mXLinkKaiConnection->Send(lFromDevice));
+    EXPECT_CALL(*mPCapDeviceMock, Send(std::string_view(lToDevice))).WillOnce(Return(true));
+    ASSERT_TRUE(mXLinkKaiConnection->ReadNextData());
+
+    // The device picking up data from XLink Kai should not send it back
+    EXPECT_CALL(*mSocketWrapperMock, SendTo(std::string_view(cEthernetDataString + lLoopedBack))).Times(0);
+    EXPECT_TRUE(mXLinkKaiConnection->Send(lLoopedBack));
+
+    XLinkKai_Constants::LinkStatistics lStatistics{mXLinkKaiConnection->GetLinkStatistics()};
+    EXPECT_EQ(lStatistics.MacAddresses, 2);
+    EXPECT_EQ(lStatistics.LoopedFrames, 1);
+    EXPECT_EQ(lStatistics.UnknownUnicastFrames, 1);
+}
+
+// Tests that a monitor device drops the frames it injected for XLink Kai when it captures them again
+TEST_F(XLinkKaiConnectionTest, TestInjectedFramesFilteredByMonitorDevice)
+{
+    std::shared_ptr<IPCapWrapperMock> lWrapperMock{std::make_shared<IPCapWrapperMock>()};
+    std::shared_ptr<IConnectorMock>   lConnectorMock{std::make_shared<IConnectorMock>()};
+    std::shared_ptr<MonitorDevice>    lMonitorDevice{std::make_shared<MonitorDevice>(0, true, nullptr, lWrapperMock)};
+
+    // Destination Mac, source Mac, EtherType and some data
+    const std::string lFromDevice{"\x0A\x0B\x0C\x0D\x0E\x0F\x00\x01\x02\x03\x04\x05\x88\xC8hello", 19};
+    const std::string lToDevice{"\x00\x01\x02\x03\x04\x05\x0A\x0B\x0C\x0D\x0E\x0F\x88\xC8hello", 19};
+
+    std::vector<std::string> lMessages{"connected;XLHA_Device;XLHA;", cEthernetDataString + lToDevice};
+    std::size_t              lMessageIndex{0};
+    std::string              lInjected{};
+
+    EXPECT_CALL(*mSocketWrapperMock, IsOpen()).WillRepeatedly(Return(true));
+    EXPECT_CALL(*mSocketWrapperMock, SendTo(_)).WillRepeatedly(Return(0));
+    EXPECT_CALL(*mSocketWrapperMock, Close()).WillRepeatedly(Return());
+    EXPECT_CALL(*mSocketWrapperMock, ReceiveFrom(_, _))
+        .WillRepeatedly(Invoke([&](char* aBuffer, size_t /*aBufferSize*/) {
+            const std::string& lMessage{lMessages.at(lMessageIndex++)};
+            memcpy(aBuffer, lMessage.data(), lMessage.size());
+            return lMessage.size();
+        }));
+    EXPECT_CALL(*lWrapperMock, IsActivated()).WillRepeatedly(Return(true));
+
+    mXLinkKaiConnection->SetIncomingConnection(lMonitorDevice);
+    lMonitorDevice->SetConnector(lConnectorMock);
+
+    // Connect and learn the handheld, then let XLink Kai send something to it
+    EXPECT_CALL(*lWrapperMock, SendPacket(_)).WillOnce(Invoke([&](std::string_view aData) {
+        lInjected = aData;
+        return 0;
+    }));
+    ASSERT_TRUE(mXLinkKaiConnection->ReadNextData());
+    ASSERT_TRUE(mXLinkKaiConnection->Send(lFromDevice));
+    ASSERT_TRUE(mXLinkKaiConnection->ReadNextData());
+    ASSERT_FALSE(lInjected.empty());
+
+    // As captured by the receiver thread
+    IPCapDevice& lDevice{*lMonitorDevice};
+    pcap_pkthdr  lHeader{};
+    lHeader.caplen = lInjected.size();
+    lHeader.len    = lInjected.size();
+
+    // Capturing the injected frame again should neither send it back to XLink Kai nor acknowledge it
+    EXPECT_CALL(*lConnectorMock, Send(_)).Times(0);
+    EXPECT_CALL(*lWrapperMock, SendPacket(_)).Times(0);
+    lDevice.ReadCallback(reinterpret_cast<const unsigned char*>(lInjected.data()), &lHeader);
+    testing::Mock::VerifyAndClearExpectations(lConnectorMock.get());
+    testing::Mock::VerifyAndClearExpectations(lWrapperMock.get());
+
+    // Once XLink Kai forgets about the source the device handles it like any other frame
+    mXLinkKaiConnection->SetIncomingConnection(lMonitorDevice);
+    EXPECT_CALL(*lWrapperMock, IsActivated()).WillRepeatedly(Return(true));
+    EXPECT_CALL(*lConnectorMock, Send(_)).WillOnce(Return(true));
+    EXPECT_CALL(*lWrapperMock, SendPacket(_)).WillOnce(Return(0));
+    lDevice.ReadCallback(reinterpret_cast<const unsigned char*>(lInjected.data()), &lHeader);
+}
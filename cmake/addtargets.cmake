@@ -73,6 +73,30 @@ foreach (target IN ITEMS ${targets})
     endif ()
   endif ()
 
+  # Benchmark stuff
+  if (${target}_BENCHMARK_SOURCES AND ENABLE_BENCHMARKS)
+    # Add all sources to the benchmarks
+    list(APPEND TMPBENCHMARKSOURCES ${${target}_SOURCES})
+    list(FILTER TMPBENCHMARKSOURCES EXCLUDE REGEX "main.cpp")
+
+    add_executable(${target}_benchmarks ${${target}_BENCHMARK_SOURCES} ${TMPBENCHMARKSOURCES})
+    target_include_directories(${target}_benchmarks PRIVATE ${${target}_INCLUDE_FOLDERS} ${${target}_BENCHMARK_INCLUDE_FOLDERS})
+    target_link_libraries(${target}_benchmarks benchmark::benchmark ${${target}_LIBRARIES})
+
+    if (${target}_COMPILE_DEFINITIONS)
+      target_compile_definitions(${target}_benchmarks PRIVATE ${${target}_COMPILE_DEFINITIONS})
+    endif ()
+
+    if (${target}_DEPENDENCIES)
+      add_dependencies(${target}_benchmarks ${${target}_DEPENDENCIES})
+    endif ()
+
+    if (AUTO_FORMAT)
+      target_clangformat_setup(${target}_benchmarks)
+      add_dependencies(${target}_benchmarks ${target}_clangformat)
+    endif ()
+  endif ()
+
   if (AUTO_FORMAT)
     add_dependencies(${target} ${target}_clangformat)
   endif ()
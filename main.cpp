@@ -1,6 +1,11 @@
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
 #include <iostream>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <string>
 
 #include <boost/asio.hpp>
@@ -10,18 +15,15 @@
 #define CHTYPE_32
 #include <curses.h>
 
-#include "Includes/IPCapDevice.h"
+#include "Includes/Daemon.h"
+#include "Includes/Engine.h"
 #undef timeout
 
 #include "Includes/Logger.h"
-#include "Includes/MonitorDevice.h"
-#include "Includes/NetConversionFunctions.h"
-#include "Includes/Timer.h"
+#include "Includes/TimerService.h"
+#include "Includes/Tracer.h"
 #include "Includes/UserInterface/KeyboardController.h"
 #include "Includes/UserInterface/MainWindowController.h"
-#include "Includes/WirelessPSPPluginDevice.h"
-#include "Includes/WirelessPromiscuousDevice.h"
-#include "Includes/XLinkKaiConnection.h"
 
 namespace
 {
@@ -29,6 +31,9 @@ namespace
     constexpr bool             cLogToDisk{true};
     constexpr std::string_view cConfigFileName{"config.txt"};
 
+    // The TUI is drawn and the engine is checked at most this often, unless a command is given
+    constexpr std::chrono::milliseconds cFrameTime{100};
+
     // Indicates if the program should be running or not, used to gracefully exit the program.
     bool gRunning{true};
 }  // namespace
@@ -93,7 +98,9 @@ int main(int argc, char* argv[])
     // clang-format off
     lDescription.add_options()
         ("help,h", "Shows this help message.")
-        ("verbose,v", "Disables HUD and shows log directly on screen.");
+        ("verbose,v", "Disables HUD and shows log directly on screen.")
+        ("daemon,d", "Runs without HUD, controlled through a local control socket.")
+        ("control-socket", po::value<std::string>(), "Path of the control socket used in daemon mode.");
     // clang-format on
     po::variables_map lVariableMap;
     po::store(po::command_line_parser(argc, argv).options(lDescription).run(), lVariableMap);
@@ -104,15 +111,29 @@ int main(int argc, char* argv[])
         po::notify(lVariableMap);
 
         bool                                  lContinue{true};
-        std::vector<std::string>              lSSIDFilters{};
         std::shared_ptr<MainWindowController> lWindowController{nullptr};
         std::shared_ptr<KeyboardController>   lKeyboardController{nullptr};
 
+        // Only accessed through std::atomic_load and std::atomic_store, the signal handler runs in its own thread
+        std::shared_ptr<Daemon> lDaemon{nullptr};
+
         // Handle quit signals gracefully.
         boost::asio::io_service lSignalIoService{};
         boost::asio::signal_set lSignals(lSignalIoService, SIGINT, SIGTERM);
-        lSignals.async_wait(&SignalHandler);
-        std::thread lThread{[lIoService = &lSignalIoService] { lIoService->run(); }};
+        lSignals.async_wait([&lDaemon](const boost::system::error_code& aError, int aSignalNumber) {
+            SignalHandler(aError, aSignalNumber);
+
+            // The daemon sleeps until something happens, so wake it up
+            std::shared_ptr<Daemon> lRunningDaemon{std::atomic_load(&lDaemon)};
+            if (!gRunning && lRunningDaemon != nullptr) {
+                lRunningDaemon->Stop();
+            }
+        });
+        std::thread lThread{[lIoService = &lSignalIoService] {
+            TRACE_THREAD_NAME("Signals");
+            lIoService->run();
+        }};
+        TRACE_THREAD_NAME("Main");
 
         WindowModel mWindowModel{};
 
@@ -126,11 +147,31 @@ int main(int argc, char* argv[])
 
         Logger::GetInstance().Init(mWindowModel.mLogLevel, cLogToDisk, lProgramPath + cLogFileName.data());
 
-        if ((lVariableMap.count("verbose") != 0U) || (lVariableMap.count("v") != 0U)) {
+        if ((lVariableMap.count("daemon") != 0U) || (lVariableMap.count("d") != 0U)) {
+            Logger::GetInstance().SetLogToScreen(true);
+            if (lSkipWizard) {
+                std::string lSocketPath{lProgramPath + Daemon_Constants::cDefaultSocketName.data()};
+                if (lVariableMap.count("control-socket") != 0U) {
+                    lSocketPath = lVariableMap["control-socket"].as<std::string>();
+                }
+
+                std::atomic_store(&lDaemon, std::make_shared<Daemon>(mWindowModel));
+                if (lDaemon->Open(lSocketPath) && gRunning) {
+                    lDaemon->Run();
+                }
+                std::atomic_store(&lDaemon, std::shared_ptr<Daemon>(nullptr));
+            } else {
+                Logger::GetInstance().Log("No config file found! First run the wizard before running in daemon mode",
+                                          Logger::Level::ERROR);
+            }
+
+            // The daemon has its own loop
+            lContinue = false;
+        } else if ((lVariableMap.count("verbose") != 0U) || (lVariableMap.count("v") != 0U)) {
             Logger::GetInstance().SetLogToScreen(true);
             if (lSkipWizard) {
                 // Start the engine immediately
-                mWindowModel.mCommand = WindowModel_Constants::Command::StartEngine;
+                mWindowModel.mCommand.Set(WindowModel_Constants::Command::StartEngine);
             } else {
                 Logger::GetInstance().Log("No config file found! First run the wizard before running in verbose mode",
                                           Logger::Level::ERROR);
@@ -152,171 +193,131 @@ int main(int argc, char* argv[])
         }
 
         if (lContinue) {
-            Timer                               lTimer{};
-            std::shared_ptr<IPCapDevice>        lDevice{nullptr};
-            std::shared_ptr<XLinkKaiConnection> lXLinkKaiConnection{std::make_shared<XLinkKaiConnection>()};
-
-            bool lSuccess{false};
+            Engine lEngine{mWindowModel};
 
             // If we need more entry methods, make an actual state machine
-            bool                                               lWaitEntry{true};
-            std::chrono::time_point<std::chrono::system_clock> lWaitStart{std::chrono::seconds{0}};
-
-            WindowModel_Constants::ConnectionMethod lOldMethod = mWindowModel.mConnectionMethod;
+            bool lWaitEntry{true};
+
+            // Sleeps until the next frame, unless a command is given
+            std::mutex                            lWakeUpMutex{};
+            std::condition_variable               lWakeUp{};
+            bool                                  lCommandGiven{false};
+            std::chrono::steady_clock::time_point lNextFrame{std::chrono::steady_clock::now()};
+
+            // Set from the TimerService once the wait state is over
+            TimerWheel::Id    lWaitTimer{0};
+            std::atomic<bool> lWaitDone{false};
+
+            Subscription lCommandSubscription{mWindowModel.mCommand.Subscribe([&](WindowModel_Constants::Command) {
+                {
+                    std::scoped_lock lLock{lWakeUpMutex};
+                    lCommandGiven = true;
+                }
+                lWakeUp.notify_one();
+            })};
 
             while (gRunning) {
                 if (lWindowController == nullptr || lWindowController->Process()) {
-                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
-                    switch (mWindowModel.mCommand) {
-                        case WindowModel_Constants::Command::StartEngine:
-                            if (mWindowModel.mLogLevel != Logger::GetInstance().GetLogLevel()) {
-                                Logger::GetInstance().SetLogLevel(mWindowModel.mLogLevel);
-                            }
+                    {
+                        std::unique_lock lLock{lWakeUpMutex};
+                        lWakeUp.wait_until(lLock, lNextFrame, [&] { return lCommandGiven; });
+                        lCommandGiven = false;
+                    }
 
-                            switch (mWindowModel.mConnectionMethod) {
-                                case WindowModel_Constants::ConnectionMethod::Plugin:
-                                    if (std::dynamic_pointer_cast<WirelessPSPPluginDevice>(lDevice) == nullptr) {
-                                        std::chrono::seconds lTimeOut =
-                                            std::chrono::seconds(std::stoi(mWindowModel.mReConnectionTimeOutS));
-                                        lDevice = std::make_shared<WirelessPSPPluginDevice>(
-                                            mWindowModel.mAutoDiscoverPSPVitaNetworks,
-                                            lTimeOut,
-                                            &mWindowModel.mCurrentlyConnectedNetwork);
-
-                                        Logger::GetInstance().Log("Plugin Device created!", Logger::Level::INFO);
+                    if (std::chrono::steady_clock::now() >= lNextFrame) {
+                        lNextFrame = std::max(lNextFrame + cFrameTime, std::chrono::steady_clock::now());
+                    }
+
+                    // The engine starts in the background, other commands are handled once it is done. Stopping
+                    // cuts the start short instead, so it does not have to wait for every adapter to come up.
+                    if (lEngine.IsStarting() &&
+                        mWindowModel.mCommand.Get() != WindowModel_Constants::Command::StopEngine) {
+                        std::optional<Engine_Constants::StartResult> lResult{lEngine.GetStartResult()};
+                        if (lResult.has_value()) {
+                            switch (lResult.value()) {
+                                case Engine_Constants::StartResult::Success:
+                                    mWindowModel.mEngineStatus.Set(WindowModel_Constants::EngineStatus::Running);
+                                    // Keep a command given while starting, it is handled next
+                                    if (mWindowModel.mCommand.Get() == WindowModel_Constants::Command::StartEngine) {
+                                        mWindowModel.mCommand.Set(WindowModel_Constants::Command::NoCommand);
                                     }
                                     break;
-                                case WindowModel_Constants::ConnectionMethod::Promiscuous:
-                                    if (std::dynamic_pointer_cast<WirelessPromiscuousDevice>(lDevice) == nullptr) {
-                                        std::chrono::seconds lTimeOut =
-                                            std::chrono::seconds(std::stoi(mWindowModel.mReConnectionTimeOutS));
-                                        lDevice = std::make_shared<WirelessPromiscuousDevice>(
-                                            mWindowModel.mAutoDiscoverPSPVitaNetworks,
-                                            lTimeOut,
-                                            &mWindowModel.mCurrentlyConnectedNetwork);
-
-                                        Logger::GetInstance().Log("Promiscuous Device created!", Logger::Level::INFO);
-                                    }
+                                case Engine_Constants::StartResult::ConnectorFailed:
+                                    Logger::GetInstance().Log(
+                                        "Failed to open connection to XLink Kai, retrying in 10 seconds!",
+                                        Logger::Level::ERROR);
+                                    // Have it take some time between tries
+                                    mWindowModel.mEngineStatus.Set(WindowModel_Constants::EngineStatus::Idle);
+                                    mWindowModel.mCommand.Set(WindowModel_Constants::Command::WaitForTime);
+                                    mWindowModel.mTimeToWait       = std::chrono::seconds(10);
+                                    mWindowModel.mCommandAfterWait = WindowModel_Constants::Command::NoCommand;
                                     break;
-#if not defined(_WIN32) && not defined(_WIN64)
-                                case WindowModel_Constants::ConnectionMethod::Monitor:
-                                    if (std::dynamic_pointer_cast<MonitorDevice>(lDevice) == nullptr) {
-                                        lDevice =
-                                            std::make_shared<MonitorDevice>(MacToInt(mWindowModel.mOnlyAcceptFromMac),
-                                                                            mWindowModel.mAcknowledgeDataFrames,
-                                                                            &mWindowModel.mCurrentlyConnectedNetwork);
-                                        Logger::GetInstance().Log("Monitor Device created!", Logger::Level::INFO);
-                                        break;
-                                    }
-				    break;
-#endif
-                                default:
-                                    Logger::GetInstance().Log("Unknown method!", Logger::Level::ERROR);
+                                case Engine_Constants::StartResult::DeviceFailed:
+                                    mWindowModel.mEngineStatus.Set(WindowModel_Constants::EngineStatus::Error);
+                                    mWindowModel.mCommand.Set(WindowModel_Constants::Command::WaitForTime);
+                                    mWindowModel.mTimeToWait       = std::chrono::seconds(5);
+                                    mWindowModel.mCommandAfterWait = WindowModel_Constants::Command::StopEngine;
+                                    break;
+                                case Engine_Constants::StartResult::UnknownMethod:
                                     gRunning = false;
                                     break;
+                                case Engine_Constants::StartResult::Cancelled:
+                                    // Only happens when stopping, which takes care of the status
+                                    break;
                             }
+                        }
+                        continue;
+                    }
 
-                            // Completely reset the xlink kai connection on a mode switch
-                            if (lOldMethod != mWindowModel.mConnectionMethod) {
-                                lXLinkKaiConnection->Close();
-                                lXLinkKaiConnection = nullptr;
-                                lXLinkKaiConnection = std::make_shared<XLinkKaiConnection>();
-                            }
-
-                            lOldMethod = mWindowModel.mConnectionMethod;
-
-                            lXLinkKaiConnection->SetIncomingConnection(lDevice);
-                            lXLinkKaiConnection->SetUseHostSSID(mWindowModel.mUseSSIDFromHost);
-
-                            lDevice->SetConnector(lXLinkKaiConnection);
-
-                            // If we are auto discovering PSP/VITA networks add those to the filter list
-                            if (mWindowModel.mAutoDiscoverPSPVitaNetworks) {
-                                lSSIDFilters.emplace_back(Net_Constants::cPSPSSIDFilterName.data());
-                                lSSIDFilters.emplace_back(Net_Constants::cVitaSSIDFilterName.data());
-                            }
-
-                            // Set the XLink Kai connection up, if we are autodiscovering we don't need to provide an IP
-                            if (!mWindowModel.mAutoDiscoverXLinkKaiInstance) {
-                                lSuccess = lXLinkKaiConnection->Open(mWindowModel.mXLinkIp,
-                                                                     std::stoi(mWindowModel.mXLinkPort));
-                            } else {
-                                lSuccess = lXLinkKaiConnection->Open("");
+                    switch (mWindowModel.mCommand.Get()) {
+                        case WindowModel_Constants::Command::StartEngine:
+                            if (mWindowModel.mLogLevel != Logger::GetInstance().GetLogLevel()) {
+                                Logger::GetInstance().SetLogLevel(mWindowModel.mLogLevel);
                             }
 
-                            // Now set up the wifi interface
-                            if (lSuccess) {
-                                if (lDevice->Open(mWindowModel.mWifiAdapter, lSSIDFilters)) {
-                                    if (lDevice->StartReceiverThread() && lXLinkKaiConnection->StartReceiverThread()) {
-                                        mWindowModel.mEngineStatus = WindowModel_Constants::EngineStatus::Running;
-                                        mWindowModel.mCommand      = WindowModel_Constants::Command::NoCommand;
-                                    } else {
-                                        Logger::GetInstance().Log("Failed to start receiver threads",
-                                                                  Logger::Level::ERROR);
-                                        mWindowModel.mEngineStatus     = WindowModel_Constants::EngineStatus::Error;
-                                        mWindowModel.mCommand          = WindowModel_Constants::Command::WaitForTime;
-                                        mWindowModel.mTimeToWait       = std::chrono::seconds(5);
-                                        mWindowModel.mCommandAfterWait = WindowModel_Constants::Command::StopEngine;
-                                    }
-                                } else {
-                                    Logger::GetInstance().Log("Failed to activate monitor interface",
-                                                              Logger::Level::ERROR);
-                                    mWindowModel.mEngineStatus     = WindowModel_Constants::EngineStatus::Error;
-                                    mWindowModel.mCommand          = WindowModel_Constants::Command::WaitForTime;
-                                    mWindowModel.mTimeToWait       = std::chrono::seconds(5);
-                                    mWindowModel.mCommandAfterWait = WindowModel_Constants::Command::StopEngine;
-                                }
-                            } else {
-                                Logger::GetInstance().Log(
-                                    "Failed to open connection to XLink Kai, retrying in 10 seconds!",
-                                    Logger::Level::ERROR);
-                                // Have it take some time between tries
-                                mWindowModel.mCommand          = WindowModel_Constants::Command::WaitForTime;
-                                mWindowModel.mTimeToWait       = std::chrono::seconds(10);
-                                mWindowModel.mCommandAfterWait = WindowModel_Constants::Command::NoCommand;
-                            }
+                            mWindowModel.mEngineStatus.Set(WindowModel_Constants::EngineStatus::Starting);
+                            lEngine.StartAsync();
                             break;
                         case WindowModel_Constants::Command::WaitForTime:
                             // Wait state, use this to add a delay without making the UI unresponsive.
                             if (lWaitEntry) {
-                                lTimer.Start(mWindowModel.mTimeToWait);
+                                lWaitDone  = false;
+                                lWaitTimer = TimerService::GetInstance().Schedule(mWindowModel.mTimeToWait, [&] {
+                                    lWaitDone = true;
+                                    {
+                                        std::scoped_lock lLock{lWakeUpMutex};
+                                        lCommandGiven = true;
+                                    }
+                                    lWakeUp.notify_one();
+                                });
                                 lWaitEntry = false;
                             }
 
-                            if (lTimer.IsTimedOut()) {
-                                mWindowModel.mCommand = mWindowModel.mCommandAfterWait;
-                                lWaitEntry            = true;
+                            if (lWaitDone) {
+                                mWindowModel.mCommand.Set(mWindowModel.mCommandAfterWait);
+                                lWaitEntry = true;
                             }
                             break;
                         case WindowModel_Constants::Command::StopEngine:
-                            lXLinkKaiConnection->Close();
-                            lDevice->Close();
-                            lSSIDFilters.clear();
-
-                            // Let's actually just remove the device, easier this way
-                            lDevice = nullptr;
+                            lEngine.Stop();
 
                             // Remove the Connected To portion to make it easier for people to understand that the
                             // network was disconnected.
-                            mWindowModel.mCurrentlyConnectedNetwork.clear();
-                            mWindowModel.mEngineStatus = WindowModel_Constants::EngineStatus::Idle;
-                            mWindowModel.mCommand      = WindowModel_Constants::Command::NoCommand;
+                            mWindowModel.mCurrentlyConnectedNetwork.Set("");
+                            mWindowModel.mEngineStatus.Set(WindowModel_Constants::EngineStatus::Idle);
+                            mWindowModel.mCommand.Set(WindowModel_Constants::Command::NoCommand);
                             break;
                         case WindowModel_Constants::Command::StartSearchNetworks:
                         case WindowModel_Constants::Command::StopSearchNetworks:
                             // TODO: implement.
                             break;
                         case WindowModel_Constants::Command::ReConnect:
-                            if (lDevice != nullptr) {
-                                lDevice->Connect("");
-                            }
-
-                            mWindowModel.mCommand = WindowModel_Constants::Command::NoCommand;
+                            lEngine.ReConnect();
+                            mWindowModel.mCommand.Set(WindowModel_Constants::Command::NoCommand);
                             break;
                         case WindowModel_Constants::Command::SetHosting:
-                            if (lXLinkKaiConnection != nullptr) {
-                                lXLinkKaiConnection->SetHosting(mWindowModel.mHosting);
-                            }
+                            lEngine.SetHosting(mWindowModel.mHosting);
+                            mWindowModel.mCommand.Set(WindowModel_Constants::Command::NoCommand);
                             break;
                         case WindowModel_Constants::Command::NoCommand:
                             break;
@@ -326,18 +327,13 @@ int main(int argc, char* argv[])
                 }
             }
 
-            mWindowModel.mEngineStatus = WindowModel_Constants::EngineStatus::Idle;
-            mWindowModel.mCommand      = WindowModel_Constants::Command::NoCommand;
+            // The wait timer refers to this scope
+            TimerService::GetInstance().Cancel(lWaitTimer);
 
-            if (lDevice != nullptr) {
-                lDevice->Close();
-            }
-
-            lXLinkKaiConnection->Close();
-            lSSIDFilters.clear();
+            mWindowModel.mEngineStatus.Set(WindowModel_Constants::EngineStatus::Idle);
+            mWindowModel.mCommand.Set(WindowModel_Constants::Command::NoCommand);
 
-            lDevice             = nullptr;
-            lXLinkKaiConnection = nullptr;
+            lEngine.Stop();
         } else {
             gRunning = false;
         }
@@ -353,5 +349,7 @@ int main(int argc, char* argv[])
         if (lThread.joinable()) {
             lThread.join();
         }
+
+        TRACE_SAVE(lProgramPath + Tracer_Constants::cFileName.data());
     }
 }